@@ -41,6 +41,9 @@
 if (my_b_write((file),(uchar*) (from),param->ref_length)) \
   DBUG_RETURN(1);
 
+class Sort_run_writer;
+class Sort_merger;
+
 	/* functions defined in this file */
 
 static uchar *read_buffpek_from_file(IO_CACHE *buffer_file, uint count,
@@ -50,6 +53,7 @@ static ha_rows find_all_keys(THD *thd, Sort_param *param, SQL_SELECT *select,
                              IO_CACHE *buffer_file,
                              IO_CACHE *tempfile,
                              Bounded_queue<uchar, uchar> *pq,
+                             Sort_run_writer *run_writer,
                              ha_rows *found_rows);
 static bool write_keys(Sort_param *param, SORT_INFO *fs_info,
                       uint count, IO_CACHE *buffer_file, IO_CACHE *tempfile);
@@ -70,6 +74,164 @@ static bool check_if_pq_applicable(Sort_param *param, SORT_INFO *info,
                                    TABLE *table,
                                    ha_rows records, size_t memory_available);
 
+/* Least number of keys a thread of a parallel sort sorts or merges at once */
+#define SORT_THREAD_MIN_KEYS 1024
+/* Keys sampled per run and merge thread to split the final merge */
+#define SORT_MERGE_SAMPLES 4
+
+/*
+  Parallel sorting
+
+  When max_sort_threads is greater than 1 and the keys do not fit into the
+  sort buffer, the runs are sorted and written, and merged, by worker
+  threads.
+
+  Sort_run_writer divides the sort buffer into one slot per thread when it
+  overflows for the first time. The full buffer is handed over to the
+  workers slot by slot; each worker sorts the keys of its slot and writes
+  them as a run. find_all_keys() continues in the first slot as soon as it
+  is written, and hands over every slot it fills in turn, so that records
+  are read while the keys of the previous slots are sorted and written.
+
+  Sort_merger replaces the passes of merge_many_buff(), where the groups of
+  MERGEBUFF runs are merged by different workers, and the final merge of
+  merge_index(), which is split by key ranges: keys sampled from the runs
+  give a splitting key for every worker but the first, and binary searches
+  find where each run crosses them. Every worker then merges its part of
+  all runs, picking the smallest key with a loser tree.
+
+  The place of every run and merge result in its file is known before it is
+  handed over, so the workers access the files with pread() and pwrite()
+  and need no locking; the temporary files must not be encrypted. Every
+  worker has its own part of the sort buffer. Sorts with a LIMIT are merged
+  by the thread of the statement.
+*/
+
+/* A part of the sort buffer, and the run that is made of it */
+struct st_sort_run_slot
+{
+  Sort_run_writer *owner;
+  /* The key pointers of the slot, and room for a radix sort of them */
+  uchar **keys;
+  Sort_key_prefix *radix_buffer;
+  uint max_keys;
+  /* Keys to sort, and how many of them to write at file_pos */
+  uint count;
+  uint write_count;
+  my_off_t file_pos;
+  uchar *write_buffer;
+  pthread_t thread;
+  bool started;
+  bool error;
+};
+typedef struct st_sort_run_slot SORT_RUN_SLOT;
+
+
+class Sort_run_writer
+{
+  Sort_param *param;
+  SORT_INFO *fs_info;
+  IO_CACHE *buffpek_pointers, *tempfile;
+  uint n_threads;
+  /* NULL until the sort buffer overflows */
+  SORT_RUN_SLOT *slots;
+  /* Room for a radix sort of all slots, or NULL if the keys are compared */
+  Sort_key_prefix *radix_buffer;
+  /* The slot that find_all_keys() fills */
+  uint cur;
+  /* Where the next run goes in tempfile */
+  my_off_t file_pos;
+  size_t write_buffer_size;
+
+  bool start(uint count);
+  bool start_slot(SORT_RUN_SLOT *slot, uint count);
+  bool wait_slot(SORT_RUN_SLOT *slot);
+
+public:
+  Sort_run_writer() :n_threads(0), slots(NULL), radix_buffer(NULL) {}
+  ~Sort_run_writer() { end(); }
+
+  /* FALSE if the sort buffer is too small to be divided */
+  bool init(Sort_param *param_arg, SORT_INFO *fs_info_arg,
+            IO_CACHE *buffpek_pointers_arg, IO_CACHE *tempfile_arg,
+            uint threads);
+  uint threads() const { return slots ? n_threads : 1; }
+
+  /* Index of the first key and number of keys of the slot to fill */
+  uint first_key() const
+  { return slots ? (uint) (slots[cur].keys - fs_info->get_sort_keys()) : 0; }
+  uint max_keys() const { return slots[cur].max_keys; }
+
+  bool write_keys(uint count);
+  void write_run(SORT_RUN_SLOT *slot);
+  bool finish();
+  void end();
+};
+
+
+/* A merge of runs, or of parts of runs, into one */
+struct st_sort_merge_job
+{
+  BUFFPEK *runs;
+  uint n_runs;
+  /* Where the result goes, and its number of keys */
+  my_off_t file_pos;
+  ha_rows count;
+};
+typedef struct st_sort_merge_job SORT_MERGE_JOB;
+
+struct st_sort_merge_worker
+{
+  Sort_merger *owner;
+  /* The part of the sort buffer of the worker */
+  uchar *buff;
+  ulong max_keys;
+  uchar *write_buffer;
+  /* The worker does the jobs first_job, first_job + n_workers, ... */
+  uint first_job;
+  pthread_t thread;
+  bool started;
+  bool error;
+};
+typedef struct st_sort_merge_worker SORT_MERGE_WORKER;
+
+
+class Sort_merger
+{
+  THD *thd;
+  Sort_param *param;
+  SORT_MERGE_WORKER *workers;
+  uint n_workers;
+  size_t write_buffer_size;
+
+  /* The merges to run, the files and the part of the keys written */
+  SORT_MERGE_JOB *jobs;
+  uint n_jobs;
+  File from_file, to_file;
+  uint wr_offset, wr_len;
+
+  bool read_run(BUFFPEK *run);
+  bool lower_bound(BUFFPEK *run, const uchar *key, uchar *buff,
+                   ha_rows *pos);
+  bool merge_job(SORT_MERGE_WORKER *worker, SORT_MERGE_JOB *job);
+  bool run_jobs();
+
+public:
+  Sort_merger() :workers(NULL), n_workers(0), jobs(NULL) {}
+  ~Sort_merger() { end(); }
+
+  /* FALSE if the merges are to be done by the thread of the statement */
+  bool init(THD *thd_arg, Sort_param *param_arg, uchar *sort_buffer,
+            uint threads);
+  uint threads() const { return n_workers; }
+
+  int merge_many_buff(BUFFPEK *buffpek, uint *maxbuffer, IO_CACHE *t_file);
+  int merge_index(BUFFPEK *buffpek, uint maxbuffer,
+                  IO_CACHE *tempfile, IO_CACHE *outfile);
+  void merge(SORT_MERGE_WORKER *worker);
+  void end();
+};
+
 void Sort_param::init_for_filesort(uint sortlen, TABLE *table,
                                    ulong max_length_for_sort_data,
                                    ha_rows maxrows, bool sort_positions)
@@ -152,6 +314,11 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
   SQL_SELECT *const select= filesort->select;
   ha_rows max_rows= filesort->limit;
   uint s_length= 0;
+  /* The workers access the temporary files with pread() and pwrite() */
+  uint sort_threads= (encrypt_tmp_files ? 1 :
+                      (uint) thd->variables.max_sort_threads);
+  Sort_run_writer run_writer;
+  Sort_merger merger;
 
   DBUG_ENTER("filesort");
 
@@ -270,14 +437,22 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
 
   param.sort_form= table;
   param.end=(param.local_sortorder=filesort->sortorder)+s_length;
+  tracker->report_read_start();
   num_rows= find_all_keys(thd, &param, select,
                           sort,
                           &buffpek_pointers,
                           &tempfile, 
                           pq.is_initialized() ? &pq : NULL,
+                          (!pq.is_initialized() && sort_threads > 1 &&
+                           run_writer.init(&param, sort, &buffpek_pointers,
+                                           &tempfile, sort_threads) ?
+                           &run_writer : NULL),
                           &sort->found_rows);
   if (num_rows == HA_POS_ERROR)
     goto err;
+  tracker->report_read_end();
+  tracker->report_sort_threads(run_writer.threads());
+  run_writer.end();
 
   maxbuffer= (uint) (my_b_tell(&buffpek_pointers)/sizeof(*buffpek));
   tracker->report_merge_passes_at_start(thd->query_plan_fsort_passes);
@@ -321,7 +496,16 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
                                 (param.rec_length + sizeof(char*))) /
                                param.rec_length - 1);
     maxbuffer--;				// Offset from 0
-    if (merge_many_buff(&param,
+    bool parallel_merge= (sort_threads > 1 &&
+                          param.max_rows == HA_POS_ERROR &&
+                          merger.init(thd, &param,
+                                      (uchar*) sort->get_sort_keys(),
+                                      sort_threads));
+    tracker->report_sort_threads(merger.threads());
+    tracker->report_merge_start();
+    if (parallel_merge ?
+        merger.merge_many_buff(buffpek, &maxbuffer, &tempfile) :
+        merge_many_buff(&param,
                         (uchar*) sort->get_sort_keys(),
                         buffpek,&maxbuffer,
 			&tempfile))
@@ -329,13 +513,16 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
     if (flush_io_cache(&tempfile) ||
 	reinit_io_cache(&tempfile,READ_CACHE,0L,0,0))
       goto err;
-    if (merge_index(&param,
+    if (parallel_merge ?
+        merger.merge_index(buffpek, maxbuffer, &tempfile, outfile) :
+        merge_index(&param,
                     (uchar*) sort->get_sort_keys(),
                     buffpek,
                     maxbuffer,
                     &tempfile,
 		    outfile))
       goto err;
+    tracker->report_merge_end();
   }
 
   if (num_rows > param.max_rows)
@@ -346,6 +533,8 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
   error= 0;
 
   err:
+  run_writer.end();
+  merger.end();
   my_free(param.tmp_buffer);
   if (!subselect || !subselect->is_uncacheable())
   {
@@ -664,6 +853,8 @@ static void dbug_print_record(TABLE *table, bool print_rowid)
                            in tempfile.
   @param tempfile          File to write sorted sequences of sortkeys to.
   @param pq                If !NULL, use it for keeping top N elements
+  @param run_writer        If !NULL, it sorts and writes the sort_keys
+                           buffers with worker threads
   @param [out] found_rows  The number of FOUND_ROWS().
                            For a query with LIMIT, this value will typically
                            be larger than the function return value.
@@ -703,10 +894,12 @@ static ha_rows find_all_keys(THD *thd, Sort_param *param, SQL_SELECT *select,
 			     IO_CACHE *buffpek_pointers,
                              IO_CACHE *tempfile,
                              Bounded_queue<uchar, uchar> *pq,
+                             Sort_run_writer *run_writer,
                              ha_rows *found_rows)
 {
   int error,flag,quick_select;
   uint idx,indexpos,ref_length;
+  uint first_key= 0, max_keys= param->max_keys_per_buffer;
   uchar *ref_pos,*next_pos,ref_buff[MAX_REFLENGTH];
   my_off_t record;
   TABLE *sort_form;
@@ -853,14 +1046,23 @@ static ha_rows find_all_keys(THD *thd, Sort_param *param, SQL_SELECT *select,
       }
       else
       {
-        if (idx == param->max_keys_per_buffer)
+        if (idx == max_keys)
         {
-          if (write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
+          if (run_writer)
+          {
+            /* Continue in the slot of the buffer that is free */
+            if (run_writer->write_keys(idx))
+              goto err;
+            first_key= run_writer->first_key();
+            max_keys= run_writer->max_keys();
+          }
+          else if (write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
             goto err;
 	  idx= 0;
 	  indexpos++;
         }
-        make_sortkey(param, fs_info->get_record_buffer(idx++), ref_pos);
+        make_sortkey(param, fs_info->get_record_buffer(first_key + idx++),
+                     ref_pos);
       }
     }
 
@@ -895,8 +1097,11 @@ static ha_rows find_all_keys(THD *thd, Sort_param *param, SQL_SELECT *select,
     DBUG_RETURN(HA_POS_ERROR);			/* purecov: inspected */
   }
   if (indexpos && idx &&
-      write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
+      (run_writer ? run_writer->write_keys(idx) :
+       write_keys(param, fs_info, idx, buffpek_pointers, tempfile)))
     DBUG_RETURN(HA_POS_ERROR);			/* purecov: inspected */
+  if (run_writer && run_writer->finish())
+    DBUG_RETURN(HA_POS_ERROR);
   retval= (my_b_inited(tempfile) ?
            (ha_rows) (my_b_tell(tempfile)/param->rec_length) :
            idx);
@@ -969,6 +1174,235 @@ write_keys(Sort_param *param,  SORT_INFO *fs_info, uint count,
 } /* write_keys */
 
 
+pthread_handler_t handle_sort_run(void *arg)
+{
+  SORT_RUN_SLOT *slot= (SORT_RUN_SLOT *) arg;
+  my_thread_init();
+  slot->owner->write_run(slot);
+  my_thread_end();
+  return 0;
+}
+
+
+bool Sort_run_writer::init(Sort_param *param_arg, SORT_INFO *fs_info_arg,
+                           IO_CACHE *buffpek_pointers_arg,
+                           IO_CACHE *tempfile_arg, uint threads)
+{
+  param= param_arg;
+  fs_info= fs_info_arg;
+  buffpek_pointers= buffpek_pointers_arg;
+  tempfile= tempfile_arg;
+  n_threads= MY_MIN(threads,
+                    param->max_keys_per_buffer / SORT_THREAD_MIN_KEYS);
+  return n_threads > 1;
+}
+
+
+/**
+  Divide the sort buffer into slots when it overflows for the first time
+
+  @param count  Number of keys in the buffer
+*/
+
+bool Sort_run_writer::start(uint count)
+{
+  uint keys_per_slot= count / n_threads;
+  uchar *write_buffers;
+  DBUG_ENTER("Sort_run_writer::start");
+
+  if (!my_b_inited(tempfile) &&
+      open_cached_file(tempfile, mysql_tmpdir, TEMP_PREFIX, DISK_BUFFER_SIZE,
+                       MYF(MY_WME)))
+    DBUG_RETURN(TRUE);
+  if (tempfile->file < 0 && real_open_cached_file(tempfile))
+    DBUG_RETURN(TRUE);
+  DBUG_ASSERT(!(tempfile->myflags & MY_ENCRYPT));
+  file_pos= my_b_tell(tempfile);
+
+  write_buffer_size= MY_MAX(DISK_BUFFER_SIZE / param->rec_length, 1) *
+                     param->rec_length;
+  if (!my_multi_malloc_large(MYF(MY_WME | MY_THREAD_SPECIFIC),
+                             &slots,
+                             (ulonglong) sizeof(SORT_RUN_SLOT) * n_threads,
+                             &write_buffers,
+                             (ulonglong) write_buffer_size * n_threads,
+                             NullS))
+  {
+    slots= NULL;
+    DBUG_RETURN(TRUE);
+  }
+  bzero(slots, sizeof(SORT_RUN_SLOT) * n_threads);
+  /* Without the buffer, the slots are sorted by comparisons */
+  if (count <= SORT_RADIX_MAX_KEYS)
+    radix_buffer= (Sort_key_prefix*) my_malloc(sizeof(Sort_key_prefix) * count,
+                                               MYF(MY_THREAD_SPECIFIC));
+
+  for (uint i= 0; i < n_threads; i++)
+  {
+    SORT_RUN_SLOT *slot= slots + i;
+    uint first= i * keys_per_slot;
+    slot->owner= this;
+    slot->keys= fs_info->get_sort_keys() + first;
+    slot->max_keys= (i == n_threads - 1 ? count - first : keys_per_slot);
+    slot->radix_buffer= radix_buffer ? radix_buffer + first : NULL;
+    slot->write_buffer= write_buffers + write_buffer_size * i;
+  }
+  DBUG_RETURN(FALSE);
+}
+
+
+/**
+  Write a BUFFPEK for the keys of a slot, and start a thread that sorts
+  and writes them
+*/
+
+bool Sort_run_writer::start_slot(SORT_RUN_SLOT *slot, uint count)
+{
+  BUFFPEK buffpek;
+
+  /* check we won't have more buffpeks than we can possibly keep in memory */
+  if (my_b_tell(buffpek_pointers) + sizeof(BUFFPEK) > (ulonglong)UINT_MAX)
+    return TRUE;
+  slot->count= count;
+  slot->write_count= ((ha_rows) count > param->max_rows ?
+                      (uint) param->max_rows : count);
+  slot->file_pos= file_pos;
+  file_pos+= (my_off_t) slot->write_count * param->rec_length;
+
+  bzero(&buffpek, sizeof(buffpek));
+  buffpek.file_pos= slot->file_pos;
+  buffpek.count= (ha_rows) slot->write_count;
+  if (my_b_write(buffpek_pointers, (uchar*) &buffpek, sizeof(buffpek)))
+    return TRUE;
+
+  slot->error= FALSE;
+  slot->started= !mysql_thread_create(key_thread_filesort, &slot->thread,
+                                      NULL, handle_sort_run, slot);
+  if (!slot->started)
+    write_run(slot);
+  return FALSE;
+}
+
+
+/* Wait until the keys of a slot have been written */
+
+bool Sort_run_writer::wait_slot(SORT_RUN_SLOT *slot)
+{
+  if (slot->started)
+  {
+    pthread_join(slot->thread, NULL);
+    slot->started= FALSE;
+  }
+  return slot->error;
+}
+
+
+/**
+  Hand over the keys of the slot that has been filled, and wait until
+  the next slot may be filled
+
+  @param count  Number of keys in the slot, or in the whole buffer when
+                it overflows for the first time
+*/
+
+bool Sort_run_writer::write_keys(uint count)
+{
+  DBUG_ENTER("Sort_run_writer::write_keys");
+  if (!slots)
+  {
+    if (start(count))
+      DBUG_RETURN(TRUE);
+    for (uint i= 0; i < n_threads; i++)
+    {
+      if (start_slot(slots + i, slots[i].max_keys))
+        DBUG_RETURN(TRUE);
+    }
+    cur= 0;
+  }
+  else
+  {
+    if (start_slot(slots + cur, count))
+      DBUG_RETURN(TRUE);
+    cur= (cur + 1) % n_threads;
+  }
+  if (wait_slot(slots + cur))
+  {
+    my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+    DBUG_RETURN(TRUE);
+  }
+  DBUG_RETURN(FALSE);
+}
+
+
+/* Sort the keys of a slot and write them at their place in tempfile */
+
+void Sort_run_writer::write_run(SORT_RUN_SLOT *slot)
+{
+  uint rec_length= param->rec_length;
+  uchar *pos= slot->write_buffer;
+  uchar *end= slot->write_buffer + write_buffer_size;
+  my_off_t write_pos= slot->file_pos;
+
+  Filesort_buffer::sort_keys(param, slot->keys, slot->count,
+                             slot->radix_buffer);
+  for (uint i= 0; i < slot->write_count; i++)
+  {
+    if (pos == end)
+    {
+      if (mysql_file_pwrite(tempfile->file, slot->write_buffer,
+                            write_buffer_size, write_pos, MYF(MY_NABP)))
+      {
+        slot->error= TRUE;
+        return;
+      }
+      write_pos+= write_buffer_size;
+      pos= slot->write_buffer;
+    }
+    memcpy(pos, slot->keys[i], rec_length);
+    pos+= rec_length;
+  }
+  if (pos != slot->write_buffer &&
+      mysql_file_pwrite(tempfile->file, slot->write_buffer,
+                        (size_t) (pos - slot->write_buffer), write_pos,
+                        MYF(MY_NABP)))
+    slot->error= TRUE;
+}
+
+
+/**
+  Wait until all runs have been written, and let tempfile continue after
+  them
+*/
+
+bool Sort_run_writer::finish()
+{
+  bool error= FALSE;
+  if (!slots)
+    return FALSE;
+  for (uint i= 0; i < n_threads; i++)
+    error|= wait_slot(slots + i);
+  if (error)
+  {
+    my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+    return TRUE;
+  }
+  return reinit_io_cache(tempfile, WRITE_CACHE, file_pos, 0, 1);
+}
+
+
+void Sort_run_writer::end()
+{
+  if (!slots)
+    return;
+  for (uint i= 0; i < n_threads; i++)
+    (void) wait_slot(slots + i);
+  my_free(slots);
+  slots= NULL;
+  my_free(radix_buffer);
+  radix_buffer= NULL;
+}
+
+
 /**
   Store length as suffix in high-byte-first order.
 */
@@ -1864,6 +2298,504 @@ int merge_index(Sort_param *param, uchar *sort_buffer,
 } /* merge_index */
 
 
+/*
+  A loser tree over the runs of a merge
+
+  Every inner node keeps the run that lost the match played at it, and
+  tree[0] the run with the smallest key. Runs without keys left have
+  key == NULL and lose every match.
+*/
+
+class Merge_loser_tree
+{
+  BUFFPEK **runs;
+  uint n_runs;
+  size_t key_length;
+  uint tree[MERGEBUFF2];
+
+  /* TRUE if run a goes before run b */
+  bool less(uint a, uint b) const
+  {
+    const uchar *key_a= runs[a]->key, *key_b= runs[b]->key;
+    if (!key_a || !key_b)
+      return !key_b && (key_a || a < b);
+    int res= memcmp(key_a, key_b, key_length);
+    return res < 0 || (res == 0 && a < b);
+  }
+
+public:
+  void init(BUFFPEK **runs_arg, uint n_runs_arg, size_t key_length_arg)
+  {
+    /* The winners of the matches; run i is leaf n_runs + i */
+    uint winners[2 * MERGEBUFF2];
+    runs= runs_arg;
+    n_runs= n_runs_arg;
+    key_length= key_length_arg;
+    DBUG_ASSERT(n_runs >= 1 && n_runs <= MERGEBUFF2);
+    for (uint i= 0; i < n_runs; i++)
+      winners[n_runs + i]= i;
+    for (uint node= n_runs - 1; node >= 1; node--)
+    {
+      uint a= winners[2 * node], b= winners[2 * node + 1];
+      if (less(a, b))
+      {
+        winners[node]= a;
+        tree[node]= b;
+      }
+      else
+      {
+        winners[node]= b;
+        tree[node]= a;
+      }
+    }
+    tree[0]= n_runs > 1 ? winners[1] : 0;
+  }
+
+  /* The run with the smallest key, or NULL if all runs are exhausted */
+  BUFFPEK *top() const
+  {
+    BUFFPEK *run= runs[tree[0]];
+    return run->key ? run : NULL;
+  }
+
+  /* Replay the matches of the top run after its key has changed */
+  void replay()
+  {
+    uint winner= tree[0];
+    for (uint node= (n_runs + winner) / 2; node >= 1; node/= 2)
+    {
+      if (less(tree[node], winner))
+        swap_variables(uint, tree[node], winner);
+    }
+    tree[0]= winner;
+  }
+};
+
+
+pthread_handler_t handle_sort_merge(void *arg)
+{
+  SORT_MERGE_WORKER *worker= (SORT_MERGE_WORKER *) arg;
+  my_thread_init();
+  worker->owner->merge(worker);
+  my_thread_end();
+  return 0;
+}
+
+
+/**
+  Divide the sort buffer among the merge threads
+
+  @param sort_buffer  Buffer for param->max_keys_per_buffer keys
+*/
+
+bool Sort_merger::init(THD *thd_arg, Sort_param *param_arg,
+                       uchar *sort_buffer, uint threads)
+{
+  uchar *write_buffers;
+  ulong keys;
+  DBUG_ENTER("Sort_merger::init");
+
+  thd= thd_arg;
+  param= param_arg;
+  n_workers= MY_MIN(threads,
+                    param->max_keys_per_buffer / SORT_THREAD_MIN_KEYS);
+  if (n_workers < 2)
+  {
+    n_workers= 0;
+    DBUG_RETURN(FALSE);
+  }
+  write_buffer_size= MY_MAX(DISK_BUFFER_SIZE / param->rec_length, 1) *
+                     param->rec_length;
+  if (!my_multi_malloc_large(MYF(MY_THREAD_SPECIFIC),
+                             &workers,
+                             (ulonglong) sizeof(SORT_MERGE_WORKER) * n_workers,
+                             &write_buffers,
+                             (ulonglong) write_buffer_size * n_workers,
+                             NullS))
+  {
+    workers= NULL;
+    n_workers= 0;
+    DBUG_RETURN(FALSE);
+  }
+  bzero(workers, sizeof(SORT_MERGE_WORKER) * n_workers);
+
+  keys= param->max_keys_per_buffer / n_workers;
+  for (uint i= 0; i < n_workers; i++)
+  {
+    SORT_MERGE_WORKER *worker= workers + i;
+    worker->owner= this;
+    worker->buff= sort_buffer + (size_t) keys * param->rec_length * i;
+    worker->max_keys= keys;
+    worker->write_buffer= write_buffers + write_buffer_size * i;
+  }
+  DBUG_RETURN(TRUE);
+}
+
+
+/* Read the next keys of a run into its buffer, like read_to_buffer() */
+
+bool Sort_merger::read_run(BUFFPEK *run)
+{
+  uint count= (uint) MY_MIN(run->max_keys, run->count);
+  size_t length= (size_t) count * param->rec_length;
+
+  if (!count)
+  {
+    run->key= NULL;
+    return FALSE;
+  }
+  if (mysql_file_pread(from_file, run->base, length, run->file_pos,
+                       MYF(MY_NABP)))
+    return TRUE;
+  run->key= run->base;
+  run->file_pos+= length;
+  run->count-= count;
+  run->mem_count= count;
+  return FALSE;
+}
+
+
+/**
+  Find the first key of a run that does not go before the given key
+
+  @param run   The run, from_file
+  @param key   The key, param->sort_length bytes
+  @param buff  Buffer for a key
+  @param pos   IN: where to start the search, OUT: index of the key
+*/
+
+bool Sort_merger::lower_bound(BUFFPEK *run, const uchar *key, uchar *buff,
+                              ha_rows *pos)
+{
+  ha_rows low= *pos, high= run->count;
+  while (low < high)
+  {
+    ha_rows mid= low + (high - low) / 2;
+    if (mysql_file_pread(from_file, buff, param->sort_length,
+                         run->file_pos + mid * param->rec_length,
+                         MYF(MY_NABP)))
+      return TRUE;
+    if (memcmp(buff, key, param->sort_length) < 0)
+      low= mid + 1;
+    else
+      high= mid;
+  }
+  *pos= low;
+  return FALSE;
+}
+
+
+/* Merge the runs of a job, in a worker thread */
+
+bool Sort_merger::merge_job(SORT_MERGE_WORKER *worker, SORT_MERGE_JOB *job)
+{
+  uint rec_length= param->rec_length;
+  BUFFPEK *runs[MERGEBUFF2], *run;
+  Merge_loser_tree tree;
+  uchar *strpos= worker->buff;
+  uchar *write_pos= worker->write_buffer;
+  uchar *write_end= worker->write_buffer +
+                    write_buffer_size / wr_len * wr_len;
+  my_off_t file_pos= job->file_pos;
+  ulong maxcount;
+
+  if (!job->n_runs)
+    return FALSE;
+  maxcount= worker->max_keys / job->n_runs;
+  for (uint i= 0; i < job->n_runs; i++)
+  {
+    run= job->runs + i;
+    run->base= strpos;
+    run->max_keys= maxcount;
+    strpos+= maxcount * rec_length;
+    if (read_run(run))
+      return TRUE;
+    runs[i]= run;
+  }
+
+  tree.init(runs, job->n_runs, param->sort_length);
+  while ((run= tree.top()))
+  {
+    if (write_pos == write_end)
+    {
+      if (thd->killed ||
+          mysql_file_pwrite(to_file, worker->write_buffer,
+                            (size_t) (write_pos - worker->write_buffer),
+                            file_pos, MYF(MY_NABP)))
+        return TRUE;
+      file_pos+= write_pos - worker->write_buffer;
+      write_pos= worker->write_buffer;
+    }
+    memcpy(write_pos, run->key + wr_offset, wr_len);
+    write_pos+= wr_len;
+    run->key+= rec_length;
+    if (!--run->mem_count && read_run(run))
+      return TRUE;
+    tree.replay();
+  }
+  return (write_pos != worker->write_buffer &&
+          mysql_file_pwrite(to_file, worker->write_buffer,
+                            (size_t) (write_pos - worker->write_buffer),
+                            file_pos, MYF(MY_NABP)));
+}
+
+
+void Sort_merger::merge(SORT_MERGE_WORKER *worker)
+{
+  for (uint i= worker->first_job; i < n_jobs && !worker->error;
+       i+= n_workers)
+    worker->error= merge_job(worker, jobs + i);
+}
+
+
+/* Run the jobs on the worker threads and wait for them */
+
+bool Sort_merger::run_jobs()
+{
+  bool error= FALSE;
+  uint i;
+  DBUG_ENTER("Sort_merger::run_jobs");
+
+  for (i= 0; i < n_workers; i++)
+  {
+    SORT_MERGE_WORKER *worker= workers + i;
+    worker->first_job= i;
+    worker->error= FALSE;
+    worker->started= (i < n_jobs &&
+                      !mysql_thread_create(key_thread_filesort,
+                                           &worker->thread, NULL,
+                                           handle_sort_merge, worker));
+  }
+  for (i= 0; i < n_workers && i < n_jobs; i++)
+  {
+    SORT_MERGE_WORKER *worker= workers + i;
+    if (worker->started)
+    {
+      pthread_join(worker->thread, NULL);
+      worker->started= FALSE;
+    }
+    else
+      merge(worker);                            // Could not start a thread
+    error|= worker->error;
+  }
+  if (error && !thd->check_killed())
+    my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+  DBUG_RETURN(error);
+}
+
+
+/**
+  Merge buffers to make < MERGEBUFF2 buffers, like merge_many_buff(),
+  with the groups of a pass merged by different threads
+*/
+
+int Sort_merger::merge_many_buff(BUFFPEK *buffpek, uint *maxbuffer,
+                                 IO_CACHE *t_file)
+{
+  uint i;
+  IO_CACHE t_file2, *from, *to, *temp;
+  DBUG_ENTER("Sort_merger::merge_many_buff");
+
+  if (*maxbuffer < MERGEBUFF2)
+    DBUG_RETURN(0);
+  if (flush_io_cache(t_file) ||
+      open_cached_file(&t_file2, mysql_tmpdir, TEMP_PREFIX, DISK_BUFFER_SIZE,
+                       MYF(MY_WME)))
+    DBUG_RETURN(1);
+  if (!(jobs= (SORT_MERGE_JOB*) my_malloc(sizeof(SORT_MERGE_JOB) *
+                                          (*maxbuffer / MERGEBUFF + 1),
+                                          MYF(MY_WME | MY_THREAD_SPECIFIC))))
+  {
+    close_cached_file(&t_file2);
+    DBUG_RETURN(1);
+  }
+
+  wr_offset= 0;
+  wr_len= param->rec_length;
+  from= t_file; to= &t_file2;
+  while (*maxbuffer >= MERGEBUFF2)
+  {
+    my_off_t file_pos= 0;
+    if (to->file < 0 && real_open_cached_file(to))
+      goto cleanup;
+    n_jobs= 0;
+    for (i= 0; ; i+= MERGEBUFF)
+    {
+      SORT_MERGE_JOB *job= jobs + n_jobs++;
+      /* The last group takes the rest, as in merge_many_buff() */
+      bool last= i > *maxbuffer - MERGEBUFF*3/2;
+      job->n_runs= last ? *maxbuffer + 1 - i : MERGEBUFF;
+      job->runs= buffpek + i;
+      job->file_pos= file_pos;
+      job->count= 0;
+      for (uint j= 0; j < job->n_runs; j++)
+        job->count+= buffpek[i + j].count;
+      file_pos+= job->count * param->rec_length;
+      if (last)
+        break;
+    }
+    from_file= from->file;
+    to_file= to->file;
+    if (run_jobs())
+      goto cleanup;
+    for (i= 0; i < n_jobs; i++)
+    {
+      buffpek[i].file_pos= jobs[i].file_pos;
+      buffpek[i].count= jobs[i].count;
+      thd->inc_status_sort_merge_passes();
+      thd->query_plan_fsort_passes++;
+    }
+    /* Let the cache of the file continue after what the threads wrote */
+    if (reinit_io_cache(to, WRITE_CACHE, file_pos, 0, 1))
+      goto cleanup;
+    temp=from; from=to; to=temp;
+    *maxbuffer= n_jobs - 1;
+  }
+cleanup:
+  close_cached_file(to);                        // This holds old result
+  if (to == t_file)
+  {
+    *t_file=t_file2;                            // Copy result file
+  }
+  my_free(jobs);
+  jobs= NULL;
+
+  DBUG_RETURN(*maxbuffer >= MERGEBUFF2);        /* Return 1 if interrupted */
+}
+
+
+/**
+  Merge the runs into outfile, saving only positions, like merge_index(),
+  with a range of keys merged by every thread
+*/
+
+int Sort_merger::merge_index(BUFFPEK *buffpek, uint maxbuffer,
+                             IO_CACHE *tempfile, IO_CACHE *outfile)
+{
+  uint n_runs= maxbuffer + 1, n_samples= 0, i, w;
+  uint samples_per_run= n_workers * SORT_MERGE_SAMPLES;
+  size_t sort_length= param->sort_length;
+  uchar *sample_keys, **samples, *key_buff;
+  BUFFPEK *parts;
+  my_off_t file_pos= 0;
+  int error= 1;
+  DBUG_ENTER("Sort_merger::merge_index");
+
+  if (outfile->file < 0 && real_open_cached_file(outfile))
+    DBUG_RETURN(1);
+  if (!my_multi_malloc_large(MYF(MY_WME | MY_THREAD_SPECIFIC),
+                             &jobs,
+                             (ulonglong) sizeof(SORT_MERGE_JOB) * n_workers,
+                             &parts,
+                             (ulonglong) sizeof(BUFFPEK) * n_workers * n_runs,
+                             &samples,
+                             (ulonglong) sizeof(uchar*) * samples_per_run *
+                             n_runs,
+                             &sample_keys,
+                             (ulonglong) sort_length * samples_per_run *
+                             n_runs,
+                             &key_buff, (ulonglong) sort_length,
+                             NullS))
+    DBUG_RETURN(1);
+  from_file= tempfile->file;
+  to_file= outfile->file;
+
+  /* Sample keys at even distances in every run */
+  for (i= 0; i < n_runs; i++)
+  {
+    for (uint j= 0; j < samples_per_run && buffpek[i].count; j++)
+    {
+      ha_rows idx= buffpek[i].count * j / samples_per_run;
+      uchar *key= sample_keys + sort_length * n_samples;
+      if (mysql_file_pread(from_file, key, sort_length,
+                           buffpek[i].file_pos + idx * param->rec_length,
+                           MYF(MY_NABP)))
+      {
+        my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+        goto err;
+      }
+      samples[n_samples++]= key;
+    }
+  }
+  my_qsort2(samples, n_samples, sizeof(uchar*),
+            get_ptr_compare(sort_length), &sort_length);
+
+  /*
+    Part w of every run holds the keys from splitting key w - 1 up to
+    splitting key w
+  */
+  for (i= 0; i < n_runs; i++)
+  {
+    ha_rows start= 0, end;
+    for (w= 0; w < n_workers; w++)
+    {
+      BUFFPEK *part= parts + w * n_runs + i;
+      end= buffpek[i].count;
+      if (w < n_workers - 1 && n_samples)
+      {
+        end= start;
+        if (lower_bound(buffpek + i, samples[(w + 1) * n_samples / n_workers],
+                        key_buff, &end))
+        {
+          my_error(ER_TEMP_FILE_WRITE_FAILURE, MYF(0));
+          goto err;
+        }
+      }
+      bzero(part, sizeof(*part));
+      part->file_pos= buffpek[i].file_pos + start * param->rec_length;
+      part->count= end - start;
+      start= end;
+    }
+  }
+
+  /* The parts of a worker without keys are left out */
+  for (w= 0; w < n_workers; w++)
+  {
+    SORT_MERGE_JOB *job= jobs + w;
+    BUFFPEK *first= parts + w * n_runs;
+    job->runs= first;
+    job->n_runs= 0;
+    job->count= 0;
+    job->file_pos= file_pos;
+    for (i= 0; i < n_runs; i++)
+    {
+      if (first[i].count)
+      {
+        job->runs[job->n_runs++]= first[i];
+        job->count+= first[i].count;
+      }
+    }
+    file_pos+= job->count * param->res_length;
+  }
+  n_jobs= n_workers;
+  wr_offset= param->rec_length - param->res_length;
+  wr_len= param->res_length;
+  if (run_jobs())
+    goto err;
+  /* All parts count as one merge */
+  thd->inc_status_sort_merge_passes();
+  thd->query_plan_fsort_passes++;
+
+  /* Let the cache of outfile continue after what the threads wrote */
+  if (reinit_io_cache(outfile, WRITE_CACHE, file_pos, 0, 1))
+    goto err;
+  error= 0;
+
+err:
+  my_free(jobs);
+  jobs= NULL;
+  DBUG_RETURN(error);
+}
+
+
+void Sort_merger::end()
+{
+  my_free(workers);
+  workers= NULL;
+  n_workers= 0;
+}
+
+
 static uint suffix_length(ulong string_length)
 {
   if (string_length < 256)
@@ -18,6 +18,7 @@
 #include "sql_const.h"
 #include "sql_sort.h"
 #include "table.h"
+#include "myisampack.h"
 
 
 namespace {
@@ -157,19 +158,181 @@ void Filesort_buffer::free_sort_buffer()
 }
 
 
+/*
+  Radix sort of the keys of a buffer
+
+  The keys made by make_sortkey() compare with memcmp(), so they are sorted
+  by their bytes from the most significant one: the keys are distributed
+  into 256 buckets by their first byte, every bucket by the second byte,
+  and so on. The buckets are permuted in place (American flag sort), so no
+  memory is needed besides the array of keys and prefixes.
+
+  Every key is kept with its first 8 bytes in an integer, so that the
+  distribution does not have to access the key itself. Buckets with few
+  keys, and buckets of keys that still are equal after
+  SORT_RADIX_MAX_DEPTH bytes, are sorted by comparisons; those compare the
+  cached prefixes first and access the keys only when the prefixes are
+  equal.
+*/
+
+/* Buckets with fewer keys are sorted by comparisons */
+#define SORT_RADIX_MIN_BUCKET 32
+/* Number of bytes the keys are distributed by */
+#define SORT_RADIX_MAX_DEPTH 8
+
+namespace {
+
+/* The first 8 bytes of a key, most significant first, padded with 0 */
+inline ulonglong key_prefix(const uchar *key, size_t length)
+{
+  if (length >= 8)
+    return mi_uint8korr(key);
+  ulonglong prefix= 0;
+  for (size_t i= 0; i < 8; i++)
+    prefix= (prefix << 8) | (i < length ? key[i] : 0);
+  return prefix;
+}
+
+
+/* The part of the keys that follows the cached prefixes */
+struct Key_suffix
+{
+  size_t offset;
+  size_t length;
+};
+
+
+int cmp_key_prefix(const void *arg, const void *a, const void *b)
+{
+  const Key_suffix *suffix= (const Key_suffix *) arg;
+  const Sort_key_prefix *key_a= (const Sort_key_prefix *) a;
+  const Sort_key_prefix *key_b= (const Sort_key_prefix *) b;
+  if (key_a->prefix != key_b->prefix)
+    return key_a->prefix < key_b->prefix ? -1 : 1;
+  if (!suffix->length)
+    return 0;
+  return memcmp(key_a->key + suffix->offset, key_b->key + suffix->offset,
+                suffix->length);
+}
+
+
+/**
+  Sort keys that are equal in their first depth bytes by comparisons
+*/
+
+void compare_sort(Sort_key_prefix *keys, uint count, size_t key_length,
+                  size_t depth)
+{
+  Key_suffix suffix;
+  size_t start= 0;
+
+  if (depth >= 8)
+  {
+    /* Cache the bytes that follow the equal ones */
+    start= depth;
+    for (uint i= 0; i < count; i++)
+      keys[i].prefix= key_prefix(keys[i].key + start, key_length - start);
+  }
+  suffix.offset= MY_MIN(start + 8, key_length);
+  suffix.length= key_length - suffix.offset;
+  my_qsort2(keys, count, sizeof(Sort_key_prefix), cmp_key_prefix, &suffix);
+}
+
+
+/**
+  Sort keys that are equal in their first depth bytes by the following
+  bytes
+*/
+
+void radix_sort(Sort_key_prefix *keys, uint count, size_t key_length,
+                size_t depth)
+{
+  uint bucket_count[256], bucket_start[257];
+
+  for (;;)
+  {
+    if (depth == key_length)
+      return;                                   // All keys are equal
+    if (count < SORT_RADIX_MIN_BUCKET || depth == SORT_RADIX_MAX_DEPTH)
+    {
+      compare_sort(keys, count, key_length, depth);
+      return;
+    }
+
+    uint shift= (uint) (56 - 8 * depth);
+    bzero(bucket_count, sizeof(bucket_count));
+    for (uint i= 0; i < count; i++)
+      bucket_count[(keys[i].prefix >> shift) & 0xff]++;
+    if (bucket_count[(keys[0].prefix >> shift) & 0xff] != count)
+      break;
+    depth++;                                    // All in one bucket
+  }
+
+  uint shift= (uint) (56 - 8 * depth);
+  bucket_start[0]= 0;
+  for (uint b= 0; b < 256; b++)
+    bucket_start[b + 1]= bucket_start[b] + bucket_count[b];
+
+  /*
+    Move every key to the next free place of its bucket. bucket_count
+    becomes the next free place.
+  */
+  memcpy(bucket_count, bucket_start, sizeof(bucket_count));
+  for (uint b= 0; b < 256; b++)
+  {
+    while (bucket_count[b] < bucket_start[b + 1])
+    {
+      Sort_key_prefix key= keys[bucket_count[b]];
+      uint key_bucket;
+      while ((key_bucket= (uint) ((key.prefix >> shift) & 0xff)) != b)
+      {
+        uint pos= bucket_count[key_bucket]++;
+        swap_variables(Sort_key_prefix, key, keys[pos]);
+      }
+      keys[bucket_count[b]++]= key;
+    }
+  }
+
+  for (uint b= 0; b < 256; b++)
+  {
+    uint n= bucket_start[b + 1] - bucket_start[b];
+    if (n > 1)
+      radix_sort(keys + bucket_start[b], n, key_length, depth + 1);
+  }
+}
+
+} // namespace
+
+
 void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
+{
+  Sort_key_prefix *buffer= NULL;
+  /* If the allocation fails, sort_keys() falls back to comparisons */
+  if (count >= SORT_RADIX_MIN_KEYS && count <= SORT_RADIX_MAX_KEYS &&
+      param->sort_length)
+    buffer= (Sort_key_prefix*) my_malloc(count * sizeof(Sort_key_prefix),
+                                         MYF(MY_THREAD_SPECIFIC));
+  sort_keys(param, get_sort_keys(), count, buffer);
+  my_free(buffer);
+}
+
+
+void Filesort_buffer::sort_keys(const Sort_param *param, uchar **keys,
+                                uint count, Sort_key_prefix *buffer)
 {
   size_t size= param->sort_length;
   if (count <= 1 || size == 0)
     return;
-  uchar **keys= get_sort_keys();
-  uchar **buffer= NULL;
-  if (radixsort_is_appliccable(count, param->sort_length) &&
-      (buffer= (uchar**) my_malloc(count*sizeof(char*),
-                                   MYF(MY_THREAD_SPECIFIC))))
+  if (buffer && count >= SORT_RADIX_MIN_KEYS)
   {
-    radixsort_for_str_ptr(keys, count, param->sort_length, buffer);
-    my_free(buffer);
+    for (uint i= 0; i < count; i++)
+    {
+      buffer[i].prefix= key_prefix(keys[i], size);
+      buffer[i].key= keys[i];
+    }
+    radix_sort(buffer, count, size, 0);
+    for (uint i= 0; i < count; i++)
+      keys[i]= buffer[i].key;
     return;
   }
   
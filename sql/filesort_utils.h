@@ -20,6 +20,25 @@
 #include "sql_array.h"
 
 class Sort_param;
+
+/* Number of keys from which Filesort_buffer::sort_keys() uses radix sort */
+#define SORT_RADIX_MIN_KEYS 256
+/*
+  Maximum number of keys for which a radix sort buffer is allocated. The
+  buffer is not part of sort_buffer_size; larger sorts compare the keys.
+*/
+#define SORT_RADIX_MAX_KEYS 100000
+
+/**
+  A key to sort and the first bytes of it, most significant byte first,
+  which are compared as an integer before the key itself is accessed.
+*/
+struct Sort_key_prefix
+{
+  ulonglong prefix;
+  uchar *key;
+};
+
 /*
   Calculate cost of merge sort
 
@@ -80,6 +99,15 @@ class Filesort_buffer
   /** Sort me... */
   void sort_buffer(const Sort_param *param, uint count);
 
+  /**
+    Sort an array of key pointers. buffer, if not NULL, has room for count
+    keys and allows radix sort; without it, the keys are compared. Does not
+    allocate memory, so that it can be called by threads other than the one
+    of the statement.
+  */
+  static void sort_keys(const Sort_param *param, uchar **keys, uint count,
+                        Sort_key_prefix *buffer);
+
   /// Initializes a record pointer.
   uchar *get_record_buffer(uint idx)
   {
@@ -3888,6 +3888,38 @@ class handler :public Sql_alloc
    return memcmp(ref1, ref2, ref_length);
  }
 
+ /**
+   Check if clones of this handler may read the table concurrently in
+   other threads during the current statement.
+
+   The clones are created with clone(), locked with ha_external_lock(),
+   prepared with start_parallel_scan() and positioned by the thread of the
+   statement. Only index_next() is then called in other threads, one thread
+   per clone. This is used by the parallel scans of sql_parallel.cc.
+
+   @retval TRUE   yes
+   @retval FALSE  no
+ */
+ virtual bool parallel_scan_supported() { return FALSE; }
+
+ /**
+   Prepare a locked clone for reading in another thread.
+
+   The engine must make the reads of the clone independent of any state
+   that the statement or the other clones may change concurrently, such as
+   its transaction. Called before ha_index_init().
+
+   @retval 0      ok
+   @retval other  error code; the clone cannot be used
+ */
+ virtual int start_parallel_scan() { return 0; }
+
+ /**
+   Undo start_parallel_scan() before the clone is unlocked with
+   ha_external_lock(). Called in the thread of the statement.
+ */
+ virtual void end_parallel_scan() {}
+
  /*
    Condition pushdown to storage engines
  */
@@ -4486,6 +4518,7 @@ class handler :public Sql_alloc
   }
   friend class ha_partition;
   friend class ha_sequence;
+  friend class JOIN_TAB_PARALLEL;
 public:
   /**
     This method is similar to update_row, however the handler doesn't need
@@ -3284,6 +3284,17 @@ bool Item_field::switch_to_nullable_fields_processor(void *arg)
   return 0;
 }
 
+bool Item_field::switch_to_table_fields_processor(void *arg)
+{
+  switch_to_table_fields_processor_data *data=
+    (switch_to_table_fields_processor_data *) arg;
+  if (field && field->table == data->from)
+    field= data->to->field[field->field_index];
+  if (result_field && result_field->table == data->from)
+    result_field= data->to->field[result_field->field_index];
+  return 0;
+}
+
 const char *Item_ident::full_name() const
 {
   char *tmp;
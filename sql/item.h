@@ -577,6 +577,16 @@ struct find_selective_predicates_list_processor_data
   List<st_cond_statistic> list;
 };
 
+/*
+  Argument of switch_to_table_fields_processor(): the references to the
+  fields of 'from' are changed to the fields of 'to' with the same index
+*/
+struct switch_to_table_fields_processor_data
+{
+  TABLE *from;
+  TABLE *to;
+};
+
 class MY_LOCALE;
 
 class Item_equal;
@@ -1645,6 +1655,7 @@ class Item: public Value_source,
   virtual bool excl_dep_on_grouping_fields(st_select_lex *sel) { return false; }
 
   virtual bool switch_to_nullable_fields_processor(void *arg) { return 0; }
+  virtual bool switch_to_table_fields_processor(void *arg) { return 0; }
   virtual bool find_function_processor (void *arg) { return 0; }
   /*
     Check if a partition function is allowed
@@ -2962,6 +2973,7 @@ class Item_field :public Item_ident
   bool enumerate_field_refs_processor(void *arg);
   bool update_table_bitmaps_processor(void *arg);
   bool switch_to_nullable_fields_processor(void *arg);
+  bool switch_to_table_fields_processor(void *arg);
   bool update_vcol_processor(void *arg);
   bool rename_fields_processor(void *arg);
   bool check_vcol_func_processor(void *arg)
@@ -880,6 +880,9 @@ class Item_func_opt_neg :public Item_bool_func
   }
   bool eq(const Item *item, bool binary_cmp) const;
   CHARSET_INFO *compare_collation() const { return cmp_collation.collation; }
+  /* The data type handler used to compare the arguments */
+  const Type_handler *comparator_type_handler() const
+  { return m_comparator.type_handler(); }
   Item* propagate_equal_fields(THD *, const Context &, COND_EQUAL *) = 0;
 };
 
@@ -68,8 +68,18 @@ void Filesort_tracker::print_json_members(Json_writer *writer)
   {
     writer->add_member("r_sort_passes").add_ll((longlong) rint(sort_passes /
                                                                get_r_loops()));
+    if (time_tracker.timed)
+    {
+      writer->add_member("r_read_time_ms").
+              add_double(read_time_tracker.get_time_ms());
+      writer->add_member("r_merge_time_ms").
+              add_double(merge_time_tracker.get_time_ms());
+    }
   }
 
+  if (sort_threads > 1)
+    writer->add_member("r_sort_threads").add_ll(sort_threads);
+
   if (sort_buffer_size != 0)
   {
     writer->add_member("r_buffer_size");
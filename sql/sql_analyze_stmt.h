@@ -131,12 +131,14 @@ class Table_access_tracker
 public:
   Table_access_tracker() :
     r_scans(0), r_rows(0), /*r_rows_after_table_cond(0),*/
-    r_rows_after_where(0)
+    r_rows_after_where(0), r_batches(0), r_workers(0)
   {}
 
   ha_rows r_scans; /* How many scans were ran on this join_tab */
   ha_rows r_rows; /* How many rows we've got after that */
   ha_rows r_rows_after_where; /* Rows after applying attached part of WHERE */
+  ha_rows r_batches; /* Record batches filled by batched execution */
+  ha_rows r_workers; /* Threads started by parallel scans */
 
   bool has_scans() { return (r_scans != 0); }
   ha_rows get_loops() { return r_scans; }
@@ -181,7 +183,7 @@ class Filesort_tracker : public Sql_alloc
     time_tracker(do_timing), r_limit(0), r_used_pq(0),
     r_examined_rows(0), r_sorted_rows(0), r_output_rows(0),
     sort_passes(0),
-    sort_buffer_size(0)
+    sort_buffer_size(0), sort_threads(0)
   {}
   
   /* Functions that filesort uses to report various things about its execution */
@@ -216,6 +218,33 @@ class Filesort_tracker : public Sql_alloc
     sort_passes += passes;
   }
 
+  /* Phases of a sort that does not fit into the sort buffer */
+  inline void report_read_start()
+  {
+    if (unlikely(time_tracker.timed))
+      read_time_tracker.start_tracking();
+  }
+  inline void report_read_end()
+  {
+    if (unlikely(time_tracker.timed))
+      read_time_tracker.stop_tracking();
+  }
+  inline void report_merge_start()
+  {
+    if (unlikely(time_tracker.timed))
+      merge_time_tracker.start_tracking();
+  }
+  inline void report_merge_end()
+  {
+    if (unlikely(time_tracker.timed))
+      merge_time_tracker.stop_tracking();
+  }
+
+  inline void report_sort_threads(uint threads)
+  {
+    set_if_bigger(sort_threads, threads);
+  }
+
   inline void report_sort_buffer_size(size_t bufsize)
   {
     if (sort_buffer_size)
@@ -246,6 +275,13 @@ class Filesort_tracker : public Sql_alloc
 private:
   Time_and_counter_tracker time_tracker;
 
+  /*
+    Time spent reading the records and writing the sorted runs, and time
+    spent merging the runs, in ANALYZE
+  */
+  Exec_time_tracker read_time_tracker;
+  Exec_time_tracker merge_time_tracker;
+
   //ulonglong r_loops; /* How many times filesort was invoked */
   /*
     LIMIT is typically a constant. There is never "LIMIT 0".
@@ -282,5 +318,8 @@ class Filesort_tracker : public Sql_alloc
     other          - value
   */
   ulonglong sort_buffer_size;
+
+  /* Largest number of threads a sort used, 0 or 1 if it was not parallel */
+  uint sort_threads;
 };
 
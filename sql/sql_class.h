@@ -583,12 +583,15 @@ typedef struct system_variables
   ulong auto_increment_increment, auto_increment_offset;
   ulong column_compression_zlib_strategy;
   ulong lock_wait_timeout;
+  ulong join_batch_size;
   ulong join_cache_level;
   ulong max_allowed_packet;
   ulong max_error_count;
   ulong max_length_for_sort_data;
+  ulong max_parallel_degree;
   ulong max_recursive_iterations;
   ulong max_sort_length;
+  ulong max_sort_threads;
   ulong max_tmp_tables;
   ulong max_insert_delayed_threads;
   ulong min_examined_row_limit;
@@ -812,6 +815,7 @@ typedef struct system_status_var
   ulong filesort_rows_;
   ulong filesort_scan_count_;
   ulong filesort_pq_sorts_;
+  ulong join_cache_spilled_parts_;
 
   /* Features used */
   ulong feature_dynamic_columns;    /* +1 when creating a dynamic column */
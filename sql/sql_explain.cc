@@ -1528,6 +1528,21 @@ void Explain_table_access::tag_to_json(Json_writer *writer, enum explain_extra_t
     case ET_NOT_EXISTS:
       writer->add_member("not_exists").add_bool(true);
       break;
+    case ET_USING_BATCHED_EXECUTION:
+      writer->add_member("batched_execution").start_object();
+      writer->add_member("batch_rows").add_ll(batch_rows);
+      writer->add_member("batched_conditions").add_ll(batch_conditions);
+      if (tracker.has_scans())
+        writer->add_member("r_batches").add_ll(tracker.r_batches);
+      writer->end_object();
+      break;
+    case ET_USING_PARALLEL_AGGREGATION:
+      writer->add_member("parallel_aggregation").start_object();
+      writer->add_member("max_degree").add_ll(parallel_degree);
+      if (tracker.has_scans())
+        writer->add_member("r_workers").add_ll(tracker.r_workers);
+      writer->end_object();
+      break;
     case ET_DISTINCT:
       writer->add_member("distinct").add_bool(true);
       break;
@@ -1822,6 +1837,9 @@ const char * extra_tag_text[]=
   "Const row not found",
   "Unique row not found",
   "Impossible ON condition",
+
+  "Using batched execution",
+  "Using parallel aggregation",
 };
 
 
@@ -546,6 +546,9 @@ enum explain_extra_tag
   ET_UNIQUE_ROW_NOT_FOUND,
   ET_IMPOSSIBLE_ON_CONDITION,
 
+  ET_USING_BATCHED_EXECUTION,
+  ET_USING_PARALLEL_AGGREGATION,
+
   ET_total
 };
 
@@ -689,7 +692,10 @@ class Explain_table_access : public Sql_alloc
     cache_cond(NULL),
     pushed_index_cond(NULL),
     sjm_nest(NULL),
-    pre_join_sort(NULL)
+    pre_join_sort(NULL),
+    batch_rows(0),
+    batch_conditions(0),
+    parallel_degree(0)
   {}
   ~Explain_table_access() { delete sjm_nest; }
 
@@ -789,6 +795,13 @@ class Explain_table_access : public Sql_alloc
   */
   Explain_aggr_filesort *pre_join_sort;
 
+  /* Valid with ET_USING_BATCHED_EXECUTION */
+  uint batch_rows;
+  uint batch_conditions;
+
+  /* Valid with ET_USING_PARALLEL_AGGREGATION */
+  uint parallel_degree;
+
   /* ANALYZE members */
 
   /* Tracker for reading the table */
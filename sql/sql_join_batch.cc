@@ -0,0 +1,868 @@
+/*
+   Copyright (c) 2018, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/**
+  @file
+
+  @brief
+  Batched evaluation of the conditions attached to scanned tables
+
+  @defgroup Batched_execution Batched execution of table scans
+  @{
+*/
+
+#include "mariadb.h"
+#include "sql_select.h"
+
+
+/*
+  Decoders of integer columns stored in the record image.
+  They must return what Field_xxx::val_int() returns.
+*/
+
+static longlong batch_decode_tiny(const uchar *ptr)
+{ return (longlong) ((signed char*) ptr)[0]; }
+
+static longlong batch_decode_utiny(const uchar *ptr)
+{ return (longlong) ptr[0]; }
+
+static longlong batch_decode_short(const uchar *ptr)
+{ return (longlong) (short) sint2korr(ptr); }
+
+static longlong batch_decode_ushort(const uchar *ptr)
+{ return (longlong) (unsigned short) sint2korr(ptr); }
+
+static longlong batch_decode_medium(const uchar *ptr)
+{ return (longlong) sint3korr(ptr); }
+
+static longlong batch_decode_umedium(const uchar *ptr)
+{ return (longlong) uint3korr(ptr); }
+
+static longlong batch_decode_long(const uchar *ptr)
+{ return (longlong) sint4korr(ptr); }
+
+static longlong batch_decode_ulong(const uchar *ptr)
+{ return (longlong) uint4korr(ptr); }
+
+static longlong batch_decode_longlong(const uchar *ptr)
+{ return sint8korr(ptr); }
+
+
+/*
+  Map the binary image of a DECIMAL value that is at most 8 bytes long
+  to a longlong with the same ordering.
+
+  The binary image is memcmp-comparable (see Field_new_decimal::cmp()),
+  so reading it as a big-endian unsigned number and flipping the sign bit
+  preserves the order of the values.
+*/
+
+static inline longlong batch_decimal_key(const uchar *ptr, uint length)
+{
+  ulonglong key= 0;
+  for (uint i= 0; i < length; i++)
+    key= (key << 8) | ptr[i];
+  key<<= 8 * (8 - length);
+  return (longlong) (key ^ 0x8000000000000000ULL);
+}
+
+
+/*
+  Extract the values of an integer column for the selected records
+*/
+
+template <longlong (*decode)(const uchar *)>
+static void batch_extract_int(BATCH_COLUMN *column, const uchar *buff,
+                              size_t rec_length, const uint *sel, uint n_sel)
+{
+  longlong *values= column->values;
+  uchar *nulls= column->nulls;
+  const uint offset= column->offset;
+  const uint null_offset= column->null_offset;
+  const uchar null_bit= column->null_bit;
+
+  for (uint k= 0; k < n_sel; k++)
+  {
+    uint i= sel[k];
+    const uchar *rec= buff + i * rec_length;
+    values[i]= decode(rec + offset);
+    nulls[i]= rec[null_offset] & null_bit;
+  }
+}
+
+
+/*
+  Compress the selection vector to the records whose value satisfies cmp.
+  The loop does not branch on the outcome of the comparison.
+*/
+
+template <class Cmp>
+static uint batch_select(const BATCH_COLUMN *column, uint *sel, uint n_sel,
+                         const Cmp &cmp)
+{
+  const longlong *values= column->values;
+  const uchar *nulls= column->nulls;
+  uint n= 0;
+
+  for (uint k= 0; k < n_sel; k++)
+  {
+    uint i= sel[k];
+    sel[n]= i;
+    n+= (uint) (!nulls[i] & cmp(values[i]));
+  }
+  return n;
+}
+
+
+struct batch_cmp_eq
+{
+  longlong c;
+  bool operator()(longlong v) const { return v == c; }
+};
+
+struct batch_cmp_ne
+{
+  longlong c;
+  bool operator()(longlong v) const { return v != c; }
+};
+
+struct batch_cmp_lt
+{
+  longlong c;
+  bool operator()(longlong v) const { return v < c; }
+};
+
+struct batch_cmp_le
+{
+  longlong c;
+  bool operator()(longlong v) const { return v <= c; }
+};
+
+struct batch_cmp_gt
+{
+  longlong c;
+  bool operator()(longlong v) const { return v > c; }
+};
+
+struct batch_cmp_ge
+{
+  longlong c;
+  bool operator()(longlong v) const { return v >= c; }
+};
+
+struct batch_cmp_between
+{
+  longlong lo, hi;
+  bool operator()(longlong v) const { return (v >= lo) & (v <= hi); }
+};
+
+struct batch_cmp_not_between
+{
+  longlong lo, hi;
+  bool operator()(longlong v) const { return (v < lo) | (v > hi); }
+};
+
+struct batch_cmp_in
+{
+  const longlong *list;
+  uint length;
+  bool operator()(longlong v) const
+  {
+    uint lo= 0, hi= length;
+    while (lo < hi)
+    {
+      uint mid= (lo + hi) / 2;
+      if (list[mid] < v)
+        lo= mid + 1;
+      else
+        hi= mid;
+    }
+    return lo < length && list[lo] == v;
+  }
+};
+
+struct batch_cmp_not_in
+{
+  batch_cmp_in in;
+  bool operator()(longlong v) const { return !in(v); }
+};
+
+
+static int batch_cmp_longlong(const void *a, const void *b)
+{
+  longlong x= *(const longlong*) a, y= *(const longlong*) b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+
+/**
+  @brief
+  Create the batched execution descriptor of a join table
+
+  @param tab  The join table
+
+  @details
+  The function checks whether the records of tab can be read in batches
+  and collects the conjuncts of the condition attached to tab that can be
+  evaluated over a batch. Batching is not used for tables whose current
+  record must be accompanied by the handler state (locking reads, rowids
+  for duplicate elimination or join buffers, loose scan), for inner tables
+  of outer joins and semi-joins, for tables read through a join buffer and
+  for tables with blob columns that are read: the values of those live in
+  handler-owned memory that the next read may reuse.
+
+  @return
+    The descriptor, or NULL if batching is not used for the table
+*/
+
+JOIN_TAB_BATCH *JOIN_TAB_BATCH::create(JOIN_TAB *tab)
+{
+  JOIN *join= tab->join;
+  THD *thd= join->thd;
+  TABLE *table= tab->table;
+  Item *cond= tab->select_cond;
+  ulonglong rows= thd->variables.join_batch_size;
+  DBUG_ENTER("JOIN_TAB_BATCH::create");
+
+  if (!rows || !cond)
+    DBUG_RETURN(NULL);
+
+  if (tab->type != JT_ALL && tab->type != JT_NEXT &&
+      tab->type != JT_RANGE && tab->type != JT_INDEX_MERGE)
+    DBUG_RETURN(NULL);
+
+  if (tab->cache || tab->use_quick == 2 ||
+      tab->last_inner || tab->first_inner || tab->emb_sj_nest ||
+      tab->bush_root_tab || tab->bush_children ||
+      tab->loosescan_match_tab || tab->flush_weedout_table ||
+      tab->check_weed_out_table || tab->do_firstmatch ||
+      tab->keep_current_rowid || tab->is_using_loose_index_scan())
+    DBUG_RETURN(NULL);
+
+  if (table->reginfo.lock_type >= TL_READ_WITH_SHARED_LOCKS)
+    DBUG_RETURN(NULL);
+
+  for (uint i= 0; i < table->s->blob_fields; i++)
+  {
+    if (bitmap_is_set(table->read_set, table->s->blob_field[i]))
+      DBUG_RETURN(NULL);
+  }
+
+  set_if_smaller(rows, thd->variables.join_buff_size / table->s->reclength);
+  if (rows < 2)
+    DBUG_RETURN(NULL);
+
+  List<Item> single;
+  List<Item> *conjuncts= &single;
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+    conjuncts= ((Item_cond*) cond)->argument_list();
+  else if (single.push_back(cond, thd->mem_root))
+    DBUG_RETURN(NULL);
+
+  JOIN_TAB_BATCH *batch= new (thd->mem_root)
+    JOIN_TAB_BATCH(thd, table, cond, (uint) rows);
+  if (!batch ||
+      !(batch->predicates= (BATCH_PREDICATE*)
+        thd->calloc(sizeof(BATCH_PREDICATE) * conjuncts->elements)) ||
+      !(batch->columns= (BATCH_COLUMN*)
+        thd->calloc(sizeof(BATCH_COLUMN) * conjuncts->elements)))
+    DBUG_RETURN(NULL);
+
+  List_iterator_fast<Item> li(*conjuncts);
+  Item *item;
+  while ((item= li++))
+  {
+    if (batch->add_predicate(item))
+      DBUG_RETURN(NULL);
+  }
+
+  if (!batch->n_predicates)
+    DBUG_RETURN(NULL);
+
+  /* EXPLAIN does not read anything */
+  if (!(join->select_options & SELECT_DESCRIBE) && batch->alloc_buffers())
+    DBUG_RETURN(NULL);
+
+  DBUG_PRINT("info", ("table: %s  batch rows: %u  predicates: %u",
+                      table->alias.c_ptr(), batch->max_rows,
+                      batch->n_predicates));
+  DBUG_RETURN(batch);
+}
+
+
+/*
+  Check whether an operand keeps its value during a scan of the table
+*/
+
+static bool batch_scan_const(TABLE *table, Item *item)
+{
+  return !(item->used_tables() & (table->map | RAND_TABLE_BIT)) &&
+         item->cmp_type() != ROW_RESULT &&
+         !item->is_expensive();
+}
+
+
+/**
+  @brief
+  Add a conjunct of the attached condition to the batch predicates
+
+  @param item  The conjunct
+
+  @details
+  A conjunct that is not simple (see sql_join_batch.h) is skipped: it is
+  only checked by evaluate_join_record().
+
+  @retval FALSE  ok
+  @retval TRUE   out of memory
+*/
+
+bool JOIN_TAB_BATCH::add_predicate(Item *item)
+{
+  if (item->type() != Item::FUNC_ITEM)
+    return FALSE;
+
+  Item_func *func= (Item_func*) item;
+  Item **args= func->arguments();
+  const Type_handler *handler;
+  enum batch_predicate_op op;
+  bool negated= FALSE;
+  uint field_arg= 0;
+
+  switch (func->functype()) {
+  case Item_func::EQ_FUNC:
+  case Item_func::NE_FUNC:
+  case Item_func::LT_FUNC:
+  case Item_func::LE_FUNC:
+  case Item_func::GT_FUNC:
+  case Item_func::GE_FUNC:
+  {
+    static const enum batch_predicate_op ops[][2]=
+    {
+      { BATCH_EQ, BATCH_EQ }, { BATCH_NE, BATCH_NE },
+      { BATCH_LT, BATCH_GT }, { BATCH_LE, BATCH_GE },
+      { BATCH_GT, BATCH_LT }, { BATCH_GE, BATCH_LE }
+    };
+    uint n;
+    switch (func->functype()) {
+    case Item_func::EQ_FUNC: n= 0; break;
+    case Item_func::NE_FUNC: n= 1; break;
+    case Item_func::LT_FUNC: n= 2; break;
+    case Item_func::LE_FUNC: n= 3; break;
+    case Item_func::GT_FUNC: n= 4; break;
+    default:                 n= 5; break;
+    }
+    /* const <op> column is turned into column <reverse op> const */
+    if (batch_scan_const(table, args[0]))
+      field_arg= 1;
+    op= ops[n][field_arg];
+    handler= ((Item_bool_rowready_func2*) func)->compare_type_handler();
+    break;
+  }
+  case Item_func::BETWEEN:
+    op= BATCH_BETWEEN;
+    negated= ((Item_func_between*) func)->negated;
+    handler= ((Item_func_between*) func)->comparator_type_handler();
+    break;
+  case Item_func::IN_FUNC:
+    if (!((Item_func_in*) func)->arg_types_compatible)
+      return FALSE;
+    op= BATCH_IN;
+    negated= ((Item_func_in*) func)->negated;
+    handler= ((Item_func_in*) func)->comparator_type_handler();
+    break;
+  default:
+    return FALSE;
+  }
+
+  Item *field_item= args[field_arg];
+  Item *real= field_item->real_item();
+  if (real->type() != Item::FIELD_ITEM)
+    return FALSE;
+  Field *field= ((Item_field*) real)->field;
+  if (field->table != table)
+    return FALSE;
+
+  for (uint i= 0; i < func->argument_count(); i++)
+  {
+    if (i != field_arg && !batch_scan_const(table, args[i]))
+      return FALSE;
+  }
+
+  enum batch_column_type type;
+  switch (handler->cmp_type()) {
+  case INT_RESULT:
+    if (field->cmp_type() != INT_RESULT ||
+        field->real_type() == MYSQL_TYPE_BIT ||
+        (field->real_type() == MYSQL_TYPE_LONGLONG &&
+         (field->flags & UNSIGNED_FLAG)))
+      return FALSE;
+    type= BATCH_COLUMN_INT;
+    break;
+  case TIME_RESULT:
+    if (field->cmp_type() != TIME_RESULT)
+      return FALSE;
+    type= handler->field_type() == MYSQL_TYPE_TIME ?
+          BATCH_COLUMN_TIME : BATCH_COLUMN_DATETIME;
+    break;
+  case DECIMAL_RESULT:
+    if (field->real_type() != MYSQL_TYPE_NEWDECIMAL ||
+        field->pack_length() > 8)
+      return FALSE;
+    type= BATCH_COLUMN_DECIMAL;
+    break;
+  default:
+    return FALSE;
+  }
+
+  BATCH_PREDICATE *pred= predicates + n_predicates;
+  if (!(pred->column= get_column(field_item, field, type)))
+    return TRUE;
+  pred->op= op;
+  pred->negated= negated;
+  pred->n_consts= func->argument_count() - 1;
+  pred->consts= field_arg ? args : args + 1;
+  if (op == BATCH_IN &&
+      !(pred->list= (longlong*) thd->alloc(sizeof(longlong) *
+                                           pred->n_consts)))
+    return TRUE;
+  n_predicates++;
+  return FALSE;
+}
+
+
+/*
+  Find or create the batch column for a field of the table
+*/
+
+BATCH_COLUMN *JOIN_TAB_BATCH::get_column(Item *item, Field *field,
+                                         enum batch_column_type type)
+{
+  for (uint i= 0; i < n_columns; i++)
+  {
+    if (columns[i].field == field && columns[i].type == type)
+      return columns + i;
+  }
+
+  BATCH_COLUMN *column= columns + n_columns++;
+  column->field= field;
+  column->item= item;
+  column->type= type;
+  column->offset= field->offset(table->record[0]);
+  if (field->null_ptr)
+  {
+    column->null_offset= (uint) (field->null_ptr - table->record[0]);
+    column->null_bit= field->null_bit;
+  }
+  column->bin_length= field->pack_length();
+  switch (type) {
+  case BATCH_COLUMN_INT:
+    switch (field->real_type()) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+      column->raw= TRUE;
+      break;
+    default:
+      break;
+    }
+    break;
+  case BATCH_COLUMN_DECIMAL:
+    column->raw= TRUE;
+    break;
+  default:
+    break;
+  }
+  return column;
+}
+
+
+bool JOIN_TAB_BATCH::alloc_buffers()
+{
+  if (!(buff= (uchar*) thd->alloc((size_t) max_rows * rec_length)) ||
+      !(sel= (uint*) thd->alloc(sizeof(uint) * max_rows)))
+    return TRUE;
+  for (uint i= 0; i < n_columns; i++)
+  {
+    BATCH_COLUMN *column= columns + i;
+    if (!(column->values= (longlong*) thd->alloc(sizeof(longlong) *
+                                                 max_rows)) ||
+        !(column->nulls= (uchar*) thd->alloc(max_rows)))
+      return TRUE;
+  }
+  return FALSE;
+}
+
+
+/**
+  @brief
+  Prepare the batch for a scan of the table
+
+  @param tab  The join table that is going to be scanned
+
+  @details
+  The operands of the predicates that do not depend on the table are
+  evaluated here, once per scan.
+
+  @retval TRUE   the records of the scan are to be read in batches
+  @retval FALSE  the scan must be executed record by record
+*/
+
+bool JOIN_TAB_BATCH::start_scan(JOIN_TAB *tab)
+{
+  /* The attached condition might have been replaced after optimization */
+  if (!buff || tab->select_cond != cond)
+    return FALSE;
+
+  for (uint i= 0; i < n_predicates; i++)
+  {
+    if (eval_consts(predicates + i))
+      return FALSE;
+  }
+  return !thd->is_error();
+}
+
+
+/*
+  Evaluate an operand of a predicate in the domain of its column.
+
+  @retval FALSE  ok, *value and *is_null are set
+  @retval TRUE   the value cannot be represented exactly in the domain
+*/
+
+bool JOIN_TAB_BATCH::eval_const(BATCH_COLUMN *column, Item *item,
+                                longlong *value, bool *is_null)
+{
+  longlong v;
+
+  switch (column->type) {
+  case BATCH_COLUMN_INT:
+    v= item->val_int();
+    if ((*is_null= item->null_value))
+      return FALSE;
+    /* Comparisons of unsigned values above LONGLONG_MAX are left alone */
+    if (item->unsigned_flag && v < 0)
+      return TRUE;
+    break;
+  case BATCH_COLUMN_DATETIME:
+    v= item->val_datetime_packed();
+    if ((*is_null= item->null_value))
+      return FALSE;
+    break;
+  case BATCH_COLUMN_TIME:
+    v= item->val_time_packed();
+    if ((*is_null= item->null_value))
+      return FALSE;
+    break;
+  case BATCH_COLUMN_DECIMAL:
+  {
+    Field_new_decimal *field= (Field_new_decimal*) column->field;
+    my_decimal buf, check, *dec= item->val_decimal(&buf);
+    uchar bin[8];
+    if ((*is_null= item->null_value))
+      return FALSE;
+    /* The value must have an exact image in the precision of the column */
+    if (my_decimal2binary(0, dec, bin, field->precision, field->dec) ||
+        binary2my_decimal(0, bin, &check, field->precision, field->dec) ||
+        my_decimal_cmp(dec, &check))
+      return TRUE;
+    v= batch_decimal_key(bin, column->bin_length);
+    break;
+  }
+  default:
+    DBUG_ASSERT(0);
+    return TRUE;
+  }
+  *value= v;
+  return FALSE;
+}
+
+
+/*
+  Evaluate the scan constant operands of a predicate and choose how the
+  predicate is applied during the scan.
+
+  @retval FALSE  ok
+  @retval TRUE   an error occurred
+*/
+
+bool JOIN_TAB_BATCH::eval_consts(BATCH_PREDICATE *pred)
+{
+  BATCH_COLUMN *column= pred->column;
+  bool is_null, lo_null, hi_null;
+
+  pred->state= BATCH_PREDICATE::FILTER;
+
+  switch (pred->op) {
+  case BATCH_BETWEEN:
+    if (eval_const(column, pred->consts[0], &pred->lo, &lo_null) ||
+        eval_const(column, pred->consts[1], &pred->hi, &hi_null))
+      pred->state= BATCH_PREDICATE::PASS;
+    else if (lo_null || hi_null)
+    {
+      /*
+        BETWEEN with a NULL bound is never TRUE. NOT BETWEEN with a single
+        NULL bound may still be TRUE; such predicates are left alone.
+      */
+      pred->state= (pred->negated && !(lo_null && hi_null)) ?
+                   BATCH_PREDICATE::PASS : BATCH_PREDICATE::REJECT;
+    }
+    break;
+  case BATCH_IN:
+  {
+    bool have_null= FALSE;
+    pred->list_length= 0;
+    for (uint i= 0; i < pred->n_consts; i++)
+    {
+      longlong v;
+      if (eval_const(column, pred->consts[i], &v, &is_null))
+      {
+        pred->state= BATCH_PREDICATE::PASS;
+        break;
+      }
+      if (is_null)
+        have_null= TRUE;
+      else
+        pred->list[pred->list_length++]= v;
+    }
+    if (pred->state == BATCH_PREDICATE::PASS)
+      break;
+    /* NOT IN with a NULL in the list is never TRUE, and nor is IN (NULL) */
+    if (pred->negated ? have_null : !pred->list_length)
+      pred->state= BATCH_PREDICATE::REJECT;
+    else
+      my_qsort(pred->list, pred->list_length, sizeof(longlong),
+               batch_cmp_longlong);
+    break;
+  }
+  default:
+    if (eval_const(column, pred->consts[0], &pred->lo, &is_null))
+      pred->state= BATCH_PREDICATE::PASS;
+    else if (is_null)
+      pred->state= BATCH_PREDICATE::REJECT;
+    break;
+  }
+  return thd->is_error();
+}
+
+
+/*
+  Extract the values of a column for the records in the selection vector
+*/
+
+void JOIN_TAB_BATCH::extract_column(BATCH_COLUMN *column)
+{
+  if (column->batch_no == batch_no)
+    return;
+  column->batch_no= batch_no;
+
+  if (column->raw)
+  {
+    Field *field= column->field;
+    bool unsigned_flag= field->flags & UNSIGNED_FLAG;
+
+    switch (column->type == BATCH_COLUMN_DECIMAL ?
+            MYSQL_TYPE_NEWDECIMAL : field->real_type()) {
+    case MYSQL_TYPE_TINY:
+      if (unsigned_flag)
+        batch_extract_int<batch_decode_utiny>(column, buff, rec_length,
+                                              sel, n_sel);
+      else
+        batch_extract_int<batch_decode_tiny>(column, buff, rec_length,
+                                             sel, n_sel);
+      break;
+    case MYSQL_TYPE_SHORT:
+      if (unsigned_flag)
+        batch_extract_int<batch_decode_ushort>(column, buff, rec_length,
+                                               sel, n_sel);
+      else
+        batch_extract_int<batch_decode_short>(column, buff, rec_length,
+                                              sel, n_sel);
+      break;
+    case MYSQL_TYPE_INT24:
+      if (unsigned_flag)
+        batch_extract_int<batch_decode_umedium>(column, buff, rec_length,
+                                                sel, n_sel);
+      else
+        batch_extract_int<batch_decode_medium>(column, buff, rec_length,
+                                               sel, n_sel);
+      break;
+    case MYSQL_TYPE_LONG:
+      if (unsigned_flag)
+        batch_extract_int<batch_decode_ulong>(column, buff, rec_length,
+                                              sel, n_sel);
+      else
+        batch_extract_int<batch_decode_long>(column, buff, rec_length,
+                                             sel, n_sel);
+      break;
+    case MYSQL_TYPE_LONGLONG:
+      batch_extract_int<batch_decode_longlong>(column, buff, rec_length,
+                                               sel, n_sel);
+      break;
+    case MYSQL_TYPE_NEWDECIMAL:
+      for (uint k= 0; k < n_sel; k++)
+      {
+        uint i= sel[k];
+        const uchar *rec= buff + (size_t) i * rec_length;
+        column->values[i]= batch_decimal_key(rec + column->offset,
+                                             column->bin_length);
+        column->nulls[i]= rec[column->null_offset] & column->null_bit;
+      }
+      break;
+    default:
+      DBUG_ASSERT(0);
+    }
+    return;
+  }
+
+  /*
+    Read the values through the operand of the predicate, exactly as the
+    predicate itself does, with the field pointing into the batch buffer.
+  */
+  Field *field= column->field;
+  Item *item= column->item;
+  for (uint k= 0; k < n_sel; k++)
+  {
+    uint i= sel[k];
+    my_ptrdiff_t diff= (buff + (size_t) i * rec_length) - table->record[0];
+    longlong v;
+
+    field->move_field_offset(diff);
+    switch (column->type) {
+    case BATCH_COLUMN_INT:
+      v= item->val_int();
+      break;
+    case BATCH_COLUMN_DATETIME:
+      v= item->val_datetime_packed();
+      break;
+    default:
+      v= item->val_time_packed();
+      break;
+    }
+    field->move_field_offset(-diff);
+    column->values[i]= v;
+    column->nulls[i]= item->null_value;
+  }
+}
+
+
+void JOIN_TAB_BATCH::apply_predicate(BATCH_PREDICATE *pred)
+{
+  BATCH_COLUMN *column= pred->column;
+
+  switch (pred->op) {
+  case BATCH_EQ:
+  {
+    batch_cmp_eq cmp= { pred->lo };
+    n_sel= batch_select(column, sel, n_sel, cmp);
+    break;
+  }
+  case BATCH_NE:
+  {
+    batch_cmp_ne cmp= { pred->lo };
+    n_sel= batch_select(column, sel, n_sel, cmp);
+    break;
+  }
+  case BATCH_LT:
+  {
+    batch_cmp_lt cmp= { pred->lo };
+    n_sel= batch_select(column, sel, n_sel, cmp);
+    break;
+  }
+  case BATCH_LE:
+  {
+    batch_cmp_le cmp= { pred->lo };
+    n_sel= batch_select(column, sel, n_sel, cmp);
+    break;
+  }
+  case BATCH_GT:
+  {
+    batch_cmp_gt cmp= { pred->lo };
+    n_sel= batch_select(column, sel, n_sel, cmp);
+    break;
+  }
+  case BATCH_GE:
+  {
+    batch_cmp_ge cmp= { pred->lo };
+    n_sel= batch_select(column, sel, n_sel, cmp);
+    break;
+  }
+  case BATCH_BETWEEN:
+    if (pred->negated)
+    {
+      batch_cmp_not_between cmp= { pred->lo, pred->hi };
+      n_sel= batch_select(column, sel, n_sel, cmp);
+    }
+    else
+    {
+      batch_cmp_between cmp= { pred->lo, pred->hi };
+      n_sel= batch_select(column, sel, n_sel, cmp);
+    }
+    break;
+  case BATCH_IN:
+    if (pred->negated)
+    {
+      batch_cmp_not_in cmp= { { pred->list, pred->list_length } };
+      n_sel= batch_select(column, sel, n_sel, cmp);
+    }
+    else
+    {
+      batch_cmp_in cmp= { pred->list, pred->list_length };
+      n_sel= batch_select(column, sel, n_sel, cmp);
+    }
+    break;
+  }
+}
+
+
+/**
+  @brief
+  Evaluate the batch predicates over the records in the batch buffer
+
+  @return
+    The number of records left in the selection vector
+*/
+
+uint JOIN_TAB_BATCH::filter()
+{
+  batch_no++;
+  n_sel= n_rows;
+  for (uint i= 0; i < n_rows; i++)
+    sel[i]= i;
+
+  for (uint i= 0; i < n_predicates && n_sel; i++)
+  {
+    BATCH_PREDICATE *pred= predicates + i;
+    switch (pred->state) {
+    case BATCH_PREDICATE::PASS:
+      break;
+    case BATCH_PREDICATE::REJECT:
+      n_sel= 0;
+      break;
+    case BATCH_PREDICATE::FILTER:
+      extract_column(pred->column);
+      apply_predicate(pred);
+      break;
+    }
+  }
+  return n_sel;
+}
+
+/**
+  @} (end of group Batched_execution)
+*/
@@ -0,0 +1,196 @@
+#ifndef SQL_JOIN_BATCH_INCLUDED
+#define SQL_JOIN_BATCH_INCLUDED
+
+/*
+   Copyright (c) 2018, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/*
+  This file contains declarations for the batched execution of table scans.
+
+  When join_batch_size is not 0, a table that is read by a table, index or
+  range scan may fill a buffer with up to join_batch_size records before any
+  of them is passed on to the next join level. The simple conjuncts of the
+  condition attached to the table are then evaluated over the whole batch,
+  one conjunct at a time: the values of the column a conjunct refers to are
+  extracted into an array for the records that are still selected, and the
+  conjunct is applied to that array, shrinking a selection vector. Only the
+  records left in the selection vector are copied back into the record
+  buffer of the table and handed to evaluate_join_record().
+
+  A conjunct is simple if it is a comparison (=, <>, <, <=, >, >=), BETWEEN
+  or IN predicate whose first operand (or either operand of a comparison)
+  is a column of the table of an integer, temporal or DECIMAL type and whose
+  other operands do not depend on the table. The other operands are
+  evaluated once at the start of each scan.
+
+  evaluate_join_record() still checks the complete attached condition for
+  the records that pass the batch filter. The batch filter thus only has to
+  be exact for the records it discards: a conjunct whose operands cannot be
+  represented exactly for a scan simply lets all records pass.
+*/
+
+/* How the values of a batch column are obtained and compared */
+enum batch_column_type
+{
+  BATCH_COLUMN_INT,                    /* val_int() */
+  BATCH_COLUMN_DATETIME,               /* val_datetime_packed() */
+  BATCH_COLUMN_TIME,                   /* val_time_packed() */
+  BATCH_COLUMN_DECIMAL                 /* binary image as a big-endian key */
+};
+
+enum batch_predicate_op
+{
+  BATCH_EQ, BATCH_NE, BATCH_LT, BATCH_LE, BATCH_GT, BATCH_GE,
+  BATCH_BETWEEN, BATCH_IN
+};
+
+/*
+  A column of the scanned table referred to by one or more conjuncts. The
+  values are extracted per batch, lazily, for the selected records only.
+*/
+struct st_batch_column
+{
+  Field *field;
+  /* The operand referring to the field; values are obtained through it */
+  Item *item;
+  enum batch_column_type type;
+  /*
+    TRUE <=> the value is decoded directly from the record image
+    (integer types and DECIMAL) instead of being read through item
+  */
+  bool raw;
+  /* Offset of the field and of its null byte in the record image */
+  uint offset;
+  uint null_offset;
+  uchar null_bit;
+  /* Length of the binary DECIMAL image */
+  uint bin_length;
+  /* Extracted values and null flags, indexed by record number */
+  longlong *values;
+  uchar *nulls;
+  /* Number of the batch the values were last extracted for */
+  ulonglong batch_no;
+};
+typedef struct st_batch_column BATCH_COLUMN;
+
+/*
+  A conjunct of the attached condition evaluated over a batch
+*/
+struct st_batch_predicate
+{
+  BATCH_COLUMN *column;
+  enum batch_predicate_op op;
+  /* TRUE <=> NOT BETWEEN or NOT IN */
+  bool negated;
+  /* Operands that are evaluated once per scan */
+  Item **consts;
+  uint n_consts;
+
+  /* Per scan state */
+  enum { FILTER, PASS, REJECT } state;
+  longlong lo, hi;
+  /* Sorted values of the IN list without NULLs */
+  longlong *list;
+  uint list_length;
+};
+typedef struct st_batch_predicate BATCH_PREDICATE;
+
+
+class JOIN_TAB_BATCH :public Sql_alloc
+{
+  THD *thd;
+  TABLE *table;
+  /* The condition the predicates were taken from */
+  Item *cond;
+
+  BATCH_COLUMN *columns;
+  uint n_columns;
+  BATCH_PREDICATE *predicates;
+  uint n_predicates;
+
+  /* Length of a record image in the batch buffer */
+  uint rec_length;
+  /* The batch buffer with the record images */
+  uchar *buff;
+  /* The selection vector */
+  uint *sel;
+  /* Number of records in the batch buffer */
+  uint n_rows;
+  /* Number of records in the selection vector */
+  uint n_sel;
+  /* Number of the current batch, used to validate extracted columns */
+  ulonglong batch_no;
+
+  JOIN_TAB_BATCH(THD *thd_arg, TABLE *table_arg, Item *cond_arg,
+                 uint max_rows_arg)
+    :thd(thd_arg), table(table_arg), cond(cond_arg),
+     columns(NULL), n_columns(0), predicates(NULL), n_predicates(0),
+     rec_length(table_arg->s->reclength), buff(NULL), sel(NULL),
+     n_rows(0), n_sel(0), batch_no(0), max_rows(max_rows_arg)
+  {}
+
+  bool add_predicate(Item *item);
+  BATCH_COLUMN *get_column(Item *item, Field *field,
+                           enum batch_column_type type);
+  bool alloc_buffers();
+  bool eval_consts(BATCH_PREDICATE *pred);
+  bool eval_const(BATCH_COLUMN *column, Item *item, longlong *value,
+                  bool *is_null);
+  void extract_column(BATCH_COLUMN *column);
+  void apply_predicate(BATCH_PREDICATE *pred);
+
+public:
+  /* Maximum number of records in a batch */
+  const uint max_rows;
+
+  static JOIN_TAB_BATCH *create(JOIN_TAB *tab);
+
+  uint predicate_count() const { return n_predicates; }
+
+  bool start_scan(JOIN_TAB *tab);
+
+  void reset() { n_rows= 0; }
+
+  bool is_full() const { return n_rows == max_rows; }
+
+  uint rows() const { return n_rows; }
+
+  /* Append the current record of the table to the batch */
+  void add_row()
+  {
+    DBUG_ASSERT(n_rows < max_rows);
+    memcpy(buff + (size_t) n_rows++ * rec_length, table->record[0],
+           rec_length);
+  }
+
+  /* Make a record of the batch the current record of the table */
+  void restore_row(uint i)
+  {
+    DBUG_ASSERT(i < n_rows);
+    memcpy(table->record[0], buff + (size_t) i * rec_length, rec_length);
+  }
+
+  uint filter();
+
+  /* Number of the k-th selected record; the numbers are ascending */
+  uint selected(uint k) const
+  {
+    DBUG_ASSERT(k < n_sel);
+    return sel[k];
+  }
+};
+
+#endif /* SQL_JOIN_BATCH_INCLUDED */
@@ -2696,7 +2696,7 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
   ref_key_info= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
   ref_used_key_parts= join_tab->ref.key_parts;
 
-  hash_func= &JOIN_CACHE_HASHED::get_hash_idx_simple;
+  hash_func= &JOIN_CACHE_HASHED::get_hash_value_simple;
   hash_cmp_func= &JOIN_CACHE_HASHED::equal_keys_simple;
 
   KEY_PART_INFO *key_part= ref_key_info->key_part;
@@ -2705,7 +2705,7 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
   {
     if (!key_part->field->eq_cmp_as_binary())
     {
-      hash_func= &JOIN_CACHE_HASHED::get_hash_idx_complex;
+      hash_func= &JOIN_CACHE_HASHED::get_hash_value_complex;
       hash_cmp_func= &JOIN_CACHE_HASHED::equal_keys_complex;
       break;
     }
@@ -2739,6 +2739,10 @@ int JOIN_CACHE_HASHED::init(bool for_explain)
     The function estimates the number of hash table entries in the hash
     table to be used and initializes this hash table within the join buffer
     space.
+    The number of slots is chosen so that the table is about half full when
+    the buffer is filled with records of the average length. As the table
+    uses open addressing no more than 3/4 of its slots are allowed to be
+    occupied.
 
   RETURN VALUE
     Currently the function always returns 0;
@@ -2756,12 +2760,12 @@ int JOIN_CACHE_HASHED::init_hash_table()
        size_of_key_ofs+= 2)
   {    
     key_entry_length= get_size_of_rec_offset() + // key chain header
-                      size_of_key_ofs +          // reference to the next key 
                       (use_emb_key ?  get_size_of_rec_offset() : key_length);
+    hash_slot_length= size_of_key_ofs + 2;       // reference and tag
 
     size_t space_per_rec= avg_record_length +
                          avg_aux_buffer_incr +
-                         key_entry_length+size_of_key_ofs;
+                         key_entry_length+2*hash_slot_length;
     size_t n= buff_size / space_per_rec;
 
     /*
@@ -2769,18 +2773,20 @@ int JOIN_CACHE_HASHED::init_hash_table()
             the number of records in in the join buffer.
     */
     size_t max_n= buff_size / (pack_length-length+
-                             key_entry_length+size_of_key_ofs);
+                             key_entry_length+2*hash_slot_length);
 
-    hash_entries= (uint) (n / 0.7);
-    set_if_bigger(hash_entries, 1);
+    hash_entries= (uint) (n / 0.5);
+    set_if_bigger(hash_entries, 2);
     
     if (offset_size((uint)(max_n*key_entry_length)) <=
         size_of_key_ofs)
       break;
   }
+  max_key_entries= hash_entries - hash_entries/4 - 1;
+  set_if_bigger(max_key_entries, 1);
    
   /* Initialize the hash table */ 
-  hash_table= buff + (buff_size-hash_entries*size_of_key_ofs);
+  hash_table= buff + (buff_size-hash_entries*hash_slot_length);
   cleanup_hash_table();
   curr_key_entry= hash_table;
 
@@ -2839,14 +2845,13 @@ uint JOIN_CACHE_HASHED::get_max_key_addon_space_per_record()
   ulong len;
   TABLE_REF *ref= &join_tab->ref;
   /* 
-    The total number of hash entries in the hash tables is bounded by
-    ceiling(N/0.7) where N is the maximum number of records in the buffer.
+    The total number of hash slots in the hash tables is bounded by
+    ceiling(N/0.5) where N is the maximum number of records in the buffer.
     That's why the multiplier 2 is used in the formula below. 
   */ 
   len= (use_emb_key ?  get_size_of_rec_offset() : ref->key_length) +
         size_of_rec_ofs +    // size of the key chain header
-        size_of_rec_ofs +    // >= size of the reference to the next key 
-        2*size_of_rec_ofs;   // >= 2*( size of hash table entry)
+        2*(size_of_rec_ofs+2); // >= 2*( size of hash table slot)
   return len; 
 }    
 
@@ -2898,6 +2903,8 @@ void JOIN_CACHE_HASHED::reset(bool for_writing)
     the record from the partial join.
     If the match flag field of a record contains MATCH_IMPOSSIBLE the key is
     not created for this record. 
+    The record is also the last one in the buffer if no more key entries
+    can be placed into the hash table.
     
   RETURN VALUE
     TRUE    if it has been decided that it should be the last record
@@ -2909,8 +2916,6 @@ bool JOIN_CACHE_HASHED::put_record()
 {
   bool is_full;
   uchar *key;
-  uint key_len= key_length;
-  uchar *key_ref_ptr;
   uchar *link= 0;
   TABLE_REF *ref= &join_tab->ref;
   uchar *next_ref_ptr= pos;
@@ -2933,55 +2938,87 @@ bool JOIN_CACHE_HASHED::put_record()
     key= ref->key_buff;
   }
 
+  if (add_to_key_chain(key, next_ref_ptr))
+    is_full= TRUE;
+  return is_full;
+}
+
+
+/* 
+  Add a record from the buffer of a hashed join cache to its key chain
+
+  SYNOPSIS
+    add_to_key_chain()
+      key           pointer to the key value of the record
+      rec_ref_ptr   position of the reference to the next record in the
+                    chain that starts the record in the join buffer
+
+  DESCRIPTION
+    The function searches for the key value of a record in the hash table.
+    If it finds the key in the hash table it joins the record to the chain
+    of records with this key. If the key is not found in the hash table the
+    key entry is placed into it and a chain containing only the record is
+    attached to the key entry. The key value is either placed in the key
+    entry for the key or, if the use_emb_key flag is set, remains in the
+    record. 
+
+  RETURN VALUE
+    TRUE    if no more key entries can be added to the hash table
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_HASHED::add_to_key_chain(uchar *key, uchar *rec_ref_ptr)
+{
+  uchar *key_ref_ptr;
+
   /* Look for the key in the hash table */
-  if (key_search(key, key_len, &key_ref_ptr))
+  if (key_search(key, key_length, &key_ref_ptr))
   {
     uchar *last_next_ref_ptr;
     /* 
       The key is found in the hash table. 
       Add the record to the circular list of the records attached to this key.
       Below 'rec' is the record to be added into the record chain for the found
-      key, 'key_ref' points to a flatten representation of the st_key_entry 
-      structure that contains the key and the head of the record chain.
+      key, 'key_ref' points to the last_rec field of a flatten representation
+      of the st_key_entry structure that contains the key and the head of the
+      record chain.
     */
-    last_next_ref_ptr= get_next_rec_ref(key_ref_ptr+get_size_of_key_offset());
+    last_next_ref_ptr= get_next_rec_ref(key_ref_ptr);
     /* rec->next_rec= key_entry->last_rec->next_rec */
-    memcpy(next_ref_ptr, last_next_ref_ptr, get_size_of_rec_offset());
+    memcpy(rec_ref_ptr, last_next_ref_ptr, get_size_of_rec_offset());
     /* key_entry->last_rec->next_rec= rec */ 
-    store_next_rec_ref(last_next_ref_ptr, next_ref_ptr);
+    store_next_rec_ref(last_next_ref_ptr, rec_ref_ptr);
     /* key_entry->last_rec= rec */
-    store_next_rec_ref(key_ref_ptr+get_size_of_key_offset(), next_ref_ptr);
+    store_next_rec_ref(key_ref_ptr, rec_ref_ptr);
+    return FALSE;
+  }
+
+  /* 
+    The key is not found in the hash table.
+    Put the key into the join buffer and store the reference to it in the
+    empty slot found for the key. Create a circular list with one element
+    referencing the record and attach the list to the key in the buffer.
+  */
+  uchar *cp= last_key_entry;
+  cp-= get_size_of_rec_offset();
+  store_next_key_ref(key_ref_ptr, cp);
+  store_next_rec_ref(rec_ref_ptr, rec_ref_ptr);
+  store_next_rec_ref(cp, rec_ref_ptr);
+  if (use_emb_key)
+  {
+    cp-= get_size_of_rec_offset();
+    store_emb_key_ref(cp, key);
   }
   else
   {
-    /* 
-      The key is not found in the hash table.
-      Put the key into the join buffer linking it with the keys for the
-      corresponding hash entry. Create a circular list with one element
-      referencing the record and attach the list to the key in the buffer.
-    */
-    uchar *cp= last_key_entry;
-    cp-= get_size_of_rec_offset()+get_size_of_key_offset();
-    store_next_key_ref(key_ref_ptr, cp);
-    store_null_key_ref(cp);
-    store_next_rec_ref(next_ref_ptr, next_ref_ptr);
-    store_next_rec_ref(cp+get_size_of_key_offset(), next_ref_ptr);
-    if (use_emb_key)
-    {
-      cp-= get_size_of_rec_offset();
-      store_emb_key_ref(cp, key);
-    }
-    else
-    {
-      cp-= key_len;
-      memcpy(cp, key, key_len);
-    }
-    last_key_entry= cp;
-    DBUG_ASSERT(last_key_entry >= end_pos);
-    /* Increment the counter of key_entries in the hash table */ 
-    key_entries++;
-  }  
-  return is_full;
+    cp-= key_length;
+    memcpy(cp, key, key_length);
+  }
+  last_key_entry= cp;
+  DBUG_ASSERT(last_key_entry >= end_pos);
+  /* Increment the counter of key_entries in the hash table */ 
+  key_entries++;
+  return key_entries >= max_key_entries;
 }
 
 
@@ -3073,18 +3110,25 @@ bool JOIN_CACHE_HASHED::skip_if_not_needed_match()
     key_search()
       key             pointer to the key value
       key_len         key value length
-      key_ref_ptr OUT position of the reference to the next key from 
-                      the hash element for the found key , or
-                      a position where the reference to the the hash 
-                      element for the key is to be added in the
-                      case when the key has not been found
+      key_ref_ptr OUT position of the last_rec field of the key entry
+                      for the found key, or the position of the empty
+                      hash slot where the reference to the key entry
+                      for the key is to be stored in the case when the
+                      key has not been found
       
   DESCRIPTION
     The function looks for a key in the hash table of the join buffer.
-    If the key is found the functionreturns the position of the reference
-    to the next key from  to the hash element for the given key. 
-    Otherwise the function returns the position where the reference to the
-    newly created hash element for the given key is to be added.  
+    Starting from the slot determined by the hash value of the key it
+    checks the slots one after another, wrapping around at the end of the
+    table, until it finds either a slot referring to the key entry for the
+    given key or an empty slot. The key entry referred to from a slot is
+    compared with the key only if the tag stored in the slot coincides with
+    the tag of the key.
+    If the key is found the function returns the position of the last_rec
+    field of the key entry for the given key. Otherwise the function returns
+    the position of the empty slot, with the tag of the key already stored
+    in it, where the reference to the newly created key entry for the given
+    key is to be stored.
 
   RETURN VALUE
     TRUE    the key is found in the hash table
@@ -3094,24 +3138,30 @@ bool JOIN_CACHE_HASHED::skip_if_not_needed_match()
 bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
                                    uchar **key_ref_ptr) 
 {
-  bool is_found= FALSE;
-  uint idx= (this->*hash_func)(key, key_length);
-  uchar *ref_ptr= hash_table+size_of_key_ofs*idx;
-  while (!is_null_key_ref(ref_ptr))
+  ulong hash_value= (this->*hash_func)(key, key_length);
+  uint tag= hash_tag(hash_value);
+  uchar *slot= hash_table+hash_slot_length*(hash_value % hash_entries);
+  uchar *slots_end= buff+buff_size;
+  while (!is_null_key_ref(slot))
   {
-    uchar *next_key;
-    ref_ptr= get_next_key_ref(ref_ptr);
-    next_key= use_emb_key ? get_emb_key(ref_ptr-get_size_of_rec_offset()) :
-                            ref_ptr-key_length;
-
-    if ((this->*hash_cmp_func)(next_key, key, key_len))
+    if (get_hash_tag(slot) == tag)
     {
-      is_found= TRUE;
-      break;
+      uchar *ref_ptr= get_next_key_ref(slot);
+      uchar *next_key= use_emb_key ?
+                         get_emb_key(ref_ptr-get_size_of_rec_offset()) :
+                         ref_ptr-key_length;
+      if ((this->*hash_cmp_func)(next_key, key, key_len))
+      {
+        *key_ref_ptr= ref_ptr;
+        return TRUE;
+      }
     }
+    if ((slot+= hash_slot_length) == slots_end)
+      slot= hash_table;
   }
-  *key_ref_ptr= ref_ptr;
-  return is_found;
+  int2store(slot+size_of_key_ofs, (uint16) tag);
+  *key_ref_ptr= slot;
+  return FALSE;
 } 
 
 
@@ -3119,21 +3169,22 @@ bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
   Hash function that considers a key in the hash table as byte array
 
   SYNOPSIS
-    get_hash_idx_simple()
+    get_hash_value_simple()
       key             pointer to the key value
       key_len         key value length
       
   DESCRIPTION
-    The function calculates an index of the hash entry in the hash table
-    of the join buffer for the given key. It considers the key just as
-    a sequence of bytes of the length key_len.
+    The function calculates the hash value of the given key. The index of
+    the first hash slot to look for the key in the hash table of the join
+    buffer and the tag of the key are taken from this value. It considers
+    the key just as a sequence of bytes of the length key_len.
 
   RETURN VALUE
-    the calculated index of the hash entry for the given key  
+    the calculated hash value of the given key  
 */
 
 inline
-uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
+ulong JOIN_CACHE_HASHED::get_hash_value_simple(uchar* key, uint key_len)
 {
   ulong nr= 1;
   ulong nr2= 4;
@@ -3144,7 +3195,7 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
     nr^= (ulong) ((((uint) nr & 63)+nr2)*((uint) *pos))+ (nr << 8);
     nr2+= 3;
   }
-  return nr % hash_entries;
+  return nr;
 }
 
 
@@ -3152,14 +3203,16 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
   Hash function that takes into account collations of the components of the key  
 
   SYNOPSIS
-    get_hash_idx_complex()
+    get_hash_value_complex()
       key             pointer to the key value
       key_len         key value length
       
   DESCRIPTION
-    The function calculates an index of the hash entry in the hash table
-    of the join buffer for the given key. It takes into account that the
-    components of the key may be of a varchar type with different collations.
+    The function calculates the hash value of the given key. The index of
+    the first hash slot to look for the key in the hash table of the join
+    buffer and the tag of the key are taken from this value. It takes into
+    account that the components of the key may be of a varchar type with
+    different collations.
     The function guarantees that the same hash value for any two equal
     keys that may differ as byte sequences.
     The function takes the info about the components of the key, their
@@ -3168,14 +3221,13 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
     operation.
 
   RETURN VALUE
-    the calculated index of the hash entry for the given key  
+    the calculated hash value of the given key  
 */
 
 inline
-uint JOIN_CACHE_HASHED::get_hash_idx_complex(uchar *key, uint key_len)
+ulong JOIN_CACHE_HASHED::get_hash_value_complex(uchar *key, uint key_len)
 {
-  return 
-    (uint) (key_hashnr(ref_key_info, ref_used_key_parts, key) % hash_entries);
+  return key_hashnr(ref_key_info, ref_used_key_parts, key);
 }
 
 
@@ -3474,6 +3526,64 @@ void JOIN_TAB_SCAN::close()
 }
 
 
+/* 
+  Initiate iterations over the rows of join_tab in a spilled partition
+
+  SYNOPSIS
+    open()
+
+  DESCRIPTION
+    The function prepares reading the rows of the joined table that have
+    been written into the partition set by set_partition(). The function
+    is called instead of JOIN_TAB_SCAN::open() for each refill of the join
+    buffer with the records of the same partition.
+
+  RETURN VALUE   
+    0            the initiation is a success 
+    error code   otherwise     
+*/
+
+int JOIN_TAB_SCAN_SPILL::open()
+{
+  save_or_restore_used_tabs(join_tab, FALSE);
+  rem_rows= rows;
+  if (!rows)
+    return 0;
+  return reinit_io_cache(file, READ_CACHE, 0L, 0, 0);
+}
+
+
+/* 
+  Read the next row of join_tab from the spilled partition
+
+  SYNOPSIS
+    next()
+
+  DESCRIPTION
+    The function reads the next row of the joined table from the partition
+    into the record buffer of the table. The rows of a partition have been
+    checked against the condition pushed to join_tab when they were written.
+
+  RETURN VALUE   
+    0            the next row has been successfully read 
+    -1           there are no more rows in the partition
+    1            an error occurred
+*/
+
+int JOIN_TAB_SCAN_SPILL::next()
+{
+  TABLE *table= join_tab->table;
+
+  if (!rem_rows)
+    return -1;
+  rem_rows--;
+  if (my_b_read(file, table->record[0], table->s->reclength))
+    return 1;
+  table->status= 0;
+  return 0;
+}
+
+
 /*
   Prepare to iterate over the BNL join cache buffer to look for matches 
 
@@ -3657,7 +3767,7 @@ uchar *JOIN_CACHE_BNLH::get_matching_chain_by_join_key()
   /* Look for this key in the join buffer */
   if (!key_search(key_buff, key_length, &key_ref_ptr))
     return 0;
-  return key_ref_ptr+get_size_of_key_offset();
+  return key_ref_ptr;
 }
 
 
@@ -3805,12 +3915,520 @@ void JOIN_CACHE_BNLH::read_next_candidate_for_match(uchar *rec_ptr)
 
 int JOIN_CACHE_BNLH::init(bool for_explain)
 {
+  int rc;
   DBUG_ENTER("JOIN_CACHE_BNLH::init");
 
   if (!(join_tab_scan= new JOIN_TAB_SCAN(join, join_tab)))
     DBUG_RETURN(1);
 
-  DBUG_RETURN(JOIN_CACHE_HASHED::init(for_explain));
+  if ((rc= JOIN_CACHE_HASHED::init(for_explain)) || for_explain)
+    DBUG_RETURN(rc);
+
+  /*
+    The join buffer can be spilled into temporary files only if it is not
+    linked to other caches, if its records and the rows of join_tab can be
+    copied byte by byte, and if the records of the buffer are joined with
+    join_tab alone.
+  */
+  spill_allowed= MY_TEST(join->allowed_join_cache_types &
+                         JOIN_CACHE_SPILL_BIT) &&
+                 !prev_cache && !blobs && !join_tab->table->s->blob_fields &&
+                 !join_tab->first_sj_inner_tab && join_tab->use_quick != 2 &&
+                 (!join_tab->first_inner ||
+                  (join_tab->is_single_inner_of_outer_join() &&
+                   !join_tab->first_upper));
+  if (spill_allowed &&
+      !(spill_scan= new JOIN_TAB_SCAN_SPILL(join, join_tab)))
+    DBUG_RETURN(1);
+
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Add a record into the buffer of the BNLH cache or into a partition
+
+  SYNOPSIS
+    put_record()
+
+  DESCRIPTION
+    This implementation of the virtual function put_record adds the record
+    into the join buffer as JOIN_CACHE_HASHED::put_record() does. If the
+    buffer becomes full and the buffer may be spilled, the records of the
+    buffer are written into partitions in temporary files. After this the
+    function writes the added records into the partitions as well.
+
+  RETURN VALUE
+    TRUE    the join buffer is full and has to be joined with join_tab
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::put_record()
+{
+  bool is_full;
+
+  if (spill_state == SPILL_WRITE)
+  {
+    if (!spill_error)
+      spill_curr_record();
+    return FALSE;
+  }
+  is_full= JOIN_CACHE_HASHED::put_record();
+  if (is_full && spill_allowed && spill_state == SPILL_NONE &&
+      !start_spilling())
+    return FALSE;
+  return is_full;
+}
+
+
+/*
+  Get the number of the partition for a key value
+
+  SYNOPSIS
+    get_spill_part_no()
+      key    the key value
+
+  DESCRIPTION
+    The function returns the number of the partition into which the records
+    with the key value 'key' are spilled. The number is taken from the high
+    bits of the multiplicative hash of the hash value of the key, so that
+    the keys of one partition are spread over all slots of the hash table
+    when the partition is read back into the join buffer.
+*/
+
+uint JOIN_CACHE_BNLH::get_spill_part_no(uchar *key)
+{
+  ulonglong nr= (ulonglong) (this->*hash_func)(key, key_length);
+  return (uint) (((nr * 0x9E3779B97F4A7C15ULL) >> 40) % spill_parts);
+}
+
+
+/*
+  Start spilling the join buffer into temporary files
+
+  SYNOPSIS
+    start_spilling()
+
+  DESCRIPTION
+    The function is called when the join buffer becomes full for the first
+    time. It chooses the number of partitions from the estimated number of
+    partial join records, such that the records of one partition are
+    expected to fit into the join buffer, opens the temporary files for the
+    partitions and moves the records of the buffer into them. After this
+    the buffer is empty and all further records are spilled.
+
+  RETURN VALUE
+    FALSE   the records have been spilled
+    TRUE    the buffer cannot be spilled
+*/
+
+bool JOIN_CACHE_BNLH::start_spilling()
+{
+  double parts;
+  DBUG_ENTER("JOIN_CACHE_BNLH::start_spilling");
+
+  /* The rowids of join_tab cannot be taken from a spilled row */
+  if (join_tab->keep_current_rowid)
+  {
+    spill_allowed= FALSE;
+    DBUG_RETURN(TRUE);
+  }
+
+  parts= ceil(1.5 * (join_tab-1)->get_partial_join_cardinality() / records);
+  set_if_bigger(parts, 2);
+  set_if_smaller(parts, JOIN_CACHE_MAX_SPILL_PARTS);
+  spill_parts= (uint) parts;
+
+  if (!my_multi_malloc(MYF(MY_WME | MY_THREAD_SPECIFIC | MY_ZEROFILL),
+                       &outer_parts, sizeof(IO_CACHE) * spill_parts,
+                       &inner_parts, sizeof(IO_CACHE) * spill_parts,
+                       &outer_part_records, sizeof(ha_rows) * spill_parts,
+                       &inner_part_records, sizeof(ha_rows) * spill_parts,
+                       &spill_buff, (size_t) (5 + key_length + pack_length),
+                       NullS))
+  {
+    spill_parts= 0;
+    spill_allowed= FALSE;
+    DBUG_RETURN(TRUE);
+  }
+
+  for (uint i= 0; i < spill_parts; i++)
+  {
+    if (open_cached_file(outer_parts + i, mysql_tmpdir, TEMP_PREFIX,
+                         IO_SIZE * 4, MYF(MY_WME)) ||
+        open_cached_file(inner_parts + i, mysql_tmpdir, TEMP_PREFIX,
+                         IO_SIZE * 4, MYF(MY_WME)))
+    {
+      end_spilling();
+      spill_allowed= FALSE;
+      DBUG_RETURN(TRUE);
+    }
+  }
+
+  /* Move the records of the join buffer into the partitions */
+  spill_error= FALSE;
+  reset(FALSE);
+  for (size_t cnt= records; cnt && !spill_error; cnt--)
+  {
+    uchar *key= 0;
+    uchar *rec= pos + get_size_of_rec_offset();
+    get_record();
+    if (!with_match_flag ||
+        get_match_flag_by_pos(curr_rec_pos) != MATCH_IMPOSSIBLE)
+    {
+      if (use_emb_key)
+        key= get_curr_emb_key();
+      else
+      {
+        cp_buffer_from_ref(join->thd, join_tab->table, &join_tab->ref);
+        key= join_tab->ref.key_buff;
+      }
+    }
+    spill_record(key, rec, (uint) (pos - rec));
+  }
+  reset(TRUE);
+  spill_state= SPILL_WRITE;
+  status_var_add(join->thd->status_var.join_cache_spilled_parts_, spill_parts);
+  DBUG_RETURN(FALSE);
+}
+
+
+/*
+  Write a record into its partition
+
+  SYNOPSIS
+    spill_record()
+      key      the key of the record, 0 if the record cannot have matches
+      rec      the record fields as they are written into the join buffer
+      rec_len  the length of the record fields
+
+  DESCRIPTION
+    The function writes the length of the record, a flag telling whether
+    the record has a key, the key unless it is embedded into the record
+    fields, and the record fields into the partition of the key. Records
+    without keys are written into the first partition.
+
+  RETURN VALUE
+    FALSE   the record has been written
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_BNLH::spill_record(uchar *key, uchar *rec, uint rec_len)
+{
+  uchar header[5];
+  uint part= key ? get_spill_part_no(key) : 0;
+  IO_CACHE *file= outer_parts + part;
+
+  int4store(header, rec_len);
+  header[4]= MY_TEST(key);
+  if (my_b_write(file, header, sizeof(header)) ||
+      (key && !use_emb_key && my_b_write(file, key, key_length)) ||
+      my_b_write(file, rec, rec_len))
+  {
+    spill_error= TRUE;
+    return TRUE;
+  }
+  outer_part_records[part]++;
+  return FALSE;
+}
+
+
+/*
+  Write the record to be put into the cache into its partition
+
+  SYNOPSIS
+    spill_curr_record()
+
+  DESCRIPTION
+    The function writes the record fields into the beginning of the empty
+    join buffer as put_record() would do, and then writes them into the
+    partition of the key built for the record.
+
+  RETURN VALUE
+    FALSE   the record has been written
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_BNLH::spill_curr_record()
+{
+  bool is_full;
+  bool res;
+  uint rec_len;
+  uchar *key= 0;
+  uchar *rec= buff;
+
+  JOIN_CACHE::reset(TRUE);
+  rec_len= write_record_data(0, &is_full);
+  if (!last_written_is_null_compl)
+  {
+    if (use_emb_key)
+      key= get_curr_emb_key();
+    else
+    {
+      cp_buffer_from_ref(join->thd, join_tab->table, &join_tab->ref);
+      key= join_tab->ref.key_buff;
+    }
+  }
+  res= spill_record(key, rec, rec_len);
+  JOIN_CACHE::reset(TRUE);
+  return res;
+}
+
+
+/*
+  Write the rows of join_tab into partitions
+
+  SYNOPSIS
+    spill_joined_table()
+
+  DESCRIPTION
+    The function scans join_tab once and writes every row that meets the
+    condition pushed to the table into the partition of its key. The rows
+    whose partitions have no records of the cache are dropped.
+
+  RETURN VALUE
+    NESTED_LOOP_OK if the rows have been written, an error code otherwise
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::spill_joined_table()
+{
+  int error;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  TABLE *table= join_tab->table;
+  KEY *keyinfo= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
+  DBUG_ENTER("JOIN_CACHE_BNLH::spill_joined_table");
+
+  table->null_row= 0;
+  if ((rc= join_tab_execution_startup(join_tab)) < 0)
+    DBUG_RETURN(rc);
+
+  if (!(error= join_tab_scan->open()))
+  {
+    while (!(error= join_tab_scan->next()))
+    {
+      uint part;
+      if (join->thd->check_killed())
+      {
+        join->thd->send_kill_message();
+        rc= NESTED_LOOP_KILLED;
+        break;
+      }
+      key_copy(key_buff, table->record[0], keyinfo, key_length, TRUE);
+      part= get_spill_part_no(key_buff);
+      if (!outer_part_records[part])
+        continue;
+      if (my_b_write(inner_parts + part, table->record[0],
+                     table->s->reclength))
+      {
+        rc= NESTED_LOOP_ERROR;
+        break;
+      }
+      inner_part_records[part]++;
+    }
+  }
+  if (error > 0)
+    rc= NESTED_LOOP_ERROR;
+  join_tab_scan->close();
+  DBUG_RETURN(rc);
+}
+
+
+/*
+  Read the next spilled record of the cache from a partition
+
+  SYNOPSIS
+    read_spilled_record()
+      file    the partition to read from
+
+  DESCRIPTION
+    The function reads the record written by spill_record() into the
+    buffer spill_buff.
+
+  RETURN VALUE
+    FALSE   the record has been read
+    TRUE    otherwise
+*/
+
+bool JOIN_CACHE_BNLH::read_spilled_record(IO_CACHE *file)
+{
+  uint len;
+
+  if (my_b_read(file, spill_buff, 5))
+    return TRUE;
+  len= uint4korr(spill_buff);
+  if (spill_buff[4] && !use_emb_key)
+    len+= key_length;
+  return MY_TEST(my_b_read(file, spill_buff + 5, len));
+}
+
+
+/*
+  Put the record read from a partition into the join buffer
+
+  SYNOPSIS
+    put_spilled_record()
+
+  DESCRIPTION
+    The function puts the record from spill_buff into the join buffer and
+    adds its key into the hash table. The record is always put into an
+    empty buffer.
+
+  RETURN VALUE
+    FALSE   the record has been put into the buffer
+    TRUE    the record does not fit into the buffer
+*/
+
+bool JOIN_CACHE_BNLH::put_spilled_record()
+{
+  uint rec_len= uint4korr(spill_buff);
+  bool has_key= spill_buff[4];
+  uchar *key= spill_buff + 5;
+  uchar *rec= key + (has_key && !use_emb_key ? key_length : 0);
+  uchar *rec_ref_ptr= pos;
+
+  if (records &&
+      (get_size_of_rec_offset() + rec_len + extra_key_length() > rem_space() ||
+       key_entries >= max_key_entries))
+    return TRUE;
+
+  pos+= get_size_of_rec_offset();
+  memcpy(pos, rec, rec_len);
+  records++;
+  curr_rec_pos= pos + (with_length ? get_size_of_rec_length() : 0);
+  last_rec_pos= curr_rec_pos;
+  end_pos= pos= pos + rec_len;
+  if (has_key)
+    add_to_key_chain(use_emb_key ? get_curr_emb_key() : key, rec_ref_ptr);
+  return FALSE;
+}
+
+
+/*
+  Join the spilled records of the cache with join_tab
+
+  SYNOPSIS
+    join_spilled_records()
+
+  DESCRIPTION
+    The function is called instead of JOIN_CACHE::join_records() when there
+    are no more records to be put into the spilled cache. It writes the
+    rows of join_tab into partitions and then joins the partitions one by
+    one: the records of a partition are read into the join buffer and
+    joined with the rows of the matching partition of join_tab by
+    JOIN_CACHE::join_records(). If the records of a partition do not fit
+    into the buffer the function joins each refill of the buffer.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_spilled_records()
+{
+  enum_nested_loop_state rc;
+  JOIN_TAB_SCAN *save_join_tab_scan= join_tab_scan;
+  bool outer_join= join_tab->is_first_inner_for_outer_join();
+  DBUG_ENTER("JOIN_CACHE_BNLH::join_spilled_records");
+
+  if (spill_error)
+  {
+    rc= NESTED_LOOP_ERROR;
+    goto finish;
+  }
+  if ((rc= spill_joined_table()) != NESTED_LOOP_OK)
+    goto finish;
+
+  spill_state= SPILL_READ;
+  join_tab_scan= spill_scan;
+  for (uint i= 0; i < spill_parts; i++)
+  {
+    IO_CACHE *file= outer_parts + i;
+    /* Records without matching rows matter only for outer joins */
+    if (!outer_part_records[i] || (!inner_part_records[i] && !outer_join))
+      continue;
+    if (reinit_io_cache(file, READ_CACHE, 0L, 0, 0))
+    {
+      rc= NESTED_LOOP_ERROR;
+      goto finish;
+    }
+    spill_scan->set_partition(inner_parts + i, inner_part_records[i]);
+    for (ha_rows cnt= outer_part_records[i]; cnt; cnt--)
+    {
+      if (read_spilled_record(file))
+      {
+        rc= NESTED_LOOP_ERROR;
+        goto finish;
+      }
+      if (put_spilled_record())
+      {
+        /* The buffer is full: join its records and put the record anew */
+        rc= JOIN_CACHE::join_records(FALSE);
+        if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+          goto finish;
+        put_spilled_record();
+      }
+    }
+    rc= JOIN_CACHE::join_records(FALSE);
+    if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+      goto finish;
+  }
+
+finish:
+  join_tab_scan= save_join_tab_scan;
+  end_spilling();
+  reset(TRUE);
+  DBUG_RETURN(rc);
+}
+
+
+/*
+  Join the records of the BNLH cache with join_tab
+
+  SYNOPSIS
+    join_records()
+      skip_last    do not join the last record in the buffer
+
+  DESCRIPTION
+    This implementation of the virtual function join_records joins the
+    records of the join buffer as JOIN_CACHE::join_records() does unless
+    the cache has been spilled. In this case all records have been put
+    into the cache and the function joins the partitions.
+
+  RETURN VALUE
+    return one of enum_nested_loop_state
+*/
+
+enum_nested_loop_state JOIN_CACHE_BNLH::join_records(bool skip_last)
+{
+  if (spill_state == SPILL_NONE)
+    return JOIN_CACHE::join_records(skip_last);
+  DBUG_ASSERT(spill_state == SPILL_WRITE && !skip_last);
+  return join_spilled_records();
+}
+
+
+/*
+  Close and remove the temporary files of the partitions
+*/
+
+void JOIN_CACHE_BNLH::end_spilling()
+{
+  for (uint i= 0; i < spill_parts; i++)
+  {
+    close_cached_file(outer_parts + i);
+    close_cached_file(inner_parts + i);
+  }
+  if (spill_parts)
+    my_free(outer_parts);
+  spill_parts= 0;
+  spill_state= SPILL_NONE;
+  spill_error= FALSE;
+}
+
+
+void JOIN_CACHE_BNLH::free()
+{
+  end_spilling();
+  JOIN_CACHE::free();
 }
 
 
@@ -22,6 +22,10 @@
 #define JOIN_CACHE_INCREMENTAL_BIT           1
 #define JOIN_CACHE_HASHED_BIT                2
 #define JOIN_CACHE_BKA_BIT                   4
+#define JOIN_CACHE_SPILL_BIT                 8
+
+/* Maximum number of partitions a hashed join buffer is spilled into */
+#define JOIN_CACHE_MAX_SPILL_PARTS          64
 
 /* 
   Categories of data fields of variable length written into join cache buffers.
@@ -659,7 +663,7 @@ class JOIN_CACHE :public Sql_alloc
   }
      
   /* Join records from the join buffer with records from the next join table */ 
-  enum_nested_loop_state join_records(bool skip_last);
+  virtual enum_nested_loop_state join_records(bool skip_last);
 
   /* Add a comment on the join algorithm employed by the join cache */
   virtual bool save_explain_data(EXPLAIN_BKA_TYPE *explain);
@@ -668,7 +672,7 @@ class JOIN_CACHE :public Sql_alloc
 
   virtual ~JOIN_CACHE() {}
   void reset_join(JOIN *j) { join= j; }
-  void free()
+  virtual void free()
   { 
     my_free(buff);
     buff= 0;
@@ -694,20 +698,30 @@ class JOIN_CACHE :public Sql_alloc
   that either itself contains the key value, or, in the case when the keys are
   embedded, refers to its occurrence in one of the records from the chain.
   To build the chains with the same keys a hash table is employed. It is placed
-  at the very end of the join buffer. The array of hash entries is allocated
+  at the very end of the join buffer. The array of hash slots is allocated
   first at the very bottom of the join buffer, while key entries are placed
   before this array.
-  A hash entry contains a header of the list of the key entries with the same
-  hash value. 
+  The hash table uses open addressing with linear probing: a key is looked for
+  in the slots starting from the slot determined by its hash value until either
+  the slot with this key or an empty slot is found. Besides a reference to a
+  key entry a slot contains a tag built from the hash value of the key. The
+  key entries whose tags differ from the tag of the searched key are skipped
+  without being accessed. The number of key entries is always kept below the
+  number of slots, so any search ends at an empty slot at the latest.
+  Each hash slot is a structure of the following type:
+    struct st_join_cache_hash_slot {
+      key_ref key_entry; // offset backward from the beginning of hash table
+      uint16 tag;
+    }
   Each key entry is a structure of the following type:
     struct st_join_cache_key_entry {
       union { 
         uchar[] value;
         cache_ref *value_ref; // offset from the beginning of the buffer
       } hash_table_key;
-      key_ref next_key; // offset backward from the beginning of hash table
       cache_ref *last_rec // offset from the beginning of the buffer
     }
+  A reference to a key entry points to its last_rec field.
   The references linking the records in a chain are always placed at the very
   beginning of the record info stored in the join buffer. The records are 
   linked in a circular list. A new record is always added to the end of this 
@@ -715,55 +729,26 @@ class JOIN_CACHE :public Sql_alloc
 
   The following picture represents a typical layout for the info stored in the
   join buffer of a join cache object of the JOIN_CACHE_HASHED class.
-    
-  buff
-  V
-  +----------------------------------------------------------------------------+
-  |     |[*]record_1_1|                                                        |
-  |     ^ |                                                                    |
-  |     | +--------------------------------------------------+                 |
-  |     |                           |[*]record_2_1|          |                 |
-  |     |                           ^ |                      V                 |
-  |     |                           | +------------------+   |[*]record_1_2|   |
-  |     |                           +--------------------+-+   |               |
-  |+--+ +---------------------+                          | |   +-------------+ |
-  ||  |                       |                          V |                 | |
-  |||[*]record_3_1|         |[*]record_1_3|              |[*]record_2_2|     | |
-  ||^                       ^                            ^                   | |
-  ||+----------+            |                            |                   | |
-  ||^          |            |<---------------------------+-------------------+ |
-  |++          | | ... mrr  |   buffer ...           ... |     |               |
-  |            |            |                            |                     |
-  |      +-----+--------+   |                      +-----|-------+             |
-  |      V     |        |   |                      V     |       |             |
-  ||key_3|[/]|[*]|      |   |                |key_2|[/]|[*]|     |             |
-  |                   +-+---|-----------------------+            |             |
-  |                   V |   |                       |            |             |
-  |             |key_1|[*]|[*]|         |   | ... |[*]|   ...  |[*]|  ...  |   |
-  +----------------------------------------------------------------------------+
-                                        ^           ^            ^
-                                        |           i-th entry   j-th entry
-                                        hash table
-
-  i-th hash entry:
-    circular record chain for key_1:
-      record_1_1
-      record_1_2
-      record_1_3 (points to record_1_1)
-    circular record chain for key_3:
-      record_3_1 (points to itself)
-
-  j-th hash entry:
-    circular record chain for key_2:
-      record_2_1
-      record_2_2 (points to record_2_1)
+
+  buff                                                     hash table
+  V                                                        V
+  +---------------------------------------------------------------------------+
+  |[*]rec_1_1|[*]rec_2_1|[*]rec_1_2|  ...  |key_2|[*]|key_1|[*]|[ ]|[#]|[ ]|[#]|
+  +---------------------------------------------------------------------------+
+   records ->                           <- key entries           hash slots
+
+  The records rec_1_1 and rec_1_2 with the key key_1 form the circular chain
+  rec_1_1 -> rec_1_2 -> rec_1_1, and the last_rec field of the key entry for
+  key_1 refers to rec_1_2. The record rec_2_1 with the key key_2 forms a
+  chain of its own. Each of the two occupied slots [#] refers to one of the
+  key entries.
 
 */
 
 class JOIN_CACHE_HASHED: public JOIN_CACHE
 {
 
-  typedef uint (JOIN_CACHE_HASHED::*Hash_func) (uchar *key, uint key_len);
+  typedef ulong (JOIN_CACHE_HASHED::*Hash_func) (uchar *key, uint key_len);
   typedef bool (JOIN_CACHE_HASHED::*Hash_cmp_func) (uchar *key1, uchar *key2,
                                                     uint key_len);
   
@@ -772,6 +757,9 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* Size of the offset of a key entry in the hash table */
   uint size_of_key_ofs;
 
+  /* Length of a slot of the hash table: the key entry offset and the tag */
+  uint hash_slot_length;
+
   /* 
     Length of the key entry in the hash table.
     A key entry either contains the key value, or it contains a reference
@@ -781,18 +769,17 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
  
   /* The beginning of the hash table in the join buffer */
   uchar *hash_table;
-  /* Number of hash entries in the hash table */
+  /* Number of slots in the hash table */
   uint hash_entries;
 
-
   /* The position of the currently retrieved key entry in the hash table */
   uchar *curr_key_entry;
 
   /* The offset of the data fields from the beginning of the record fields */
   uint data_fields_offset;
 
-  inline uint get_hash_idx_simple(uchar *key, uint key_len);
-  inline uint get_hash_idx_complex(uchar *key, uint key_len);
+  inline ulong get_hash_value_simple(uchar *key, uint key_len);
+  inline ulong get_hash_value_complex(uchar *key, uint key_len);
 
   inline bool equal_keys_simple(uchar *key1, uchar *key2, uint key_len);
   inline bool equal_keys_complex(uchar *key1, uchar *key2, uint key_len);
@@ -834,6 +821,11 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
 
   /* Number of key entries in the hash table (number of distinct keys) */
   uint key_entries;
+  /* 
+    Maximum number of key entries in the hash table. It is less than
+    hash_entries, so that the table always has empty slots.
+  */
+  uint max_key_entries;
 
   /* The position of the last key entry in the hash table */
   uchar *last_key_entry;
@@ -850,8 +842,8 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   uint get_size_of_key_offset() { return size_of_key_ofs; }
 
   /* 
-    Get the position of the next_key_ptr field pointed to by 
-    a linking reference stored at the position key_ref_ptr. 
+    Get the position of the last_rec field of the key entry pointed to by
+    the reference stored at the position key_ref_ptr of a hash slot. 
     This reference is actually the offset backward from the
     beginning of hash table.
   */  
@@ -861,10 +853,10 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   }
 
   /* 
-    Store the linking reference to the next_key_ptr field at 
-    the position key_ref_ptr. The position of the next_key_ptr
-    field is pointed to by ref. The stored reference is actually
-    the offset backward from the beginning of the hash table.
+    Store the reference to the key entry whose last_rec field is pointed
+    to by ref at the position key_ref_ptr of a hash slot. The stored
+    reference is actually the offset backward from the beginning of the
+    hash table.
   */  
   void store_next_key_ref(uchar *key_ref_ptr, uchar *ref)
   {
@@ -872,8 +864,8 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   }     
   
   /* 
-    Check whether the reference to the next_key_ptr field at the position
-    key_ref_ptr contains  a nil value.
+    Check whether the hash slot at the position key_ref_ptr is empty, that
+    is, whether its reference to a key entry contains a nil value.
   */
   bool is_null_key_ref(uchar *key_ref_ptr)
   {
@@ -881,15 +873,17 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
     return memcmp(key_ref_ptr, &nil, size_of_key_ofs ) == 0;
   } 
 
-  /* 
-    Set the reference to the next_key_ptr field at the position
-    key_ref_ptr equal to nil.
-  */
-  void store_null_key_ref(uchar *key_ref_ptr)
+  /* Get the tag of a key stored in the hash slot at the position slot_ptr */
+  uint get_hash_tag(uchar *slot_ptr)
   {
-    ulong nil= 0;
-    store_offset(size_of_key_ofs, key_ref_ptr, nil);
-  } 
+    return uint2korr(slot_ptr+size_of_key_ofs);
+  }
+
+  /* Build the tag of a key stored in the hash slots from its hash value */
+  uint hash_tag(ulong hash_value)
+  {
+    return (uint) ((hash_value / hash_entries) & 0xFFFF);
+  }
 
   uchar *get_next_rec_ref(uchar *ref_ptr)
   {
@@ -972,6 +966,9 @@ class JOIN_CACHE_HASHED: public JOIN_CACHE
   /* Search for a key in the hash table of the join buffer */
   bool key_search(uchar *key, uint key_len, uchar **key_ref_ptr);
 
+  /* Add the record at rec_ref_ptr to the chain of the records with key */
+  bool add_to_key_chain(uchar *key, uchar *rec_ref_ptr);
+
   /* Reallocate the join buffer of a hashed join cache */
   int realloc_buffer();
 
@@ -1086,6 +1083,42 @@ class JOIN_TAB_SCAN: public Sql_alloc
 
 };
 
+
+/*
+  The class JOIN_TAB_SCAN_SPILL is a companion class for the class
+  JOIN_CACHE_BNLH that is used after the join buffer has been spilled into
+  partitions in temporary files. The class implements the iterator over the
+  rows of the joined table that have been written into the partition which is
+  currently joined. The rows have already been checked against the condition
+  pushed to the table. They are read into the record buffer of the table.
+*/
+
+class JOIN_TAB_SCAN_SPILL: public JOIN_TAB_SCAN
+{
+  /* The file with the rows of the partition */
+  IO_CACHE *file;
+  /* The number of rows in the file */
+  ha_rows rows;
+  /* The number of rows not read from the file yet */
+  ha_rows rem_rows;
+
+public:
+
+  JOIN_TAB_SCAN_SPILL(JOIN *j, JOIN_TAB *tab)
+    :JOIN_TAB_SCAN(j, tab), file(0), rows(0), rem_rows(0) {}
+
+  /* Set the partition to iterate over */
+  void set_partition(IO_CACHE *part_file, ha_rows part_rows)
+  {
+    file= part_file;
+    rows= part_rows;
+  }
+
+  int open();
+
+  int next();
+};
+
 /*
   The class JOIN_CACHE_BNL is used when the BNL join algorithm is
   employed to perform a join operation   
@@ -1178,6 +1211,50 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
 
   void read_next_candidate_for_match(uchar *rec_ptr);
 
+private:
+
+  /*
+    When the join buffer becomes full for the first time and spilling is
+    allowed, all records from the buffer are written into partitions in
+    temporary files according to the hash values of their keys, and so are
+    all further records put into the cache (SPILL_WRITE). When there are no
+    more records the rows of join_tab are written into partitions in the
+    same way, and the partitions are joined one by one: the records of a
+    partition are read back into the join buffer and the rows of join_tab
+    from the matching partition are read as the candidates for matches
+    (SPILL_READ). Thus join_tab is scanned only once. If the records of a
+    partition do not fit into the join buffer the rows of the partition of
+    join_tab are read for each refill of the buffer.
+  */
+  enum { SPILL_NONE, SPILL_WRITE, SPILL_READ } spill_state;
+  /* TRUE if the join buffer can be spilled into temporary files */
+  bool spill_allowed;
+  /* Set if a write into a temporary file has failed */
+  bool spill_error;
+  /* The number of partitions the join buffer is spilled into */
+  uint spill_parts;
+  /* The partitions of the records put into the cache */
+  IO_CACHE *outer_parts;
+  /* The partitions of the rows of join_tab */
+  IO_CACHE *inner_parts;
+  /* The numbers of records in the partitions */
+  ha_rows *outer_part_records;
+  ha_rows *inner_part_records;
+  /* Buffer for a record read from a partition */
+  uchar *spill_buff;
+  /* The iterator over the rows of join_tab in a partition */
+  JOIN_TAB_SCAN_SPILL *spill_scan;
+
+  uint get_spill_part_no(uchar *key);
+  bool start_spilling();
+  bool spill_record(uchar *key, uchar *rec, uint rec_len);
+  bool spill_curr_record();
+  enum_nested_loop_state spill_joined_table();
+  bool read_spilled_record(IO_CACHE *file);
+  bool put_spilled_record();
+  enum_nested_loop_state join_spilled_records();
+  void end_spilling();
+
 public:
 
   /* 
@@ -1185,7 +1262,9 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
     used to join table 'tab' to the result of joining the previous tables 
     specified by the 'j' parameter.
   */   
-  JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab) : JOIN_CACHE_HASHED(j, tab) {}
+  JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab)
+    :JOIN_CACHE_HASHED(j, tab), spill_state(SPILL_NONE), spill_allowed(0),
+     spill_parts(0), spill_scan(0) {}
 
   /* 
     This constructor creates a linked BNLH join cache. The cache is to be 
@@ -1194,11 +1273,20 @@ class JOIN_CACHE_BNLH :public JOIN_CACHE_HASHED
     cache object to which this cache is linked.
   */   
   JOIN_CACHE_BNLH(JOIN *j, JOIN_TAB *tab, JOIN_CACHE *prev) 
-    : JOIN_CACHE_HASHED(j, tab, prev) {}
+    :JOIN_CACHE_HASHED(j, tab, prev), spill_state(SPILL_NONE),
+     spill_allowed(0), spill_parts(0), spill_scan(0) {}
 
   /* Initialize the BNLH cache */       
   int init(bool for_explain);
 
+  /* Add a record into the buffer of the BNLH cache or into a partition */
+  bool put_record();
+
+  /* Join records from the join buffer or from its partitions with join_tab */
+  enum_nested_loop_state join_records(bool skip_last);
+
+  void free();
+
   enum Join_algorithm get_join_alg() { return BNLH_JOIN_ALG; }
 
   bool is_key_access() { return TRUE; }
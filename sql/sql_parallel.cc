@@ -0,0 +1,926 @@
+/*
+   Copyright (c) 2018, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/**
+  @file
+
+  @brief
+  Parallel scans of the table of single-table aggregate queries
+
+  @defgroup Parallel_scan Parallel scans with partial aggregation
+  @{
+*/
+
+#include "mariadb.h"
+#include "sql_select.h"
+#include "mysqld.h"
+
+/* Minimum number of records a worker thread is started for */
+#define PARALLEL_SCAN_MIN_ROWS 10000
+
+/* Number of records a worker reads between checks for a killed query */
+#define PARALLEL_SCAN_KILL_CHECK 1024
+
+
+/*
+  Value of an integer column, biased so that the order of the unsigned
+  values is the order of the column values
+*/
+
+static ulonglong split_value(Field *field)
+{
+  ulonglong value= (ulonglong) field->val_int();
+  return ((Field_num *) field)->unsigned_flag ? value : value ^ (1ULL << 63);
+}
+
+
+/* Check that an expression can be evaluated by a worker thread */
+
+static bool is_safe_for_worker(Item *item)
+{
+  return !(item->used_tables() & (RAND_TABLE_BIT | OUTER_REF_TABLE_BIT)) &&
+         !item->with_subquery() && !item->with_sum_func &&
+         !item->is_expensive();
+}
+
+
+static uchar *parallel_group_key(const uchar *record, size_t *length,
+                                 my_bool not_used __attribute__((unused)))
+{
+  PARALLEL_GROUP *group= (PARALLEL_GROUP *) record;
+  *length= group->key_length;
+  return group->key;
+}
+
+
+pthread_handler_t handle_parallel_scan(void *arg)
+{
+  PARALLEL_WORKER *worker= (PARALLEL_WORKER *) arg;
+  my_thread_init();
+  worker->owner->scan(worker);
+  my_thread_end();
+  return 0;
+}
+
+
+/*
+  Copy the settings of the statement that affect the evaluation of
+  expressions to the THD of a worker thread
+*/
+
+static void copy_settings(THD *to, THD *from)
+{
+  to->variables.sql_mode= from->variables.sql_mode;
+  to->variables.old_behavior= from->variables.old_behavior;
+  to->variables.option_bits= from->variables.option_bits;
+  to->variables.div_precincrement= from->variables.div_precincrement;
+  to->variables.max_allowed_packet= from->variables.max_allowed_packet;
+  to->variables.max_sort_length= from->variables.max_sort_length;
+  to->variables.group_concat_max_len= from->variables.group_concat_max_len;
+  to->variables.default_week_format= from->variables.default_week_format;
+  to->variables.lc_time_names= from->variables.lc_time_names;
+  to->variables.time_zone= from->variables.time_zone;
+  to->variables.character_set_client= from->variables.character_set_client;
+  to->variables.character_set_results= from->variables.character_set_results;
+  to->variables.collation_connection= from->variables.collation_connection;
+  to->variables.collation_database= from->variables.collation_database;
+  to->variables.collation_server= from->variables.collation_server;
+  to->variables.character_set_filesystem=
+    from->variables.character_set_filesystem;
+  to->set_time(from->start_time, from->start_time_sec_part);
+  to->query_id= from->query_id;
+}
+
+
+JOIN_TAB_PARALLEL::JOIN_TAB_PARALLEL(JOIN *join_arg, JOIN_TAB *tab,
+                                     uint max_degree_arg)
+  :thd(join_arg->thd), join(join_arg), join_tab(tab), table(tab->table),
+   index(MAX_KEY), split_field(NULL), funcs(NULL), n_funcs(0),
+   group_fields(NULL), n_group_fields(0), key_length(0),
+   workers(NULL), n_workers(0), mem_limit(0), cur_worker(0), cur_group(0),
+   max_degree(max_degree_arg)
+{}
+
+
+/**
+  Check if an aggregate function can be computed by the worker threads
+
+  @retval FALSE  the function was added to funcs
+  @retval TRUE   the function cannot be computed in parallel, or out of memory
+*/
+
+bool JOIN_TAB_PARALLEL::add_func(Item_sum *item)
+{
+  PARALLEL_FUNC *func= funcs + n_funcs;
+  Item *arg, *real;
+  Field *field;
+
+  if (item->has_with_distinct() || item->get_arg_count() != 1)
+    return TRUE;
+  arg= item->get_arg(0);
+  bzero((void*) func, sizeof(*func));
+  func->item= item;
+
+  switch (item->sum_func()) {
+  case Item_sum::COUNT_FUNC:
+    func->type= PARALLEL_COUNT;
+    break;
+  case Item_sum::SUM_FUNC:
+    if (item->result_type() == DECIMAL_RESULT)
+      func->type= PARALLEL_SUM_DECIMAL;
+    else if (item->result_type() == REAL_RESULT)
+      func->type= PARALLEL_SUM_REAL;
+    else
+      return TRUE;
+    break;
+  case Item_sum::MIN_FUNC:
+  case Item_sum::MAX_FUNC:
+    real= arg->real_item();
+    if (real->type() != Item::FIELD_ITEM ||
+        (field= ((Item_field *) real)->field)->table != table ||
+        field->type() == MYSQL_TYPE_BIT || (field->flags & BLOB_FLAG))
+      return TRUE;
+    func->type= item->sum_func() == Item_sum::MIN_FUNC ? PARALLEL_MIN :
+                                                          PARALLEL_MAX;
+    func->field= field;
+    /*
+      The partial value of a group is handed over to the function through
+      a copy of the column with a null byte of its own
+    */
+    if (!(func->value= (uchar *) thd->alloc(field->pack_length() + 1)) ||
+        !(func->value_field= field->clone(thd->mem_root, (my_ptrdiff_t) 0)))
+      return TRUE;
+    func->value_field->move_field(func->value + 1, func->value, 1);
+    if (!(func->value_item= new (thd->mem_root) Item_field(thd,
+                                                           func->value_field)))
+      return TRUE;
+    n_funcs++;
+    return FALSE;
+  default:
+    return TRUE;
+  }
+  if (!is_safe_for_worker(arg))
+    return TRUE;
+  n_funcs++;
+  return FALSE;
+}
+
+
+/**
+  Add a GROUP BY element to the group key of the worker threads
+
+  @details
+    Elements that do not depend on the table are left out. The others must
+    be columns of the table.
+
+  @retval FALSE  ok
+  @retval TRUE   the element cannot be used in a group key
+*/
+
+bool JOIN_TAB_PARALLEL::add_group_field(Item *item)
+{
+  PARALLEL_GROUP_FIELD *group_field= group_fields + n_group_fields;
+  Item *real= item->real_item();
+  Field *field;
+
+  if (!(item->used_tables() & (table->map | RAND_TABLE_BIT)))
+    return FALSE;
+  if (real->type() != Item::FIELD_ITEM ||
+      (field= ((Item_field *) real)->field)->table != table ||
+      (field->flags & BLOB_FLAG))
+    return TRUE;
+
+  group_field->field= field;
+  group_field->length= field->key_length();
+  group_field->image_length= group_field->length +
+    (field->type() == MYSQL_TYPE_VARCHAR ? HA_KEY_BLOB_LENGTH : 0) +
+    (field->maybe_null() ? 1 : 0);
+  key_length+= group_field->image_length;
+  n_group_fields++;
+  return FALSE;
+}
+
+
+/* Check if an index can split the table into ranges */
+
+bool JOIN_TAB_PARALLEL::usable_index(uint idx)
+{
+  KEY *key= table->key_info + idx;
+  Field *field= key->key_part[0].field;
+  ulong flags= table->file->index_flags(idx, 0, 1);
+
+  if (!table->keys_in_use_for_query.is_set(idx) ||
+      (key->flags & (HA_FULLTEXT | HA_SPATIAL)) ||
+      (flags & (HA_READ_NEXT | HA_READ_RANGE)) !=
+      (HA_READ_NEXT | HA_READ_RANGE) ||
+      field->maybe_null())
+    return FALSE;
+
+  switch (field->real_type()) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    return TRUE;
+  default:
+    return FALSE;
+  }
+}
+
+
+/**
+  Choose the index that splits the table
+
+  @details
+    The index the table is read through with keyread is kept. Otherwise
+    the primary key is preferred, as the records are read in the order of
+    the primary key in engines with a clustered primary key.
+
+  @retval FALSE  an index was chosen
+  @retval TRUE   no usable index
+*/
+
+bool JOIN_TAB_PARALLEL::choose_index()
+{
+  uint pk= table->s->primary_key;
+
+  if (table->file->keyread_enabled())
+  {
+    if (!usable_index(table->file->keyread))
+      return TRUE;
+    index= table->file->keyread;
+  }
+  else if (pk != MAX_KEY && usable_index(pk))
+    index= pk;
+  else
+  {
+    for (index= 0; index < table->s->keys; index++)
+    {
+      if (usable_index(index))
+        break;
+    }
+    if (index == table->s->keys)
+      return TRUE;
+  }
+  split_field= table->key_info[index].key_part[0].field;
+  return FALSE;
+}
+
+
+/**
+  Decide whether a table is scanned in parallel
+
+  @param join  The join of a single-table aggregate query
+  @param tab   The table of the join
+
+  @details
+    This is done when the plan of the query is final. The caller has
+    checked that the aggregation can merge the partial groups of the
+    workers.
+
+  @return The object that runs the parallel scans of the table,
+          or NULL if the table is read in the usual way
+*/
+
+JOIN_TAB_PARALLEL *JOIN_TAB_PARALLEL::create(JOIN *join, JOIN_TAB *tab)
+{
+  THD *thd= join->thd;
+  TABLE *table= tab->table;
+  JOIN_TAB_PARALLEL *parallel;
+  Item_sum **func_ptr;
+  uint n_sum_funcs= 0;
+  DBUG_ENTER("JOIN_TAB_PARALLEL::create");
+
+  if ((tab->type != JT_ALL && tab->type != JT_NEXT) ||
+      tab->quick || (tab->select && tab->select->quick) ||
+      tab->filesort || tab->cache || tab->use_quick == 2 ||
+      tab->keep_current_rowid ||
+      join->ordered_index_usage != JOIN::ordered_index_void ||
+      join->procedure || join->rollup.state != ROLLUP::STATE_NONE ||
+      join->select_lex->have_window_funcs() ||
+      (join->select_lex->uncacheable & UNCACHEABLE_DEPENDENT) ||
+      join->select_lex->master_unit()->item)
+    DBUG_RETURN(NULL);
+
+  if (table->s->tmp_table != NO_TMP_TABLE || table->vfield ||
+      table->reginfo.lock_type >= TL_READ_WITH_SHARED_LOCKS ||
+      table->file->pushed_idx_cond || table->file->pushed_cond ||
+      !table->file->parallel_scan_supported() ||
+      table->stat_records() < 2 * PARALLEL_SCAN_MIN_ROWS)
+    DBUG_RETURN(NULL);
+
+  for (uint i= 0; i < table->s->blob_fields; i++)
+  {
+    if (bitmap_is_set(table->read_set, table->s->blob_field[i]))
+      DBUG_RETURN(NULL);
+  }
+
+  if (tab->select_cond && !is_safe_for_worker(tab->select_cond))
+    DBUG_RETURN(NULL);
+
+  for (func_ptr= join->sum_funcs; *func_ptr; func_ptr++)
+    n_sum_funcs++;
+
+  if (!(parallel= new (thd->mem_root)
+        JOIN_TAB_PARALLEL(join, tab,
+                          (uint) thd->variables.max_parallel_degree)) ||
+      !(parallel->funcs= (PARALLEL_FUNC *)
+        thd->alloc(sizeof(PARALLEL_FUNC) * n_sum_funcs)) ||
+      !(parallel->group_fields= (PARALLEL_GROUP_FIELD *)
+        thd->alloc(sizeof(PARALLEL_GROUP_FIELD) *
+                   (join->select_lex->group_list.elements + 1))))
+    DBUG_RETURN(NULL);
+
+  for (func_ptr= join->sum_funcs; *func_ptr; func_ptr++)
+  {
+    if (parallel->add_func(*func_ptr))
+      DBUG_RETURN(NULL);
+  }
+
+  for (ORDER *group= join->select_lex->group_list.first; group;
+       group= group->next)
+  {
+    if (parallel->add_group_field(*group->item))
+      DBUG_RETURN(NULL);
+  }
+
+  if (parallel->choose_index())
+    DBUG_RETURN(NULL);
+  /* The workers stop at the end of their range by the split column */
+  bitmap_set_bit(table->read_set, parallel->split_field->field_index);
+  DBUG_RETURN(parallel);
+}
+
+
+/* Make the key image of the split column for a biased value */
+
+void JOIN_TAB_PARALLEL::make_key(uchar *key, ulonglong value)
+{
+  bool unsigned_flag= ((Field_num *) split_field)->unsigned_flag;
+  my_bitmap_map *old_map= dbug_tmp_use_all_columns(table, table->write_set);
+  if (!unsigned_flag)
+    value^= 1ULL << 63;
+  split_field->store((longlong) value, unsigned_flag);
+  dbug_tmp_restore_column_map(table->write_set, old_map);
+  memcpy(key, split_field->ptr, split_field->pack_length());
+}
+
+
+/* Estimate the number of records with first <= split column < value */
+
+ha_rows JOIN_TAB_PARALLEL::rows_before(ulonglong first, ulonglong value)
+{
+  uchar min_buff[8], max_buff[8];
+  uint length= split_field->pack_length();
+  key_range min_key= { min_buff, length, 1, HA_READ_KEY_EXACT };
+  key_range max_key= { max_buff, length, 1, HA_READ_BEFORE_KEY };
+
+  make_key(min_buff, first);
+  make_key(max_buff, value);
+  return table->file->records_in_range(index, &min_key, &max_key);
+}
+
+
+/**
+  Split the table into ranges of about the same number of records
+
+  @param min_value  The smallest biased value of the split column
+  @param max_value  The largest biased value of the split column
+  @param bounds     OUT The values the ranges begin with, except the first
+
+  @return The number of bounds, 0 if the table is not worth splitting
+*/
+
+uint JOIN_TAB_PARALLEL::split(ulonglong min_value, ulonglong max_value,
+                              ulonglong *bounds)
+{
+  ha_rows total= rows_before(min_value, max_value);
+  uint n= (uint) MY_MIN(max_degree, total / PARALLEL_SCAN_MIN_ROWS);
+  uint n_bounds= 0;
+  ulonglong low= min_value;
+
+  for (uint i= 1; i < n; i++)
+  {
+    ha_rows target= total / n * i;
+    ulonglong high= max_value;
+
+    /* Find the smallest value with at least target records before it */
+    while (high - low > 1)
+    {
+      ulonglong mid= low + (high - low) / 2;
+      if (rows_before(min_value, mid) >= target)
+        high= mid;
+      else
+        low= mid;
+    }
+    if (high <= (n_bounds ? bounds[n_bounds - 1] : min_value))
+      continue;
+    bounds[n_bounds++]= high;
+    low= high;
+  }
+  return n_bounds;
+}
+
+
+/**
+  Make a copy of an expression over the columns of the table that reads
+  the record of a worker
+*/
+
+Item *JOIN_TAB_PARALLEL::clone_item(PARALLEL_WORKER *worker, Item *item)
+{
+  Item *copy;
+  switch_to_table_fields_processor_data data= { table, worker->table };
+
+  if (!(copy= item->build_clone(thd)))
+    return NULL;
+  copy->walk(&Item::cleanup_excluding_fields_processor, 0, 0);
+  copy->walk(&Item::switch_to_table_fields_processor, 0, &data);
+  if (!copy->fixed && copy->fix_fields(thd, &copy))
+    return NULL;
+  return copy;
+}
+
+
+/**
+  Prepare a worker for the scan of a range of the table
+
+  @details
+    The handler of the worker is positioned at the first record of the
+    range here, in the thread of the statement.
+
+  @retval FALSE  ok
+  @retval TRUE   the worker cannot be used
+*/
+
+bool JOIN_TAB_PARALLEL::init_worker(PARALLEL_WORKER *worker, ulonglong start,
+                                    bool has_start, ulonglong end,
+                                    bool has_end)
+{
+  uchar key[8];
+  handler *file;
+  my_ptrdiff_t diff;
+  Field **field;
+
+  worker->owner= this;
+  worker->end= end;
+  worker->has_end= has_end;
+  my_hash_init(&worker->groups, &my_charset_bin, 64, 0, 0,
+               parallel_group_key, 0, 0);
+  init_alloc_root(&worker->mem_root, "parallel_scan", 8192, 0, MYF(0));
+
+  if (!(file= table->file->clone(table->s->normalized_path.str,
+                                 thd->mem_root)))
+    return TRUE;
+  if (file->ha_external_lock(thd, F_RDLCK))
+  {
+    file->ha_close();
+    delete file;
+    return TRUE;
+  }
+  worker->file= file;
+  if (!file->parallel_scan_supported() || file->start_parallel_scan())
+    return TRUE;
+  worker->parallel_started= true;
+  if ((table->file->keyread_enabled() && file->ha_start_keyread(index)) ||
+      file->ha_index_init(index, 1))
+    return TRUE;
+
+  /* A copy of the table with copies of its fields that read the record */
+  if (!(worker->record= (uchar *) thd->memdup(table->record[0],
+                                              table->s->rec_buff_length)) ||
+      !(worker->table= (TABLE *) thd->memdup(table, sizeof(TABLE))) ||
+      !(field= (Field **) thd->alloc(sizeof(Field *) *
+                                     (table->s->fields + 1))) ||
+      !(worker->key_buff= (uchar *) thd->alloc(key_length + 1)))
+    return TRUE;
+  diff= (my_ptrdiff_t) (worker->record - table->record[0]);
+  for (uint i= 0; i < table->s->fields; i++)
+  {
+    if (!(field[i]= table->field[i]->clone(thd->mem_root, worker->table,
+                                           diff)))
+      return TRUE;
+  }
+  field[table->s->fields]= 0;
+  worker->table->field= field;
+  worker->table->record[0]= worker->record;
+  worker->split_field= field[split_field->field_index];
+
+  if (join_tab->select_cond &&
+      !(worker->cond= clone_item(worker, join_tab->select_cond)))
+    return TRUE;
+  if (!(worker->args= (Item **) thd->calloc(sizeof(Item *) * n_funcs)))
+    return TRUE;
+  for (uint i= 0; i < n_funcs; i++)
+  {
+    if (funcs[i].type != PARALLEL_MIN && funcs[i].type != PARALLEL_MAX &&
+        !(worker->args[i]= clone_item(worker, funcs[i].item->get_arg(0))))
+      return TRUE;
+  }
+
+  if (has_start)
+  {
+    make_key(key, start);
+    worker->error= file->ha_index_read_map(worker->record, key, 1,
+                                           HA_READ_KEY_OR_NEXT);
+  }
+  else
+    worker->error= file->ha_index_first(worker->record);
+  if (worker->error == HA_ERR_KEY_NOT_FOUND)
+    worker->error= HA_ERR_END_OF_FILE;
+  return FALSE;
+}
+
+
+/**
+  Split the table among the worker threads before the scan
+
+  @details
+    The smallest and the largest values of the split column are read, and
+    the boundaries of the ranges are searched for with records_in_range().
+
+  @retval TRUE   the workers are ready, run() is to be called
+  @retval FALSE  the table is to be read in the usual way
+*/
+
+bool JOIN_TAB_PARALLEL::start_scan()
+{
+  handler *file= table->file;
+  ulonglong min_value= 0, max_value= 0, *bounds;
+  uint n_bounds;
+  int error;
+  DBUG_ENTER("JOIN_TAB_PARALLEL::start_scan");
+
+  n_workers= 0;
+  cur_worker= 0;
+  cur_group= 0;
+  if (file->inited || file->ha_index_init(index, 1))
+    DBUG_RETURN(FALSE);
+  if (!(error= file->ha_index_first(table->record[0])))
+  {
+    min_value= split_value(split_field);
+    if (!(error= file->ha_index_last(table->record[0])))
+      max_value= split_value(split_field);
+  }
+  file->ha_index_end();
+  if (error)
+    DBUG_RETURN(FALSE);
+
+  if (!(bounds= (ulonglong *) thd->alloc(sizeof(ulonglong) * max_degree)) ||
+      !(n_bounds= split(min_value, max_value, bounds)) ||
+      !(workers= (PARALLEL_WORKER *)
+        thd->calloc(sizeof(PARALLEL_WORKER) * (n_bounds + 1))))
+    DBUG_RETURN(FALSE);
+
+  mem_limit= (size_t) (thd->variables.tmp_memory_table_size /
+                       (n_bounds + 1));
+  for (uint i= 0; i <= n_bounds; i++)
+  {
+    n_workers++;
+    if (init_worker(workers + i, i ? bounds[i - 1] : 0, i > 0,
+                    i < n_bounds ? bounds[i] : 0, i < n_bounds))
+    {
+      end_scan();
+      DBUG_RETURN(FALSE);
+    }
+  }
+  DBUG_RETURN(TRUE);
+}
+
+
+/**
+  Aggregate the current record of a worker into its group
+
+  @retval FALSE  ok
+  @retval TRUE   out of memory or over the memory limit of the worker
+*/
+
+bool JOIN_TAB_PARALLEL::add_row(PARALLEL_WORKER *worker)
+{
+  TABLE *copy= worker->table;
+  uchar *pos= worker->key_buff;
+  PARALLEL_GROUP *group;
+
+  for (uint i= 0; i < n_group_fields; i++)
+  {
+    PARALLEL_GROUP_FIELD *group_field= group_fields + i;
+    Field *field= copy->field[group_field->field->field_index];
+    uchar *end= pos + group_field->image_length;
+    if (field->maybe_null() && (*pos++= (uchar) field->is_null()))
+      bzero(pos, end - pos);
+    else
+      field->get_key_image(pos, group_field->length, Field::itRAW);
+    pos= end;
+  }
+
+  if (!(group= (PARALLEL_GROUP *) my_hash_search(&worker->groups,
+                                                 worker->key_buff,
+                                                 key_length)))
+  {
+    worker->mem_used+= sizeof(PARALLEL_GROUP) + key_length +
+                       table->s->reclength + n_funcs * sizeof(PARALLEL_SUM);
+    if (worker->mem_used > mem_limit ||
+        !(group= (PARALLEL_GROUP *) alloc_root(&worker->mem_root,
+                                               sizeof(PARALLEL_GROUP))) ||
+        !(group->key= (uchar *) memdup_root(&worker->mem_root,
+                                            worker->key_buff,
+                                            key_length + 1)) ||
+        !(group->record= (uchar *) memdup_root(&worker->mem_root,
+                                               worker->record,
+                                               table->s->reclength)) ||
+        !(group->sums= new (&worker->mem_root) PARALLEL_SUM[n_funcs]))
+      return TRUE;
+    group->key_length= key_length;
+    for (uint i= 0; i < n_funcs; i++)
+    {
+      PARALLEL_SUM *sum= group->sums + i;
+      sum->count= 0;
+      sum->real= 0.0;
+      my_decimal_set_zero(&sum->dec);
+      sum->image= NULL;
+      sum->null= TRUE;
+      if (funcs[i].field)
+      {
+        uint length= funcs[i].field->pack_length() + 1;
+        worker->mem_used+= length;
+        if (!(sum->image= (uchar *) alloc_root(&worker->mem_root, length)))
+          return TRUE;
+        sum->image[0]= 1;
+      }
+    }
+    if (my_hash_insert(&worker->groups, (uchar *) group))
+      return TRUE;
+  }
+
+  for (uint i= 0; i < n_funcs; i++)
+  {
+    PARALLEL_SUM *sum= group->sums + i;
+    Item *arg= worker->args[i];
+
+    switch (funcs[i].type) {
+    case PARALLEL_COUNT:
+      if (!arg->maybe_null || !arg->is_null())
+        sum->count++;
+      break;
+    case PARALLEL_SUM_DECIMAL:
+    {
+      my_decimal value, tmp, *val= arg->val_decimal(&value);
+      if (!arg->null_value)
+      {
+        my_decimal_add(E_DEC_FATAL_ERROR, &tmp, &sum->dec, val);
+        sum->dec= tmp;
+        sum->null= FALSE;
+      }
+      break;
+    }
+    case PARALLEL_SUM_REAL:
+    {
+      double value= arg->val_real();
+      if (!arg->null_value)
+      {
+        sum->real+= value;
+        sum->null= FALSE;
+      }
+      break;
+    }
+    case PARALLEL_MIN:
+    case PARALLEL_MAX:
+    {
+      Field *field= copy->field[funcs[i].field->field_index];
+      if (field->is_null())
+        break;
+      if (!sum->null)
+      {
+        int cmp= field->cmp(field->ptr, sum->image + 1);
+        if (funcs[i].type == PARALLEL_MIN ? cmp >= 0 : cmp <= 0)
+          break;
+      }
+      sum->image[0]= 0;
+      memcpy(sum->image + 1, field->ptr, field->pack_length());
+      sum->null= FALSE;
+      break;
+    }
+    }
+  }
+  return FALSE;
+}
+
+
+/**
+  Read the range of a worker and aggregate its records
+
+  @details
+    This runs in the worker thread, with a THD of its own. The scan is
+    abandoned on any warning or error of the evaluation of the
+    expressions: the table is then read again in the usual way, which
+    reports them.
+*/
+
+void JOIN_TAB_PARALLEL::scan(PARALLEL_WORKER *worker)
+{
+  THD *worker_thd;
+  DBUG_ENTER("JOIN_TAB_PARALLEL::scan");
+
+  if (!(worker_thd= new THD(0)))
+  {
+    worker->state= PARALLEL_WORKER::SCAN_ABANDONED;
+    DBUG_VOID_RETURN;
+  }
+  worker_thd->thread_stack= (char*) &worker_thd;
+  worker_thd->store_globals();
+  worker_thd->system_thread= SYSTEM_THREAD_GENERIC;
+  copy_settings(worker_thd, thd);
+  worker->table->in_use= worker_thd;
+
+  worker->state= PARALLEL_WORKER::SCAN_OK;
+  for (ha_rows n= 0; !worker->error; n++)
+  {
+    if (worker->has_end && split_value(worker->split_field) >= worker->end)
+      break;
+    if (!(n % PARALLEL_SCAN_KILL_CHECK) && thd->killed)
+    {
+      worker->state= PARALLEL_WORKER::SCAN_KILLED;
+      break;
+    }
+    worker->rows++;
+    if ((!worker->cond || worker->cond->val_int()) && add_row(worker))
+    {
+      worker->state= PARALLEL_WORKER::SCAN_ABANDONED;
+      break;
+    }
+    if (worker_thd->is_error() ||
+        worker_thd->get_stmt_da()->current_statement_warn_count())
+    {
+      worker->state= PARALLEL_WORKER::SCAN_ABANDONED;
+      break;
+    }
+    worker->error= worker->file->index_next(worker->record);
+  }
+  if (worker->error && worker->error != HA_ERR_END_OF_FILE)
+    worker->state= PARALLEL_WORKER::SCAN_FAILED;
+
+  worker->table->in_use= thd;
+  delete worker_thd;
+  set_current_thd(0);
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Run the worker threads and wait for them to finish
+
+  @retval  0  ok, the partial groups are passed on with next_group()
+  @retval -1  the table is to be read in the usual way after end_scan()
+  @retval  1  error or killed query; end_scan() is to be called
+*/
+
+int JOIN_TAB_PARALLEL::run()
+{
+  int res= 0;
+  uint i;
+  DBUG_ENTER("JOIN_TAB_PARALLEL::run");
+
+  for (i= 0; i < n_workers; i++)
+  {
+    PARALLEL_WORKER *worker= workers + i;
+    worker->started= !mysql_thread_create(key_thread_parallel_scan,
+                                          &worker->thread, NULL,
+                                          handle_parallel_scan, worker);
+  }
+
+  for (i= 0; i < n_workers; i++)
+  {
+    PARALLEL_WORKER *worker= workers + i;
+    if (!worker->started)
+    {
+      res= -1;
+      continue;
+    }
+    pthread_join(worker->thread, NULL);
+    thd->status_var.ha_read_next_count+= worker->rows;
+  }
+
+  for (i= 0; i < n_workers && res >= 0; i++)
+  {
+    PARALLEL_WORKER *worker= workers + i;
+    if (!worker->started)
+      continue;
+    switch (worker->state) {
+    case PARALLEL_WORKER::SCAN_OK:
+      break;
+    case PARALLEL_WORKER::SCAN_ABANDONED:
+      res= -1;
+      break;
+    case PARALLEL_WORKER::SCAN_FAILED:
+      worker->file->print_error(worker->error, MYF(0));
+      res= 1;
+      break;
+    case PARALLEL_WORKER::SCAN_KILLED:
+      res= 1;
+      break;
+    }
+  }
+  DBUG_RETURN(res);
+}
+
+
+/* Hand the partial aggregates of a group to the aggregate functions */
+
+void JOIN_TAB_PARALLEL::set_direct_values(PARALLEL_GROUP *group)
+{
+  for (uint i= 0; i < n_funcs; i++)
+  {
+    PARALLEL_FUNC *func= funcs + i;
+    PARALLEL_SUM *sum= group->sums + i;
+
+    switch (func->type) {
+    case PARALLEL_COUNT:
+      ((Item_sum_count *) func->item)->direct_add(sum->count);
+      break;
+    case PARALLEL_SUM_DECIMAL:
+      ((Item_sum_sum *) func->item)->direct_add(sum->null ? NULL : &sum->dec);
+      break;
+    case PARALLEL_SUM_REAL:
+      ((Item_sum_sum *) func->item)->direct_add(sum->real, sum->null);
+      break;
+    case PARALLEL_MIN:
+    case PARALLEL_MAX:
+      memcpy(func->value, sum->image, func->field->pack_length() + 1);
+      ((Item_sum_hybrid *) func->item)->direct_add(func->value_item);
+      break;
+    }
+  }
+}
+
+
+/**
+  Make the next partial group of the workers current
+
+  @details
+    The first record of the group is put into the record buffer of the
+    table, and the partial aggregates are handed to the aggregate
+    functions, to be used by the next update of their groups.
+
+  @retval TRUE   a group was made current
+  @retval FALSE  no more groups
+*/
+
+bool JOIN_TAB_PARALLEL::next_group()
+{
+  for (; cur_worker < n_workers; cur_worker++, cur_group= 0)
+  {
+    PARALLEL_WORKER *worker= workers + cur_worker;
+    if (cur_group < worker->groups.records)
+    {
+      PARALLEL_GROUP *group= (PARALLEL_GROUP *)
+        my_hash_element(&worker->groups, cur_group++);
+      memcpy(table->record[0], group->record, table->s->reclength);
+      set_direct_values(group);
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+
+/* Free the partial groups and release the handlers of the workers */
+
+void JOIN_TAB_PARALLEL::end_scan()
+{
+  for (uint i= 0; i < n_workers; i++)
+  {
+    PARALLEL_WORKER *worker= workers + i;
+    my_hash_free(&worker->groups);
+    free_root(&worker->mem_root, MYF(0));
+    if (worker->file)
+    {
+      if (worker->file->inited)
+        worker->file->ha_index_end();
+      if (worker->parallel_started)
+        worker->file->end_parallel_scan();
+      worker->file->ha_external_lock(thd, F_UNLCK);
+      worker->file->ha_close();
+      delete worker->file;
+      worker->file= NULL;
+    }
+  }
+  n_workers= 0;
+}
+
+/**
+  @} (end of group Parallel_scan)
+*/
@@ -0,0 +1,235 @@
+#ifndef SQL_PARALLEL_INCLUDED
+#define SQL_PARALLEL_INCLUDED
+
+/*
+   Copyright (c) 2018, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/*
+  This file contains declarations for the parallel scan of the table of a
+  single-table aggregate query.
+
+  When max_parallel_degree is greater than 1, a query like
+
+    SELECT y, COUNT(*), SUM(x) FROM t WHERE ... GROUP BY y
+
+  may read its table with several threads. The table is split into ranges
+  of an index whose first column is an integer. The boundaries of the
+  ranges are found with handler::records_in_range(), so that each range
+  holds about the same number of records. Each range is read by a worker
+  thread through its own clone of the table handler, into its own record
+  buffer. The worker evaluates its own copies of the attached condition and
+  of the arguments of the aggregate functions, and keeps a partial
+  aggregate per group in a hash table.
+
+  When all workers have finished, the partial groups are passed on to the
+  usual aggregation one by one: the group is represented by a record of the
+  group, and its partial aggregates are handed to the aggregate functions
+  with their direct_add() methods, which Item_sum::add(), reset_field() and
+  update_field() use instead of the values of their arguments. The usual
+  GROUP BY processing thus merges the partial groups of the workers. This
+  requires an aggregation that looks up the group of every record in a
+  temporary table, or a single group.
+
+  The engine has to allow the scan with handler::parallel_scan_supported(),
+  and handler::start_parallel_scan() makes the reads of a worker independent
+  of the transaction state that the other threads modify. The workers only
+  call index_next() on their handlers; all other handler calls are made by
+  the thread of the statement.
+
+  Supported aggregate functions are COUNT, SUM, MIN and MAX without
+  DISTINCT. MIN and MAX must take a column, and the GROUP BY list must
+  consist of columns. If a worker gets a warning or an error from the
+  evaluation of an expression, or exceeds its share of tmp_table_size, the
+  partial results are discarded and the table is read in the usual way.
+*/
+
+class JOIN_TAB_PARALLEL;
+
+/* How the partial results of an aggregate function are computed */
+enum parallel_func_type
+{
+  PARALLEL_COUNT,
+  PARALLEL_SUM_DECIMAL,
+  PARALLEL_SUM_REAL,
+  PARALLEL_MIN,
+  PARALLEL_MAX
+};
+
+/*
+  An aggregate function of the query
+*/
+struct st_parallel_func
+{
+  Item_sum *item;
+  enum parallel_func_type type;
+  /* MIN/MAX: the column */
+  Field *field;
+  /*
+    MIN/MAX: a copy of the column that is moved to the partial value of a
+    group, with a null byte in front of it, and an item that reads it
+  */
+  Field *value_field;
+  Item *value_item;
+  uchar *value;
+};
+typedef struct st_parallel_func PARALLEL_FUNC;
+
+/*
+  A GROUP BY column and the length of its part of the group key
+*/
+struct st_parallel_group_field
+{
+  Field *field;
+  /* The length passed to get_key_image() */
+  uint length;
+  /* The bytes taken in the key, with the null byte */
+  uint image_length;
+};
+typedef struct st_parallel_group_field PARALLEL_GROUP_FIELD;
+
+/*
+  The partial result of an aggregate function for a group
+*/
+struct st_parallel_sum :public Sql_alloc
+{
+  longlong count;
+  double real;
+  my_decimal dec;
+  /* MIN/MAX: a null byte and the image of the column */
+  uchar *image;
+  /* TRUE <=> no value has been aggregated */
+  bool null;
+};
+typedef struct st_parallel_sum PARALLEL_SUM;
+
+/*
+  The partial aggregates of a group of a worker
+*/
+struct st_parallel_group
+{
+  uchar *key;
+  uint key_length;
+  /* The first record of the group */
+  uchar *record;
+  PARALLEL_SUM *sums;
+};
+typedef struct st_parallel_group PARALLEL_GROUP;
+
+/*
+  A worker thread and the range of the table it reads
+*/
+struct st_parallel_worker
+{
+  JOIN_TAB_PARALLEL *owner;
+  /* The clone of the table handler, positioned at the start of the range */
+  handler *file;
+  /* Whether file->start_parallel_scan() succeeded */
+  bool parallel_started;
+  /*
+    A copy of the TABLE object with copies of its fields that point into
+    record. in_use is set to the THD of the worker thread.
+  */
+  TABLE *table;
+  uchar *record;
+  /* The split column in table */
+  Field *split_field;
+  /* Copies of the attached condition and of the arguments of the functions */
+  Item *cond;
+  Item **args;
+  /* Biased value of the split column the range ends before, if has_end */
+  ulonglong end;
+  bool has_end;
+
+  pthread_t thread;
+  bool started;
+
+  /* The partial groups, allocated on mem_root */
+  HASH groups;
+  MEM_ROOT mem_root;
+  size_t mem_used;
+  uchar *key_buff;
+
+  /* Result of the last read, and outcome of the scan */
+  int error;
+  enum { SCAN_OK, SCAN_FAILED, SCAN_ABANDONED, SCAN_KILLED } state;
+  ha_rows rows;
+};
+typedef struct st_parallel_worker PARALLEL_WORKER;
+
+
+class JOIN_TAB_PARALLEL :public Sql_alloc
+{
+  THD *thd;
+  JOIN *join;
+  JOIN_TAB *join_tab;
+  TABLE *table;
+
+  /* The index that splits the table and its first column */
+  uint index;
+  Field *split_field;
+
+  PARALLEL_FUNC *funcs;
+  uint n_funcs;
+
+  /* The GROUP BY columns that make up the group key */
+  PARALLEL_GROUP_FIELD *group_fields;
+  uint n_group_fields;
+  uint key_length;
+
+  PARALLEL_WORKER *workers;
+  uint n_workers;
+  /* Memory a worker may use for its groups */
+  size_t mem_limit;
+
+  /* The worker and the group passed on by next_group() */
+  uint cur_worker;
+  ulong cur_group;
+
+  JOIN_TAB_PARALLEL(JOIN *join_arg, JOIN_TAB *tab, uint max_degree_arg);
+
+  bool add_func(Item_sum *item);
+  bool add_group_field(Item *item);
+  bool usable_index(uint idx);
+  bool choose_index();
+  ha_rows rows_before(ulonglong first, ulonglong value);
+  void make_key(uchar *key, ulonglong value);
+  uint split(ulonglong min_value, ulonglong max_value, ulonglong *bounds);
+  bool init_worker(PARALLEL_WORKER *worker, ulonglong start, bool has_start,
+                   ulonglong end, bool has_end);
+  Item *clone_item(PARALLEL_WORKER *worker, Item *item);
+  bool add_row(PARALLEL_WORKER *worker);
+  void set_direct_values(PARALLEL_GROUP *group);
+
+public:
+  /* Maximum number of worker threads */
+  const uint max_degree;
+
+  static JOIN_TAB_PARALLEL *create(JOIN *join, JOIN_TAB *tab);
+
+  bool start_scan();
+
+  uint worker_count() const { return n_workers; }
+
+  int run();
+
+  void scan(PARALLEL_WORKER *worker);
+
+  bool next_group();
+
+  void end_scan();
+};
+
+#endif /* SQL_PARALLEL_INCLUDED */
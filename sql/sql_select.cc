@@ -170,6 +170,8 @@ bool const_expression_in_where(COND *conds,Item *item, Item **comp_item);
 static int do_select(JOIN *join, Procedure *procedure);
 
 static enum_nested_loop_state evaluate_join_record(JOIN *, JOIN_TAB *, int);
+static enum_nested_loop_state sub_select_batched(JOIN *, JOIN_TAB *);
+static enum_nested_loop_state sub_select_parallel(JOIN *, JOIN_TAB *);
 static enum_nested_loop_state
 evaluate_null_complemented_join_record(JOIN *join, JOIN_TAB *join_tab);
 static enum_nested_loop_state
@@ -1507,6 +1509,85 @@ int JOIN::init_join_caches()
 }
 
 
+/*
+  Check if the aggregation of a table accepts the partial groups of a
+  parallel scan: it must look up the group of every record it gets, or
+  have a single group
+*/
+
+static bool accepts_partial_aggregates(JOIN *join, JOIN_TAB *tab)
+{
+  Next_select_func write_func= tab->next_select;
+
+  if (write_func == sub_select_postjoin_aggr)
+    write_func= (tab + 1)->aggr->get_write_func();
+  if (write_func == end_update || write_func == end_unique_update)
+    return TRUE;
+  return join->implicit_grouping &&
+         (write_func == end_send_group || write_func == end_write_group);
+}
+
+
+/**
+  Decide whether the table of a single-table aggregate query is scanned
+  in parallel
+
+  @details
+    This is done when the aggregation has been set up, and after the
+    attached conditions have got their final form.
+*/
+
+int JOIN::init_parallel_scan()
+{
+  JOIN_TAB *tab;
+
+  if (thd->variables.max_parallel_degree <= 1 ||
+      thd->lex->sql_command != SQLCOM_SELECT ||
+      table_count != const_tables + 1 || aggr_tables > 1 ||
+      !sum_funcs || !*sum_funcs)
+    return 0;
+
+  tab= first_linear_tab(this, WITHOUT_BUSH_ROOTS, WITHOUT_CONST_TABLES);
+  if (!tab || !accepts_partial_aggregates(this, tab))
+    return 0;
+  tab->parallel= JOIN_TAB_PARALLEL::create(this, tab);
+  return thd->is_fatal_error;
+}
+
+
+/**
+  Decide which tables are scanned in batches
+
+  @details
+    This is done after the join buffers have been set up, as the tables
+    read through a join buffer are not batched, and after the attached
+    conditions have got their final form. Tables scanned in parallel are
+    not batched either.
+*/
+
+int JOIN::init_join_batches()
+{
+  JOIN_TAB *tab;
+
+  if (!thd->variables.join_batch_size ||
+      thd->lex->sql_command == SQLCOM_UPDATE_MULTI ||
+      thd->lex->sql_command == SQLCOM_DELETE_MULTI)
+    return 0;
+
+  for (tab= first_linear_tab(this, WITH_BUSH_ROOTS, WITHOUT_CONST_TABLES);
+       tab;
+       tab= next_linear_tab(this, tab, WITH_BUSH_ROOTS))
+  {
+    if (tab->parallel)
+      continue;
+    tab->batch= JOIN_TAB_BATCH::create(tab);
+    if (thd->is_fatal_error)
+      return 1;
+  }
+  return 0;
+}
+
+
 /**
   global select optimisation.
 
@@ -2580,6 +2661,12 @@ int JOIN::optimize_stage2()
   if (init_join_caches())
     DBUG_RETURN(1);
 
+  if (init_parallel_scan())
+    DBUG_RETURN(1);
+
+  if (init_join_batches())
+    DBUG_RETURN(1);
+
   error= 0;
 
   if (select_options & SELECT_DESCRIBE)
@@ -7069,10 +7156,18 @@ best_access_path(JOIN      *join,
     We need also to check that:
     (1) s is inner table of semi-join -> join cache is allowed for semijoins
     (2) s is inner table of outer join -> join cache is allowed for outer joins
+    If the join buffer may be spilled into temporary files hash join is
+    considered at any join cache level when the records of the previous
+    tables do not fit into the join buffer.
   */  
   if (idx > join->const_tables && best_key == 0 &&
       (join->allowed_join_cache_types & JOIN_CACHE_HASHED_BIT) &&
-      join->max_allowed_join_cache_level > 2 &&
+      (join->max_allowed_join_cache_level > 2 ||
+       ((join->allowed_join_cache_types & JOIN_CACHE_SPILL_BIT) &&
+        join->max_allowed_join_cache_level > 0 &&
+        !s->emb_sj_nest && !s->table->s->blob_fields &&
+        (double) cache_record_length(join,idx) * record_count >
+        (double) thd->variables.join_buff_size)) &&
      !bitmap_is_clear_all(eq_join_set) &&  !disable_jbuf &&
       (!s->emb_sj_nest ||                     
        join->allowed_semijoin_with_cache) &&    // (1)
@@ -7084,13 +7179,29 @@ best_access_path(JOIN      *join,
     double rnd_records= matching_candidates_in_table(s, found_constraint,
                                                      use_cond_selectivity);
 
+    double refills;
+
     tmp= s->quick ? s->quick->read_time : s->scan_time();
     tmp+= (s->records - rnd_records)/(double) TIME_FOR_COMPARE;
 
-    /* We read the table as many times as join buffer becomes full. */
-    tmp*= (1.0 + floor((double) cache_record_length(join,idx) *
-                          record_count /
-                          (double) thd->variables.join_buff_size));
+    refills= floor((double) cache_record_length(join,idx) * record_count /
+                   (double) thd->variables.join_buff_size);
+    if (refills && (join->allowed_join_cache_types & JOIN_CACHE_SPILL_BIT) &&
+        !s->emb_sj_nest && !s->table->s->blob_fields)
+    {
+      /*
+        The table is read once, and the records of the join buffer and the
+        rows of the table are written into temporary files and read back.
+      */
+      tmp+= 2.0 * ((double) cache_record_length(join,idx) * record_count +
+                   (double) s->table->s->reclength * rnd_records) /
+            (double) IO_SIZE;
+    }
+    else
+    {
+      /* We read the table as many times as join buffer becomes full. */
+      tmp*= (1.0 + refills);
+    }
     best_time= tmp + 
                (record_count*join_sel) / TIME_FOR_COMPARE * rnd_records;
     best= tmp;
@@ -10455,7 +10566,9 @@ make_join_select(JOIN *join,SQL_SELECT *select,COND *cond)
              (join->allowed_join_cache_types & JOIN_CACHE_HASHED_BIT) &&
 	     ((join->max_allowed_join_cache_level+1)/2 == 2 ||
               ((join->max_allowed_join_cache_level+1)/2 > 2 &&
-	       is_hash_join_key_no(tab->ref.key))) &&
+	       is_hash_join_key_no(tab->ref.key)) ||
+              ((join->allowed_join_cache_types & JOIN_CACHE_SPILL_BIT) &&
+               is_hash_join_key_no(tab->ref.key))) &&
               (!tab->emb_sj_nest ||                     
                join->allowed_semijoin_with_cache) && 
               (!(tab->table->map & join->outer_join) ||
@@ -11411,6 +11524,9 @@ end_sj_materialize(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
     join_cache_level==7|8 then a JOIN_CACHE_BKAH object is employed. 
     If the value of join_cache_level is odd then creation of a non-linked 
     join cache is forced.
+    If the optimizer switch join_cache_spill is on and the optimizer has
+    chosen hash join for the table then a non-linked JOIN_CACHE_BNLH object
+    is employed also when join_cache_level==1|2.
 
     Currently for any join operation a join cache of the  level of the
     highest allowed and applicable level is used.
@@ -11620,6 +11736,24 @@ uint check_join_cache_usage(JOIN_TAB *tab,
   case JT_CONST:
   case JT_REF:
   case JT_EQ_REF:
+    if (cache_level <= 2 && tab->is_ref_for_hash_join() && !no_hashed_cache &&
+        (join->allowed_join_cache_types & JOIN_CACHE_SPILL_BIT) &&
+        !tab->is_nested_inner())
+    {
+      /*
+        Hash join has been chosen because the join buffer may be spilled.
+        Only an unlinked buffer can be spilled.
+      */
+      if (!tab->hash_join_is_possible() ||
+          tab->make_scan_filter())
+        goto no_join_cache;
+      if ((tab->cache= new (root) JOIN_CACHE_BNLH(join, tab, 0)))
+      {
+        tab->icp_other_tables_ok= FALSE;
+        return 3;
+      }
+      goto no_join_cache;
+    }
     if (cache_level <=2 || (no_hashed_cache && no_bka_cache))
       goto no_join_cache;
     if (tab->ref.is_access_triggered())
@@ -19224,7 +19358,19 @@ sub_select(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
   if (join_tab->loosescan_match_tab)
     join_tab->loosescan_match_tab->found_match= FALSE;
 
-  if (rc != NESTED_LOOP_NO_MORE_ROWS)
+  if (rc != NESTED_LOOP_NO_MORE_ROWS && join_tab->parallel &&
+      join_tab->parallel->start_scan())
+  {
+    /* Returns NESTED_LOOP_OK only when falling back to the usual scan */
+    rc= sub_select_parallel(join, join_tab);
+  }
+  else if (rc != NESTED_LOOP_NO_MORE_ROWS && join_tab->batch &&
+           join_tab->batch->start_scan(join_tab))
+  {
+    /* Never returns NESTED_LOOP_OK with the scan still to be continued */
+    rc= sub_select_batched(join, join_tab);
+  }
+  else if (rc != NESTED_LOOP_NO_MORE_ROWS)
   {
     error= (*join_tab->read_first_record)(join_tab);
     if (!error && join_tab->keep_current_rowid)
@@ -19280,6 +19426,149 @@ sub_select(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
   DBUG_RETURN(rc);
 }
 
+/**
+  @brief Scan a table in batches of records.
+
+  The records are read into the batch buffer of join_tab until it is full
+  or the scan ends. The batch predicates are evaluated over all of them,
+  and only the selected records are made current again one by one and
+  handed to evaluate_join_record(), which checks the complete attached
+  condition and passes the record to the next level of the nested loop.
+
+  @param  join     - The join object
+  @param  join_tab - The join_tab to scan; join_tab->batch is prepared
+                     for the scan
+
+  @return Nested loop state. NESTED_LOOP_NO_MORE_ROWS when the scan is
+          complete, NESTED_LOOP_OK when a return to an earlier table
+          was requested.
+*/
+
+static enum_nested_loop_state
+sub_select_batched(JOIN *join, JOIN_TAB *join_tab)
+{
+  JOIN_TAB_BATCH *batch= join_tab->batch;
+  TABLE *table= join_tab->table;
+  READ_RECORD *info= &join_tab->read_record;
+  THD *thd= join->thd;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  DBUG_ENTER("sub_select_batched");
+
+  int error= (*join_tab->read_first_record)(join_tab);
+
+  while (!error)
+  {
+    batch->reset();
+    do
+      batch->add_row();
+    while (!batch->is_full() && !(error= info->read_record()));
+
+    if (error > 0 || thd->is_error())
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    if (thd->check_killed())
+    {
+      thd->send_kill_message();
+      DBUG_RETURN(NESTED_LOOP_KILLED);
+    }
+
+    join_tab->tracker->r_batches++;
+    uint n_rows= batch->rows();
+    uint n_sel= batch->filter();
+    uint save_status= table->status;
+    uint k= 0;
+
+    for (uint i= 0; i < n_rows; i++)
+    {
+      if (k == n_sel || batch->selected(k) != i)
+      {
+        /* The record was discarded by the batch predicates */
+        join_tab->tracker->r_rows++;
+        join->join_examined_rows++;
+        thd->get_stmt_da()->inc_current_row_for_warning();
+        continue;
+      }
+      k++;
+      batch->restore_row(i);
+      table->status= 0;
+      rc= evaluate_join_record(join, join_tab, 0);
+      if (rc != NESTED_LOOP_OK || join->return_tab < join_tab)
+      {
+        table->status= save_status;
+        DBUG_RETURN(rc);
+      }
+    }
+    table->status= save_status;
+
+    /* Read the first record of the next batch */
+    if (!error)
+      error= info->read_record();
+  }
+
+  if (error > 0 || thd->is_error())
+    DBUG_RETURN(NESTED_LOOP_ERROR);
+  DBUG_RETURN(NESTED_LOOP_NO_MORE_ROWS);
+}
+
+/**
+  @brief Scan a table in parallel and pass on the partial groups.
+
+  The worker threads prepared by JOIN_TAB_PARALLEL::start_scan() read the
+  table and aggregate its records into partial groups. Each partial group
+  is then made current and handed to evaluate_join_record(), which passes
+  it on to the aggregation together with its partial aggregates.
+  When the workers give up, the table is read in the usual way.
+
+  @param  join     - The join object
+  @param  join_tab - The join_tab to scan; join_tab->parallel is prepared
+                     for the scan
+
+  @return Nested loop state. NESTED_LOOP_NO_MORE_ROWS when all the groups
+          were passed on, NESTED_LOOP_OK when a return to an earlier table
+          was requested, or when the table was positioned at its first
+          record for the usual scan.
+*/
+
+static enum_nested_loop_state
+sub_select_parallel(JOIN *join, JOIN_TAB *join_tab)
+{
+  JOIN_TAB_PARALLEL *parallel= join_tab->parallel;
+  TABLE *table= join_tab->table;
+  THD *thd= join->thd;
+  enum_nested_loop_state rc= NESTED_LOOP_NO_MORE_ROWS;
+  int res;
+  DBUG_ENTER("sub_select_parallel");
+
+  join_tab->tracker->r_workers+= parallel->worker_count();
+  if ((res= parallel->run()))
+  {
+    parallel->end_scan();
+    if (res > 0)
+    {
+      if (thd->check_killed())
+      {
+        thd->send_kill_message();
+        DBUG_RETURN(NESTED_LOOP_KILLED);
+      }
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    }
+    /* The partial groups were discarded: read the table in the usual way */
+    int error= (*join_tab->read_first_record)(join_tab);
+    DBUG_RETURN(evaluate_join_record(join, join_tab, error));
+  }
+
+  uint save_status= table->status;
+  while (rc == NESTED_LOOP_NO_MORE_ROWS && parallel->next_group())
+  {
+    table->status= 0;
+    rc= evaluate_join_record(join, join_tab, 0);
+    if (rc == NESTED_LOOP_OK && join->return_tab >= join_tab)
+      rc= NESTED_LOOP_NO_MORE_ROWS;
+  }
+  table->status= save_status;
+  parallel->end_scan();
+  DBUG_RETURN(rc);
+}
+
 /**
   @brief Process one row of the nested loop join.
 
@@ -25295,6 +25584,19 @@ bool JOIN_TAB::save_explain_data(Explain_table_access *eta,
       if (cache->save_explain_data(&eta->bka_type))
         return 1;
     }
+
+    if (batch)
+    {
+      eta->push_extra(ET_USING_BATCHED_EXECUTION);
+      eta->batch_rows= batch->max_rows;
+      eta->batch_conditions= batch->predicate_count();
+    }
+
+    if (parallel)
+    {
+      eta->push_extra(ET_USING_PARALLEL_AGGREGATION);
+      eta->parallel_degree= parallel->max_degree;
+    }
   }
 
   /* 
@@ -26239,7 +26541,9 @@ bool JOIN::change_result(select_result *new_result, select_result *old_result)
     bit 1 is set if tjoin buffers are allowed to be incremental
     bit 2 is set if the join buffers are allowed to be hashed
     but 3 is set if the join buffers are allowed to be used for BKA
-  join algorithms.
+  join algorithms
+    bit 4 is set if the hashed join buffers are allowed to be spilled into
+  temporary files.
   The allowed types are read from system variables.
   Besides the function sets maximum allowed join cache level that is
   also read from a system variable.
@@ -26254,6 +26558,8 @@ void JOIN::set_allowed_join_cache_types()
     allowed_join_cache_types|= JOIN_CACHE_HASHED_BIT;
   if (optimizer_flag(thd, OPTIMIZER_SWITCH_JOIN_CACHE_BKA))
     allowed_join_cache_types|= JOIN_CACHE_BKA_BIT;
+  if (optimizer_flag(thd, OPTIMIZER_SWITCH_JOIN_CACHE_SPILL))
+    allowed_join_cache_types|= JOIN_CACHE_SPILL_BIT;
   allowed_semijoin_with_cache=
     optimizer_flag(thd, OPTIMIZER_SWITCH_SEMIJOIN_WITH_CACHE);
   allowed_outer_join_with_cache=
@@ -233,6 +233,8 @@ Item *remove_pushed_top_conjuncts(THD *thd, Item *cond);
  *************************************************************************************/
 
 class JOIN_CACHE;
+class JOIN_TAB_BATCH;
+class JOIN_TAB_PARALLEL;
 class SJ_TMP_TABLE;
 class JOIN_TAB_RANGE;
 class AGGR_OP;
@@ -384,6 +386,17 @@ typedef struct st_join_table {
   uint          used_join_cache_level;
   ulong         join_buffer_size_limit;
   JOIN_CACHE	*cache;
+  /*
+    Non-NULL <=> the table is scanned in batches of records over which the
+    simple conjuncts of select_cond are evaluated first (see
+    sql_join_batch.h)
+  */
+  JOIN_TAB_BATCH *batch;
+  /*
+    Non-NULL <=> the table is scanned in parallel by several threads that
+    pass partial aggregates on to the aggregation (see sql_parallel.h)
+  */
+  JOIN_TAB_PARALLEL *parallel;
   /*
     Index condition for BKA access join
   */
@@ -660,6 +673,8 @@ typedef struct st_join_table {
 
 
 #include "sql_join_cache.h"
+#include "sql_join_batch.h"
+#include "sql_parallel.h"
 
 enum_nested_loop_state
 sub_select_cache(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
@@ -1027,6 +1042,8 @@ class AGGR_OP :public Sql_alloc
   {
     write_func= new_write_func;
   }
+  /** write_func getter */
+  Next_select_func get_write_func() const { return write_func; }
 
 private:
   /** Write function that would be used for saving records in tmp table. */
@@ -1593,6 +1610,8 @@ class JOIN :public Sql_alloc
   bool optimize_unflattened_subqueries();
   bool optimize_constant_subqueries();
   int init_join_caches();
+  int init_join_batches();
+  int init_parallel_scan();
   bool make_sum_func_list(List<Item> &all_fields, List<Item> &send_fields,
 			  bool before_group_by, bool recompute= FALSE);
 
@@ -1683,7 +1702,9 @@ class JOIN :public Sql_alloc
   bool is_allowed_hash_join_access()
   { 
     return MY_TEST(allowed_join_cache_types & JOIN_CACHE_HASHED_BIT) &&
-           max_allowed_join_cache_level > JOIN_CACHE_HASHED_BIT;
+           (max_allowed_join_cache_level > JOIN_CACHE_HASHED_BIT ||
+            (MY_TEST(allowed_join_cache_types & JOIN_CACHE_SPILL_BIT) &&
+             max_allowed_join_cache_level > 0));
   }
   /*
     Check if we need to create a temporary table.
@@ -2325,7 +2346,7 @@ Item_equal *find_item_equal(COND_EQUAL *cond_equal, Field *field,
 extern bool test_if_ref(Item *, 
                  Item_field *left_item,Item *right_item);
 
-inline bool optimizer_flag(THD *thd, uint flag)
+inline bool optimizer_flag(THD *thd, ulonglong flag)
 { 
   return (thd->variables.optimizer_switch & flag);
 }
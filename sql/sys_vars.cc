@@ -1154,6 +1154,15 @@ static Sys_var_ulong Sys_interactive_timeout(
        CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(1, LONG_TIMEOUT), DEFAULT(NET_WAIT_TIMEOUT), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_join_batch_size(
+       "join_batch_size",
+       "Number of records a table or range scan reads into a batch before "
+       "the simple conditions attached to the table are evaluated over the "
+       "whole batch. The batch is also limited by join_buffer_size. "
+       "0 disables batched execution",
+       SESSION_VAR(join_batch_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 65536), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_ulonglong Sys_join_buffer_size(
        "join_buffer_size",
        "The size of the buffer that is used for joins",
@@ -2220,6 +2229,15 @@ static Sys_var_ulong Sys_max_long_data_size(
        VALID_RANGE(1024, UINT_MAX32), DEFAULT(1024*1024),
        BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_max_parallel_degree(
+       "max_parallel_degree",
+       "Maximum number of threads that scan the table of a single-table "
+       "aggregate query in parallel. The table is split into ranges of an "
+       "index, and the partial aggregates of the threads are combined by "
+       "the usual GROUP BY processing. 1 disables parallel scans",
+       SESSION_VAR(max_parallel_degree), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 256), DEFAULT(1), BLOCK_SIZE(1));
+
 static PolyLock_mutex PLock_prepared_stmt_count(&LOCK_prepared_stmt_count);
 static Sys_var_ulong Sys_max_prepared_stmt_count(
        "max_prepared_stmt_count",
@@ -2242,6 +2260,14 @@ static Sys_var_ulong Sys_max_sort_length(
        SESSION_VAR(max_sort_length), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(4, 8192*1024L), DEFAULT(1024), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_max_sort_threads(
+       "max_sort_threads",
+       "Maximum number of threads that a sort which does not fit into "
+       "sort_buffer_size uses to sort and write its runs, and to merge them. "
+       "1 disables parallel sorting",
+       SESSION_VAR(max_sort_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 64), DEFAULT(1), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_max_sp_recursion_depth(
        "max_sp_recursion_depth",
        "Maximum stored procedure recursion depth",
@@ -2474,6 +2500,7 @@ export const char *optimizer_switch_names[]=
   "orderby_uses_equalities",
   "condition_pushdown_for_derived",
   "split_materialized",
+  "join_cache_spill",
   "default", 
   NullS
 };
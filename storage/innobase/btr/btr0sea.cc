@@ -77,6 +77,64 @@ UNIV_INTERN byte		btr_sea_pad2[CACHE_LINE_SIZE];
 /** The adaptive hash index */
 btr_search_sys_t*	btr_search_sys;
 
+/** Acquire an adaptive hash index partition latch in exclusive mode,
+counting the waits in btr_search_part_stat_t::n_latch_waits.
+NOTE! Use the corresponding macro btr_search_x_lock(), not directly
+this function!
+@param[in,out]	latch	the latch of the partition
+@param[in]	part	the partition number
+@param[in]	file	file name where the latch is acquired
+@param[in]	line	line where the latch is acquired */
+static inline
+void
+btr_search_x_lock_func(
+	rw_lock_t*	latch,
+	ulint		part,
+	const char*	file,
+	unsigned	line)
+{
+	ut_ad(latch == btr_search_latches[part]);
+
+	if (!DBUG_EVALUATE_IF("btr_search_latch_wait", false,
+			      rw_lock_x_lock_func_nowait_inline(
+				      latch, file, line))) {
+		my_atomic_addlint(
+			&btr_search_sys->part_stats[part].n_latch_waits, 1);
+		rw_lock_x_lock_inline(latch, 0, file, line);
+	}
+}
+
+/** Acquire an adaptive hash index partition latch in shared mode,
+counting the waits in btr_search_part_stat_t::n_latch_waits.
+NOTE! Use the corresponding macro btr_search_s_lock(), not directly
+this function!
+@param[in,out]	latch	the latch of the partition
+@param[in]	part	the partition number
+@param[in]	file	file name where the latch is acquired
+@param[in]	line	line where the latch is acquired */
+static inline
+void
+btr_search_s_lock_func(
+	rw_lock_t*	latch,
+	ulint		part,
+	const char*	file,
+	unsigned	line)
+{
+	ut_ad(latch == btr_search_latches[part]);
+
+	if (!DBUG_EVALUATE_IF("btr_search_latch_wait", false,
+			      rw_lock_s_lock_nowait(latch, file, line))) {
+		my_atomic_addlint(
+			&btr_search_sys->part_stats[part].n_latch_waits, 1);
+		rw_lock_s_lock_inline(latch, 0, file, line);
+	}
+}
+
+#define btr_search_x_lock(latch, part)				\
+	btr_search_x_lock_func(latch, part, __FILE__, __LINE__)
+#define btr_search_s_lock(latch, part)				\
+	btr_search_s_lock_func(latch, part, __FILE__, __LINE__)
+
 /** If the number of records on the page divided by this parameter
 would have been successfully accessed using a hash index, the index
 is then built on the page, assuming the global limit has been reached */
@@ -262,6 +320,11 @@ btr_search_sys_create(ulint hash_size)
 		btr_search_sys->hash_tables[i]->adaptive = TRUE;
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 	}
+
+	/* Step-3: Allocate the statistics counters of each part. */
+	btr_search_sys->part_stats = static_cast<btr_search_part_stat_t*>(
+		ut_zalloc(sizeof(btr_search_part_stat_t) * btr_ahi_parts,
+			  mem_key_ahi));
 }
 
 /** Resize hash index hash table.
@@ -317,6 +380,7 @@ btr_search_sys_free()
 	}
 
 	ut_free(btr_search_sys->hash_tables);
+	ut_free(btr_search_sys->part_stats);
 	ut_free(btr_search_sys);
 	btr_search_sys = NULL;
 
@@ -331,6 +395,22 @@ btr_search_sys_free()
 	btr_search_latches = NULL;
 }
 
+/** Get the number of times an adaptive hash index latch could not be
+acquired without waiting.
+@return sum of btr_search_part_stat_t::n_latch_waits of all partitions */
+ulint
+btr_search_latch_waits()
+{
+	ulint	n = 0;
+
+	for (ulint i = 0; i < btr_ahi_parts; ++i) {
+		n += my_atomic_loadlint(
+			&btr_search_sys->part_stats[i].n_latch_waits);
+	}
+
+	return(n);
+}
+
 /** Set index->ref_count = 0 on all indexes of a table.
 @param[in,out]	table	table handler */
 static
@@ -845,6 +925,10 @@ btr_search_failure(btr_search_t* info, btr_cur_t* cursor)
 {
 	cursor->flag = BTR_CUR_HASH_FAIL;
 
+	my_atomic_addlint(
+		&btr_search_sys->part_stats[
+			btr_get_search_part(cursor->index)].n_hash_fail, 1);
+
 #ifdef UNIV_SEARCH_PERF_STAT
 	++info->n_hash_fail;
 
@@ -934,10 +1018,12 @@ btr_search_guess_on_hash(
 	cursor->fold = fold;
 	cursor->flag = BTR_CUR_HASH;
 
-	rw_lock_t* use_latch = ahi_latch ? NULL : btr_get_search_latch(index);
+	const ulint	ahi_part = btr_get_search_part(index);
+	rw_lock_t*	use_latch = ahi_latch
+		? NULL : btr_search_latches[ahi_part];
 
 	if (use_latch) {
-		rw_lock_s_lock(use_latch);
+		btr_search_s_lock(use_latch, ahi_part);
 
 		if (!btr_search_enabled) {
 			goto fail;
@@ -1054,6 +1140,7 @@ btr_search_guess_on_hash(
 	meanwhile! Thus it might not be a bug. */
 #endif
 	info->last_hash_succ = TRUE;
+	my_atomic_addlint(&btr_search_sys->part_stats[ahi_part].n_hash_succ, 1);
 
 #ifdef UNIV_SEARCH_PERF_STAT
 	btr_search_n_succ++;
@@ -1232,7 +1319,7 @@ btr_search_drop_page_hash_index(buf_block_t* block)
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(latch);
+	btr_search_x_lock(latch, ahi_slot);
 
 	if (UNIV_UNLIKELY(!block->index)) {
 		/* Someone else has meanwhile dropped the hash index */
@@ -1486,7 +1573,7 @@ btr_search_build_page_hash_index(
 	btr_search_check_free_space_in_heap(index);
 
 	hash_table_t*	table	= btr_get_search_table(index);
-	rw_lock_x_lock(ahi_latch);
+	btr_search_x_lock(ahi_latch, btr_get_search_part(index));
 
 	if (!btr_search_enabled) {
 		goto exit_func;
@@ -1704,9 +1791,10 @@ btr_search_update_hash_on_delete(btr_cur_t* cursor)
 		mem_heap_free(heap);
 	}
 
-	rw_lock_t*	ahi_latch = btr_get_search_latch(index);
+	const ulint	ahi_part = btr_get_search_part(index);
+	rw_lock_t*	ahi_latch = btr_search_latches[ahi_part];
 
-	rw_lock_x_lock(ahi_latch);
+	btr_search_x_lock(ahi_latch, ahi_part);
 	assert_block_ahi_valid(block);
 
 	if (block->index) {
@@ -1763,7 +1851,7 @@ btr_search_update_hash_node_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 
 	ut_a(cursor->index == index);
 	ut_a(!dict_index_is_ibuf(index));
-	rw_lock_x_lock(ahi_latch);
+	btr_search_x_lock(ahi_latch, btr_get_search_part(index));
 
 	if (!block->index) {
 
@@ -1849,6 +1937,7 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 	btr_search_check_free_space_in_heap(index);
 
 	table = btr_get_search_table(index);
+	const ulint	ahi_part = btr_get_search_part(index);
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1885,7 +1974,7 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 	} else {
 		if (left_side) {
 			locked = true;
-			rw_lock_x_lock(ahi_latch);
+			btr_search_x_lock(ahi_latch, ahi_part);
 
 			if (!btr_search_enabled) {
 				goto function_exit;
@@ -1901,7 +1990,7 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 
 		if (!locked) {
 			locked = true;
-			rw_lock_x_lock(ahi_latch);
+			btr_search_x_lock(ahi_latch, ahi_part);
 
 			if (!btr_search_enabled) {
 				goto function_exit;
@@ -1921,7 +2010,7 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 		if (!left_side) {
 			if (!locked) {
 				locked = true;
-				rw_lock_x_lock(ahi_latch);
+				btr_search_x_lock(ahi_latch, ahi_part);
 
 				if (!btr_search_enabled) {
 					goto function_exit;
@@ -1938,7 +2027,7 @@ btr_search_update_hash_on_insert(btr_cur_t* cursor, rw_lock_t* ahi_latch)
 
 		if (!locked) {
 			locked = true;
-			rw_lock_x_lock(ahi_latch);
+			btr_search_x_lock(ahi_latch, ahi_part);
 
 			if (!btr_search_enabled) {
 				goto function_exit;
@@ -126,10 +126,100 @@ struct set_numa_interleave_t
 };
 
 #define NUMA_MEMPOLICY_INTERLEAVE_IN_SCOPE set_numa_interleave_t scoped_numa
+
+/** NUMA nodes that the buffer pool instances are bound to in turn;
+empty if innodb_buffer_pool_numa_bind=OFF */
+static std::vector<ulint>	buf_numa_nodes;
+/** NUMA node of each CPU; empty if innodb_buffer_pool_numa_bind=OFF */
+static std::vector<ulint>	buf_numa_cpu_node;
+
+/** Determine the NUMA nodes for innodb_buffer_pool_numa_bind. */
+static
+void
+buf_numa_init()
+{
+	buf_numa_nodes.clear();
+	buf_numa_cpu_node.clear();
+
+	if (!srv_buf_pool_numa_bind) {
+		return;
+	}
+
+	if (srv_numa_interleave) {
+		ib::warn() << "innodb_buffer_pool_numa_bind is ignored"
+			" because innodb_numa_interleave is set.";
+		srv_buf_pool_numa_bind = FALSE;
+		return;
+	}
+
+	if (numa_available() < 0) {
+		ib::warn() << "innodb_buffer_pool_numa_bind is ignored"
+			" because NUMA is not available.";
+		srv_buf_pool_numa_bind = FALSE;
+		return;
+	}
+
+	struct bitmask*	numa_mems_allowed = numa_get_mems_allowed();
+
+	for (int node = 0; node <= numa_max_node(); node++) {
+		if (numa_bitmask_isbitset(numa_mems_allowed, node)) {
+			buf_numa_nodes.push_back(ulint(node));
+		}
+	}
+
+	numa_bitmask_free(numa_mems_allowed);
+
+	for (int cpu = 0; cpu < numa_num_configured_cpus(); cpu++) {
+		int	node = numa_node_of_cpu(cpu);
+		buf_numa_cpu_node.push_back(node < 0
+					    ? ULINT_UNDEFINED : ulint(node));
+	}
+
+	if (buf_numa_nodes.empty()) {
+		ib::warn() << "innodb_buffer_pool_numa_bind is ignored"
+			" because no NUMA node is available.";
+		buf_numa_cpu_node.clear();
+		srv_buf_pool_numa_bind = FALSE;
+		return;
+	}
+
+	ib::info() << "Binding " << srv_buf_pool_instances
+		<< " buffer pool instance(s) to " << buf_numa_nodes.size()
+		<< " NUMA node(s).";
+}
+
+/** @return the NUMA node of the CPU the calling thread is running on,
+or ULINT_UNDEFINED if unknown */
+ulint
+buf_numa_node_of_current_cpu()
+{
+	int	cpu = sched_getcpu();
+
+	return(cpu >= 0 && ulint(cpu) < buf_numa_cpu_node.size()
+	       ? buf_numa_cpu_node[cpu] : ULINT_UNDEFINED);
+}
 #else
 #define NUMA_MEMPOLICY_INTERLEAVE_IN_SCOPE
 #endif /* HAVE_LIBNUMA */
 
+/** Note a page get from a buffer pool instance, counting the accesses
+from other NUMA nodes than the instance is bound to.
+@param[in,out]	buf_pool	buffer pool instance */
+static inline
+void
+buf_pool_note_page_get(
+	buf_pool_t*	buf_pool)
+{
+	buf_pool->stat.n_page_gets++;
+
+#ifdef HAVE_LIBNUMA
+	if (buf_pool->numa_node != ULINT_UNDEFINED
+	    && buf_numa_node_of_current_cpu() != buf_pool->numa_node) {
+		buf_pool->stat.n_page_gets_remote++;
+	}
+#endif /* HAVE_LIBNUMA */
+}
+
 #ifdef HAVE_SNAPPY
 #include "snappy-c.h"
 #endif
@@ -1573,6 +1663,21 @@ buf_chunk_init(
 				" buffer pool page frames to MPOL_INTERLEAVE"
 				" (error: " << strerror(errno) << ").";
 		}
+	} else if (buf_pool->numa_node != ULINT_UNDEFINED) {
+		struct bitmask*	numa_node_mask = numa_allocate_nodemask();
+		numa_bitmask_setbit(numa_node_mask,
+				    unsigned(buf_pool->numa_node));
+		int	st = mbind(chunk->mem, chunk->mem_size(),
+				   MPOL_PREFERRED,
+				   numa_node_mask->maskp,
+				   numa_node_mask->size,
+				   MPOL_MF_MOVE);
+		if (st != 0) {
+			ib::warn() << "Failed to bind buffer pool page frames"
+				" to NUMA node " << buf_pool->numa_node
+				<< " (error: " << strerror(errno) << ").";
+		}
+		numa_bitmask_free(numa_node_mask);
 	}
 #endif /* HAVE_LIBNUMA */
 
@@ -1896,6 +2001,10 @@ buf_pool_init_instance(
 		buf_pool->no_flush[i] = os_event_create(0);
 	}
 
+	buf_pool->flush_io_depth = srv_flush_io_depth;
+	buf_pool->flush_io_wait = ULINT_UNDEFINED;
+	buf_pool->flush_io_event = os_event_create(0);
+
 	buf_pool->watch = (buf_page_t*) ut_zalloc_nokey(
 		sizeof(*buf_pool->watch) * BUF_POOL_WATCH_SIZE);
 	for (i = 0; i < BUF_POOL_WATCH_SIZE; i++) {
@@ -2002,6 +2111,8 @@ buf_pool_free_instance(
 		os_event_destroy(buf_pool->no_flush[i]);
 	}
 
+	os_event_destroy(buf_pool->flush_io_event);
+
 	ut_free(buf_pool->chunks);
 	ha_clear(buf_pool->page_hash);
 	hash_table_free(buf_pool->page_hash);
@@ -2030,6 +2141,29 @@ buf_pool_free_instance(
 	buf_pool->allocator.~ut_allocator();
 }
 
+/** Register the memory of all buffer pool chunks for asynchronous I/O. */
+static
+void
+buf_pool_register_chunks()
+{
+	std::vector<byte*>	mem;
+	std::vector<ulint>	len;
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		const buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		const buf_chunk_t*	chunk = buf_pool->chunks;
+
+		for (ulint n = buf_pool->n_chunks; n--; chunk++) {
+			mem.push_back(chunk->mem);
+			len.push_back(chunk->mem_size());
+		}
+	}
+
+	if (!mem.empty()) {
+		os_aio_register_buffers(&mem[0], &len[0], mem.size());
+	}
+}
+
 /********************************************************************//**
 Creates the buffer pool.
 @return DB_SUCCESS if success, DB_ERROR if not enough memory or error */
@@ -2057,9 +2191,21 @@ buf_pool_init(
 
 	buf_chunk_map_reg = UT_NEW_NOKEY(buf_pool_chunk_map_t());
 
+#ifdef HAVE_LIBNUMA
+	buf_numa_init();
+#endif /* HAVE_LIBNUMA */
+
 	for (i = 0; i < n_instances; i++) {
 		buf_pool_t*	ptr	= &buf_pool_ptr[i];
 
+		ptr->numa_node = ULINT_UNDEFINED;
+#ifdef HAVE_LIBNUMA
+		if (!buf_numa_nodes.empty()) {
+			ptr->numa_node = buf_numa_nodes[
+				i % buf_numa_nodes.size()];
+		}
+#endif /* HAVE_LIBNUMA */
+
 		if (buf_pool_init_instance(ptr, size, i) != DB_SUCCESS) {
 
 			/* Free all the instances created so far. */
@@ -2076,6 +2222,8 @@ buf_pool_init(
 
 	btr_search_sys_create(buf_pool_get_curr_size() / sizeof(void*) / 64);
 
+	buf_pool_register_chunks();
+
 	return(DB_SUCCESS);
 }
 
@@ -2823,6 +2971,9 @@ buf_pool_resize()
 		return;
 	}
 
+	/* The chunks may be freed or reallocated below. */
+	os_aio_unregister_buffers();
+
 	/* Indicate critical path */
 	buf_pool_resizing = true;
 
@@ -3050,6 +3201,8 @@ buf_pool_resize()
 
 	buf_pool_resizing = false;
 
+	buf_pool_register_chunks();
+
 	/* Normalize other components, if the new size is too different */
 	if (!warning && new_size_too_diff) {
 		srv_buf_pool_base_size = srv_buf_pool_size;
@@ -3770,7 +3923,7 @@ buf_page_get_zip(
 	ibool		must_read;
 	buf_pool_t*	buf_pool = buf_pool_get(page_id);
 
-	buf_pool->stat.n_page_gets++;
+	buf_pool_note_page_get(buf_pool);
 
 	for (;;) {
 lookup:
@@ -4268,7 +4421,7 @@ buf_page_get_gen(
 	ut_ad(!mtr || !ibuf_inside(mtr)
 	      || ibuf_page_low(page_id, page_size, FALSE, file, line, NULL));
 
-	buf_pool->stat.n_page_gets++;
+	buf_pool_note_page_get(buf_pool);
 	hash_lock = buf_page_hash_lock_get(buf_pool, page_id);
 loop:
 	block = guess;
@@ -4987,7 +5140,7 @@ buf_page_optimistic_get(
 #endif /* UNIV_IBUF_COUNT_DEBUG */
 
 	buf_pool = buf_pool_from_block(block);
-	buf_pool->stat.n_page_gets++;
+	buf_pool_note_page_get(buf_pool);
 
 	return(TRUE);
 }
@@ -5095,7 +5248,7 @@ buf_page_get_known_nowait(
 #ifdef UNIV_IBUF_COUNT_DEBUG
 	ut_a((mode == BUF_KEEP_OLD) || ibuf_count_get(block->page.id) == 0);
 #endif
-	buf_pool->stat.n_page_gets++;
+	buf_pool_note_page_get(buf_pool);
 
 	return(TRUE);
 }
@@ -5182,7 +5335,7 @@ buf_page_try_get_func(
 
 	buf_block_dbg_add_level(block, SYNC_NO_ORDER_CHECK);
 
-	buf_pool->stat.n_page_gets++;
+	buf_pool_note_page_get(buf_pool);
 
 #ifdef UNIV_IBUF_COUNT_DEBUG
 	ut_a(ibuf_count_get(block->page.id) == 0);
@@ -6901,6 +7054,13 @@ buf_stats_aggregate_pool_info(
 	total_info->io_cur += pool_info->io_cur;
 	total_info->unzip_sum += pool_info->unzip_sum;
 	total_info->unzip_cur += pool_info->unzip_cur;
+	total_info->numa_node = ULINT_UNDEFINED;
+	total_info->n_page_gets_remote += pool_info->n_page_gets_remote;
+	total_info->flush_io_depth += pool_info->flush_io_depth;
+	total_info->flush_io_latency = ut_max(total_info->flush_io_latency,
+					      pool_info->flush_io_latency);
+	total_info->flush_rate += pool_info->flush_rate;
+	total_info->flush_stall_time += pool_info->flush_stall_time;
 }
 /*******************************************************************//**
 Collect buffer pool stats information for a buffer pool. Also
@@ -6971,6 +7131,15 @@ buf_stats_get_pool_info(
 
 	pool_info->n_page_gets = buf_pool->stat.n_page_gets;
 
+	pool_info->numa_node = buf_pool->numa_node;
+
+	pool_info->n_page_gets_remote = buf_pool->stat.n_page_gets_remote;
+
+	pool_info->flush_io_depth = buf_pool->flush_io_depth;
+	pool_info->flush_io_latency = buf_pool->flush_io_latency;
+	pool_info->flush_rate = buf_pool->flush_rate;
+	pool_info->flush_stall_time = buf_pool->stat.flush_stall_time;
+
 	pool_info->n_ra_pages_read_rnd = buf_pool->stat.n_ra_pages_read_rnd;
 	pool_info->n_ra_pages_read = buf_pool->stat.n_ra_pages_read;
 
@@ -7112,6 +7281,30 @@ buf_print_io_instance(
 		      file);
 	}
 
+	if (srv_buf_pool_numa_bind) {
+		if (pool_info->numa_node != ULINT_UNDEFINED) {
+			fprintf(file, "NUMA node " ULINTPF ", ",
+				pool_info->numa_node);
+		}
+
+		fprintf(file,
+			"Page gets " ULINTPF ", from remote NUMA nodes "
+			ULINTPF "\n",
+			pool_info->n_page_gets,
+			pool_info->n_page_gets_remote);
+	}
+
+	if (srv_flush_io_depth) {
+		fprintf(file,
+			"Flush rate " ULINTPF "/s, I/O depth " ULINTPF
+			", write latency " ULINTPF " us,"
+			" stall time " UINT64PF " ms\n",
+			pool_info->flush_rate,
+			pool_info->flush_io_depth,
+			pool_info->flush_io_latency,
+			pool_info->flush_stall_time / 1000);
+	}
+
 	/* Statistics about read ahead algorithm */
 	fprintf(file, "Pages read ahead %.2f/s,"
 		" evicted without access %.2f/s,"
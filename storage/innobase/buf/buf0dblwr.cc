@@ -134,11 +134,35 @@ buf_dblwr_init(
 
 	mutex_create(LATCH_ID_BUF_DBLWR, &buf_dblwr->mutex);
 
-	buf_dblwr->b_event = os_event_create("dblwr_batch_event");
 	buf_dblwr->s_event = os_event_create("dblwr_single_event");
-	buf_dblwr->first_free = 0;
 	buf_dblwr->s_reserved = 0;
-	buf_dblwr->b_reserved = 0;
+
+	/* By default, use one segment per page cleaner thread. The
+	buffer pool instances are mapped to the segments in turn. */
+	ulint	n_segments = srv_doublewrite_segments
+		? srv_doublewrite_segments
+		: srv_n_page_cleaners;
+
+	n_segments = ut_min(n_segments, ulint(srv_buf_pool_instances));
+	n_segments = ut_min(n_segments, ulint(srv_doublewrite_batch_size));
+	n_segments = ut_max(n_segments, ulint(1));
+
+	buf_dblwr->n_segments = n_segments;
+	buf_dblwr->segments = static_cast<buf_dblwr_segment_t*>(
+		ut_zalloc_nokey(n_segments * sizeof *buf_dblwr->segments));
+
+	for (ulint i = 0, first = 0; i < n_segments; i++) {
+		buf_dblwr_segment_t*	seg = &buf_dblwr->segments[i];
+
+		mutex_create(LATCH_ID_BUF_DBLWR, &seg->mutex);
+		seg->b_event = os_event_create("dblwr_batch_event");
+		seg->first = first;
+		seg->size = (srv_doublewrite_batch_size + i) / n_segments;
+		first += seg->size;
+
+		ut_ad(i + 1 < n_segments
+		      || first == srv_doublewrite_batch_size);
+	}
 
 	buf_dblwr->block1 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
@@ -695,9 +719,18 @@ buf_dblwr_free()
 	/* Free the double write data structures. */
 	ut_a(buf_dblwr != NULL);
 	ut_ad(buf_dblwr->s_reserved == 0);
-	ut_ad(buf_dblwr->b_reserved == 0);
 
-	os_event_destroy(buf_dblwr->b_event);
+	for (ulint i = 0; i < buf_dblwr->n_segments; i++) {
+		buf_dblwr_segment_t*	seg = &buf_dblwr->segments[i];
+
+		ut_ad(seg->b_reserved == 0);
+		os_event_destroy(seg->b_event);
+		mutex_free(&seg->mutex);
+	}
+
+	ut_free(buf_dblwr->segments);
+	buf_dblwr->segments = NULL;
+
 	os_event_destroy(buf_dblwr->s_event);
 	ut_free(buf_dblwr->write_buf_unaligned);
 	buf_dblwr->write_buf_unaligned = NULL;
@@ -713,6 +746,32 @@ buf_dblwr_free()
 	buf_dblwr = NULL;
 }
 
+/** Count the doublewrite segments that batches have been written from.
+@return number of segments with at least one batch written */
+ulint
+buf_dblwr_n_segments_written()
+{
+	ulint	n = 0;
+
+	for (ulint i = 0; i < buf_dblwr->n_segments; i++) {
+		n += buf_dblwr->segments[i].n_writes > 0;
+	}
+
+	return(n);
+}
+
+/** Get the doublewrite segment that a buffer pool instance uses for
+batch flushing.
+@param[in]	buf_pool	buffer pool instance
+@return the doublewrite segment */
+static inline
+buf_dblwr_segment_t*
+buf_dblwr_get_segment(const buf_pool_t* buf_pool)
+{
+	return(&buf_dblwr->segments[buf_pool->instance_no
+				    % buf_dblwr->n_segments]);
+}
+
 /********************************************************************//**
 Updates the doublewrite buffer when an IO request is completed. */
 void
@@ -729,28 +788,33 @@ buf_dblwr_update(
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
-		mutex_enter(&buf_dblwr->mutex);
+		{
+			buf_dblwr_segment_t*	seg = buf_dblwr_get_segment(
+				buf_pool_from_bpage(bpage));
 
-		ut_ad(buf_dblwr->batch_running);
-		ut_ad(buf_dblwr->b_reserved > 0);
-		ut_ad(buf_dblwr->b_reserved <= buf_dblwr->first_free);
+			mutex_enter(&seg->mutex);
 
-		buf_dblwr->b_reserved--;
+			ut_ad(seg->batch_running);
+			ut_ad(seg->b_reserved > 0);
+			ut_ad(seg->b_reserved <= seg->first_free);
 
-		if (buf_dblwr->b_reserved == 0) {
-			mutex_exit(&buf_dblwr->mutex);
-			/* This will finish the batch. Sync data files
-			to the disk. */
-			fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
-			mutex_enter(&buf_dblwr->mutex);
+			seg->b_reserved--;
 
-			/* We can now reuse the doublewrite memory buffer: */
-			buf_dblwr->first_free = 0;
-			buf_dblwr->batch_running = false;
-			os_event_set(buf_dblwr->b_event);
-		}
+			if (seg->b_reserved == 0) {
+				mutex_exit(&seg->mutex);
+				/* This will finish the batch. Sync data
+				files to the disk. */
+				fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
+				mutex_enter(&seg->mutex);
 
-		mutex_exit(&buf_dblwr->mutex);
+				/* We can now reuse the segment: */
+				seg->first_free = 0;
+				seg->batch_running = false;
+				os_event_set(seg->b_event);
+			}
+
+			mutex_exit(&seg->mutex);
+		}
 		break;
 	case BUF_FLUSH_SINGLE_PAGE:
 		{
@@ -935,39 +999,59 @@ buf_dblwr_write_block_to_datafile(
 	}
 }
 
-/********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+/** Write slots of the doublewrite memory buffer to the doublewrite
+buffer on disk, using synchronous IO.
+@param[in]	first	first slot to write
+@param[in]	n	number of slots to write */
+static
 void
-buf_dblwr_flush_buffered_writes()
+buf_dblwr_write_slots(ulint first, ulint n)
 {
-	byte*		write_buf;
-	ulint		first_free;
-	ulint		len;
+	while (n > 0) {
+		ulint	page_no;
+		ulint	len;
 
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
-		/* Sync the writes to the disk. */
-		buf_dblwr_sync_datafiles();
-		/* Now we flush the data to disk (for example, with fsync) */
-		fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
-		return;
+		if (first < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+			page_no = buf_dblwr->block1 + first;
+			len = ut_min(n, TRX_SYS_DOUBLEWRITE_BLOCK_SIZE - first);
+		} else {
+			page_no = buf_dblwr->block2 + first
+				- TRX_SYS_DOUBLEWRITE_BLOCK_SIZE;
+			len = n;
+		}
+
+		fil_io(IORequestWrite, true,
+		       page_id_t(TRX_SYS_SPACE, page_no), univ_page_size,
+		       0, len * UNIV_PAGE_SIZE,
+		       (void*) (buf_dblwr->write_buf + first * UNIV_PAGE_SIZE),
+		       NULL);
+
+		first += len;
+		n -= len;
 	}
+}
+
+/** Flush the buffered writes from a doublewrite segment to disk, and
+post the writes to the data files.
+@param[in,out]	seg	doublewrite segment */
+static
+void
+buf_dblwr_flush_segment(buf_dblwr_segment_t* seg)
+{
+	ulint		first_free;
 
 	ut_ad(!srv_read_only_mode);
 
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&seg->mutex);
 
 	/* Write first to doublewrite buffer blocks. We use synchronous
 	aio and thus know that file write has been completed when the
 	control returns. */
 
-	if (buf_dblwr->first_free == 0) {
+	if (seg->first_free == 0) {
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&seg->mutex);
 
 		/* Wake possible simulated aio thread as there could be
 		system temporary tablespace pages active for flushing.
@@ -978,38 +1062,38 @@ buf_dblwr_flush_buffered_writes()
 		return;
 	}
 
-	if (buf_dblwr->batch_running) {
+	if (seg->batch_running) {
 		/* Another thread is running the batch right now. Wait
 		for it to finish. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		int64_t	sig_count = os_event_reset(seg->b_event);
+		mutex_exit(&seg->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(seg->b_event, sig_count);
 		goto try_again;
 	}
 
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
+	ut_ad(seg->first_free == seg->b_reserved);
 
-	/* Disallow anyone else to post to doublewrite buffer or to
-	start another batch of flushing. */
-	buf_dblwr->batch_running = true;
-	first_free = buf_dblwr->first_free;
+	/* Disallow anyone else to post to this doublewrite segment or to
+	start another batch of flushing from it. */
+	seg->batch_running = true;
+	first_free = seg->first_free;
 
 	/* Now safe to release the mutex. Note that though no other
 	thread is allowed to post to the doublewrite batch flushing
-	but any threads working on single page flushes are allowed
-	to proceed. */
-	mutex_exit(&buf_dblwr->mutex);
+	of this segment, any threads working on single page flushes
+	or on other segments are allowed to proceed. */
+	mutex_exit(&seg->mutex);
 
-	write_buf = buf_dblwr->write_buf;
+	byte*	write_buf = buf_dblwr->write_buf + seg->first * UNIV_PAGE_SIZE;
 
 	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
+	     i < first_free;
 	     len2 += UNIV_PAGE_SIZE, i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
+		block = (buf_block_t*) buf_dblwr->buf_block_arr[seg->first + i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -1027,34 +1111,14 @@ buf_dblwr_flush_buffered_writes()
 		buf_dblwr_check_page_lsn(write_buf + len2);
 	}
 
-	/* Write out the first block of the doublewrite buffer */
-	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     buf_dblwr->first_free) * UNIV_PAGE_SIZE;
-
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block1), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
-
-	if (buf_dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		/* No unwritten pages in the second block. */
-		goto flush;
-	}
-
-	/* Write out the second block of the doublewrite buffer. */
-	len = (buf_dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-	       * UNIV_PAGE_SIZE;
+	/* Write out the slots of the segment, which may span both
+	blocks of the doublewrite buffer. */
+	buf_dblwr_write_slots(seg->first, first_free);
 
-	write_buf = buf_dblwr->write_buf
-		    + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
-
-	fil_io(IORequestWrite, true,
-	       page_id_t(TRX_SYS_SPACE, buf_dblwr->block2), univ_page_size,
-	       0, len, (void*) write_buf, NULL);
-
-flush:
 	/* increment the doublewrite flushed pages counter */
-	srv_stats.dblwr_pages_written.add(buf_dblwr->first_free);
+	srv_stats.dblwr_pages_written.add(first_free);
 	srv_stats.dblwr_writes.inc();
+	seg->n_writes++;
 
 	/* Now flush the doublewrite buffer data to disk */
 	fil_flush(TRX_SYS_SPACE);
@@ -1063,21 +1127,21 @@ buf_dblwr_flush_buffered_writes()
 	and in recovery we will find them in the doublewrite buffer
 	blocks. Next do the writes to the intended positions. */
 
-	/* Up to this point first_free and buf_dblwr->first_free are
-	same because we have set the buf_dblwr->batch_running flag
+	/* Up to this point first_free and seg->first_free are
+	same because we have set the seg->batch_running flag
 	disallowing any other thread to post any request but we
-	can't safely access buf_dblwr->first_free in the loop below.
+	can't safely access seg->first_free in the loop below.
 	This is so because it is possible that after we are done with
 	the last iteration and before we terminate the loop, the batch
 	gets finished in the IO helper thread and another thread posts
-	a new batch setting buf_dblwr->first_free to a higher value.
-	If this happens and we are using buf_dblwr->first_free in the
+	a new batch setting seg->first_free to a higher value.
+	If this happens and we are using seg->first_free in the
 	loop termination condition then we'll end up dispatching
 	the same block twice from two different threads. */
-	ut_ad(first_free == buf_dblwr->first_free);
+	ut_ad(first_free == seg->first_free);
 	for (ulint i = 0; i < first_free; i++) {
 		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+			buf_dblwr->buf_block_arr[seg->first + i], false);
 	}
 
 	/* Wake possible simulated aio thread to actually post the
@@ -1087,6 +1151,44 @@ buf_dblwr_flush_buffered_writes()
 	os_aio_simulated_wake_handler_threads();
 }
 
+/********************************************************************//**
+Flushes possible buffered writes from the doublewrite memory buffer to disk,
+and also wakes up the aio thread if simulated aio is used. It is very
+important to call this function after a batch of writes has been posted,
+and also when we may have to wait for a page latch! Otherwise a deadlock
+of threads can occur. */
+void
+buf_dblwr_flush_buffered_writes()
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		/* Now we flush the data to disk (for example, with fsync) */
+		fil_flush_file_spaces(FIL_TYPE_TABLESPACE);
+		return;
+	}
+
+	for (ulint i = 0; i < buf_dblwr->n_segments; i++) {
+		buf_dblwr_flush_segment(&buf_dblwr->segments[i]);
+	}
+}
+
+/** Flush the buffered writes from the doublewrite segment that a buffer
+pool instance uses for batch flushing, and wake up the aio thread if
+simulated aio is used. This must be called after a batch of writes has
+been posted by the instance.
+@param[in]	buf_pool	buffer pool instance */
+void
+buf_dblwr_flush_buffered_writes(const buf_pool_t* buf_pool)
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		buf_dblwr_flush_buffered_writes();
+		return;
+	}
+
+	buf_dblwr_flush_segment(buf_dblwr_get_segment(buf_pool));
+}
+
 /********************************************************************//**
 Posts a buffer page for writing. If the doublewrite memory buffer is
 full, calls buf_dblwr_flush_buffered_writes and waits for for free
@@ -1098,36 +1200,39 @@ buf_dblwr_add_to_batch(
 {
 	ut_a(buf_page_in_file(bpage));
 
+	buf_dblwr_segment_t*	seg = buf_dblwr_get_segment(
+		buf_pool_from_bpage(bpage));
+
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&seg->mutex);
 
-	ut_a(buf_dblwr->first_free <= srv_doublewrite_batch_size);
+	ut_a(seg->first_free <= seg->size);
 
-	if (buf_dblwr->batch_running) {
+	if (seg->batch_running) {
 
-		/* This not nearly as bad as it looks. There is only
-		page_cleaner thread which does background flushing
-		in batches therefore it is unlikely to be a contention
-		point. The only exception is when a user thread is
-		forced to do a flush batch because of a sync
-		checkpoint. */
-		int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		/* This not nearly as bad as it looks. Each page cleaner
+		thread usually flushes a different buffer pool instance,
+		which is mapped to its own segment, therefore it is
+		unlikely to be a contention point. The only exception is
+		when a user thread is forced to do a flush batch because
+		of a sync checkpoint. */
+		int64_t	sig_count = os_event_reset(seg->b_event);
+		mutex_exit(&seg->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(seg->b_event, sig_count);
 		goto try_again;
 	}
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (seg->first_free == seg->size) {
+		mutex_exit(&seg->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_segment(seg);
 
 		goto try_again;
 	}
 
 	byte*	p = buf_dblwr->write_buf
-		+ univ_page_size.physical() * buf_dblwr->first_free;
+		+ univ_page_size.physical() * (seg->first + seg->first_free);
 
 	/* We request frame here to get correct buffer in case of
 	encryption and/or page compression */
@@ -1150,24 +1255,24 @@ buf_dblwr_add_to_batch(
 		memcpy(p, frame, bpage->size.logical());
 	}
 
-	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
+	buf_dblwr->buf_block_arr[seg->first + seg->first_free] = bpage;
 
-	buf_dblwr->first_free++;
-	buf_dblwr->b_reserved++;
+	seg->first_free++;
+	seg->b_reserved++;
 
-	ut_ad(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
-	ut_ad(buf_dblwr->b_reserved <= srv_doublewrite_batch_size);
+	ut_ad(!seg->batch_running);
+	ut_ad(seg->first_free == seg->b_reserved);
+	ut_ad(seg->b_reserved <= seg->size);
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (seg->first_free == seg->size) {
+		mutex_exit(&seg->mutex);
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_segment(seg);
 
 		return;
 	}
 
-	mutex_exit(&(buf_dblwr->mutex));
+	mutex_exit(&seg->mutex);
 }
 
 /********************************************************************//**
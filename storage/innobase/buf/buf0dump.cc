@@ -32,8 +32,10 @@ Created April 08, 2011 Vasil Dimov
 
 #include "univ.i"
 
+#include "btr0btr.h"
 #include "buf0buf.h"
 #include "buf0dump.h"
+#include "buf0rea.h"
 #include "dict0dict.h"
 #include "os0file.h"
 #include "os0thread.h"
@@ -60,16 +62,67 @@ static volatile bool	buf_load_should_start;
 
 static ibool	buf_load_abort_flag = FALSE;
 
+/** Whether the buffer pool load at startup has reached
+innodb_buffer_pool_load_warm_pct, or has ended */
+static volatile bool	buf_load_warm;
+
+/** Number of hotness levels assigned to pages by their position in the
+LRU list. Non-leaf B-tree pages are hotter than any of these. */
+static const ulint	BUF_DUMP_HOT_LRU = 8;
+
+/** Number of dump entries that a buffer pool load thread claims at
+a time */
+static const ulint	BUF_LOAD_BATCH = 64;
+
 /* Used to temporary store dump info in order to avoid IO while holding
 buffer pool mutex during dump and also to sort the contents of the dump
-before reading the pages from disk during load.
-We store the space id in the high 32 bits and page no in low 32 bits. */
-typedef ib_uint64_t	buf_dump_t;
+before reading the pages from disk during load. */
+struct buf_dump_t {
+	/** tablespace identifier */
+	uint32_t	space;
+	/** page number */
+	uint32_t	page_no;
+	/** hotness of the page; see buf_dump_hotness() */
+	uint32_t	hot;
+
+	/** Order of loading: the hottest pages first, and pages of
+	the same hotness in file order. */
+	bool operator<(const buf_dump_t& other) const
+	{
+		if (hot != other.hot) {
+			return(hot > other.hot);
+		}
 
-/* Aux macros to create buf_dump_t and to extract space and page from it */
-#define BUF_DUMP_CREATE(space, page)	ut_ull_create(space, page)
-#define BUF_DUMP_SPACE(a)		((ulint) ((a) >> 32))
-#define BUF_DUMP_PAGE(a)		((ulint) ((a) & 0xFFFFFFFFUL))
+		if (space != other.space) {
+			return(space < other.space);
+		}
+
+		return(page_no < other.page_no);
+	}
+};
+
+/** State of a buffer pool load */
+struct buf_load_t {
+	/** the dump entries, in the order of loading */
+	const buf_dump_t*	dump;
+	/** number of dump entries */
+	ulint			n;
+	/** first entry of the next unclaimed batch */
+	ulint			next;
+	/** number of processed entries */
+	ulint			n_done;
+	/** n_done at which the buffer pool is considered warm */
+	ulint			n_warm;
+	/** number of load threads, including the buf_dump_thread */
+	ulint			n_threads;
+	/** maximum number of pending asynchronous reads per thread,
+	or 1 for synchronous reads */
+	ulint			io_depth;
+	/** number of started load threads that are still running */
+	ulint			n_running;
+	/** signalled when a started load thread exits */
+	os_event_t		done;
+};
 
 /*****************************************************************//**
 Wakes up the buffer pool dump/load thread and instructs it to start
@@ -245,6 +298,39 @@ buf_dump_generate_path(
 	}
 }
 
+/** Determine the hotness of a page for buffer pool dump.
+The root and other non-leaf pages of B-trees are the hottest, and they
+are loaded first. The rest of the pages are ranked by their position
+in the LRU list.
+@param[in]	bpage	page in the LRU list
+@param[in]	pos	position of bpage in the LRU list
+@param[in]	n_pages	number of pages to dump from the LRU list
+@return hotness, the higher the hotter */
+static
+ulint
+buf_dump_hotness(const buf_page_t* bpage, ulint pos, ulint n_pages)
+{
+	const byte*	frame = buf_page_get_state(bpage)
+		== BUF_BLOCK_FILE_PAGE
+		? reinterpret_cast<const buf_block_t*>(bpage)->frame
+		: bpage->zip.data;
+
+	/* The page is not latched. A stale level is harmless. */
+	if (frame != NULL) {
+		switch (fil_page_get_type(frame)) {
+		case FIL_PAGE_INDEX:
+		case FIL_PAGE_TYPE_INSTANT:
+		case FIL_PAGE_RTREE:
+			if (ulint level = btr_page_get_level(frame)) {
+				return(BUF_DUMP_HOT_LRU + level);
+			}
+		}
+	}
+
+	/* The LRU list starts from the most recently used page. */
+	return(BUF_DUMP_HOT_LRU - 1 - pos * BUF_DUMP_HOT_LRU / n_pages);
+}
+
 /*****************************************************************//**
 Perform a buffer pool dump into the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -351,8 +437,10 @@ buf_dump(
 
 			ut_a(buf_page_in_file(bpage));
 
-			dump[j] = BUF_DUMP_CREATE(bpage->id.space(),
-						  bpage->id.page_no());
+			dump[j].space = uint32_t(bpage->id.space());
+			dump[j].page_no = uint32_t(bpage->id.page_no());
+			dump[j].hot = uint32_t(
+				buf_dump_hotness(bpage, j, n_pages));
 		}
 
 		ut_a(j == n_pages);
@@ -360,9 +448,10 @@ buf_dump(
 		buf_pool_mutex_exit(buf_pool);
 
 		for (j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
-			ret = fprintf(f, ULINTPF "," ULINTPF "\n",
-				      BUF_DUMP_SPACE(dump[j]),
-				      BUF_DUMP_PAGE(dump[j]));
+			ret = fprintf(f, ULINTPF "," ULINTPF "," ULINTPF "\n",
+				      ulint(dump[j].space),
+				      ulint(dump[j].page_no),
+				      ulint(dump[j].hot));
 			if (ret < 0) {
 				ut_free(dump);
 				fclose(f);
@@ -433,10 +522,12 @@ buf_load_throttle_if_needed(
 					throttling is needed, we do the check
 					every srv_io_capacity IO ops. */
 	ulint*	last_activity_count,
-	ulint	n_io)			/*!< in: number of IO ops done since
+	ulint	n_io,			/*!< in: number of IO ops done since
 					buffer pool load has started */
+	ulint	io_capacity)		/*!< in: IO ops per second allowed
+					for this thread */
 {
-	if (n_io % srv_io_capacity < srv_io_capacity - 1) {
+	if (n_io % io_capacity < io_capacity - 1) {
 		return;
 	}
 
@@ -446,7 +537,7 @@ buf_load_throttle_if_needed(
 		return;
 	}
 
-	/* srv_io_capacity IO operations have been performed by buffer pool
+	/* io_capacity IO operations have been performed by buffer pool
 	load since the last time we were here. */
 
 	/* If no other activity, then keep going without any delay. */
@@ -486,12 +577,192 @@ buf_load_throttle_if_needed(
 	*last_activity_count = srv_get_activity_count();
 }
 
+/** Read an entry of a buffer pool dump file.
+Entries written before the hotness was recorded are treated as the
+coldest ones.
+@param[in,out]	f	dump file
+@param[out]	space_id	tablespace identifier
+@param[out]	page_no		page number
+@param[out]	hot		hotness
+@return	1 if an entry was read, 0 at the end of the file, -1 on error */
+static
+int
+buf_load_read_entry(FILE* f, ulint* space_id, ulint* page_no, ulint* hot)
+{
+	char	line[80];
+
+	do {
+		if (!fgets(line, sizeof line, f)) {
+			return(feof(f) ? 0 : -1);
+		}
+	} while (line[strspn(line, " \t\r\n")] == '\0');
+
+	*hot = 0;
+
+	switch (sscanf(line, ULINTPF "," ULINTPF "," ULINTPF,
+		       space_id, page_no, hot)) {
+	case 2:
+	case 3:
+		return(1);
+	}
+
+	return(-1);
+}
+
+/** Wait until there are fewer pending page reads than a limit.
+@param[in]	limit	maximum number of pending reads */
+static
+void
+buf_load_wait_for_reads(ulint limit)
+{
+	while (!SHUTTING_DOWN()) {
+		ulint	n_pend_reads = 0;
+
+		for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+			n_pend_reads += buf_pool_from_array(i)->n_pend_reads;
+		}
+
+		if (n_pend_reads < limit) {
+			return;
+		}
+
+		os_thread_sleep(1000);
+	}
+}
+
+/** Read pages of a buffer pool load, until all the batches have been
+claimed or the load is aborted.
+@param[in,out]	load	buffer pool load */
+static
+void
+buf_load_pages(buf_load_t* load)
+{
+	/* Each thread gets its share of innodb_io_capacity. */
+	const ulint	io_capacity = std::max<ulint>(
+		srv_io_capacity / load->n_threads, 1);
+	const bool	sync = load->io_depth == 1;
+	ulint		last_check_time = 0;
+	ulint		last_activity_cnt = 0;
+	ulint		n_io = 0;
+	ulint		n_pending = 0;
+
+	/* Avoid calling the expensive fil_space_acquire_silent() for each
+	page within the same tablespace. The entries of a hotness level
+	are sorted by (space, page), so most pages from a given tablespace
+	are consecutive. */
+	ulint		cur_space_id = ULINT_UNDEFINED;
+	fil_space_t*	space = NULL;
+	page_size_t	page_size(0);
+
+	while (!SHUTTING_DOWN() && !buf_load_abort_flag) {
+		ulint		i = my_atomic_addlint(
+			&load->next, BUF_LOAD_BATCH);
+
+		if (i >= load->n) {
+			break;
+		}
+
+		const ulint	end = std::min(i + BUF_LOAD_BATCH, load->n);
+
+		for (; i < end && !SHUTTING_DOWN() && !buf_load_abort_flag;
+		     i++) {
+			const buf_dump_t&	d = load->dump[i];
+
+			if (d.space != cur_space_id) {
+				if (space != NULL) {
+					fil_space_release(space);
+				}
+
+				cur_space_id = d.space;
+				space = fil_space_acquire_silent(cur_space_id);
+
+				if (space != NULL) {
+					const page_size_t	cur_page_size(
+						space->flags);
+					page_size.copy_from(cur_page_size);
+				}
+			}
+
+			/* JAN: TODO: As we use background page read below,
+			if tablespace is encrypted we cant use it. */
+			if (space != NULL
+			    && (!space->crypt_data
+				|| space->crypt_data->encryption
+				== FIL_ENCRYPTION_OFF
+				|| space->crypt_data->type
+				== CRYPT_SCHEME_UNENCRYPTED)) {
+
+				buf_read_page_background(
+					page_id_t(d.space, d.page_no),
+					page_size, sync);
+
+				if (!sync && ++n_pending == load->io_depth) {
+					n_pending = 0;
+					os_aio_simulated_wake_handler_threads();
+					buf_load_wait_for_reads(
+						load->n_threads
+						* load->io_depth);
+				}
+			}
+
+			ulint	n_done = my_atomic_addlint(
+				&load->n_done, 1) + 1;
+
+			if (n_done >= load->n_warm) {
+				buf_load_warm = true;
+			}
+
+			buf_load_throttle_if_needed(
+				&last_check_time, &last_activity_cnt,
+				n_io++, io_capacity);
+
+#ifdef UNIV_DEBUG
+			if (n_done >= srv_buf_pool_load_pages_abort) {
+				buf_load_abort_flag = 1;
+			}
+#endif
+		}
+	}
+
+	if (n_pending) {
+		os_aio_simulated_wake_handler_threads();
+	}
+
+	if (space != NULL) {
+		fil_space_release(space);
+	}
+}
+
+/** Buffer pool load thread, started by buf_load().
+@param[in,out]	arg	buffer pool load
+@return this function does not return, it calls os_thread_exit() */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(buf_load_thread)(void* arg)
+{
+	my_thread_init();
+
+	buf_load_t*	load = static_cast<buf_load_t*>(arg);
+
+	buf_load_pages(load);
+
+	os_event_set(load->done);
+	my_atomic_addlint(&load->n_running, ulint(-1));
+
+	my_thread_end();
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
 innodb_buffer_pool_load_status will be set accordingly, see buf_load_status().
 The dump filename can be specified by (relative to srv_data_home):
-SET GLOBAL innodb_buffer_pool_filename='filename'; */
+SET GLOBAL innodb_buffer_pool_filename='filename';
+The pages are read by innodb_buffer_pool_load_threads threads, the
+hottest pages first. */
 static
 void
 buf_load()
@@ -506,7 +777,8 @@ buf_load()
 	ulint		i;
 	ulint		space_id;
 	ulint		page_no;
-	int		fscanf_ret;
+	ulint		hot;
+	int		read_ret;
 
 	/* Ignore any leftovers from before */
 	buf_load_abort_flag = FALSE;
@@ -529,13 +801,13 @@ buf_load()
 	This file is tiny (approx 500KB per 1GB buffer pool), reading it
 	two times is fine. */
 	dump_n = 0;
-	while (fscanf(f, ULINTPF "," ULINTPF, &space_id, &page_no) == 2
+	while ((read_ret = buf_load_read_entry(f, &space_id, &page_no, &hot))
+	       == 1
 	       && !SHUTTING_DOWN()) {
 		dump_n++;
 	}
 
-	if (!SHUTTING_DOWN() && !feof(f)) {
-		/* fscanf() returned != 2 */
+	if (!SHUTTING_DOWN() && read_ret < 0) {
 		const char*	what;
 		if (ferror(f)) {
 			what = "reading";
@@ -584,11 +856,10 @@ buf_load()
 	export_vars.innodb_buffer_pool_load_incomplete = 1;
 
 	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
-		fscanf_ret = fscanf(f, ULINTPF "," ULINTPF,
-				    &space_id, &page_no);
+		read_ret = buf_load_read_entry(f, &space_id, &page_no, &hot);
 
-		if (fscanf_ret != 2) {
-			if (feof(f)) {
+		if (read_ret != 1) {
+			if (read_ret == 0) {
 				break;
 			}
 			/* else */
@@ -602,7 +873,8 @@ buf_load()
 			return;
 		}
 
-		if (space_id > ULINT32_MASK || page_no > ULINT32_MASK) {
+		if (space_id > ULINT32_MASK || page_no > ULINT32_MASK
+		    || hot > ULINT32_MASK) {
 			ut_free(dump);
 			fclose(f);
 			buf_load_status(STATUS_ERR,
@@ -616,7 +888,9 @@ buf_load()
 			return;
 		}
 
-		dump[i] = BUF_DUMP_CREATE(space_id, page_no);
+		dump[i].space = uint32_t(space_id);
+		dump[i].page_no = uint32_t(page_no);
+		dump[i].hot = uint32_t(hot);
 	}
 
 	/* Set dump_n to the actual number of initialized elements,
@@ -639,15 +913,19 @@ buf_load()
 		std::sort(dump, dump + dump_n);
 	}
 
-	ulint		last_check_time = 0;
-	ulint		last_activity_cnt = 0;
+	buf_load_t	load;
 
-	/* Avoid calling the expensive fil_space_acquire_silent() for each
-	page within the same tablespace. dump[] is sorted by (space, page),
-	so all pages from a given tablespace are consecutive. */
-	ulint		cur_space_id = BUF_DUMP_SPACE(dump[0]);
-	fil_space_t*	space = fil_space_acquire_silent(cur_space_id);
-	page_size_t	page_size(space ? space->flags : 0);
+	load.dump = dump;
+	load.n = dump_n;
+	load.next = 0;
+	load.n_done = 0;
+	load.n_warm = (dump_n * srv_buf_pool_load_warm_pct + 99) / 100;
+	load.n_threads = std::min<ulint>(
+		srv_buf_pool_load_threads,
+		(dump_n + BUF_LOAD_BATCH - 1) / BUF_LOAD_BATCH);
+	load.io_depth = srv_buf_pool_load_io_depth;
+	load.n_running = load.n_threads - 1;
+	load.done = os_event_create(0);
 
 	/* JAN: TODO: MySQL 5.7 PSI
 #ifdef HAVE_PSI_STAGE_INTERFACE
@@ -659,93 +937,49 @@ buf_load()
 	mysql_stage_set_work_completed(pfs_stage_progress, 0);
 	*/
 
-	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
-
-		/* space_id for this iteration of the loop */
-		const ulint	this_space_id = BUF_DUMP_SPACE(dump[i]);
-
-		if (this_space_id != cur_space_id) {
-			if (space != NULL) {
-				fil_space_release(space);
-			}
+	for (i = 1; i < load.n_threads; i++) {
+		os_thread_create(buf_load_thread, &load, NULL);
+	}
 
-			cur_space_id = this_space_id;
-			space = fil_space_acquire_silent(cur_space_id);
+	buf_load_pages(&load);
 
-			if (space != NULL) {
-				const page_size_t	cur_page_size(
-					space->flags);
-				page_size.copy_from(cur_page_size);
-			}
-		}
+	for (;;) {
+		int64_t	sig_count = os_event_reset(load.done);
 
-		/* JAN: TODO: As we use background page read below,
-		if tablespace is encrypted we cant use it. */
-		if (space == NULL ||
-		   (space && space->crypt_data &&
-		    space->crypt_data->encryption != FIL_ENCRYPTION_OFF &&
-		    space->crypt_data->type != CRYPT_SCHEME_UNENCRYPTED)) {
-			continue;
+		if (!my_atomic_loadlint(&load.n_running)) {
+			break;
 		}
 
-		buf_read_page_background(
-			page_id_t(this_space_id, BUF_DUMP_PAGE(dump[i])),
-			page_size, true);
+		os_event_wait_time_low(load.done, 100000, sig_count);
+	}
 
-		if (i % 64 == 63) {
-			os_aio_simulated_wake_handler_threads();
-		}
+	os_event_destroy(load.done);
+	ut_free(dump);
 
-		if (buf_load_abort_flag) {
-			if (space != NULL) {
-				fil_space_release(space);
-			}
-			buf_load_abort_flag = FALSE;
-			ut_free(dump);
-			buf_load_status(
-				STATUS_INFO,
-				"Buffer pool(s) load aborted on request");
-			/* Premature end, set estimated = completed = i and
-			end the current stage event. */
-			/*
-			mysql_stage_set_work_estimated(pfs_stage_progress, i);
-			mysql_stage_set_work_completed(pfs_stage_progress,
-			i);
-			*/
+	if (buf_load_abort_flag) {
+		buf_load_abort_flag = FALSE;
+		buf_load_status(
+			STATUS_INFO,
+			"Buffer pool(s) load aborted on request");
+		/* Premature end, set estimated = completed = i and
+		end the current stage event. */
+		/*
+		mysql_stage_set_work_estimated(pfs_stage_progress, i);
+		mysql_stage_set_work_completed(pfs_stage_progress,
+		i);
+		*/
 #ifdef HAVE_PSI_STAGE_INTERFACE
-			/* mysql_end_stage(); */
+		/* mysql_end_stage(); */
 #endif /* HAVE_PSI_STAGE_INTERFACE */
-			return;
-		}
-
-		buf_load_throttle_if_needed(
-			&last_check_time, &last_activity_cnt, i);
-
-#ifdef UNIV_DEBUG
-		if ((i+1) >= srv_buf_pool_load_pages_abort) {
-			buf_load_abort_flag = 1;
-		}
-#endif
-	}
-
-	if (space != NULL) {
-		fil_space_release(space);
+		return;
 	}
 
-	ut_free(dump);
-
 	ut_sprintf_timestamp(now);
 
-	if (i == dump_n) {
+	if (load.n_done == dump_n) {
 		buf_load_status(STATUS_INFO,
 			"Buffer pool(s) load completed at %s", now);
 		export_vars.innodb_buffer_pool_load_incomplete = 0;
-	} else if (!buf_load_abort_flag) {
-		buf_load_status(STATUS_INFO,
-			"Buffer pool(s) load aborted due to user instigated abort at %s",
-			now);
-		/* intentionally don't reset innodb_buffer_pool_load_incomplete
-                   as we don't want a shutdown to save the buffer pool */
 	} else {
 		buf_load_status(STATUS_INFO,
 			"Buffer pool(s) load aborted due to shutdown at %s",
@@ -773,6 +1007,24 @@ buf_load_abort()
 	buf_load_abort_flag = TRUE;
 }
 
+/** Wait until the buffer pool load at startup has loaded
+innodb_buffer_pool_load_warm_pct of the dumped pages, or has ended. */
+void
+buf_load_wait_warm()
+{
+	if (!srv_buf_pool_load_warm_pct || !srv_buffer_pool_load_at_startup) {
+		return;
+	}
+
+	ib::info() << "Waiting for the buffer pool load to reach "
+		<< srv_buf_pool_load_warm_pct << "%";
+
+	while (!buf_load_warm && srv_buf_dump_thread_active
+	       && !SHUTTING_DOWN()) {
+		os_thread_sleep(10000);
+	}
+}
+
 /*****************************************************************//**
 This is the main thread for buffer pool dump/load. It waits for an
 event and when waked up either performs a dump or load and sleeps
@@ -800,6 +1052,8 @@ DECLARE_THREAD(buf_dump_thread)(void*)
 #endif /* WITH_WSREP */
 	}
 
+	buf_load_warm = true;
+
 	while (!SHUTTING_DOWN()) {
 
 		os_event_wait(srv_buf_dump_event);
@@ -57,6 +57,9 @@ Created 11/11/1995 Heikki Tuuri
 #include <sys/resource.h>
 static const int buf_flush_page_cleaner_priority = -20;
 #endif /* UNIV_LINUX */
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif /* HAVE_LIBNUMA */
 
 /** Sleep time in microseconds for loop waiting for the oldest
 modification lsn */
@@ -803,6 +806,13 @@ void buf_flush_write_complete(buf_page_t* bpage, bool dblwr)
 		os_event_set(buf_pool->no_flush[flush_type]);
 	}
 
+	if (flush_type == BUF_FLUSH_LIST
+	    && buf_pool->n_flush[flush_type] == buf_pool->flush_io_wait) {
+		/* Let buf_flush_wait_io_depth() submit more writes. */
+		buf_pool->flush_io_wait = ULINT_UNDEFINED;
+		os_event_set(buf_pool->flush_io_event);
+	}
+
 	if (dblwr) {
 		buf_dblwr_update(bpage, flush_type);
 	}
@@ -1749,6 +1759,80 @@ buf_do_LRU_batch(
 	n->evicted += n->unzip_LRU_evicted;
 }
 
+/** Wait until enough of the page writes of a flush_list batch have
+completed, if the batch has as many writes in flight as allowed by
+buf_pool->flush_io_depth. The writes that are buffered in the doublewrite
+buffer are submitted first. The wait is used for estimating the write
+latency of the device.
+@param[in,out]	buf_pool	buffer pool instance */
+static
+void
+buf_flush_wait_io_depth(buf_pool_t* buf_pool)
+{
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(!buf_flush_list_mutex_own(buf_pool));
+
+	const ulint	depth = buf_pool->flush_io_depth;
+	const ulint	n_pending = buf_pool->n_flush[BUF_FLUSH_LIST];
+
+	if (depth == 0 || n_pending < depth) {
+		return;
+	}
+
+	buf_pool_mutex_exit(buf_pool);
+
+	/* Submit the writes that were buffered in the doublewrite
+	segment of the instance, or wake up the simulated AIO handler
+	threads. */
+	if (!srv_read_only_mode && srv_use_doublewrite_buf && buf_dblwr) {
+		buf_dblwr_flush_buffered_writes(buf_pool);
+	} else {
+		os_aio_simulated_wake_handler_threads();
+	}
+
+	uintmax_t	start = ut_time_us(NULL);
+
+	buf_pool_mutex_enter(buf_pool);
+
+	/* Resume when half of the writes have completed, so that the
+	next writes will be submitted as a batch. */
+	const ulint	target = depth / 2;
+	ulint		n_before = buf_pool->n_flush[BUF_FLUSH_LIST];
+
+	if (n_before > target) {
+		int64_t	sig_count = os_event_reset(buf_pool->flush_io_event);
+
+		buf_pool->flush_io_wait = target;
+
+		buf_pool_mutex_exit(buf_pool);
+
+		thd_wait_begin(NULL, THD_WAIT_DISKIO);
+		os_event_wait_low(buf_pool->flush_io_event, sig_count);
+		thd_wait_end(NULL);
+
+		buf_pool_mutex_enter(buf_pool);
+	}
+
+	const ulint	n_after = buf_pool->n_flush[BUF_FLUSH_LIST];
+	const ulint	elapsed = ulint(ut_time_us(NULL) - start);
+
+	buf_pool->stat.flush_stall_time += elapsed;
+
+	if (n_before > n_after) {
+		/* By Little's law, the latency is the average number
+		of writes in flight divided by their completion rate. */
+		ulint	latency = (n_before + n_after) / 2 * elapsed
+			/ (n_before - n_after);
+
+		buf_pool->flush_io_latency = buf_pool->flush_io_latency
+			? (3 * buf_pool->flush_io_latency + latency) / 4
+			: latency;
+		buf_pool->flush_io_n_waits++;
+	}
+
+	MONITOR_INC_VALUE(MONITOR_FLUSH_IO_DEPTH_STALL_TIME, elapsed);
+}
+
 /** This utility flushes dirty blocks from the end of the flush_list.
 The calling thread is not allowed to own any latches on pages!
 @param[in]	buf_pool	buffer pool instance
@@ -1802,6 +1886,11 @@ buf_do_flush_list_batch(
 		buf_flush_page_and_try_neighbors(
 			bpage, BUF_FLUSH_LIST, min_n, &count);
 
+		/* Keep at most buf_pool->flush_io_depth writes in flight.
+		The flush_hp will be adjusted if prev is removed from the
+		flush_list while we are waiting. */
+		buf_flush_wait_io_depth(buf_pool);
+
 		buf_flush_list_mutex_enter(buf_pool);
 
 		ut_ad(flushed || buf_pool->flush_hp.is_hp(prev));
@@ -1961,7 +2050,7 @@ buf_flush_end(
 	buf_pool_mutex_exit(buf_pool);
 
 	if (!srv_read_only_mode) {
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(buf_pool);
 	} else {
 		os_aio_simulated_wake_handler_threads();
 	}
@@ -2397,6 +2486,79 @@ af_get_pct_for_lsn(
 		/ 7.5));
 }
 
+/** Adjust the number of page writes that a flush_list batch of each
+buffer pool instance may keep in flight, and compute the flush rate of
+each instance. Called approximately once every second by the page cleaner
+coordinator.
+
+When the checkpoint age exceeds the asynchronous flush point, flushing
+must make progress as fast as possible, and innodb_flush_io_depth writes
+are allowed. Otherwise, the limit is halved whenever the measured write
+latency has more than doubled from its recent minimum, which means that
+the device queue is saturated, and it is increased by a quarter
+otherwise.
+@param[in]	elapsed	milliseconds since the previous call */
+static
+void
+buf_flush_adapt_io_depth(ulint elapsed)
+{
+	const ulint	max_depth = srv_flush_io_depth;
+	const lsn_t	cur_lsn = log_get_lsn_nowait();
+	const lsn_t	oldest_lsn = buf_pool_get_oldest_modification();
+	const bool	urgent = cur_lsn > oldest_lsn
+		&& oldest_lsn != 0
+		&& cur_lsn - oldest_lsn >= log_get_max_modified_age_async();
+
+	if (elapsed == 0) {
+		elapsed = 1;
+	}
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+		buf_pool_mutex_enter(buf_pool);
+
+		const ulint	written = buf_pool->stat.n_pages_written;
+
+		/* buf_refresh_io_stats() may have reset the counter. */
+		buf_pool->flush_rate = written >= buf_pool->flush_rate_written
+			? (written - buf_pool->flush_rate_written) * 1000
+			/ elapsed
+			: 0;
+		buf_pool->flush_rate_written = written;
+
+		ulint	depth = buf_pool->flush_io_depth;
+		ulint	latency = buf_pool->flush_io_latency;
+		ulint&	latency_min = buf_pool->flush_io_latency_min;
+
+		if (max_depth == 0) {
+			depth = 0;
+		} else if (urgent || depth == 0 || depth > max_depth) {
+			depth = max_depth;
+		} else if (buf_pool->flush_io_n_waits == 0) {
+			/* The limit was not reached. */
+		} else if (latency > 2 * latency_min) {
+			depth = ut_max(depth / 2, ulint(1));
+		} else {
+			depth = ut_min(depth + depth / 4 + 1, max_depth);
+		}
+
+		/* Let the minimum drift upwards, so that a permanent
+		change of the device latency will be adapted to. */
+		if (latency != 0) {
+			latency_min = latency_min
+				? ut_min(latency_min + latency_min / 16 + 1,
+					 latency)
+				: latency;
+		}
+
+		buf_pool->flush_io_depth = depth;
+		buf_pool->flush_io_n_waits = 0;
+
+		buf_pool_mutex_exit(buf_pool);
+	}
+}
+
 /*********************************************************************//**
 This function is called approximately once every second by the
 page_cleaner thread. Based on various factors it decides if there is a
@@ -2778,6 +2940,77 @@ pc_request(
 	mutex_exit(&page_cleaner.mutex);
 }
 
+#ifdef HAVE_LIBNUMA
+/**
+Select the requested slot to flush for innodb_buffer_pool_numa_bind,
+preferring a buffer pool instance that is bound to the NUMA node the
+calling thread is running on. If there is none, move the calling thread
+to the NUMA node of the first requested instance until
+pc_restore_numa_affinity() is called.
+@param[in]	first	the first slot in PAGE_CLEANER_STATE_REQUESTED
+@param[out]	cpus	the previous CPU affinity of the thread,
+			or NULL if it was not changed
+@return	the slot to flush */
+static
+ulint
+pc_select_numa_slot(ulint first, bitmask** cpus)
+{
+	ut_ad(mutex_own(&page_cleaner.mutex));
+	ut_ad(page_cleaner.slots[first].state
+	      == PAGE_CLEANER_STATE_REQUESTED);
+
+	const ulint	numa_node = buf_numa_node_of_current_cpu();
+
+	if (numa_node == ULINT_UNDEFINED) {
+		return(first);
+	}
+
+	for (ulint i = first; i < page_cleaner.n_slots; i++) {
+		if (page_cleaner.slots[i].state == PAGE_CLEANER_STATE_REQUESTED
+		    && buf_pool_from_array(i)->numa_node == numa_node) {
+			return(i);
+		}
+	}
+
+	const ulint	node = buf_pool_from_array(first)->numa_node;
+
+	if (node == ULINT_UNDEFINED) {
+		return(first);
+	}
+
+	*cpus = numa_allocate_cpumask();
+
+	if (numa_sched_getaffinity(0, *cpus) < 0) {
+		numa_free_cpumask(*cpus);
+		*cpus = NULL;
+		return(first);
+	}
+
+	/* Run on the NUMA node of the instance, so that the
+	flushing will access node-local memory. */
+	if (numa_run_on_node(int(node)) < 0) {
+		numa_free_cpumask(*cpus);
+		*cpus = NULL;
+	}
+
+	return(first);
+}
+
+/**
+Restore the CPU affinity that pc_select_numa_slot() changed, so that
+the thread is not bound to one NUMA node for the rest of its life.
+@param[in,out]	cpus	the CPU affinity to restore, or NULL */
+static
+void
+pc_restore_numa_affinity(bitmask* cpus)
+{
+	if (cpus != NULL) {
+		numa_sched_setaffinity(0, cpus);
+		numa_free_cpumask(cpus);
+	}
+}
+#endif /* HAVE_LIBNUMA */
+
 /**
 Do flush for one slot.
 @return	the number of the slots which has not been treated yet. */
@@ -2789,6 +3022,9 @@ pc_flush_slot(void)
 	ulint	list_tm = 0;
 	int	lru_pass = 0;
 	int	list_pass = 0;
+#ifdef HAVE_LIBNUMA
+	bitmask*	cpus = NULL;
+#endif /* HAVE_LIBNUMA */
 
 	mutex_enter(&page_cleaner.mutex);
 
@@ -2810,6 +3046,13 @@ pc_flush_slot(void)
 		page_cleaner.n_slots_requested > 0 */
 		ut_a(i < page_cleaner.n_slots);
 
+#ifdef HAVE_LIBNUMA
+		if (srv_buf_pool_numa_bind) {
+			i = pc_select_numa_slot(i, &cpus);
+			slot = &page_cleaner.slots[i];
+		}
+#endif /* HAVE_LIBNUMA */
+
 		buf_pool_t* buf_pool = buf_pool_from_array(i);
 
 		page_cleaner.n_slots_requested--;
@@ -2864,6 +3107,9 @@ pc_flush_slot(void)
 finish:
 		mutex_enter(&page_cleaner.mutex);
 finish_mutex:
+#ifdef HAVE_LIBNUMA
+		pc_restore_numa_affinity(cpus);
+#endif /* HAVE_LIBNUMA */
 		page_cleaner.n_slots_flushing--;
 		page_cleaner.n_slots_finished++;
 		slot->state = PAGE_CLEANER_STATE_FINISHED;
@@ -3204,6 +3450,9 @@ DECLARE_THREAD(buf_flush_page_cleaner_coordinator)(void*)
 				warn_count = 0;
 			}
 
+			buf_flush_adapt_io_depth(
+				curr_time + 1000 - next_loop_time);
+
 			next_loop_time = curr_time + 1000;
 			n_flushed_last = n_evicted = 0;
 		}
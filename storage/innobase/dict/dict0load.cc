@@ -48,6 +48,7 @@ Created 4/24/1996 Heikki Tuuri
 #include "srv0srv.h"
 #include <stack>
 #include <set>
+#include <vector>
 
 /** Following are the InnoDB system tables. The positions in
 this array are referenced by enum dict_system_table_id. */
@@ -1359,6 +1360,167 @@ dict_sys_tables_rec_read(
 	return(true);
 }
 
+/** Minimum number of tablespaces in the default location for opening
+them in parallel */
+#define DICT_CHECK_PLL_MIN	32
+
+/** A file-per-table tablespace in the default location, to be opened by
+dict_check_sys_tables() */
+struct dict_check_space_t {
+	/** table name */
+	table_name_t	name;
+	/** tablespace ID */
+	ulint		id;
+	/** FSP_SPACE_FLAGS */
+	ulint		flags;
+	/** file path from SYS_DATAFILES */
+	char*		filepath;
+	/** result of fil_ibd_open() */
+	dberr_t		err;
+};
+
+/** State of the threads that open tablespaces in parallel */
+struct dict_check_pll_t {
+	/** the tablespaces */
+	dict_check_space_t*	spaces;
+	/** number of tablespaces */
+	ulint			n_spaces;
+	/** whether to read and validate the first page of each file */
+	bool			validate;
+	/** number of the next tablespace to open */
+	ulint			next;
+	/** number of threads that are running */
+	ulint			n_running;
+	/** signalled when a thread exits */
+	os_event_t		done;
+};
+
+/** Open the tablespaces of dict_check_pll_t until none are left.
+@param[in,out]	pll	parallel state */
+static
+void
+dict_check_pll_open(dict_check_pll_t* pll)
+{
+	for (;;) {
+		ulint	i = my_atomic_addlint(&pll->next, 1);
+
+		if (i >= pll->n_spaces) {
+			return;
+		}
+
+		dict_check_space_t&	s = pll->spaces[i];
+
+		/* The dictionary cannot be updated from this thread.
+		The caller will do that. */
+		s.err = fil_ibd_open(pll->validate, false,
+				     FIL_TYPE_TABLESPACE, s.id, s.flags,
+				     s.name.m_name, s.filepath);
+	}
+}
+
+/** Thread that opens tablespaces for dict_check_sys_tables().
+@param[in,out]	arg	dict_check_pll_t
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(dict_check_pll_thread)(void* arg)
+{
+	dict_check_pll_t*	pll = static_cast<dict_check_pll_t*>(arg);
+
+	my_thread_init();
+
+	dict_check_pll_open(pll);
+
+	my_thread_end();
+
+	os_event_set(pll->done);
+	my_atomic_addlint(&pll->n_running, ulint(-1));
+
+	os_thread_exit();
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Open file-per-table tablespaces in the default location.
+With innodb_tablespace_discovery_threads > 1, open them in parallel and
+then bring SYS_DATAFILES up to date in the calling thread, like for the
+tablespaces that were opened during redo log apply.
+@param[in,out]	spaces		tablespaces
+@param[in]	validate	whether to validate the first page */
+static
+void
+dict_check_open_spaces(
+	std::vector<dict_check_space_t>&	spaces,
+	bool					validate)
+{
+	const bool	fix_dict = !srv_read_only_mode
+		&& srv_log_file_size != 0;
+	ulint		n_threads = std::min<ulint>(
+		srv_tablespace_discovery_threads,
+		spaces.size() / DICT_CHECK_PLL_MIN);
+
+	if (n_threads <= 1) {
+		for (ulint i = 0; i < spaces.size(); i++) {
+			dict_check_space_t&	s = spaces[i];
+
+			s.err = fil_ibd_open(validate, fix_dict,
+					     FIL_TYPE_TABLESPACE, s.id,
+					     s.flags, s.name.m_name,
+					     s.filepath);
+		}
+
+		return;
+	}
+
+	dict_check_pll_t	pll;
+
+	pll.spaces = &spaces[0];
+	pll.n_spaces = spaces.size();
+	pll.validate = validate;
+	pll.next = 0;
+	pll.n_running = n_threads - 1;
+	pll.done = os_event_create(0);
+
+	for (ulint i = 1; i < n_threads; i++) {
+		os_thread_create(dict_check_pll_thread, &pll, NULL);
+	}
+
+	dict_check_pll_open(&pll);
+
+	for (;;) {
+		int64_t	sig_count = os_event_reset(pll.done);
+
+		if (!my_atomic_loadlint(&pll.n_running)) {
+			break;
+		}
+
+		os_event_wait_time_low(pll.done, 100000, sig_count);
+	}
+
+	os_event_destroy(pll.done);
+
+	if (!fix_dict) {
+		return;
+	}
+
+	/* The file may have been found at a location that does not
+	match SYS_DATAFILES. If so, update SYS_DATAFILES. */
+	for (ulint i = 0; i < spaces.size(); i++) {
+		const dict_check_space_t&	s = spaces[i];
+
+		if (s.err != DB_SUCCESS) {
+			continue;
+		}
+
+		char*	fil_path = fil_space_get_first_path(s.id);
+
+		if (fil_path && strcmp(s.filepath, fil_path)) {
+			dict_update_filepath(s.id, fil_path);
+		}
+
+		ut_free(fil_path);
+	}
+}
+
 /** Load and check each non-predefined tablespace mentioned in SYS_TABLES.
 Search SYS_TABLES and check each tablespace mentioned that has not
 already been added to the fil_system.  If it is valid, add it to the
@@ -1375,6 +1537,8 @@ dict_check_sys_tables(
 	btr_pcur_t	pcur;
 	const rec_t*	rec;
 	mtr_t		mtr;
+	/* Tablespaces in the default location, opened after the scan */
+	std::vector<dict_check_space_t>	spaces;
 
 	DBUG_ENTER("dict_check_sys_tables");
 
@@ -1467,6 +1631,29 @@ dict_check_sys_tables(
 		opened. */
 		char*	filepath = dict_get_first_path(space_id);
 
+		max_space_id = ut_max(max_space_id, space_id);
+
+		if (filepath != NULL && !DICT_TF_HAS_DATA_DIR(flags)) {
+			char*	default_path = fil_make_filepath(
+				NULL, table_name.m_name, IBD, false);
+			bool	is_default = default_path
+				&& !strcmp(filepath, default_path);
+
+			ut_free(default_path);
+
+			if (is_default) {
+				/* Defer the opening, so that the files
+				can be opened in parallel. */
+				dict_check_space_t	s = {
+					table_name, space_id,
+					dict_tf_to_fsp_flags(flags),
+					filepath, DB_SUCCESS
+				};
+				spaces.push_back(s);
+				continue;
+			}
+		}
+
 		/* Check that the .ibd file exists. */
 		dberr_t	err = fil_ibd_open(
 			validate,
@@ -1482,14 +1669,27 @@ dict_check_sys_tables(
 				<< " because it could not be opened.";
 		}
 
-		max_space_id = ut_max(max_space_id, space_id);
-
 		ut_free(table_name.m_name);
 		ut_free(filepath);
 	}
 
 	mtr_commit(&mtr);
 
+	dict_check_open_spaces(spaces, validate);
+
+	for (ulint i = 0; i < spaces.size(); i++) {
+		dict_check_space_t&	s = spaces[i];
+
+		if (s.err != DB_SUCCESS) {
+			ib::warn() << "Ignoring tablespace for "
+				<< s.name
+				<< " because it could not be opened.";
+		}
+
+		ut_free(s.name.m_name);
+		ut_free(s.filepath);
+	}
+
 	DBUG_RETURN(max_space_id);
 }
 
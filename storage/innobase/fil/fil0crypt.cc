@@ -1093,6 +1093,10 @@ fil_crypt_start_encrypting_space(
 	return recheck;
 }
 
+/** Maximum number of rotated tablespaces whose page 0 update a
+rotation thread defers, so that one flush-list batch covers them all */
+#define FIL_CRYPT_FLUSH_BATCH	64
+
 /** State of a rotation thread */
 struct rotate_thread_t {
 	explicit rotate_thread_t(uint no) {
@@ -1104,6 +1108,8 @@ struct rotate_thread_t {
 
 	uint thread_no;
 	bool first;		    /*!< is position before first space */
+	bool stealing;		    /*!< whether to join tablespaces that
+				    other threads are rotating */
 	fil_space_t* space;	    /*!< current space or NULL */
 	ulint offset;		    /*!< current offset */
 	ulint batch;		    /*!< #pages to rotate */
@@ -1114,6 +1120,17 @@ struct rotate_thread_t {
 	uint allocated_iops;	   /*!< allocated iops */
 	ulint cnt_waited;	   /*!< #times waited during this slot */
 	uintmax_t sum_waited_us;   /*!< wait time during this slot */
+	ulonglong io_start_us;	   /*!< start of the current pacing
+				   interval, or 0 */
+	ulint io_count;		   /*!< I/O operations issued in the
+				   current pacing interval */
+
+	/** rotated tablespaces whose page 0 has not been updated yet */
+	ulint flush_batch[FIL_CRYPT_FLUSH_BATCH];
+	ulint n_flush_batch;	   /*!< number of elements in flush_batch */
+	lsn_t flush_lsn;	   /*!< the pages of flush_batch
+				   must be flushed up to this LSN */
+	time_t flush_batch_start;  /*!< when flush_batch became nonempty */
 
 	fil_crypt_stat_t crypt_stat; // statistics
 
@@ -1202,6 +1219,16 @@ fil_crypt_space_needs_rotation(
 			break;
 		}
 
+		/* Spread the threads over different tablespaces first.
+		Only when every tablespace that needs rotation has been
+		claimed, help other threads with their remaining pages. */
+		if (crypt_data->rotate_state.active_threads
+		    && (!state->stealing
+			|| crypt_data->rotate_state.next_offset
+			> crypt_data->rotate_state.max_offset)) {
+			break;
+		}
+
 		/* No need to rotate space if encryption is disabled */
 		if (crypt_data->not_encrypted()) {
 			break;
@@ -1306,6 +1333,7 @@ fil_crypt_alloc_iops(
 	mutex_exit(&fil_crypt_threads_mutex);
 
 	state->allocated_iops = alloc;
+	state->io_start_us = 0;
 
 	return alloc > 0;
 }
@@ -1321,6 +1349,8 @@ fil_crypt_realloc_iops(
 {
 	ut_a(state->allocated_iops > 0);
 
+	const uint old_iops = state->allocated_iops;
+
 	if (10 * state->cnt_waited > state->batch) {
 		/* if we waited more than 10% re-estimate max_iops */
 		ulint avg_wait_time_us =
@@ -1402,6 +1432,11 @@ fil_crypt_realloc_iops(
 		mutex_exit(&fil_crypt_threads_mutex);
 	}
 
+	if (state->allocated_iops != old_iops) {
+		/* Start pacing at the new rate. */
+		state->io_start_us = 0;
+	}
+
 	fil_crypt_update_total_stat(state);
 }
 
@@ -1434,6 +1469,22 @@ fil_crypt_return_iops(
 	fil_crypt_update_total_stat(state);
 }
 
+/** Return the next tablespace that may need key rotation.
+If key rotation is enabled (default) we iterate all tablespaces.
+If key rotation is not enabled we iterate only the tablespaces
+added to keyrotation list.
+@param[in,out]	prev_space	previous tablespace, or NULL
+@return the next tablespace
+@retval NULL if this was the last */
+static
+fil_space_t*
+fil_crypt_next_space(fil_space_t* prev_space)
+{
+	return(srv_fil_crypt_rotate_key_age
+	       ? fil_space_next(prev_space)
+	       : fil_space_keyrotate_next(prev_space));
+}
+
 /***********************************************************************
 Search for a space needing rotation
 @param[in,out]		key_state		Key state
@@ -1462,42 +1513,46 @@ fil_crypt_find_space_to_rotate(
 
 	if (state->first) {
 		state->first = false;
+		state->stealing = false;
 		if (state->space) {
 			fil_space_release(state->space);
 		}
 		state->space = NULL;
 	}
 
-	/* If key rotation is enabled (default) we iterate all tablespaces.
-	If key rotation is not enabled we iterate only the tablespaces
-	added to keyrotation list. */
-	if (srv_fil_crypt_rotate_key_age) {
-		state->space = fil_space_next(state->space);
-	} else {
-		state->space = fil_space_keyrotate_next(state->space);
-	}
+	state->space = fil_crypt_next_space(state->space);
 
-	while (!state->should_shutdown() && state->space) {
-		/* If there is no crypt data and we have not yet read
-		page 0 for this tablespace, we need to read it before
-		we can continue. */
-		if (!state->space->crypt_data) {
-			fil_crypt_read_crypt_data(state->space);
-		}
+	for (;;) {
+		while (!state->should_shutdown() && state->space) {
+			/* If there is no crypt data and we have not yet read
+			page 0 for this tablespace, we need to read it before
+			we can continue. */
+			if (!state->space->crypt_data) {
+				fil_crypt_read_crypt_data(state->space);
+			}
 
-		if (fil_crypt_space_needs_rotation(state, key_state, recheck)) {
-			ut_ad(key_state->key_id);
-			/* init state->min_key_version_found before
-			* starting on a space */
-			state->min_key_version_found = key_state->key_version;
-			return true;
+			if (fil_crypt_space_needs_rotation(
+				    state, key_state, recheck)) {
+				ut_ad(key_state->key_id);
+				/* init state->min_key_version_found before
+				* starting on a space */
+				state->min_key_version_found =
+					key_state->key_version;
+				return true;
+			}
+
+			state->space = fil_crypt_next_space(state->space);
 		}
 
-		if (srv_fil_crypt_rotate_key_age) {
-			state->space = fil_space_next(state->space);
-		} else {
-			state->space = fil_space_keyrotate_next(state->space);
+		if (state->stealing || state->should_shutdown()) {
+			break;
 		}
+
+		/* All tablespaces needing rotation were claimed by
+		other threads. Make another pass, stealing pages from
+		the tablespaces that are still being rotated. */
+		state->stealing = true;
+		state->space = fil_crypt_next_space(NULL);
 	}
 
 	/* if we didn't find any space return iops */
@@ -1531,6 +1586,7 @@ fil_crypt_start_rotate_space(
 		/* FIXME: max_offset could be removed and instead
 		space->size consulted.*/
 		crypt_data->rotate_state.max_offset = state->space->size;
+		crypt_data->rotate_state.pages_done = 0;
 		crypt_data->rotate_state.end_lsn = 0;
 		crypt_data->rotate_state.min_key_version_found =
 			key_state->key_version;
@@ -1602,16 +1658,61 @@ fil_crypt_find_page_to_rotate(
 	return found;
 }
 
-#define fil_crypt_get_page_throttle(state,offset,mtr,sleeptime_ms) \
+/** Account for a page read or write of a rotation thread.
+@param[in,out]	state	Rotation state */
+static
+void
+fil_crypt_io_note(rotate_thread_t* state)
+{
+	if (!state->io_start_us) {
+		state->io_start_us = ut_time_us(NULL);
+		state->io_count = 0;
+	}
+
+	state->io_count++;
+}
+
+/** Sleep until the I/O operations that a rotation thread has issued
+fit in the share of innodb_encryption_rotation_iops that is allocated
+to the thread, so that the operations are spaced 1/allocated_iops
+seconds apart on average. Must be called without holding any latches.
+@param[in,out]	state	Rotation state */
+static
+void
+fil_crypt_io_throttle(rotate_thread_t* state)
+{
+	ut_ad(state->allocated_iops > 0);
+
+	if (!state->io_count) {
+		return;
+	}
+
+	const ulonglong	now = ut_time_us(NULL);
+	const ulonglong	due = state->io_start_us
+		+ state->io_count * 1000000ULL / state->allocated_iops;
+
+	if (due > now) {
+		os_event_reset(fil_crypt_throttle_sleep_event);
+		os_event_wait_time(fil_crypt_throttle_sleep_event,
+				   ulint(due - now));
+	} else if (now - due > 1000000) {
+		/* Do not let the time that was spent without I/O
+		(waiting for latches or flushing) accumulate into a
+		burst of more than 1 second. */
+		state->io_start_us = 0;
+		state->io_count = 0;
+	}
+}
+
+#define fil_crypt_get_page_throttle(state,offset,mtr) \
 	fil_crypt_get_page_throttle_func(state, offset, mtr, \
-					 sleeptime_ms, __FILE__, __LINE__)
+					 __FILE__, __LINE__)
 
 /***********************************************************************
-Get a page and compute sleep time
+Get a page, reading it from the data file at the allocated iops rate
 @param[in,out]		state		Rotation state
 @param[in]		offset		Page offset
 @param[in,out]		mtr		Minitransaction
-@param[out]		sleeptime_ms	Sleep time
 @param[in]		file		File where called
 @param[in]		line		Line where called
 @return page or NULL*/
@@ -1621,7 +1722,6 @@ fil_crypt_get_page_throttle_func(
 	rotate_thread_t*	state,
 	ulint 			offset,
 	mtr_t*			mtr,
-	ulint*			sleeptime_ms,
 	const char*		file,
 	unsigned		line)
 {
@@ -1653,6 +1753,8 @@ fil_crypt_get_page_throttle_func(
 
 	state->crypt_stat.pages_read_from_disk++;
 
+	fil_crypt_io_note(state);
+
 	uintmax_t start = ut_time_us(NULL);
 	block = buf_page_get_gen(page_id, page_size,
 				 RW_X_LATCH,
@@ -1667,20 +1769,6 @@ fil_crypt_get_page_throttle_func(
 	state->cnt_waited++;
 	state->sum_waited_us += (end - start);
 
-	/* average page load */
-	ulint add_sleeptime_ms = 0;
-	ulint avg_wait_time_us =ulint(state->sum_waited_us / state->cnt_waited);
-	ulint alloc_wait_us = 1000000 / state->allocated_iops;
-
-	if (avg_wait_time_us < alloc_wait_us) {
-		/* we reading faster than we allocated */
-		add_sleeptime_ms = (alloc_wait_us - avg_wait_time_us) / 1000;
-	} else {
-		/* if page load time is longer than we want, skip sleeping */
-	}
-
-	*sleeptime_ms += add_sleeptime_ms;
-
 	return block;
 }
 
@@ -1695,7 +1783,6 @@ but locks block and then fil_space_latch when freeing page.
 @param[in]		offset		Page offset
 @param[in,out]		mtr		Minitransaction
 @param[out]		allocation_status Allocation status
-@param[out]		sleeptime_ms	Sleep time
 @return block or NULL
 */
 static
@@ -1704,8 +1791,7 @@ btr_scrub_get_block_and_allocation_status(
 	rotate_thread_t*	state,
 	ulint 			offset,
 	mtr_t*			mtr,
-	btr_scrub_page_allocation_status_t *allocation_status,
-	ulint*			sleeptime_ms)
+	btr_scrub_page_allocation_status_t *allocation_status)
 {
 	mtr_t local_mtr;
 	buf_block_t *block = NULL;
@@ -1722,9 +1808,7 @@ btr_scrub_get_block_and_allocation_status(
 	if (*allocation_status == BTR_SCRUB_PAGE_FREE) {
 		/* this is easy case, we lock fil_space_latch first and
 		then block */
-		block = fil_crypt_get_page_throttle(state,
-						    offset, mtr,
-						    sleeptime_ms);
+		block = fil_crypt_get_page_throttle(state, offset, mtr);
 		mtr_commit(&local_mtr);
 	} else {
 		/* page is allocated according to xdes */
@@ -1738,9 +1822,7 @@ btr_scrub_get_block_and_allocation_status(
 		* such as free-ing a page
 		*/
 
-		block = fil_crypt_get_page_throttle(state,
-						    offset, mtr,
-						    sleeptime_ms);
+		block = fil_crypt_get_page_throttle(state, offset, mtr);
 	}
 
 	return block;
@@ -1760,7 +1842,6 @@ fil_crypt_rotate_page(
 	fil_space_t*space = state->space;
 	ulint space_id = space->id;
 	ulint offset = state->offset;
-	ulint sleeptime_ms = 0;
 	fil_space_crypt_t *crypt_data = space->crypt_data;
 
 	ut_ad(space->n_pending_ops > 0);
@@ -1784,8 +1865,7 @@ fil_crypt_rotate_page(
 	mtr_t mtr;
 	mtr.start();
 	if (buf_block_t* block = fil_crypt_get_page_throttle(state,
-							     offset, &mtr,
-							     &sleeptime_ms)) {
+							     offset, &mtr)) {
 		bool modified = false;
 		int needs_scrubbing = BTR_SCRUB_SKIP_PAGE;
 		lsn_t block_lsn = block->page.newest_modification;
@@ -1818,6 +1898,9 @@ fil_crypt_rotate_page(
 			mtr.set_named_space(space);
 			modified = true;
 
+			/* The page will have to be written. */
+			fil_crypt_io_note(state);
+
 			/* force rotation by dummy updating page */
 			mlog_write_ulint(frame + FIL_PAGE_SPACE_ID,
 					 space_id, MLOG_4BYTES, &mtr);
@@ -1847,9 +1930,7 @@ fil_crypt_rotate_page(
 			btr_scrub_page_allocation_status_t allocated;
 
 			block = btr_scrub_get_block_and_allocation_status(
-				state, offset, &mtr,
-				&allocated,
-				&sleeptime_ms);
+				state, offset, &mtr, &allocated);
 
 			if (block) {
 				mtr.set_named_space(space);
@@ -1862,9 +1943,7 @@ fil_crypt_rotate_page(
 					/* we need to refetch it once more now that we have
 					* index locked */
 					block = btr_scrub_get_block_and_allocation_status(
-						state, offset, &mtr,
-						&allocated,
-						&sleeptime_ms);
+						state, offset, &mtr, &allocated);
 
 					needs_scrubbing = btr_scrub_page(&state->scrub_data,
 						block, allocated,
@@ -1919,11 +1998,7 @@ fil_crypt_rotate_page(
 		mtr.commit();
 	}
 
-	if (sleeptime_ms) {
-		os_event_reset(fil_crypt_throttle_sleep_event);
-		os_event_wait_time(fil_crypt_throttle_sleep_event,
-				   1000 * sleeptime_ms);
-	}
+	fil_crypt_io_throttle(state);
 }
 
 /***********************************************************************
@@ -1939,9 +2014,23 @@ fil_crypt_rotate_pages(
 	ulint space = state->space->id;
 	ulint end = std::min(state->offset + state->batch,
 			     state->space->free_limit);
+	fil_space_crypt_t *crypt_data = state->space->crypt_data;
+	ulint pages_done = 0;
 
 	ut_ad(state->space->n_pending_ops > 0);
 
+	/* Rather than flooding the flush list, give the page cleaner
+	some time if the buffer pool is already full of dirty pages. */
+	for (uint i = 0;
+	     i < 10 && srv_max_buf_pool_modified_pct > 0
+	     && buf_get_modified_ratio_pct() >= srv_max_buf_pool_modified_pct
+	     && !state->should_shutdown()
+	     && !state->space->is_stopping();
+	     i++) {
+		os_event_reset(fil_crypt_throttle_sleep_event);
+		os_event_wait_time(fil_crypt_throttle_sleep_event, 100000);
+	}
+
 	for (; state->offset < end; state->offset++) {
 
 		/* we can't rotate pages in dblwr buffer as
@@ -1958,27 +2047,74 @@ fil_crypt_rotate_pages(
 		}
 
 		fil_crypt_rotate_page(key_state, state);
+		pages_done++;
+	}
+
+	mutex_enter(&crypt_data->mutex);
+	crypt_data->rotate_state.pages_done += pages_done;
+	mutex_exit(&crypt_data->mutex);
+
+	DBUG_EXECUTE_IF(
+		"ib_encryption_rotate_pause",
+		while (!state->should_shutdown()
+		       && DBUG_EVALUATE_IF("ib_encryption_rotate_pause",
+					   true, false)) {
+			os_thread_sleep(10000);
+		});
+}
+
+/** Update page 0 of a tablespace after its rotated pages were flushed.
+@param[in,out]	space	tablespace */
+static
+void
+fil_crypt_write_page0(fil_space_t* space)
+{
+	fil_space_crypt_t *crypt_data = space->crypt_data;
+
+	ut_ad(space->n_pending_ops > 0);
+	ut_ad(crypt_data->rotate_state.flushing);
+
+	if (crypt_data->min_key_version == 0) {
+		crypt_data->type = CRYPT_SCHEME_UNENCRYPTED;
 	}
+
+	/* update page 0 */
+	mtr_t mtr;
+	mtr.start();
+
+	dberr_t err;
+
+	if (buf_block_t* block = buf_page_get_gen(
+		    page_id_t(space->id, 0), page_size_t(space->flags),
+		    RW_X_LATCH, NULL, BUF_GET,
+		    __FILE__, __LINE__, &mtr, &err)) {
+		mtr.set_named_space(space);
+		crypt_data->write_page0(space, block->frame, &mtr);
+	}
+
+	mtr.commit();
 }
 
 /***********************************************************************
-Flush rotated pages and then update page 0
+Flush the pages that were rotated in the tablespaces of
+state->flush_batch, and then update page 0 of those tablespaces.
+A single flush-list batch covers all the tablespaces, instead of
+one batch for each (possibly tiny) tablespace.
 
 @param[in,out]		state	rotation state */
 static
 void
-fil_crypt_flush_space(
+fil_crypt_flush_batch(
 	rotate_thread_t*	state)
 {
-	fil_space_t* space = state->space;
-	fil_space_crypt_t *crypt_data = space->crypt_data;
-
-	ut_ad(space->n_pending_ops > 0);
+	if (!state->n_flush_batch) {
+		return;
+	}
 
 	/* flush tablespace pages so that there are no pages left with old key */
-	lsn_t end_lsn = crypt_data->rotate_state.end_lsn;
+	const lsn_t end_lsn = state->flush_lsn;
 
-	if (end_lsn > 0 && !space->is_stopping()) {
+	if (end_lsn > 0) {
 		bool success = false;
 		ulint n_pages = 0;
 		ulint sum_pages = 0;
@@ -1988,7 +2124,7 @@ fil_crypt_flush_space(
 			success = buf_flush_lists(ULINT_MAX, end_lsn, &n_pages);
 			buf_flush_wait_batch_end(NULL, BUF_FLUSH_LIST);
 			sum_pages += n_pages;
-		} while (!success && !space->is_stopping());
+		} while (!success);
 
 		uintmax_t end = ut_time_us(NULL);
 
@@ -2001,25 +2137,38 @@ fil_crypt_flush_space(
 		}
 	}
 
-	if (crypt_data->min_key_version == 0) {
-		crypt_data->type = CRYPT_SCHEME_UNENCRYPTED;
-	}
+	for (ulint i = 0; i < state->n_flush_batch; i++) {
+		/* The tablespace may have been dropped meanwhile. */
+		fil_space_t* space = fil_space_acquire_silent(
+			state->flush_batch[i]);
 
-	/* update page 0 */
-	mtr_t mtr;
-	mtr.start();
+		if (!space) {
+			continue;
+		}
 
-	dberr_t err;
+		fil_space_crypt_t *crypt_data = space->crypt_data;
 
-	if (buf_block_t* block = buf_page_get_gen(
-		    page_id_t(space->id, 0), page_size_t(space->flags),
-		    RW_X_LATCH, NULL, BUF_GET,
-		    __FILE__, __LINE__, &mtr, &err)) {
-		mtr.set_named_space(space);
-		crypt_data->write_page0(space, block->frame, &mtr);
+		mutex_enter(&crypt_data->mutex);
+		/* If a new rotation was started meanwhile, it will
+		update page 0 when it completes. */
+		const bool write = !crypt_data->rotate_state.active_threads
+			&& !crypt_data->rotate_state.flushing;
+		crypt_data->rotate_state.flushing |= write;
+		mutex_exit(&crypt_data->mutex);
+
+		if (write) {
+			fil_crypt_write_page0(space);
+
+			mutex_enter(&crypt_data->mutex);
+			crypt_data->rotate_state.flushing = false;
+			mutex_exit(&crypt_data->mutex);
+		}
+
+		fil_space_release(space);
 	}
 
-	mtr.commit();
+	state->n_flush_batch = 0;
+	state->flush_lsn = 0;
 }
 
 /***********************************************************************
@@ -2071,10 +2220,10 @@ fil_crypt_complete_rotate_space(
 		* the iteration is done
 		*/
 		bool should_flush = last && done;
+		const lsn_t end_lsn = crypt_data->rotate_state.end_lsn;
 
 		if (should_flush) {
 			/* we're the last active thread */
-			crypt_data->rotate_state.flushing = true;
 			crypt_data->min_key_version =
 				crypt_data->rotate_state.min_key_version_found;
 		}
@@ -2097,11 +2246,23 @@ fil_crypt_complete_rotate_space(
 		}
 
 		if (should_flush) {
-			fil_crypt_flush_space(state);
+			/* Defer the flush and the page 0 update, so
+			that one flush-list batch covers many
+			tablespaces. */
+			if (!state->n_flush_batch) {
+				state->flush_batch_start = time(0);
+			}
 
-			mutex_enter(&crypt_data->mutex);
-			crypt_data->rotate_state.flushing = false;
-			mutex_exit(&crypt_data->mutex);
+			state->flush_batch[state->n_flush_batch++] =
+				state->space->id;
+
+			if (end_lsn > state->flush_lsn) {
+				state->flush_lsn = end_lsn;
+			}
+
+			if (state->n_flush_batch == FIL_CRYPT_FLUSH_BATCH) {
+				fil_crypt_flush_batch(state);
+			}
 		}
 	} else {
 		mutex_enter(&crypt_data->mutex);
@@ -2214,11 +2375,21 @@ DECLARE_THREAD(fil_crypt_thread)(
 
 			/* return iops */
 			fil_crypt_return_iops(&thr);
+
+			if (thr.n_flush_batch
+			    && ulint(time(0) - thr.flush_batch_start)
+			    >= srv_alloc_time) {
+				fil_crypt_flush_batch(&thr);
+			}
 		}
+
+		/* Nothing more to rotate for now. */
+		fil_crypt_flush_batch(&thr);
 	}
 
 	/* return iops if shutting down */
 	fil_crypt_return_iops(&thr);
+	fil_crypt_flush_batch(&thr);
 
 	/* release current space if shutting down */
 	if (thr.space) {
@@ -2451,6 +2622,10 @@ fil_space_crypt_get_status(
 				crypt_data->rotate_state.next_offset;
 			status->rotate_max_page_number =
 				crypt_data->rotate_state.max_offset;
+			status->rotate_active_threads =
+				crypt_data->rotate_state.active_threads;
+			status->rotate_pages_done =
+				crypt_data->rotate_state.pages_done;
 		}
 
 		mutex_exit(&crypt_data->mutex);
@@ -228,6 +228,200 @@ fil_space_belongs_in_lru(
 	return(false);
 }
 
+/** Entry of fil_system->lf_spaces. Page reads look up the data file
+of a tablespace here without acquiring fil_system->mutex. */
+struct fil_space_lf_t {
+	/** tablespace identifier; lf_hash_init() relies on this
+	to be first in the struct */
+	ulint		id;
+	/** the tablespace, or NULL if reads must acquire
+	fil_system->mutex; only set by fil_space_lf_enable() */
+	fil_space_t*	space;
+	/** number of reads that are using space without holding
+	fil_system->mutex */
+	ulint		n_ref;
+	/** number of fil_space_lf_disable_and_wait() calls that are
+	waiting for n_ref to reach 0; protected by fil_system->mutex */
+	ulint		n_waiting;
+};
+
+/** Initialize an entry of fil_system->lf_spaces when it is inserted.
+@param[out]	element	entry
+@param[in,out]	space	tablespace */
+static
+void
+fil_space_lf_initializer(LF_HASH*, fil_space_lf_t* element, fil_space_t* space)
+{
+	element->id = space->id;
+	element->space = NULL;
+	element->n_ref = 0;
+	element->n_waiting = 0;
+	space->lf = element;
+}
+
+/** Allow reads of a tablespace to bypass fil_system->mutex if the
+tablespace consists of a single open data file that is not being
+renamed, dropped or truncated.
+@param[in]	space	tablespace */
+static
+void
+fil_space_lf_enable(fil_space_t* space)
+{
+	ut_ad(mutex_own(&fil_system->mutex));
+
+	if (!space->lf
+	    || space->lf->n_waiting
+	    || space->purpose != FIL_TYPE_TABLESPACE
+	    || space->stop_ios
+	    || space->is_stopping()
+	    || srv_is_undo_tablespace(space->id)
+	    || UT_LIST_GET_LEN(space->chain) != 1) {
+		return;
+	}
+
+	const fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
+
+	if (node->is_open() && node->size > 0 && !space->lf->space) {
+		my_atomic_storeptr(
+			reinterpret_cast<void**>(&space->lf->space), space);
+	}
+}
+
+/** Make reads of a tablespace acquire fil_system->mutex again.
+@param[in]	space	tablespace
+@return number of reads that are still being executed without
+fil_system->mutex */
+static
+ulint
+fil_space_lf_disable(fil_space_t* space)
+{
+	ut_ad(mutex_own(&fil_system->mutex));
+
+	if (!space->lf) {
+		return(0);
+	}
+
+	if (space->lf->space) {
+		my_atomic_storeptr(
+			reinterpret_cast<void**>(&space->lf->space), NULL);
+	}
+
+	return(my_atomic_loadlint(&space->lf->n_ref));
+}
+
+/** Check if the data files of a tablespace have no pending operations
+that would prevent closing, truncating or detaching them.
+@param[in]	space	tablespace
+@return whether no i/o, flushes or extension are pending */
+static
+bool
+fil_space_is_idle(const fil_space_t* space)
+{
+	ut_ad(mutex_own(&fil_system->mutex));
+
+	for (const fil_node_t* node = UT_LIST_GET_FIRST(space->chain);
+	     node != NULL;
+	     node = UT_LIST_GET_NEXT(chain, node)) {
+
+		if (node->n_pending > 0
+		    || node->n_pending_flushes > 0
+		    || node->being_extended) {
+
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** Make reads of a tablespace acquire fil_system->mutex again, and wait
+for the reads that are being executed without the mutex.
+
+A read that was queued with IORequest::DO_NOT_WAKE is only submitted
+when the issuing thread wakes up the i/o handler threads, and that
+thread may first have to acquire fil_system->mutex for its next
+fil_io(). Therefore, fil_system->mutex is released while waiting.
+Meanwhile, other threads may start i/o, flush or extend the files,
+so we also wait until none of that is pending. While we are waiting,
+fil_try_to_close_file_in_LRU() will not close the files. Thus, the
+caller will observe the same state as if the mutex had been held
+all the time, except that the files may have been opened.
+@param[in,out]	space	tablespace */
+static
+void
+fil_space_lf_disable_and_wait(fil_space_t* space)
+{
+	ut_ad(mutex_own(&fil_system->mutex));
+
+	if (!fil_space_lf_disable(space)) {
+		return;
+	}
+
+	/* Prevent fil_io() from enabling the lock-free reads again,
+	and fil_try_to_close_file_in_LRU() from closing the files. */
+	fil_space_lf_t*	lf = space->lf;
+	lf->n_waiting++;
+
+	do {
+		mutex_exit(&fil_system->mutex);
+		os_thread_sleep(100);
+		mutex_enter(&fil_system->mutex);
+
+		ut_ad(space->lf == lf);
+	} while (fil_space_lf_disable(space) || !fil_space_is_idle(space));
+
+	lf->n_waiting--;
+}
+
+/** Look up the data file of a page read without acquiring
+fil_system->mutex.
+@param[in]	page_id	page to be read
+@return data file, to be released by fil_node_io_done()
+@retval NULL if the read must acquire fil_system->mutex */
+static
+fil_node_t*
+fil_node_acquire_lf(const page_id_t& page_id)
+{
+	LF_PINS*	pins = lf_hash_get_pins(&fil_system->lf_spaces);
+
+	if (!pins) {
+		return(NULL);
+	}
+
+	ulint		id = page_id.space();
+	fil_node_t*	node = NULL;
+	fil_space_lf_t*	element = static_cast<fil_space_lf_t*>(
+		lf_hash_search(&fil_system->lf_spaces, pins, &id, sizeof id));
+
+	if (element) {
+		/* fil_space_lf_disable() stores space=NULL before
+		reading n_ref, while we increment n_ref before reading
+		space. Thus, either we will fall back to the mutex,
+		or fil_space_lf_disable() will see our reference. */
+		my_atomic_addlint(&element->n_ref, 1);
+
+		if (fil_space_t* space = static_cast<fil_space_t*>(
+			    my_atomic_loadptr(reinterpret_cast<void**>(
+						      &element->space)))) {
+			node = UT_LIST_GET_FIRST(space->chain);
+
+			if (node->size <= page_id.page_no()
+			    || space->stop_ios || space->is_stopping()) {
+				node = NULL;
+			}
+		}
+
+		if (!node) {
+			my_atomic_addlint(&element->n_ref, ulint(-1));
+		}
+
+		lf_hash_search_unpin(pins);
+	}
+
+	lf_hash_put_pins(pins);
+	return(node);
+}
+
 /********************************************************************//**
 NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
 
@@ -775,7 +969,8 @@ fil_node_open_file(
 	return(true);
 }
 
-/** Close a file node.
+/** Close a file node. If reads are being executed without
+fil_system->mutex, the mutex will be released while waiting for them.
 @param[in,out]	node	File node */
 static
 void
@@ -786,6 +981,14 @@ fil_node_close_file(
 
 	ut_ad(mutex_own(&(fil_system->mutex)));
 	ut_a(node->is_open());
+	fil_space_lf_disable_and_wait(node->space);
+
+	if (!node->is_open()) {
+		/* Another thread closed the file while we were
+		waiting for fil_system->mutex. */
+		return;
+	}
+
 	ut_a(node->n_pending == 0);
 	ut_a(node->n_pending_flushes == 0);
 	ut_a(!node->being_extended);
@@ -844,7 +1047,9 @@ fil_try_to_close_file_in_LRU(
 
 		if (node->modification_counter == node->flush_counter
 		    && node->n_pending_flushes == 0
-		    && !node->being_extended) {
+		    && !node->being_extended
+		    && !(node->space->lf && node->space->lf->n_waiting)
+		    && !fil_space_lf_disable(node->space)) {
 
 			fil_node_close_file(node);
 
@@ -1336,6 +1541,8 @@ fil_node_close_to_free(
 /** Detach a space object from the tablespace memory cache.
 Closes the files in the chain but does not delete them.
 There must not be any pending i/o's or flushes on the files.
+fil_system->mutex may be released and reacquired; see
+fil_space_lf_disable_and_wait().
 @param[in,out]	space		tablespace */
 static
 void
@@ -1344,6 +1551,18 @@ fil_space_detach(
 {
 	ut_ad(mutex_own(&fil_system->mutex));
 
+	if (space->lf) {
+		fil_space_lf_disable_and_wait(space);
+
+		LF_PINS*	pins = lf_hash_get_pins(&fil_system->lf_spaces);
+		ut_a(pins);
+		int	err = lf_hash_delete(&fil_system->lf_spaces, pins,
+					     &space->id, sizeof space->id);
+		ut_a(err == 0);
+		lf_hash_put_pins(pins);
+		space->lf = NULL;
+	}
+
 	HASH_DELETE(fil_space_t, hash, fil_system->spaces, space->id, space);
 
 	fil_space_t*	fnamespace = fil_space_get_by_name(space->name);
@@ -1578,6 +1797,14 @@ fil_space_create(
 	HASH_INSERT(fil_space_t, name_hash, fil_system->name_hash,
 		    ut_fold_string(name), space);
 
+	if (purpose != FIL_TYPE_LOG) {
+		LF_PINS*	pins = lf_hash_get_pins(&fil_system->lf_spaces);
+		ut_a(pins);
+		int	err = lf_hash_insert(&fil_system->lf_spaces, pins, space);
+		ut_a(err == 0);
+		lf_hash_put_pins(pins);
+	}
+
 	UT_LIST_ADD_LAST(fil_system->space_list, space);
 
 	if (id < SRV_LOG_SPACE_FIRST_ID && id > fil_system->max_assigned_id) {
@@ -1943,6 +2170,11 @@ fil_init(
 		     &fil_space_t::unflushed_spaces);
 	UT_LIST_INIT(fil_system->named_spaces, &fil_space_t::named_spaces);
 
+	lf_hash_init(&fil_system->lf_spaces, sizeof(fil_space_lf_t),
+		     LF_HASH_UNIQUE, 0, sizeof(ulint), 0, &my_charset_bin);
+	fil_system->lf_spaces.initializer = reinterpret_cast<
+		lf_hash_initializer>(fil_space_lf_initializer);
+
 	fil_system->max_n_open = max_n_open;
 
 	fil_space_crypt_init();
@@ -2801,7 +3033,8 @@ fil_check_pending_io(
 
 	*node = UT_LIST_GET_FIRST(space->chain);
 
-	if (space->n_pending_flushes > 0 || (*node)->n_pending > 0) {
+	if (space->n_pending_flushes > 0 || (*node)->n_pending > 0
+	    || fil_space_lf_disable(space)) {
 
 		ut_a(!(*node)->being_extended);
 
@@ -3159,6 +3392,7 @@ fil_truncate_tablespace(
 
 	ut_ad(node->is_open());
 
+	fil_space_lf_disable_and_wait(space);
 	space->size = node->size = size_in_pages;
 
 	bool success = os_file_truncate(node->name, node->handle, 0);
@@ -3260,6 +3494,7 @@ fil_reinit_space_header_for_table(
 
 	fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
 
+	fil_space_lf_disable_and_wait(space);
 	space->size = node->size = size;
 
 	mutex_exit(&fil_system->mutex);
@@ -3590,7 +3825,8 @@ fil_rename_tablespace(
 
 	if (node->n_pending > 0
 	    || node->n_pending_flushes > 0
-	    || node->being_extended) {
+	    || node->being_extended
+	    || fil_space_lf_disable(space)) {
 		/* There are pending i/o's or flushes or the file is
 		currently being extended, sleep for a while and
 		retry */
@@ -4987,6 +5223,37 @@ fil_node_complete_io(fil_node_t* node, const IORequest& type)
 	}
 }
 
+/** Account for a finished i/o operation in the statistics of the
+tablespace, and release the file node.
+@param[in,out]	node	file node
+@param[in]	type	IO context */
+static
+void
+fil_node_io_done(fil_node_t* node, const IORequest& type)
+{
+	fil_space_t*	space = node->space;
+	ulint		us = ulint(ut_time_us(NULL) - type.start_time());
+
+	if (type.is_read()) {
+		my_atomic_addlint(&space->n_reads, 1);
+		my_atomic_addlint(&space->read_time_us, us);
+	} else {
+		my_atomic_addlint(&space->n_writes, 1);
+		my_atomic_addlint(&space->write_time_us, us);
+	}
+
+	if (type.is_no_fil_mutex()) {
+		/* fil_space_detach() waits for this; the reference
+		keeps space->lf valid. */
+		ut_ad(type.is_read());
+		my_atomic_addlint(&space->lf->n_ref, ulint(-1));
+	} else {
+		mutex_enter(&fil_system->mutex);
+		fil_node_complete_io(node, type);
+		mutex_exit(&fil_system->mutex);
+	}
+}
+
 /** Report information about an invalid page access. */
 static
 void
@@ -5101,12 +5368,27 @@ fil_io(
 		srv_stats.data_written.add(len);
 	}
 
+	req_type.set_start_time(ut_time_us(NULL));
+
+	fil_space_t*	space;
+	ulint		cur_page_no = page_id.page_no();
+	fil_node_t*	node;
+
+	/* Page reads of open single-file tablespaces do not need
+	fil_system->mutex; see fil_space_lf_enable(). */
+	if (req_type.is_read() && !req_type.is_log()
+	    && (node = fil_node_acquire_lf(page_id)) != NULL) {
+		req_type.set_no_fil_mutex();
+		space = node->space;
+		goto do_io;
+	}
+
 	/* Reserve the fil_system mutex and make sure that we can open at
 	least one file while holding it, if the file is not already open */
 
 	fil_mutex_enter_and_prepare_for_io(page_id.space());
 
-	fil_space_t*	space = fil_space_get_by_id(page_id.space());
+	space = fil_space_get_by_id(page_id.space());
 
 	/* If we are deleting a tablespace we don't allow async read operations
 	on that. However, we do allow write operations and sync read operations. */
@@ -5132,8 +5414,7 @@ fil_io(
 
 	ut_ad(mode != OS_AIO_IBUF || fil_type_is_data(space->purpose));
 
-	ulint		cur_page_no = page_id.page_no();
-	fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
+	node = UT_LIST_GET_FIRST(space->chain);
 
 	for (;;) {
 
@@ -5230,9 +5511,18 @@ fil_io(
 			space->name, byte_offset, len, req_type.is_read());
 	}
 
+	if (req_type.is_read()) {
+		fil_space_lf_enable(space);
+	}
+
 	/* Now we have made the changes in the data structures of fil_system */
 	mutex_exit(&fil_system->mutex);
 
+do_io:
+	my_atomic_addlint(req_type.is_read()
+			  ? &space->n_read_bytes : &space->n_write_bytes,
+			  len);
+
 	/* Calculate the low 32 bits and the high 32 bits of the file offset */
 
 	if (!page_size.is_compressed()) {
@@ -5291,11 +5581,7 @@ fil_io(
 		/* The i/o operation is already completed when we return from
 		os_aio: */
 
-		mutex_enter(&fil_system->mutex);
-
-		fil_node_complete_io(node, req_type);
-
-		mutex_exit(&fil_system->mutex);
+		fil_node_io_done(node, req_type);
 
 		ut_ad(fil_validate_skip());
 	}
@@ -5331,14 +5617,11 @@ fil_aio_wait(
 
 	srv_set_io_thread_op_info(segment, "complete io for fil node");
 
-	mutex_enter(&fil_system->mutex);
-
-	fil_node_complete_io(node, type);
 	const fil_type_t	purpose	= node->space->purpose;
 	const ulint		space_id= node->space->id;
 	const bool		dblwr	= node->space->use_doublewrite();
 
-	mutex_exit(&fil_system->mutex);
+	fil_node_io_done(node, type);
 
 	ut_ad(fil_validate_skip());
 
@@ -5645,6 +5928,7 @@ fil_close(void)
 		ut_a(UT_LIST_GET_LEN(fil_system->unflushed_spaces) == 0);
 		ut_a(UT_LIST_GET_LEN(fil_system->space_list) == 0);
 
+		lf_hash_destroy(&fil_system->lf_spaces);
 		mutex_free(&fil_system->mutex);
 
 		ut_free(fil_system);
@@ -6464,6 +6748,7 @@ truncate_t::truncate(
 	fil_node_t*	node = UT_LIST_GET_FIRST(space->chain);
 
 	if (trunc_to_default) {
+		fil_space_lf_disable_and_wait(space);
 		space->size = node->size = FIL_IBD_FILE_INITIAL_SIZE;
 	}
 
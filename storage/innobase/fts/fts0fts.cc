@@ -200,7 +200,6 @@ struct fts_tokenize_param_t {
 /** Run SYNC on the table, i.e., write out data from the cache to the
 FTS auxiliary INDEX table and clear the cache at the end.
 @param[in,out]	sync		sync state
-@param[in]	unlock_cache	whether unlock cache lock when write node
 @param[in]	wait		whether wait when a sync is in progress
 @param[in]      has_dict        whether has dict operation lock
 @return DB_SUCCESS if all OK */
@@ -208,7 +207,6 @@ static
 dberr_t
 fts_sync(
 	fts_sync_t*	sync,
-	bool		unlock_cache,
 	bool		wait,
 	bool		has_dict);
 
@@ -909,6 +907,15 @@ fts_drop_index(
 				if (!retry && index_cache->words) {
 					fts_words_free(index_cache->words);
 					rbt_free(index_cache->words);
+
+					if (index_cache->sync_words) {
+						fts_words_free(
+							index_cache
+							->sync_words);
+						rbt_free(
+							index_cache
+							->sync_words);
+					}
 					break;
 				}
 				DICT_BG_YIELD(trx);
@@ -1111,6 +1118,12 @@ fts_cache_clear(
 
 		index_cache->words = NULL;
 
+		if (index_cache->sync_words != NULL) {
+			fts_words_free(index_cache->sync_words);
+			rbt_free(index_cache->sync_words);
+			index_cache->sync_words = NULL;
+		}
+
 		for (j = 0; j < FTS_NUM_AUX_INDEX; ++j) {
 
 			if (index_cache->ins_graph[j] != NULL) {
@@ -1144,7 +1157,13 @@ fts_cache_clear(
 
 	mutex_enter((ib_mutex_t*) &cache->deleted_lock);
 	cache->deleted_doc_ids = NULL;
+	cache->sync->deleted_doc_ids = NULL;
 	mutex_exit((ib_mutex_t*) &cache->deleted_lock);
+
+	if (cache->sync->heap != NULL) {
+		mem_heap_free(cache->sync->heap);
+		cache->sync->heap = NULL;
+	}
 }
 
 /*********************************************************************//**
@@ -2913,6 +2932,15 @@ fts_doc_ids_free(
 	mem_heap_free(heap);
 }
 
+/** Account for a document that was added to the cache.
+@param[in,out]	table	table of the document
+@param[in]	doc_id	document id */
+static
+void
+fts_added(
+	dict_table_t*	table,
+	doc_id_t	doc_id);
+
 /*********************************************************************//**
 Do commit-phase steps necessary for the insertion of a new row. */
 void
@@ -2928,6 +2956,18 @@ fts_add(
 
 	fts_add_doc_by_id(ftt, doc_id, row->fts_indexes);
 
+	fts_added(table, doc_id);
+}
+
+/** Account for a document that was added to the cache.
+@param[in,out]	table	table of the document
+@param[in]	doc_id	document id */
+static
+void
+fts_added(
+	dict_table_t*	table,
+	doc_id_t	doc_id)
+{
 	mutex_enter(&table->fts->cache->deleted_lock);
 	++table->fts->cache->added;
 	mutex_exit(&table->fts->cache->deleted_lock);
@@ -3056,6 +3096,148 @@ fts_modify(
 	return(error);
 }
 
+/** Minimum number of inserted documents for each thread that
+tokenizes them at commit */
+#define FTS_ADD_PLL_MIN_ROWS	1000
+
+/** Number of inserted documents that a tokenizing thread claims
+at a time */
+#define FTS_ADD_PLL_BATCH	64
+
+/** State of a parallel tokenization of inserted documents */
+struct fts_add_pll_t {
+	/** FTS trx table */
+	fts_trx_table_t*	ftt;
+	/** the inserted rows, in doc id order */
+	fts_trx_row_t**		rows;
+	/** number of inserted rows */
+	ulint			n_rows;
+	/** first row of the next unclaimed batch */
+	ulint			next;
+	/** number of started threads that are still running */
+	ulint			n_running;
+	/** signalled when a started thread exits */
+	os_event_t		done;
+};
+
+/** Tokenize inserted documents into the cache, claiming batches of
+consecutive doc ids until all of them have been added.
+@param[in,out]	pll	parallel tokenization state */
+static
+void
+fts_add_pll_docs(
+	fts_add_pll_t*	pll)
+{
+	for (;;) {
+		ulint	first = my_atomic_addlint(
+			&pll->next, FTS_ADD_PLL_BATCH);
+
+		if (first >= pll->n_rows) {
+			break;
+		}
+
+		ulint	last = std::min<ulint>(
+			first + FTS_ADD_PLL_BATCH, pll->n_rows);
+
+		for (ulint i = first; i < last; i++) {
+			fts_trx_row_t*	row = pll->rows[i];
+
+			fts_add_doc_by_id(
+				pll->ftt, row->doc_id, row->fts_indexes);
+		}
+	}
+}
+
+/** Tokenizing thread, started by fts_add_pll().
+@param[in,out]	arg	parallel tokenization state
+@return this function does not return, it calls os_thread_exit() */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(fts_add_pll_thread)(void* arg)
+{
+	my_thread_init();
+
+	fts_add_pll_t*	pll = static_cast<fts_add_pll_t*>(arg);
+
+	fts_add_pll_docs(pll);
+
+	os_event_set(pll->done);
+	my_atomic_addlint(&pll->n_running, ulint(-1));
+
+	my_thread_end();
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Tokenize the documents inserted by a committing transaction
+with innodb_ft_sort_pll_degree threads, and add them to the cache.
+@param[in,out]	ftt		FTS trx table
+@param[in]	n_inserts	number of rows in the FTS_INSERT state
+@return whether the documents were added */
+static
+bool
+fts_add_pll(
+	fts_trx_table_t*	ftt,
+	ulint			n_inserts)
+{
+	ulint	n_threads = std::min<ulint>(
+		fts_sort_pll_degree, n_inserts / FTS_ADD_PLL_MIN_ROWS);
+
+	if (n_threads < 2) {
+		return(false);
+	}
+
+	/* The workers must not initialize the index concurrently. */
+	if (!(ftt->table->fts->fts_status & ADDED_TABLE_SYNCED)) {
+		fts_init_index(ftt->table, FALSE);
+	}
+
+	fts_add_pll_t	pll;
+
+	pll.ftt = ftt;
+	pll.rows = static_cast<fts_trx_row_t**>(
+		ut_malloc_nokey(n_inserts * sizeof *pll.rows));
+	pll.n_rows = 0;
+	pll.next = 0;
+	pll.n_running = n_threads - 1;
+	pll.done = os_event_create(0);
+
+	for (const ib_rbt_node_t* node = rbt_first(ftt->rows);
+	     node != NULL;
+	     node = rbt_next(ftt->rows, node)) {
+
+		fts_trx_row_t*	row = rbt_value(fts_trx_row_t, node);
+
+		if (row->state == FTS_INSERT) {
+			pll.rows[pll.n_rows++] = row;
+		}
+	}
+
+	ut_ad(pll.n_rows == n_inserts);
+
+	for (ulint i = 1; i < n_threads; i++) {
+		os_thread_create(fts_add_pll_thread, &pll, NULL);
+	}
+
+	fts_add_pll_docs(&pll);
+
+	for (;;) {
+		int64_t	sig_count = os_event_reset(pll.done);
+
+		if (!my_atomic_loadlint(&pll.n_running)) {
+			break;
+		}
+
+		os_event_wait_time_low(pll.done, 100000, sig_count);
+	}
+
+	os_event_destroy(pll.done);
+	ut_free(pll.rows);
+
+	return(true);
+}
+
 /*********************************************************************//**
 The given transaction is about to be committed; do whatever is necessary
 from the FTS system's POV.
@@ -3090,6 +3272,16 @@ fts_commit_table(
 		rw_lock_x_unlock(&cache->init_lock);
 	}
 
+	ulint	n_inserts = 0;
+
+	for (node = rbt_first(rows); node != NULL; node = rbt_next(rows, node)) {
+		n_inserts += rbt_value(fts_trx_row_t, node)->state
+			== FTS_INSERT;
+	}
+
+	/* Large inserts are tokenized by multiple threads. */
+	const bool	added = fts_add_pll(ftt, n_inserts);
+
 	for (node = rbt_first(rows);
 	     node != NULL && error == DB_SUCCESS;
 	     node = rbt_next(rows, node)) {
@@ -3098,7 +3290,11 @@ fts_commit_table(
 
 		switch (row->state) {
 		case FTS_INSERT:
-			fts_add(ftt, row);
+			if (added) {
+				fts_added(ftt->table, row->doc_id);
+			} else {
+				fts_add(ftt, row);
+			}
 			break;
 
 		case FTS_MODIFY:
@@ -3480,7 +3676,7 @@ fts_add_doc_from_tuple(
 
                        if (cache->total_size > fts_max_cache_size / 5
                            || fts_need_sync) {
-                               fts_sync(cache->sync, true, false, false);
+                               fts_sync(cache->sync, false, false);
                        }
 
                        mtr_start(&mtr);
@@ -3658,7 +3854,7 @@ fts_add_doc_by_id(
 
 				DBUG_EXECUTE_IF(
 					"fts_instrument_sync_debug",
-					fts_sync(cache->sync, true, true, false);
+					fts_sync(cache->sync, true, false);
 				);
 
 				DEBUG_SYNC_C("fts_instrument_sync_request");
@@ -4009,7 +4205,10 @@ fts_sync_add_deleted_cache(
 
 	ut_a(ib_vector_size(doc_ids) > 0);
 
+	/* Queries may be reading the doc ids concurrently. */
+	mutex_enter(&sync->table->fts->cache->deleted_lock);
 	ib_vector_sort(doc_ids, fts_update_doc_id_cmp);
+	mutex_exit(&sync->table->fts->cache->deleted_lock);
 
 	info = pars_info_create();
 
@@ -4044,17 +4243,16 @@ fts_sync_add_deleted_cache(
 	return(error);
 }
 
-/** Write the words and ilist to disk.
+/** Write the words and ilist to disk. The cache lock is not held,
+because new documents are added to fts_index_cache_t::words.
 @param[in,out]	trx		transaction
 @param[in]	index_cache	index cache
-@param[in]	unlock_cache	whether unlock cache when write node
 @return DB_SUCCESS if all went well else error code */
 static MY_ATTRIBUTE((nonnull, warn_unused_result))
 dberr_t
 fts_sync_write_words(
 	trx_t*			trx,
-	fts_index_cache_t*	index_cache,
-	bool			unlock_cache)
+	fts_index_cache_t*	index_cache)
 {
 	fts_table_t	fts_table;
 	ulint		n_nodes = 0;
@@ -4062,18 +4260,18 @@ fts_sync_write_words(
 	const ib_rbt_node_t* rbt_node;
 	dberr_t		error = DB_SUCCESS;
 	ibool		print_error = FALSE;
-	dict_table_t*	table = index_cache->index->table;
+	ib_rbt_t*	words = index_cache->sync_words;
 
 	FTS_INIT_INDEX_TABLE(
 		&fts_table, NULL, FTS_INDEX_TABLE, index_cache->index);
 
-	n_words = rbt_size(index_cache->words);
+	n_words = rbt_size(words);
 
 	/* We iterate over the entire tree, even if there is an error,
 	since we want to free the memory used during caching. */
-	for (rbt_node = rbt_first(index_cache->words);
+	for (rbt_node = rbt_first(words);
 	     rbt_node;
-	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+	     rbt_node = rbt_next(words, rbt_node)) {
 
 		ulint			i;
 		ulint			selected;
@@ -4101,11 +4299,6 @@ fts_sync_write_words(
 
 			/*FIXME: we need to handle the error properly. */
 			if (error == DB_SUCCESS) {
-				if (unlock_cache) {
-					rw_lock_x_unlock(
-						&table->fts->cache->lock);
-				}
-
 				error = fts_write_node(
 					trx,
 					&index_cache->ins_graph[selected],
@@ -4118,11 +4311,6 @@ fts_sync_write_words(
 				DBUG_EXECUTE_IF("fts_instrument_sync_sleep",
 					os_thread_sleep(1000000);
 				);
-
-				if (unlock_cache) {
-					rw_lock_x_lock(
-						&table->fts->cache->lock);
-				}
 			}
 		}
 
@@ -4185,65 +4373,141 @@ fts_sync_index(
 	trx->op_info = "doing SYNC index";
 
 	if (fts_enable_diag_print) {
-		ib::info() << "SYNC words: " << rbt_size(index_cache->words);
+		ib::info() << "SYNC words: "
+			<< rbt_size(index_cache->sync_words);
 	}
 
-	ut_ad(rbt_validate(index_cache->words));
+	ut_ad(rbt_validate(index_cache->sync_words));
 
-	return(fts_sync_write_words(trx, index_cache, sync->unlock_cache));
+	return(fts_sync_write_words(trx, index_cache));
 }
 
-/** Check if index cache has been synced completely
-@param[in,out]	index_cache	index cache
-@return true if index is synced, otherwise false. */
+/** Reset synced flag in index cache when rollback
+@param[in,out]	index_cache	index cache */
 static
-bool
-fts_sync_index_check(
+void
+fts_sync_index_reset(
 	fts_index_cache_t*	index_cache)
 {
 	const ib_rbt_node_t*	rbt_node;
 
-	for (rbt_node = rbt_first(index_cache->words);
+	for (rbt_node = rbt_first(index_cache->sync_words);
 	     rbt_node != NULL;
-	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+	     rbt_node = rbt_next(index_cache->sync_words, rbt_node)) {
 
 		fts_tokenizer_word_t*	word;
 		word = rbt_value(fts_tokenizer_word_t, rbt_node);
 
-		fts_node_t*	fts_node;
-		fts_node = static_cast<fts_node_t*>(ib_vector_last(word->nodes));
-
-		if (!fts_node->synced) {
-			return(false);
+		for (ulint i = 0; i < ib_vector_size(word->nodes); ++i) {
+			static_cast<fts_node_t*>(
+				ib_vector_get(word->nodes, i))->synced = false;
 		}
 	}
-
-	return(true);
 }
 
-/** Reset synced flag in index cache when rollback
+/** Free the query graphs that SYNC used for an index.
 @param[in,out]	index_cache	index cache */
 static
 void
-fts_sync_index_reset(
+fts_sync_index_free_graphs(
 	fts_index_cache_t*	index_cache)
 {
-	const ib_rbt_node_t*	rbt_node;
+	for (ulint j = 0; fts_index_selector[j].value; ++j) {
 
-	for (rbt_node = rbt_first(index_cache->words);
-	     rbt_node != NULL;
-	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+		if (index_cache->ins_graph[j] != NULL) {
 
-		fts_tokenizer_word_t*	word;
-		word = rbt_value(fts_tokenizer_word_t, rbt_node);
+			fts_que_graph_free_check_lock(
+				NULL, index_cache,
+				index_cache->ins_graph[j]);
+
+			index_cache->ins_graph[j] = NULL;
+		}
 
-		fts_node_t*	fts_node;
-		fts_node = static_cast<fts_node_t*>(ib_vector_last(word->nodes));
+		if (index_cache->sel_graph[j] != NULL) {
 
-		fts_node->synced = false;
+			fts_que_graph_free_check_lock(
+				NULL, index_cache,
+				index_cache->sel_graph[j]);
+
+			index_cache->sel_graph[j] = NULL;
+		}
 	}
 }
 
+/** Detach the contents of the cache for writing them to disk, and
+start collecting new documents into empty words trees. Queries keep
+searching the detached words until the SYNC completes.
+@param[in,out]	sync	sync state */
+static
+void
+fts_sync_switch(
+	fts_sync_t*	sync)
+{
+	fts_cache_t*	cache = sync->table->fts->cache;
+
+	ut_ad(rw_lock_own(&cache->lock, RW_LOCK_X));
+	ut_ad(sync->heap == NULL);
+
+	sync->heap = static_cast<mem_heap_t*>(cache->sync_heap->arg);
+	sync->sync_doc_id = sync->max_doc_id;
+	cache->sync_heap->arg = NULL;
+
+	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+		fts_index_cache_t*	index_cache;
+
+		index_cache = static_cast<fts_index_cache_t*>(
+			ib_vector_get(cache->indexes, i));
+
+		ut_ad(index_cache->sync_words == NULL);
+
+		index_cache->sync_words = index_cache->words;
+		index_cache->words = NULL;
+		index_cache->doc_stats = NULL;
+	}
+
+	mutex_enter(&cache->deleted_lock);
+	sync->deleted_doc_ids = cache->deleted_doc_ids;
+	mutex_exit(&cache->deleted_lock);
+
+	fts_need_sync = false;
+
+	fts_cache_init(cache);
+}
+
+/** Free the contents that were written by a SYNC.
+@param[in,out]	sync	sync state */
+static
+void
+fts_sync_free(
+	fts_sync_t*	sync)
+{
+	fts_cache_t*	cache = sync->table->fts->cache;
+
+	ut_ad(rw_lock_own(&cache->lock, RW_LOCK_X));
+
+	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+		fts_index_cache_t*	index_cache;
+
+		index_cache = static_cast<fts_index_cache_t*>(
+			ib_vector_get(cache->indexes, i));
+
+		if (index_cache->sync_words != NULL) {
+			fts_words_free(index_cache->sync_words);
+			rbt_free(index_cache->sync_words);
+			index_cache->sync_words = NULL;
+		}
+
+		fts_sync_index_free_graphs(index_cache);
+	}
+
+	mutex_enter(&cache->deleted_lock);
+	sync->deleted_doc_ids = NULL;
+	mutex_exit(&cache->deleted_lock);
+
+	mem_heap_free(sync->heap);
+	sync->heap = NULL;
+}
+
 /** Commit the SYNC, change state of processed doc ids etc.
 @param[in,out]	sync	sync state
 @return DB_SUCCESS if all OK */
@@ -4261,24 +4525,22 @@ fts_sync_commit(
 
 	/* After each Sync, update the CONFIG table about the max doc id
 	we just sync-ed to index table */
-	error = fts_cmp_set_sync_doc_id(sync->table, sync->max_doc_id, FALSE,
+	error = fts_cmp_set_sync_doc_id(sync->table, sync->sync_doc_id, FALSE,
 					&last_doc_id);
 
 	/* Get the list of deleted documents that are either in the
 	cache or were headed there but were deleted before the add
 	thread got to them. */
 
-	if (error == DB_SUCCESS && ib_vector_size(cache->deleted_doc_ids) > 0) {
+	if (error == DB_SUCCESS && ib_vector_size(sync->deleted_doc_ids) > 0) {
 
 		error = fts_sync_add_deleted_cache(
-			sync, cache->deleted_doc_ids);
+			sync, sync->deleted_doc_ids);
 	}
 
-	/* We need to do this within the deleted lock since fts_delete() can
-	attempt to add a deleted doc id to the cache deleted id array. */
-	fts_cache_clear(cache);
+	rw_lock_x_lock(&cache->lock);
+	fts_sync_free(sync);
 	DEBUG_SYNC_C("fts_deleted_doc_ids_clear");
-	fts_cache_init(cache);
 	rw_lock_x_unlock(&cache->lock);
 
 	if (error == DB_SUCCESS) {
@@ -4308,7 +4570,8 @@ fts_sync_commit(
 	return(error);
 }
 
-/** Rollback a sync operation
+/** Rollback a sync operation. The contents that were being written
+are kept for the next SYNC.
 @param[in,out]	sync	sync state */
 static
 void
@@ -4318,8 +4581,9 @@ fts_sync_rollback(
 	trx_t*		trx = sync->trx;
 	fts_cache_t*	cache = sync->table->fts->cache;
 
+	rw_lock_x_lock(&cache->lock);
+
 	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
-		ulint			j;
 		fts_index_cache_t*	index_cache;
 
 		index_cache = static_cast<fts_index_cache_t*>(
@@ -4327,28 +4591,11 @@ fts_sync_rollback(
 
 		/* Reset synced flag so nodes will not be skipped
 		in the next sync, see fts_sync_write_words(). */
-		fts_sync_index_reset(index_cache);
-
-		for (j = 0; fts_index_selector[j].value; ++j) {
-
-			if (index_cache->ins_graph[j] != NULL) {
-
-				fts_que_graph_free_check_lock(
-					NULL, index_cache,
-					index_cache->ins_graph[j]);
-
-				index_cache->ins_graph[j] = NULL;
-			}
-
-			if (index_cache->sel_graph[j] != NULL) {
-
-				fts_que_graph_free_check_lock(
-					NULL, index_cache,
-					index_cache->sel_graph[j]);
-
-				index_cache->sel_graph[j] = NULL;
-			}
+		if (index_cache->sync_words != NULL) {
+			fts_sync_index_reset(index_cache);
 		}
+
+		fts_sync_index_free_graphs(index_cache);
 	}
 
 	rw_lock_x_unlock(&cache->lock);
@@ -4362,8 +4609,10 @@ fts_sync_rollback(
 
 /** Run SYNC on the table, i.e., write out data from the cache to the
 FTS auxiliary INDEX table and clear the cache at the end.
+The contents of the cache are detached at the start, and they are
+written without holding the cache lock, so that documents can be
+added to the cache meanwhile.
 @param[in,out]	sync		sync state
-@param[in]	unlock_cache	whether unlock cache lock when write node
 @param[in]	wait		whether wait when a sync is in progress
 @param[in]      has_dict        whether has dict operation lock
 @return DB_SUCCESS if all OK */
@@ -4371,7 +4620,6 @@ static
 dberr_t
 fts_sync(
 	fts_sync_t*	sync,
-	bool		unlock_cache,
 	bool		wait,
 	bool		has_dict)
 {
@@ -4385,9 +4633,7 @@ fts_sync(
 
 	rw_lock_x_lock(&cache->lock);
 
-	/* Check if cache is being synced.
-	Note: we release cache lock in fts_sync_write_words() to
-	avoid long wait for the lock by other threads. */
+	/* Check if cache is being synced. */
 	while (sync->in_progress) {
 		rw_lock_x_unlock(&cache->lock);
 
@@ -4400,9 +4646,9 @@ fts_sync(
 		rw_lock_x_lock(&cache->lock);
 	}
 
-	sync->unlock_cache = unlock_cache;
 	sync->in_progress = true;
 
+begin_sync:
 	DEBUG_SYNC_C("fts_sync_begin");
 	fts_sync_begin(sync);
 
@@ -4412,12 +4658,11 @@ fts_sync(
 		sync->trx->dict_operation_lock_mode = RW_S_LATCH;
 	}
 
-begin_sync:
-	if (cache->total_size > fts_max_cache_size) {
-		/* Avoid the case: sync never finish when
-		insert/update keeps comming. */
-		ut_ad(sync->unlock_cache);
-		sync->unlock_cache = false;
+	/* If an earlier SYNC failed, retry its contents first. */
+	const bool	retry = sync->heap != NULL;
+
+	if (!retry) {
+		fts_sync_switch(sync);
 	}
 
 	for (i = 0; i < ib_vector_size(cache->indexes); ++i) {
@@ -4427,14 +4672,41 @@ fts_sync(
 			ib_vector_get(cache->indexes, i));
 
 		if (index_cache->index->to_be_dropped
-		   || index_cache->index->table->to_be_dropped) {
+		   || index_cache->index->table->to_be_dropped
+		   || index_cache->sync_words == NULL) {
 			continue;
 		}
 
 		index_cache->index->index_fts_syncing = true;
-		DBUG_EXECUTE_IF("fts_instrument_sync_sleep_drop_waits",
-				os_thread_sleep(10000000);
-				);
+	}
+
+	rw_lock_x_unlock(&cache->lock);
+
+	DBUG_EXECUTE_IF("fts_instrument_sync_sleep_drop_waits",
+			os_thread_sleep(10000000);
+			);
+
+	/* The index caches cannot be removed while index_fts_syncing
+	is set, but new ones can be added by fts_add_index(). */
+	for (i = 0; ; ++i) {
+		fts_index_cache_t*	index_cache = NULL;
+
+		rw_lock_x_lock(&cache->lock);
+
+		if (i < ib_vector_size(cache->indexes)) {
+			index_cache = static_cast<fts_index_cache_t*>(
+				ib_vector_get(cache->indexes, i));
+		}
+
+		rw_lock_x_unlock(&cache->lock);
+
+		if (index_cache == NULL) {
+			break;
+		}
+
+		if (!index_cache->index->index_fts_syncing) {
+			continue;
+		}
 
 		error = fts_sync_index(sync, index_cache);
 
@@ -4450,22 +4722,6 @@ fts_sync(
 			goto end_sync;
 	);
 
-	/* Make sure all the caches are synced. */
-	for (i = 0; i < ib_vector_size(cache->indexes); ++i) {
-		fts_index_cache_t*	index_cache;
-
-		index_cache = static_cast<fts_index_cache_t*>(
-			ib_vector_get(cache->indexes, i));
-
-		if (index_cache->index->to_be_dropped
-		    || index_cache->index->table->to_be_dropped
-		    || fts_sync_index_check(index_cache)) {
-			continue;
-		}
-
-		goto begin_sync;
-	}
-
 end_sync:
 	if (error == DB_SUCCESS && !sync->interrupted) {
 		error = fts_sync_commit(sync);
@@ -4482,6 +4738,12 @@ fts_sync(
 			->index->index_fts_syncing = false;
 	}
 
+	/* The caller may expect everything that was added so far
+	to be written. */
+	if (retry && wait && error == DB_SUCCESS && !sync->interrupted) {
+		goto begin_sync;
+	}
+
 	sync->interrupted = false;
 	sync->in_progress = false;
 	os_event_set(sync->event);
@@ -4504,14 +4766,12 @@ fts_sync(
 /** Run SYNC on the table, i.e., write out data from the cache to the
 FTS auxiliary INDEX table and clear the cache at the end.
 @param[in,out]	table		fts table
-@param[in]	unlock_cache	whether unlock cache when write node
 @param[in]	wait		whether wait for existing sync to finish
 @param[in]	has_dict	whether has dict operation lock
 @return DB_SUCCESS on success, error code on failure. */
 dberr_t
 fts_sync_table(
 	dict_table_t*	table,
-	bool		unlock_cache,
 	bool		wait,
 	bool		has_dict)
 {
@@ -4521,8 +4781,7 @@ fts_sync_table(
 
 	if (!dict_table_is_discarded(table) && table->fts->cache
 	    && !dict_table_is_corrupted(table)) {
-		err = fts_sync(table->fts->cache->sync,
-			       unlock_cache, wait, has_dict);
+		err = fts_sync(table->fts->cache->sync, wait, has_dict);
 	}
 
 	return(err);
@@ -5333,6 +5592,7 @@ const ib_vector_t*
 fts_cache_find_word(
 /*================*/
 	const fts_index_cache_t*index_cache,	/*!< in: cache to search */
+	const ib_rbt_t*		words,		/*!< in: words of the cache */
 	const fts_string_t*	text)		/*!< in: word to search for */
 {
 	ib_rbt_bound_t		parent;
@@ -5345,7 +5605,7 @@ fts_cache_find_word(
 #endif /* UNIV_DEBUG */
 
 	/* Lookup the word in the rb tree */
-	if (rbt_search(index_cache->words, &parent, text) == 0) {
+	if (rbt_search(words, &parent, text) == 0) {
 		const fts_tokenizer_word_t*	word;
 
 		word = rbt_value(fts_tokenizer_word_t, parent.last);
@@ -5381,6 +5641,18 @@ fts_cache_append_deleted_doc_ids(
 		ib_vector_push(vector, &update->doc_id);
 	}
 
+	/* Include the doc ids that are being written out by a SYNC. */
+	const ib_vector_t*	sync_ids = cache->sync->deleted_doc_ids;
+
+	for (ulint i = 0; sync_ids && i < ib_vector_size(sync_ids); ++i) {
+		const fts_update_t*	update;
+
+		update = static_cast<const fts_update_t*>(
+			ib_vector_get_const(sync_ids, i));
+
+		ib_vector_push(vector, &update->doc_id);
+	}
+
 	mutex_exit((ib_mutex_t*) &cache->deleted_lock);
 }
 
@@ -1017,6 +1017,7 @@ fts_cache_find_wildcard(
 /*====================*/
 	fts_query_t*		query,		/*!< in: query instance */
 	const fts_index_cache_t*index_cache,	/*!< in: cache to search */
+	const ib_rbt_t*		words,		/*!< in: words of the cache */
 	const fts_string_t*	token)		/*!< in: token to search */
 {
 	ib_rbt_bound_t		parent;
@@ -1034,7 +1035,7 @@ fts_cache_find_wildcard(
 	srch_text.f_str = term;
 
 	/* Lookup the word in the rb tree */
-	if (rbt_search_cmp(index_cache->words, &parent, &srch_text, NULL,
+	if (rbt_search_cmp(words, &parent, &srch_text, NULL,
 			   innobase_fts_text_cmp_prefix) == 0) {
 		const fts_tokenizer_word_t*     word;
 		ulint				i;
@@ -1082,11 +1083,11 @@ fts_cache_find_wildcard(
 
 			if (!forward) {
 				cur_node = rbt_prev(
-					index_cache->words, cur_node);
+					words, cur_node);
 			} else {
 cont_search:
 				cur_node = rbt_next(
-					index_cache->words, cur_node);
+					words, cur_node);
 			}
 
 			if (!cur_node) {
@@ -1106,6 +1107,50 @@ fts_cache_find_wildcard(
 	return(num_word);
 }
 
+/*****************************************************************//**
+Search the index cache for a token, including the words that are being
+written out by a SYNC. The caller must hold the cache lock. */
+static
+void
+fts_query_search_cache(
+/*===================*/
+	fts_query_t*		query,		/*!< in: query instance */
+	const fts_index_cache_t*index_cache,	/*!< in: cache to search */
+	const fts_string_t*	token,		/*!< in: token to search */
+	bool			wildcard)	/*!< in: whether to do
+						a wildcard search */
+{
+	const ib_rbt_t*	words[2] = {
+		index_cache->words, index_cache->sync_words
+	};
+
+	for (ulint j = 0; j < 2 && query->error == DB_SUCCESS; ++j) {
+
+		if (words[j] == NULL) {
+			continue;
+		}
+
+		if (wildcard) {
+			fts_cache_find_wildcard(
+				query, index_cache, words[j], token);
+			continue;
+		}
+
+		const ib_vector_t*	nodes = fts_cache_find_word(
+			index_cache, words[j], token);
+
+		for (ulint i = 0; nodes && i < ib_vector_size(nodes)
+		     && query->error == DB_SUCCESS; ++i) {
+			const fts_node_t*	node;
+
+			node = static_cast<const fts_node_t*>(
+				ib_vector_get_const(nodes, i));
+
+			fts_query_check_node(query, token, node);
+		}
+	}
+}
+
 /*****************************************************************//**
 Set difference.
 @return DB_SUCCESS if all go well */
@@ -1137,9 +1182,7 @@ fts_query_difference(
 
 	/* There is nothing we can substract from an empty set. */
 	if (query->doc_ids && !rbt_empty(query->doc_ids)) {
-		ulint			i;
 		fts_fetch_t		fetch;
-		const ib_vector_t*	nodes;
 		const fts_index_cache_t*index_cache;
 		que_t*			graph = NULL;
 		fts_cache_t*		cache = table->fts->cache;
@@ -1153,23 +1196,11 @@ fts_query_difference(
 		ut_a(index_cache != NULL);
 
 		/* Search the cache for a matching word first. */
-		if (query->cur_node->term.wildcard
-		    && query->flags != FTS_PROXIMITY
-		    && query->flags != FTS_PHRASE) {
-			fts_cache_find_wildcard(query, index_cache, token);
-		} else {
-			nodes = fts_cache_find_word(index_cache, token);
-
-			for (i = 0; nodes && i < ib_vector_size(nodes)
-			     && query->error == DB_SUCCESS; ++i) {
-				const fts_node_t*	node;
-
-				node = static_cast<const fts_node_t*>(
-					ib_vector_get_const(nodes, i));
-
-				fts_query_check_node(query, token, node);
-			}
-		}
+		fts_query_search_cache(
+			query, index_cache, token,
+			query->cur_node->term.wildcard
+			&& query->flags != FTS_PROXIMITY
+			&& query->flags != FTS_PHRASE);
 
 		rw_lock_x_unlock(&cache->lock);
 
@@ -1230,9 +1261,7 @@ fts_query_intersect(
 	we know the intersection set is empty in advance. */
 	if (!(rbt_empty(query->doc_ids) && query->multi_exist)) {
 		ulint                   n_doc_ids = 0;
-		ulint			i;
 		fts_fetch_t		fetch;
-		const ib_vector_t*	nodes;
 		const fts_index_cache_t*index_cache;
 		que_t*			graph = NULL;
 		fts_cache_t*		cache = table->fts->cache;
@@ -1278,22 +1307,9 @@ fts_query_intersect(
 		/* Must find the index cache. */
 		ut_a(index_cache != NULL);
 
-		if (query->cur_node->term.wildcard) {
-			/* Wildcard search the index cache */
-			fts_cache_find_wildcard(query, index_cache, token);
-		} else {
-			nodes = fts_cache_find_word(index_cache, token);
-
-			for (i = 0; nodes && i < ib_vector_size(nodes)
-			     && query->error == DB_SUCCESS; ++i) {
-				const fts_node_t*	node;
-
-				node = static_cast<const fts_node_t*>(
-					ib_vector_get_const(nodes, i));
-
-				fts_query_check_node(query, token, node);
-			}
-		}
+		fts_query_search_cache(
+			query, index_cache, token,
+			query->cur_node->term.wildcard);
 
 		rw_lock_x_unlock(&cache->lock);
 
@@ -1357,27 +1373,11 @@ fts_query_cache(
 	/* Must find the index cache. */
 	ut_a(index_cache != NULL);
 
-	if (query->cur_node->term.wildcard
-	    && query->flags != FTS_PROXIMITY
-	    && query->flags != FTS_PHRASE) {
-		/* Wildcard search the index cache */
-		fts_cache_find_wildcard(query, index_cache, token);
-	} else {
-		const ib_vector_t*      nodes;
-		ulint			i;
-
-		nodes = fts_cache_find_word(index_cache, token);
-
-		for (i = 0; nodes && i < ib_vector_size(nodes)
-		     && query->error == DB_SUCCESS; ++i) {
-			const fts_node_t*	node;
-
-			node = static_cast<const fts_node_t*>(
-				ib_vector_get_const(nodes, i));
-
-			fts_query_check_node(query, token, node);
-		}
-	}
+	fts_query_search_cache(
+		query, index_cache, token,
+		query->cur_node->term.wildcard
+		&& query->flags != FTS_PROXIMITY
+		&& query->flags != FTS_PHRASE);
 
 	rw_lock_x_unlock(&cache->lock);
 
@@ -602,7 +602,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	PSI_KEY(trx_pool_mutex),
 	PSI_KEY(trx_pool_manager_mutex),
 	PSI_KEY(srv_sys_mutex),
-	PSI_KEY(lock_mutex),
+	PSI_KEY(lock_rec_hash_mutex),
 	PSI_KEY(lock_wait_mutex),
 	PSI_KEY(trx_mutex),
 	PSI_KEY(srv_threads_mutex),
@@ -633,6 +633,8 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	PSI_RWLOCK_KEY(dict_operation_lock),
 	PSI_RWLOCK_KEY(fil_space_latch),
 	PSI_RWLOCK_KEY(checkpoint_lock),
+	PSI_RWLOCK_KEY(lock_sys_latch),
+	PSI_RWLOCK_KEY(trx_sys_snapshot_latch),
 	PSI_RWLOCK_KEY(fts_cache_rw_lock),
 	PSI_RWLOCK_KEY(fts_cache_init_rw_lock),
 	PSI_RWLOCK_KEY(trx_i_s_cache_lock),
@@ -658,8 +660,10 @@ static PSI_thread_info	all_innodb_threads[] = {
 	PSI_KEY(io_write_thread),
 	PSI_KEY(page_cleaner_thread),
 	PSI_KEY(recv_writer_thread),
+	PSI_KEY(recv_apply_thread),
 	PSI_KEY(srv_error_monitor_thread),
 	PSI_KEY(srv_lock_timeout_thread),
+	PSI_KEY(srv_lock_deadlock_thread),
 	PSI_KEY(srv_master_thread),
 	PSI_KEY(srv_monitor_thread),
 	PSI_KEY(srv_purge_thread),
@@ -984,6 +988,10 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_data_written,		  SHOW_LONG},
   {"dblwr_pages_written",
   (char*) &export_vars.innodb_dblwr_pages_written,	  SHOW_LONG},
+  {"dblwr_segments",
+  (char*) &export_vars.innodb_dblwr_segments,		  SHOW_LONG},
+  {"dblwr_segments_written",
+  (char*) &export_vars.innodb_dblwr_segments_written,	  SHOW_LONG},
   {"dblwr_writes",
   (char*) &export_vars.innodb_dblwr_writes,		  SHOW_LONG},
   {"log_waits",
@@ -1012,6 +1020,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_pages_written,		  SHOW_LONG},
   {"row_lock_current_waits",
   (char*) &export_vars.innodb_row_lock_current_waits,	  SHOW_LONG},
+  {"row_lock_shard_grants",
+  (char*) &export_vars.innodb_row_lock_shard_grants,	  SHOW_LONG},
   {"row_lock_time",
   (char*) &export_vars.innodb_row_lock_time,		  SHOW_LONGLONG},
   {"row_lock_time_avg",
@@ -1045,6 +1055,8 @@ static SHOW_VAR innodb_status_variables[]= {
 #ifdef UNIV_DEBUG
   {"ahi_drop_lookups",
   (char*) &export_vars.innodb_ahi_drop_lookups,           SHOW_LONG},
+  {"purge_split_batches",
+  (char*) &export_vars.innodb_purge_split_batches,        SHOW_LONG},
 #endif /* UNIV_DEBUG */
 
   /* Status variables for page compression */
@@ -1097,6 +1109,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_onlineddl_rowlog_pct_used, SHOW_LONG},
   {"onlineddl_pct_progress",
   (char*) &export_vars.innodb_onlineddl_pct_progress, SHOW_LONG},
+  {"onlineddl_parallel_scan_threads",
+  (char*) &export_vars.innodb_onlineddl_parallel_scan_threads, SHOW_LONG},
 
   /* Times secondary index lookup triggered cluster lookup and
   times prefix optimization avoided triggering cluster lookup */
@@ -1104,6 +1118,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_sec_rec_cluster_reads,	  SHOW_LONG},
   {"secondary_index_triggered_cluster_reads_avoided",
   (char*) &export_vars.innodb_sec_rec_cluster_reads_avoided, SHOW_LONG},
+  {"secondary_index_triggered_cluster_read_aheads",
+  (char*) &export_vars.innodb_sec_rec_cluster_read_aheads, SHOW_LONG},
 
   /* Encryption */
   {"encryption_rotation_pages_read_from_cache",
@@ -2989,7 +3005,8 @@ ha_innobase::ha_innobase(
 			  |  (srv_force_primary_key ? HA_REQUIRE_PRIMARY_KEY : 0)
 		  ),
 	m_start_of_scan(),
-        m_mysql_has_locked()
+        m_mysql_has_locked(),
+	m_parallel_scan()
 {}
 
 /*********************************************************************//**
@@ -5428,6 +5445,80 @@ ha_innobase::primary_key_is_clustered()
 	return(true);
 }
 
+/** Determine if clones of this handle may read the table concurrently
+in other threads during the current statement.
+trx_t is not thread-safe: row_search_mvcc() updates trx->op_info and
+trx->lock.n_active_thrs without any synchronization. Therefore,
+start_parallel_scan() makes each clone read with a transaction of its
+own, whose read view is a copy of the read view of the statement.
+That is only possible for consistent reads, which do not lock anything.
+The reads of the clones must not be counted in srv_conc_enter_innodb()
+either.
+@return whether the table may be scanned in parallel */
+
+bool
+ha_innobase::parallel_scan_supported()
+{
+	return(m_prebuilt->select_lock_type == LOCK_NONE
+	       && !srv_thread_concurrency
+	       && !m_prebuilt->table->is_temporary()
+	       && !m_prebuilt->table->no_rollback());
+}
+
+/** Make a locked clone read with a transaction of its own that sees
+the same snapshot as the transaction of the statement.
+@return 0 or error code */
+
+int
+ha_innobase::start_parallel_scan()
+{
+	trx_t*	parent = m_prebuilt->trx;
+
+	ut_ad(!m_parallel_scan);
+	ut_ad(parent == thd_to_trx(m_user_thd));
+	ut_ad(m_prebuilt->select_lock_type == LOCK_NONE);
+
+	/* The statement has already read the table, so its read view
+	has been opened unless no read views are used at all. */
+	if (!parent->read_view.is_open() && !srv_read_only_mode) {
+		return(HA_ERR_UNSUPPORTED);
+	}
+
+	trx_t*	trx = trx_allocate_for_background();
+
+	/* Let the worker notice KILL, and make it an auto-commit
+	non-locking read-only transaction if the statement is one. */
+	trx->mysql_thd = m_user_thd;
+	trx->isolation_level = parent->isolation_level;
+	trx_start_if_not_started(trx, false);
+
+	if (parent->read_view.is_open()) {
+		trx->read_view.open_copy(parent->read_view);
+	}
+
+	row_update_prebuilt_trx(m_prebuilt, trx);
+	m_parallel_scan = true;
+
+	return(0);
+}
+
+/** Free the transaction of start_parallel_scan(). */
+
+void
+ha_innobase::end_parallel_scan()
+{
+	ut_ad(m_parallel_scan);
+
+	trx_t*	trx = m_prebuilt->trx;
+
+	row_update_prebuilt_trx(m_prebuilt, thd_to_trx(m_user_thd));
+	m_parallel_scan = false;
+
+	trx_commit_for_mysql(trx);
+	trx->mysql_thd = NULL;
+	trx_free_for_background(trx);
+}
+
 /** Normalizes a table name string.
 A normalized name consists of the database name catenated to '/'
 and table name. For example: test/mytable.
@@ -9438,7 +9529,7 @@ ha_innobase::index_read(
 	DBUG_ENTER("index_read");
 	DEBUG_SYNC_C("ha_innobase_index_read_begin");
 
-	ut_a(m_prebuilt->trx == thd_to_trx(m_user_thd));
+	ut_a(m_prebuilt->trx == thd_to_trx(m_user_thd) || m_parallel_scan);
 	ut_ad(key_len != 0 || find_flag != HA_READ_KEY_EXACT);
 
 	dict_index_t*	index = m_prebuilt->index;
@@ -9699,7 +9790,7 @@ ha_innobase::change_active_index(
 	DBUG_ENTER("change_active_index");
 
 	ut_ad(m_user_thd == ha_thd());
-	ut_a(m_prebuilt->trx == thd_to_trx(m_user_thd));
+	ut_a(m_prebuilt->trx == thd_to_trx(m_user_thd) || m_parallel_scan);
 
 	TrxInInnoDB	trx_in_innodb(m_prebuilt->trx);
 
@@ -9827,7 +9918,7 @@ ha_innobase::general_fetch(
 
 	const trx_t*	trx = m_prebuilt->trx;
 
-	ut_ad(trx == thd_to_trx(m_user_thd));
+	ut_ad(trx == thd_to_trx(m_user_thd) || m_parallel_scan);
 
 	if (TrxInInnoDB::is_aborted(trx)) {
 
@@ -14718,7 +14809,7 @@ ha_innobase::optimize(
 	if (innodb_optimize_fulltext_only) {
 		if (m_prebuilt->table->fts && m_prebuilt->table->fts->cache
 		    && !dict_table_is_discarded(m_prebuilt->table)) {
-			fts_sync_table(m_prebuilt->table, false, true, false);
+			fts_sync_table(m_prebuilt->table, true, false);
 			fts_optimize_table(m_prebuilt->table);
 		}
 		return(HA_ADMIN_OK);
@@ -15633,6 +15724,14 @@ ha_innobase::end_stmt()
 		row_mysql_prebuilt_free_blob_heap(m_prebuilt);
 	}
 
+	/* Do not keep a prefetch cache that was grown for a long scan
+	in an idle table handle. */
+	if (m_prebuilt->fetch_cache_alloc > MYSQL_FETCH_CACHE_SIZE) {
+		m_prebuilt->n_fetch_cached = 0;
+		m_prebuilt->fetch_cache_first = 0;
+		row_mysql_prebuilt_free_fetch_cache(m_prebuilt);
+	}
+
 	reset_template();
 
 	m_ds_mrr.dsmrr_close();
@@ -19770,6 +19869,12 @@ static MYSQL_SYSVAR_BOOL(doublewrite, innobase_use_doublewrite,
   " Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(doublewrite_segments, srv_doublewrite_segments,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of segments of the doublewrite buffer that are written"
+  " independently by batch flushing (0 = one per page cleaner thread)",
+  NULL, NULL, 0, 0, BUF_DBLWR_MAX_SEGMENTS, 0);
+
 static MYSQL_SYSVAR_BOOL(use_atomic_writes, innobase_use_atomic_writes,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "Enable atomic writes, instead of using the doublewrite buffer, for files "
@@ -19847,6 +19952,15 @@ static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
   1,			/* Minimum value */
   32, 0);		/* Maximum value */
 
+static MYSQL_SYSVAR_ULONG(recovery_apply_threads, srv_n_recv_apply_threads,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads applying redo log records to pages during crash"
+  " recovery. Default is 1 (apply from the recovery thread only).",
+  NULL, NULL,
+  1,			/* Default setting */
+  1,			/* Minimum value */
+  64, 0);		/* Maximum value */
+
 static MYSQL_SYSVAR_ULONG(sync_array_size, srv_sync_array_size,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
   "Size of the mutex/lock wait array.",
@@ -19866,6 +19980,13 @@ static MYSQL_SYSVAR_BOOL(file_per_table, srv_file_per_table,
   "Stores each InnoDB table to an .ibd file in the database dir.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(tablespace_discovery_threads,
+  srv_tablespace_discovery_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads that open the .ibd files of the tables"
+  " at startup (1=open them one at a time)",
+  NULL, NULL, 8, 1, 64, 0);
+
 static MYSQL_SYSVAR_STR(ft_server_stopword_table, innobase_server_stopword_table,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_MEMALLOC,
   "The user supplied stopword table name.",
@@ -19954,6 +20075,13 @@ static MYSQL_SYSVAR_BOOL(flush_sync, srv_flush_sync,
   "Allow IO bursts at the checkpoints ignoring io_capacity setting.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(flush_io_depth, srv_flush_io_depth,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of page writes that the flushing of a buffer pool"
+  " instance may keep in flight (0 = no limit). The page cleaner adjusts"
+  " the effective limit to the measured write latency and checkpoint age.",
+  NULL, NULL, 0, 0, 65536, 0);
+
 static MYSQL_SYSVAR_ULONG(flushing_avg_loops,
   srv_flushing_avg_loops,
   PLUGIN_VAR_RQCMDARG,
@@ -20191,6 +20319,23 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_load_at_startup, srv_buffer_pool_load_at_st
   "Load the buffer pool from a file named @@innodb_buffer_pool_filename",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_threads, srv_buf_pool_load_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that read the pages of a buffer pool load",
+  NULL, NULL, 1, 1, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_io_depth, srv_buf_pool_load_io_depth,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of asynchronous page reads that each buffer pool load thread"
+  " submits at a time (1=synchronous reads)",
+  NULL, NULL, 1, 1, 1024, 0);
+
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_warm_pct, srv_buf_pool_load_warm_pct,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Delay startup until this percentage of the hottest pages of"
+  " @@innodb_buffer_pool_filename has been loaded (0=do not wait)",
+  NULL, NULL, 0, 0, 100, 0);
+
 static MYSQL_SYSVAR_BOOL(defragment, srv_defragment,
   PLUGIN_VAR_RQCMDARG,
   "Enable/disable InnoDB defragmentation (default FALSE). When set to FALSE, all existing "
@@ -20275,6 +20420,12 @@ static MYSQL_SYSVAR_BOOL(deadlock_detect, innobase_deadlock_detect,
   " and we rely on innodb_lock_wait_timeout in case of deadlock.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(deadlock_detect_async, innobase_deadlock_detect_async,
+  PLUGIN_VAR_NOCMDARG,
+  "Whether deadlocks are detected by a background thread"
+  " instead of by the transaction that starts a lock wait (default OFF).",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_LONG(fill_factor, innobase_fill_factor,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of B-tree page filled during bulk insert",
@@ -20341,6 +20492,12 @@ static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   "Maximum modification log file size for online index creation",
   NULL, NULL, 128<<20, 65536, ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONG(index_build_threads, srv_index_build_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that scan the clustered index and load the indexes"
+  " when adding secondary indexes (1=single-threaded)",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_BOOL(optimize_fulltext_only, innodb_optimize_fulltext_only,
   PLUGIN_VAR_NOCMDARG,
   "Only optimize the Fulltext index of the table",
@@ -20438,6 +20595,13 @@ static MYSQL_SYSVAR_BOOL(prefix_index_cluster_optimization,
   "Enable prefix optimization to sometimes avoid cluster index lookups.",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_ULONG(batched_lookup_size, srv_batched_lookup_size,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of records of a secondary index page whose clustered"
+  " index leaf pages are read ahead in PRIMARY KEY order during a scan"
+  " that needs columns from the clustered index. 0 or 1 disables it.",
+  NULL, NULL, 64, 0, 1024, 0);
+
 static MYSQL_SYSVAR_ULONG(thread_sleep_delay, srv_thread_sleep_delay,
   PLUGIN_VAR_RQCMDARG,
   "Time of innodb thread sleeping before joining InnoDB queue (usec)."
@@ -20526,11 +20690,24 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use io_uring instead of libaio for native AIO on Linux, if supported.",
+  NULL, NULL, FALSE);
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "Use NUMA interleave memory policy to allocate InnoDB buffer pool.",
   NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(buffer_pool_numa_bind, srv_buf_pool_numa_bind,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Allocate each InnoDB buffer pool instance on one NUMA node, assigning"
+  " the nodes to the instances in turn, and let the page cleaner threads"
+  " flush each instance from its own node."
+  " Ignored if innodb_numa_interleave is set.",
+  NULL, NULL, FALSE);
 #endif /* HAVE_LIBNUMA */
 
 static MYSQL_SYSVAR_STR(change_buffering, innobase_change_buffering,
@@ -20917,6 +21094,9 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_load_pages_abort),
 #endif /* UNIV_DEBUG */
   MYSQL_SYSVAR(buffer_pool_load_at_startup),
+  MYSQL_SYSVAR(buffer_pool_load_threads),
+  MYSQL_SYSVAR(buffer_pool_load_io_depth),
+  MYSQL_SYSVAR(buffer_pool_load_warm_pct),
   MYSQL_SYSVAR(defragment),
   MYSQL_SYSVAR(defragment_n_pages),
   MYSQL_SYSVAR(defragment_stats_accuracy),
@@ -20935,12 +21115,14 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(temp_data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_segments),
   MYSQL_SYSVAR(stats_include_delete_marked),
   MYSQL_SYSVAR(use_atomic_writes),
   MYSQL_SYSVAR(fast_shutdown),
   MYSQL_SYSVAR(read_io_threads),
   MYSQL_SYSVAR(write_io_threads),
   MYSQL_SYSVAR(file_per_table),
+  MYSQL_SYSVAR(tablespace_discovery_threads),
   MYSQL_SYSVAR(flush_log_at_timeout),
   MYSQL_SYSVAR(flush_log_at_trx_commit),
   MYSQL_SYSVAR(flush_method),
@@ -20959,6 +21141,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(locks_unsafe_for_binlog),
   MYSQL_SYSVAR(lock_wait_timeout),
   MYSQL_SYSVAR(deadlock_detect),
+  MYSQL_SYSVAR(deadlock_detect_async),
   MYSQL_SYSVAR(page_size),
   MYSQL_SYSVAR(log_buffer_size),
   MYSQL_SYSVAR(log_file_size),
@@ -20971,6 +21154,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(adaptive_flushing_lwm),
   MYSQL_SYSVAR(adaptive_flushing),
   MYSQL_SYSVAR(flush_sync),
+  MYSQL_SYSVAR(flush_io_depth),
   MYSQL_SYSVAR(flushing_avg_loops),
   MYSQL_SYSVAR(max_purge_lag),
   MYSQL_SYSVAR(max_purge_lag_delay),
@@ -21002,19 +21186,23 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(strict_mode),
   MYSQL_SYSVAR(sort_buffer_size),
   MYSQL_SYSVAR(online_alter_log_max_size),
+  MYSQL_SYSVAR(index_build_threads),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
   MYSQL_SYSVAR(table_locks),
   MYSQL_SYSVAR(thread_concurrency),
   MYSQL_SYSVAR(adaptive_max_sleep_delay),
   MYSQL_SYSVAR(prefix_index_cluster_optimization),
+  MYSQL_SYSVAR(batched_lookup_size),
   MYSQL_SYSVAR(thread_sleep_delay),
   MYSQL_SYSVAR(tmpdir),
   MYSQL_SYSVAR(autoinc_lock_mode),
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(use_io_uring),
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
+  MYSQL_SYSVAR(buffer_pool_numa_bind),
 #endif /* HAVE_LIBNUMA */
   MYSQL_SYSVAR(change_buffering),
   MYSQL_SYSVAR(change_buffer_max_size),
@@ -21038,6 +21226,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(monitor_reset_all),
   MYSQL_SYSVAR(purge_threads),
   MYSQL_SYSVAR(purge_batch_size),
+  MYSQL_SYSVAR(recovery_apply_threads),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(background_drop_list_empty),
   MYSQL_SYSVAR(log_checkpoint_now),
@@ -21154,7 +21343,8 @@ i_s_innodb_sys_virtual,
 i_s_innodb_mutexes,
 i_s_innodb_sys_semaphore_waits,
 i_s_innodb_tablespaces_encryption,
-i_s_innodb_tablespaces_scrubbing
+i_s_innodb_tablespaces_scrubbing,
+i_s_innodb_tablespaces_io
 maria_declare_plugin_end;
 
 /** @brief Initialize the default value of innodb_commit_concurrency.
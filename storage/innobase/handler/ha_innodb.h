@@ -296,6 +296,12 @@ class ha_innobase: public handler
 
 	bool primary_key_is_clustered();
 
+	bool parallel_scan_supported();
+
+	int start_parallel_scan();
+
+	void end_parallel_scan();
+
 	int cmp_ref(const uchar* ref1, const uchar* ref2);
 
 	/** On-line ALTER TABLE interface @see handler0alter.cc @{ */
@@ -517,6 +523,10 @@ class ha_innobase: public handler
 
         /** If mysql has locked with external_lock() */
         bool                    m_mysql_has_locked;
+
+	/** whether m_prebuilt->trx is a transaction of a parallel scan
+	worker; see start_parallel_scan() */
+	bool			m_parallel_scan;
 };
 
 
@@ -3213,6 +3213,7 @@ int
 i_s_fts_index_cache_fill_one_index(
 /*===============================*/
 	fts_index_cache_t*	index_cache,	/*!< in: FTS index cache */
+	const ib_rbt_t*		words,		/*!< in: words of the cache */
 	THD*			thd,		/*!< in: thread */
 	fts_string_t*		conv_str,	/*!< in/out: buffer */
 	TABLE_LIST*		tables)		/*!< in/out: tables to fill */
@@ -3234,9 +3235,9 @@ i_s_fts_index_cache_fill_one_index(
 	int	ret = 0;
 
 	/* Go through each word in the index cache */
-	for (rbt_node = rbt_first(index_cache->words);
+	for (rbt_node = rbt_first(words);
 	     rbt_node;
-	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+	     rbt_node = rbt_next(words, rbt_node)) {
 		fts_tokenizer_word_t* word;
 
 		word = rbt_value(fts_tokenizer_word_t, rbt_node);
@@ -3366,8 +3367,16 @@ i_s_fts_index_cache_fill(
 		index_cache = static_cast<fts_index_cache_t*> (
 			ib_vector_get(cache->indexes, i));
 
+		/* Words that are being written out by a SYNC */
+		if (index_cache->sync_words) {
+			BREAK_IF(ret = i_s_fts_index_cache_fill_one_index(
+					 index_cache, index_cache->sync_words,
+					 thd, &conv_str, tables));
+		}
+
 		BREAK_IF(ret = i_s_fts_index_cache_fill_one_index(
-				 index_cache, thd, &conv_str, tables));
+				 index_cache, index_cache->words,
+				 thd, &conv_str, tables));
 	}
 
 	ut_free(conv_str.f_str);
@@ -4389,6 +4398,60 @@ static ST_FIELD_INFO	i_s_innodb_buffer_stats_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
+#define IDX_BUF_STATS_NUMA_NODE		32
+	{STRUCT_FLD(field_name,		"NUMA_NODE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED | MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_GET_REMOTE	33
+	{STRUCT_FLD(field_name,		"NUMBER_PAGES_GET_REMOTE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_FLUSH_RATE	34
+	{STRUCT_FLD(field_name,		"FLUSH_RATE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_FLUSH_IO_DEPTH	35
+	{STRUCT_FLD(field_name,		"FLUSH_IO_DEPTH"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_FLUSH_IO_LATENCY	36
+	{STRUCT_FLD(field_name,		"FLUSH_IO_LATENCY"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_FLUSH_STALL_TIME	37
+	{STRUCT_FLD(field_name,		"FLUSH_STALL_TIME"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
 	END_OF_ST_FIELD_INFO
 };
 
@@ -4524,6 +4587,29 @@ i_s_innodb_stats_fill(
 	OK(fields[IDX_BUF_STATS_UNZIP_CUR]->store(
 		   info->unzip_cur, true));
 
+	if (info->numa_node == ULINT_UNDEFINED) {
+		fields[IDX_BUF_STATS_NUMA_NODE]->set_null();
+	} else {
+		OK(fields[IDX_BUF_STATS_NUMA_NODE]->store(
+			   info->numa_node, true));
+		fields[IDX_BUF_STATS_NUMA_NODE]->set_notnull();
+	}
+
+	OK(fields[IDX_BUF_STATS_GET_REMOTE]->store(
+		   info->n_page_gets_remote, true));
+
+	OK(fields[IDX_BUF_STATS_FLUSH_RATE]->store(
+		   info->flush_rate, true));
+
+	OK(fields[IDX_BUF_STATS_FLUSH_IO_DEPTH]->store(
+		   info->flush_io_depth, true));
+
+	OK(fields[IDX_BUF_STATS_FLUSH_IO_LATENCY]->store(
+		   info->flush_io_latency, true));
+
+	OK(fields[IDX_BUF_STATS_FLUSH_STALL_TIME]->store(
+		   info->flush_stall_time, true));
+
 	DBUG_RETURN(schema_table_store_record(thd, table));
 }
 
@@ -8535,6 +8621,24 @@ static ST_FIELD_INFO	innodb_tablespaces_encryption_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
+#define TABLESPACES_ENCRYPTION_KEY_ROTATION_THREADS	10
+	{STRUCT_FLD(field_name,		"KEY_ROTATION_THREADS"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED | MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_DONE	11
+	{STRUCT_FLD(field_name,		"KEY_ROTATION_PAGES_DONE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED | MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
 	END_OF_ST_FIELD_INFO
 };
 
@@ -8592,11 +8696,21 @@ i_s_dict_fill_tablespaces_encryption(
 		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_MAX_PAGE_NUMBER]->set_notnull();
 		OK(fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_MAX_PAGE_NUMBER]->store(
 			   status.rotate_max_page_number, true));
+		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_THREADS]->set_notnull();
+		OK(fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_THREADS]->store(
+			   status.rotate_active_threads, true));
+		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_DONE]->set_notnull();
+		OK(fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_DONE]->store(
+			   status.rotate_pages_done, true));
 	} else {
 		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGE_NUMBER]
 			->set_null();
 		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_MAX_PAGE_NUMBER]
 			->set_null();
+		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_THREADS]
+			->set_null();
+		fields[TABLESPACES_ENCRYPTION_KEY_ROTATION_PAGES_DONE]
+			->set_null();
 	}
 
 	OK(schema_table_store_record(thd, table_to_fill));
@@ -9085,6 +9199,226 @@ UNIV_INTERN struct st_maria_plugin	i_s_innodb_tablespaces_scrubbing =
 	STRUCT_FLD(maturity, MariaDB_PLUGIN_MATURITY_STABLE)
 };
 
+/**  TABLESPACES_IO    ****************************************************/
+/* Fields of the table INFORMATION_SCHEMA.INNODB_TABLESPACES_IO */
+static ST_FIELD_INFO	innodb_tablespaces_io_fields_info[] =
+{
+#define TABLESPACES_IO_SPACE		0
+	{STRUCT_FLD(field_name,		"SPACE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define TABLESPACES_IO_NAME		1
+	{STRUCT_FLD(field_name,		"NAME"),
+	 STRUCT_FLD(field_length,	MAX_FULL_NAME_LEN + 1),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define TABLESPACES_IO_READS		2
+	{STRUCT_FLD(field_name,		"READS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define TABLESPACES_IO_BYTES_READ	3
+	{STRUCT_FLD(field_name,		"BYTES_READ"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define TABLESPACES_IO_READ_TIME_US	4
+	{STRUCT_FLD(field_name,		"READ_TIME_US"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define TABLESPACES_IO_WRITES		5
+	{STRUCT_FLD(field_name,		"WRITES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define TABLESPACES_IO_BYTES_WRITTEN	6
+	{STRUCT_FLD(field_name,		"BYTES_WRITTEN"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define TABLESPACES_IO_WRITE_TIME_US	7
+	{STRUCT_FLD(field_name,		"WRITE_TIME_US"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/**********************************************************************//**
+Function to fill INFORMATION_SCHEMA.INNODB_TABLESPACES_IO
+with the I/O statistics of a tablespace.
+@param[in]	thd		Thread handle
+@param[in]	space		Tablespace
+@param[in]	table_to_fill	I_S table
+@return 0 on success */
+static
+int
+i_s_fill_tablespaces_io(
+	THD*			thd,
+	const fil_space_t*	space,
+	TABLE*			table_to_fill)
+{
+	Field**	fields;
+
+	DBUG_ENTER("i_s_fill_tablespaces_io");
+
+	fields = table_to_fill->field;
+
+	OK(fields[TABLESPACES_IO_SPACE]->store(space->id, true));
+
+	OK(field_store_string(fields[TABLESPACES_IO_NAME], space->name));
+
+	OK(fields[TABLESPACES_IO_READS]->store(
+		   my_atomic_loadlint(&space->n_reads), true));
+	OK(fields[TABLESPACES_IO_BYTES_READ]->store(
+		   my_atomic_loadlint(&space->n_read_bytes), true));
+	OK(fields[TABLESPACES_IO_READ_TIME_US]->store(
+		   my_atomic_loadlint(&space->read_time_us), true));
+	OK(fields[TABLESPACES_IO_WRITES]->store(
+		   my_atomic_loadlint(&space->n_writes), true));
+	OK(fields[TABLESPACES_IO_BYTES_WRITTEN]->store(
+		   my_atomic_loadlint(&space->n_write_bytes), true));
+	OK(fields[TABLESPACES_IO_WRITE_TIME_US]->store(
+		   my_atomic_loadlint(&space->write_time_us), true));
+
+	OK(schema_table_store_record(thd, table_to_fill));
+
+	DBUG_RETURN(0);
+}
+/*******************************************************************//**
+Function to populate INFORMATION_SCHEMA.INNODB_TABLESPACES_IO table.
+Loop through each tablespace in fil_system->space_list.
+@return 0 on success */
+static
+int
+i_s_tablespaces_io_fill_table(
+/*==========================*/
+	THD*		thd,	/*!< in: thread */
+	TABLE_LIST*	tables,	/*!< in/out: tables to fill */
+	Item*		)	/*!< in: condition (not used) */
+{
+	DBUG_ENTER("i_s_tablespaces_io_fill_table");
+	RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name.str);
+
+	/* deny access to user without PROCESS_ACL privilege */
+	if (check_global_access(thd, PROCESS_ACL)) {
+		DBUG_RETURN(0);
+	}
+
+	for (fil_space_t* space = fil_space_next(NULL); space != NULL;
+	     space = fil_space_next(space)) {
+		if (i_s_fill_tablespaces_io(thd, space, tables->table)) {
+			fil_space_release(space);
+			DBUG_RETURN(1);
+		}
+	}
+
+	DBUG_RETURN(0);
+}
+/*******************************************************************//**
+Bind the dynamic table INFORMATION_SCHEMA.INNODB_TABLESPACES_IO
+@return 0 on success */
+static
+int
+innodb_tablespaces_io_init(
+/*=======================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	ST_SCHEMA_TABLE*	schema;
+
+	DBUG_ENTER("innodb_tablespaces_io_init");
+
+	schema = (ST_SCHEMA_TABLE*) p;
+
+	schema->fields_info = innodb_tablespaces_io_fields_info;
+	schema->fill_table = i_s_tablespaces_io_fill_table;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_maria_plugin	i_s_innodb_tablespaces_io =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_TABLESPACES_IO"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, plugin_author),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "InnoDB TABLESPACES_IO"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, innodb_tablespaces_io_init),
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, i_s_common_deinit),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+	/* Maria extension */
+	STRUCT_FLD(version_info, INNODB_VERSION_STR),
+	STRUCT_FLD(maturity, MariaDB_PLUGIN_MATURITY_STABLE)
+};
+
 /**  INNODB_MUTEXES  *********************************************/
 /* Fields of the dynamic table INFORMATION_SCHEMA.INNODB_MUTEXES */
 static ST_FIELD_INFO	innodb_mutexes_fields_info[] =
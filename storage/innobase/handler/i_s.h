@@ -63,6 +63,7 @@ extern struct st_maria_plugin	i_s_innodb_mutexes;
 extern struct st_maria_plugin	i_s_innodb_sys_virtual;
 extern struct st_maria_plugin	i_s_innodb_tablespaces_encryption;
 extern struct st_maria_plugin	i_s_innodb_tablespaces_scrubbing;
+extern struct st_maria_plugin	i_s_innodb_tablespaces_io;
 extern struct st_maria_plugin	i_s_innodb_sys_semaphore_waits;
 
 /** maximum number of buffer page info we would cache. */
@@ -202,6 +202,14 @@ UNIV_INLINE
 void
 btr_search_s_unlock_all();
 
+/** Get the adaptive hash index partition of an index.
+A partition is selected using pair of index-id, space-id.
+@param[in]	index	index handler
+@return partition number, less than btr_ahi_parts */
+UNIV_INLINE
+ulint
+btr_get_search_part(const dict_index_t* index);
+
 /** Get the latch based on index attributes.
 A latch is selected from an array of latches using pair of index-id, space-id.
 @param[in]	index	index handler
@@ -307,13 +315,35 @@ struct btr_search_t{
 };
 
 #ifdef BTR_CUR_HASH_ADAPT
+/** Statistics of an adaptive hash index partition. The counters are
+updated with atomic operations, for user info only. */
+struct btr_search_part_stat_t{
+	ulint	n_hash_succ;	/*!< number of successful lookups */
+	ulint	n_hash_fail;	/*!< number of failed lookups */
+	ulint	n_latch_waits;	/*!< number of times the partition
+				latch could not be acquired without
+				waiting */
+	byte	pad[CACHE_LINE_SIZE - 3 * sizeof(ulint)];
+				/*!< padding to keep the counters of
+				each partition in their own cache line */
+};
+
 /** The hash index system */
 struct btr_search_sys_t{
 	hash_table_t**	hash_tables;	/*!< the adaptive hash tables,
 					mapping dtuple_fold values
 					to rec_t pointers on index pages */
+	btr_search_part_stat_t*
+			part_stats;	/*!< statistics of each partition,
+					array of btr_ahi_parts elements */
 };
 
+/** Get the number of times an adaptive hash index latch could not be
+acquired without waiting.
+@return sum of btr_search_part_stat_t::n_latch_waits of all partitions */
+ulint
+btr_search_latch_waits();
+
 /** Latches protecting access to adaptive hash index. */
 extern rw_lock_t**		btr_search_latches;
 
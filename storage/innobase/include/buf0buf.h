@@ -204,6 +204,17 @@ struct buf_pool_info_t{
 	ulint	unzip_cur;		/*!< buf_LRU_stat_cur.unzip, num
 					pages decompressed in current
 					interval */
+
+	/* NUMA locality */
+	ulint	numa_node;		/*!< buf_pool->numa_node */
+	ulint	n_page_gets_remote;	/*!< buf_pool->n_page_gets_remote */
+
+	/* flush_list write pipeline */
+	ulint	flush_io_depth;		/*!< buf_pool->flush_io_depth */
+	ulint	flush_io_latency;	/*!< buf_pool->flush_io_latency */
+	ulint	flush_rate;		/*!< buf_pool->flush_rate */
+	ib_uint64_t flush_stall_time;	/*!< buf_pool->stat.flush_stall_time
+					in microseconds */
 };
 
 /** The occupied bytes of lists in all buffer pools */
@@ -358,6 +369,12 @@ buf_pool_init(
 /*=========*/
 	ulint	size,		/*!< in: Size of the total pool in bytes */
 	ulint	n_instances);	/*!< in: Number of instances */
+#ifdef HAVE_LIBNUMA
+/** @return the NUMA node of the CPU the calling thread is running on,
+or ULINT_UNDEFINED if unknown */
+ulint
+buf_numa_node_of_current_cpu();
+#endif /* HAVE_LIBNUMA */
 /********************************************************************//**
 Frees the buffer pool at shutdown.  This must not be invoked before
 freeing all mutexes. */
@@ -2063,6 +2080,15 @@ struct buf_pool_stat_t{
 				buf_page_peek_if_too_old() */
 	ulint	LRU_bytes;	/*!< LRU size in bytes */
 	ulint	flush_list_bytes;/*!< flush_list size in bytes */
+	ulint	n_page_gets_remote;/*!< number of page gets that were
+				performed by a thread that was running
+				on another NUMA node than the one the
+				instance is bound to; only maintained
+				with innodb_buffer_pool_numa_bind;
+				NOT protected by the buffer pool mutex */
+	ib_uint64_t flush_stall_time;/*!< microseconds that flush_list
+				batches waited for page writes to complete
+				because of innodb_flush_io_depth */
 };
 
 /** Statistics of buddy blocks of a given size. */
@@ -2103,6 +2129,11 @@ struct buf_pool_t{
 					buf_block_t */
 	ulint		instance_no;	/*!< Array index of this buffer
 					pool instance */
+	ulint		numa_node;	/*!< NUMA node where the chunks
+					of this instance are allocated,
+					or ULINT_UNDEFINED if the instance
+					is not bound to a NUMA node
+					(innodb_buffer_pool_numa_bind=OFF) */
 	ulint		curr_pool_size;	/*!< Current pool size in bytes */
 	ulint		LRU_old_ratio;  /*!< Reserve this much of the buffer
 					pool for "old" blocks */
@@ -2189,6 +2220,30 @@ struct buf_pool_t{
 					of the given type running;
 					os_event_set() and os_event_reset()
 					are protected by buf_pool_t::mutex */
+	ulint		flush_io_depth;	/*!< maximum number of page writes
+					that a flush_list batch may keep
+					in flight, or 0 for no limit;
+					adjusted by the page cleaner
+					within innodb_flush_io_depth */
+	ulint		flush_io_wait;	/*!< n_flush[BUF_FLUSH_LIST] that
+					a flush_list batch is waiting for,
+					or ULINT_UNDEFINED */
+	os_event_t	flush_io_event;	/*!< set when n_flush[BUF_FLUSH_LIST]
+					drops to flush_io_wait */
+	ulint		flush_io_latency;
+					/*!< estimated latency of a page
+					write in microseconds, or 0 if not
+					measured yet */
+	ulint		flush_io_latency_min;
+					/*!< lowest recent flush_io_latency */
+	ulint		flush_io_n_waits;
+					/*!< number of waits for page writes
+					since flush_io_depth was adjusted */
+	ulint		flush_rate;	/*!< pages written per second during
+					the last page cleaner interval */
+	ulint		flush_rate_written;
+					/*!< stat.n_pages_written when
+					flush_rate was last computed */
 	ib_rbt_t*	flush_rbt;	/*!< a red-black tree is used
 					exclusively during recovery to
 					speed up insertions in the
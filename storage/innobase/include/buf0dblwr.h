@@ -109,6 +109,14 @@ of threads can occur. */
 void
 buf_dblwr_flush_buffered_writes();
 
+/** Flush the buffered writes from the doublewrite segment that a buffer
+pool instance uses for batch flushing, and wake up the aio thread if
+simulated aio is used. This must be called after a batch of writes has
+been posted by the instance.
+@param[in]	buf_pool	buffer pool instance */
+void
+buf_dblwr_flush_buffered_writes(const buf_pool_t* buf_pool);
+
 /********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
@@ -123,21 +131,50 @@ buf_dblwr_write_single_page(
 	buf_page_t*	bpage,	/*!< in: buffer block to write */
 	bool		sync);	/*!< in: true if sync IO requested */
 
-/** Doublewrite control struct */
-struct buf_dblwr_t{
-	ib_mutex_t	mutex;	/*!< mutex protecting the first_free
-				field and write_buf */
-	ulint		block1;	/*!< the page number of the first
-				doublewrite block (64 pages) */
-	ulint		block2;	/*!< page number of the second block */
-	ulint		first_free;/*!< first free position in write_buf
-				measured in units of UNIV_PAGE_SIZE */
+/** Count the doublewrite segments that batches have been written from.
+@return number of segments with at least one batch written */
+ulint
+buf_dblwr_n_segments_written();
+
+/** Maximum value of innodb_doublewrite_segments */
+#define BUF_DBLWR_MAX_SEGMENTS	16
+
+/** A part of the batch flushing area of the doublewrite buffer. Each
+buffer pool instance posts its batch writes to one segment, and the
+segments are written and synced independently of each other, so that
+the page cleaner threads do not have to wait for each other. */
+struct buf_dblwr_segment_t{
+	ib_mutex_t	mutex;	/*!< mutex protecting first_free,
+				b_reserved and batch_running */
+	ulint		first;	/*!< first slot of the segment in
+				write_buf and buf_block_arr */
+	ulint		size;	/*!< number of slots in the segment */
+	ulint		first_free;/*!< first free slot of the segment,
+				relative to first */
 	ulint		b_reserved;/*!< number of slots currently reserved
 				for batch flush. */
 	os_event_t	b_event;/*!< event where threads wait for a
 				batch flush to end;
 				os_event_set() and os_event_reset()
-				are protected by buf_dblwr_t::mutex */
+				are protected by mutex */
+	bool		batch_running;/*!< set to true if currently a batch
+				is being written from the segment */
+	ulint		n_writes;/*!< number of batches written from
+				the segment; only updated by the thread
+				that set batch_running */
+};
+
+/** Doublewrite control struct */
+struct buf_dblwr_t{
+	ib_mutex_t	mutex;	/*!< mutex protecting the slots
+				for single page flushes */
+	ulint		block1;	/*!< the page number of the first
+				doublewrite block (64 pages) */
+	ulint		block2;	/*!< page number of the second block */
+	buf_dblwr_segment_t* segments;/*!< the segments for batch
+				flushing, covering the first
+				srv_doublewrite_batch_size slots */
+	ulint		n_segments;/*!< number of segments */
 	ulint		s_reserved;/*!< number of slots currently
 				reserved for single page flushes. */
 	os_event_t	s_event;/*!< event where threads wait for a
@@ -145,9 +182,6 @@ struct buf_dblwr_t{
 	bool*		in_use;	/*!< flag used to indicate if a slot is
 				in use. Only used for single page
 				flushes. */
-	bool		batch_running;/*!< set to TRUE if currently a batch
-				is being written from the doublewrite
-				buffer. */
 	byte*		write_buf;/*!< write buffer used in writing to the
 				doublewrite buffer, aligned to an
 				address divisible by UNIV_PAGE_SIZE
@@ -54,6 +54,11 @@ void
 buf_load_abort();
 /*============*/
 
+/** Wait until the buffer pool load at startup has loaded
+innodb_buffer_pool_load_warm_pct of the dumped pages, or has ended. */
+void
+buf_load_wait_warm();
+
 /*****************************************************************//**
 This is the main thread for buffer pool dump/load. It waits for an
 event and when waked up either performs a dump or load and sleeps
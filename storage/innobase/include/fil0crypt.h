@@ -89,6 +89,7 @@ struct fil_space_rotate_state_t
 	ulint active_threads;	/*!< active threads in space */
 	ulint next_offset;	/*!< next "free" offset */
 	ulint max_offset;	/*!< max offset needing to be rotated */
+	ulint pages_done;	/*!< pages processed since start_time */
 	uint  min_key_version_found; /*!< min key version found but not
 				     rotated */
 	lsn_t end_lsn;		/*!< max lsn created when rotating this
@@ -214,6 +215,8 @@ struct fil_space_crypt_status_t {
 	bool flushing;           /*!< is flush at end of rotation ongoing */
 	ulint rotate_next_page_number; /*!< next page if key rotating */
 	ulint rotate_max_page_number;  /*!< max page if key rotating */
+	ulint rotate_active_threads;   /*!< threads rotating the space */
+	ulint rotate_pages_done;       /*!< pages processed if key rotating */
 };
 
 /** Statistics about encryption key rotation */
@@ -35,6 +35,8 @@ Created 10/25/1995 Heikki Tuuri
 #include "page0size.h"
 #include "ibuf0types.h"
 
+#include <lf.h>
+
 // Forward declaration
 extern ibool srv_use_doublewrite_buf;
 extern struct buf_dblwr_t* buf_dblwr;
@@ -73,6 +75,7 @@ fil_type_is_data(
 }
 
 struct fil_node_t;
+struct fil_space_lf_t;
 
 /** Tablespace or log data space */
 struct fil_space_t {
@@ -189,6 +192,21 @@ struct fil_space_t {
 	punch hole */
 	bool		punch_hole;
 
+	/** Entry in fil_system->lf_spaces, or NULL for the redo log.
+	Protected by fil_system->mutex. */
+	fil_space_lf_t*	lf;
+
+	/** @name I/O statistics; updated with atomic operations and
+	reported in INFORMATION_SCHEMA.INNODB_TABLESPACES_IO */
+	/* @{ */
+	ulint		n_reads;	/*!< number of completed reads */
+	ulint		n_read_bytes;	/*!< number of bytes read */
+	ulint		read_time_us;	/*!< microseconds spent in reads */
+	ulint		n_writes;	/*!< number of completed writes */
+	ulint		n_write_bytes;	/*!< number of bytes written */
+	ulint		write_time_us;	/*!< microseconds spent in writes */
+	/* @} */
+
 	ulint		magic_n;/*!< FIL_SPACE_MAGIC_N */
 
 	/** @return whether the tablespace is about to be dropped or
@@ -531,6 +549,10 @@ struct fil_system_t {
 	UT_LIST_BASE_NODE_T(fil_space_t) rotation_list;
 					/*!< list of all file spaces needing
 					key rotation.*/
+	LF_HASH		lf_spaces;	/*!< data file spaces hashed on the
+					space id, for looking up the file
+					of a page read without acquiring
+					the mutex; see fil_space_lf_t */
 
 	ibool		space_id_reuse_warned;
 					/* !< TRUE if fil_space_create()
@@ -437,6 +437,7 @@ fts_cache_find_word(
 /*================*/
 	const fts_index_cache_t*
 			index_cache,	/*!< in: cache to search */
+	const ib_rbt_t*	words,		/*!< in: words of the cache */
 	const fts_string_t*
 			text)		/*!< in: word to search for */
 	MY_ATTRIBUTE((warn_unused_result));
@@ -68,6 +68,11 @@ struct fts_index_cache_t {
 	ib_rbt_t*	words;		/*!< Nodes; indexed by fts_string_t*,
 					cells are fts_tokenizer_word_t*.*/
 
+	ib_rbt_t*	sync_words;	/*!< The words that are being written
+					to the INDEX table by SYNC, while
+					new documents are added to words;
+					NULL if no SYNC is pending */
+
 	ib_vector_t*	doc_stats;	/*!< Array of the fts_doc_stats_t
 					contained in the memory buffer.
 					Must be in sorted order (ascending).
@@ -126,8 +131,18 @@ struct fts_sync_t {
 					set the upper_limit field */
 	ib_time_t	start_time;	/*!< SYNC start time */
 	bool		in_progress;	/*!< flag whether sync is in progress.*/
-	bool		unlock_cache;	/*!< flag whether unlock cache when
-					write fts node */
+	mem_heap_t*	heap;		/*!< The memory of the cache contents
+					that are being written, i.e.,
+					fts_index_cache_t::sync_words and
+					deleted_doc_ids; NULL if no SYNC is
+					pending. If a SYNC fails, these are
+					kept for the next SYNC. */
+	ib_vector_t*	deleted_doc_ids;/*!< fts_cache_t::deleted_doc_ids
+					of the contents that are being
+					written; covered by
+					fts_cache_t::deleted_lock */
+	doc_id_t	sync_doc_id;	/*!< max_doc_id of the contents that
+					are being written */
 	os_event_t	event;		/*!< sync finish event;
 					only os_event_set() and os_event_wait()
 					are used */
@@ -58,6 +58,9 @@ class ReadView;
 /** The value of innodb_deadlock_detect */
 extern my_bool	innobase_deadlock_detect;
 
+/** The value of innodb_deadlock_detect_async */
+extern my_bool	innobase_deadlock_detect_async;
+
 /*********************************************************************//**
 Gets the size of a lock struct.
 @return size in bytes */
@@ -588,7 +591,7 @@ lock_print_info_all_transactions(
 Return approximate number or record locks (bits set in the bitmap) for
 this transaction. Since delete-marked records may be removed, the
 record count will not be precise.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding lock_sys.latch. */
 ulint
 lock_number_of_rows_locked(
 /*=======================*/
@@ -597,7 +600,7 @@ lock_number_of_rows_locked(
 
 /*********************************************************************//**
 Return the number of table locks for a transaction.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding lock_sys.latch. */
 ulint
 lock_number_of_tables_locked(
 /*=========================*/
@@ -716,6 +719,18 @@ DECLARE_THREAD(lock_wait_timeout_thread)(
 	void*	arg);	/*!< in: a dummy parameter required by
 			os_thread_create */
 
+/** A thread which looks for deadlocks among the transactions that are
+suspended in lock waits, when innodb_deadlock_detect_async is set.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(lock_deadlock_thread)(void*);
+
+/** Look for deadlocks among the transactions that are suspended in lock
+waits, and roll back a victim of each deadlock. */
+void
+lock_deadlock_check_async();
+
 /********************************************************************//**
 Releases a user OS thread waiting for a lock to be released, if the
 thread is already suspended. */
@@ -879,15 +894,38 @@ struct lock_op_t{
 
 typedef ib_mutex_t LockMutex;
 
+/** Number of mutexes protecting the cells of lock_sys.rec_hash */
+#define LOCK_SYS_REC_SHARDS	64
+
 /** The lock system struct */
 class lock_sys_t
 {
   bool m_initialised;
 
 public:
+	/** A mutex protecting the record lock queues of the
+	lock_sys.rec_hash cells c for which
+	c % LOCK_SYS_REC_SHARDS is the index of the shard */
+	struct rec_shard_t
+	{
+		MY_ALIGNED(CACHE_LINE_SIZE)
+		LockMutex	mutex;
+	};
+
 	MY_ALIGNED(CACHE_LINE_SIZE)
-	LockMutex	mutex;			/*!< Mutex protecting the
-						locks */
+	rw_lock_t	latch;			/*!< Latch protecting the
+						locks. Exclusive mode protects
+						everything. Shared mode
+						together with a rec_shards[]
+						mutex only allows a record
+						lock request to look at and
+						add to the lock queue of a
+						page, when it does not have
+						to wait */
+	rec_shard_t	rec_shards[LOCK_SYS_REC_SHARDS];
+						/*!< Mutexes protecting
+						the cells of rec_hash
+						in shared latch mode */
 	hash_table_t*	rec_hash;		/*!< hash table of the record
 						locks */
 	hash_table_t*	prdt_hash;		/*!< hash table of the predicate
@@ -923,6 +961,16 @@ class lock_sys_t
 	bool		timeout_thread_active;	/*!< True if the timeout thread
 						is running */
 
+	os_event_t	deadlock_event;		/*!< An event waited for by
+						lock_deadlock_thread.
+						Signaled when a transaction
+						is suspended in a lock wait,
+						and on shutdown. */
+
+	bool		deadlock_thread_active;	/*!< True if
+						lock_deadlock_thread
+						is running */
+
 
   /**
     Constructor.
@@ -954,6 +1002,33 @@ class lock_sys_t
 
   /** Closes the lock system at database shutdown. */
   void close();
+
+
+  /**
+    Acquire latch in shared mode and the rec_shards[] mutex of a page.
+
+    @param[in] block buffer block of the page
+    @return the rec_shards[] index to pass to rec_shard_exit()
+  */
+  ulint rec_shard_enter(const buf_block_t* block);
+
+
+  /**
+    Release the rec_shards[] mutex and latch.
+
+    @param[in] shard return value of rec_shard_enter()
+  */
+  void rec_shard_exit(ulint shard);
+
+#ifdef UNIV_DEBUG
+  /**
+    Test if the thread holds latch in shared mode and a rec_shards[] mutex.
+
+    @param[in] cell rec_hash cell index
+    @return whether the lock queues in the rec_hash cell are protected
+  */
+  bool rec_shard_own(ulint cell);
+#endif /* UNIV_DEBUG */
 };
 
 /*************************************************************//**
@@ -1000,21 +1075,29 @@ lock_rec_trx_wait(
 /** The lock system */
 extern lock_sys_t lock_sys;
 
-/** Test if lock_sys.mutex can be acquired without waiting. */
+/** Test if lock_sys.latch can be acquired in exclusive mode without
+waiting.
+@return nonzero if the latch could not be acquired */
 #define lock_mutex_enter_nowait() 		\
-	(lock_sys.mutex.trylock(__FILE__, __LINE__))
+	(!rw_lock_x_lock_nowait(&lock_sys.latch))
+
+/** Test if lock_sys.latch is owned in exclusive mode. */
+#define lock_mutex_own() (rw_lock_own(&lock_sys.latch, RW_LOCK_X))
 
-/** Test if lock_sys.mutex is owned. */
-#define lock_mutex_own() (lock_sys.mutex.is_owned())
+/** Test if the record lock queue of a page is protected, either by
+lock_sys.latch in exclusive mode, or by lock_sys.rec_shard_enter(). */
+#define lock_rec_queue_own(space, page_no)				\
+	(lock_mutex_own()						\
+	 || lock_sys.rec_shard_own(lock_rec_hash(space, page_no)))
 
-/** Acquire the lock_sys.mutex. */
+/** Acquire the lock_sys.latch in exclusive mode. */
 #define lock_mutex_enter() do {			\
-	mutex_enter(&lock_sys.mutex);		\
+	rw_lock_x_lock(&lock_sys.latch);	\
 } while (0)
 
-/** Release the lock_sys.mutex. */
+/** Release the lock_sys.latch from exclusive mode. */
 #define lock_mutex_exit() do {			\
-	lock_sys.mutex.exit();			\
+	rw_lock_x_unlock(&lock_sys.latch);	\
 } while (0)
 
 /** Test if lock_sys.wait_mutex is owned. */
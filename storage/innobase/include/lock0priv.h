@@ -111,7 +111,7 @@ operator<<(std::ostream& out, const lock_rec_t& lock)
 	return(lock.print(out));
 }
 
-/** Lock struct; protected by lock_sys.mutex */
+/** Lock struct; protected by lock_sys.latch */
 struct lock_t {
 	trx_t*		trx;		/*!< transaction owning the
 					lock */
@@ -861,7 +861,8 @@ class RecLock {
 	Setup the context from the requirements */
 	void init(const page_t* page)
 	{
-		ut_ad(lock_mutex_own());
+		ut_ad(lock_rec_queue_own(m_rec_id.m_space_id,
+					 m_rec_id.m_page_no));
 		ut_ad(!srv_read_only_mode);
 		ut_ad(dict_index_is_clust(m_index)
 		      || !dict_index_is_online_ddl(m_index));
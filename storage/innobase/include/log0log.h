@@ -109,6 +109,31 @@ log_write_low(
 /*==========*/
 	const byte*	str,		/*!< in: string */
 	ulint		str_len);	/*!< in: string length */
+/** Reserve space for a redo log record group in the log buffer and
+advance the log block headers and log_sys->lsn as if the records were
+written by log_write_low(). The caller must hold log_sys->mutex, and
+must copy the records with log_write_reserved() after releasing it.
+@param[in]	len	length of the records, in bytes
+@return start of the reserved area in log_sys->buf */
+byte*
+log_reserve_low(
+	ulint	len);
+/** Copy part of a redo log record group to the area that was reserved
+with log_reserve_low(), skipping the log block headers and trailers.
+@param[in]	ptr	current position in the reserved area
+@param[in]	str	log records
+@param[in]	str_len	length of str, in bytes
+@return the position following the copied records */
+byte*
+log_write_reserved(
+	byte*		ptr,
+	const byte*	str,
+	ulint		str_len);
+/** Note that the records of a log_reserve_low() area were copied
+by log_write_reserved(), so that the log buffer may be written. */
+UNIV_INLINE
+void
+log_write_reserved_done();
 /************************************************************//**
 Closes the log.
 @return lsn */
@@ -600,6 +625,15 @@ struct log_t{
 	ulint		buf_free;	/*!< first free offset within the log
 					buffer in use */
 
+	char		pad_copies[CACHE_LINE_SIZE];/*!< Padding */
+	ulint		n_pending_copies;/*!< number of mini-transactions
+					that have reserved space in buf
+					with log_reserve_low() but not yet
+					copied their records there with
+					log_write_reserved(); incremented
+					while holding mutex, decremented
+					atomically without it */
+
 	char		pad2[CACHE_LINE_SIZE];/*!< Padding */
 	LogSysMutex	mutex;		/*!< mutex protecting the log */
 	char		pad3[CACHE_LINE_SIZE]; /*!< Padding */
@@ -229,6 +229,10 @@ class IORequest {
 
 		/** Use punch hole if available*/
 		PUNCH_HOLE = 256,
+
+		/** The file node was looked up without fil_system->mutex,
+		and the request must be completed without it as well */
+		NO_FIL_MUTEX = 512,
 	};
 
 	/** Default constructor */
@@ -236,6 +240,7 @@ class IORequest {
 		:
 		m_bpage(NULL),
 		m_fil_node(NULL),
+		m_start(0),
 		m_type(READ)
 	{
 		/* No op */
@@ -248,6 +253,7 @@ class IORequest {
 		:
 		m_bpage(NULL),
 		m_fil_node(NULL),
+		m_start(0),
 		m_type(static_cast<uint16_t>(type))
 	{
 		if (!is_punch_hole_supported()) {
@@ -263,6 +269,7 @@ class IORequest {
 		:
 		m_bpage(bpage),
 		m_fil_node(NULL),
+		m_start(0),
 		m_type(static_cast<uint16_t>(type))
 	{
 		if (bpage && buf_page_should_punch_hole(bpage)) {
@@ -367,6 +374,34 @@ class IORequest {
 		m_type &= ~DO_NOT_WAKE;
 	}
 
+	/** Note that the file node was looked up without fil_system->mutex */
+	void set_no_fil_mutex()
+	{
+		m_type |= NO_FIL_MUTEX;
+	}
+
+	/** @return true if the request must be completed without
+	acquiring fil_system->mutex */
+	bool is_no_fil_mutex() const
+		MY_ATTRIBUTE((warn_unused_result))
+	{
+		return((m_type & NO_FIL_MUTEX) == NO_FIL_MUTEX);
+	}
+
+	/** Set the time when the request was submitted
+	@param[in]	start	ut_time_us() at submission */
+	void set_start_time(ulonglong start)
+	{
+		m_start = start;
+	}
+
+	/** @return ut_time_us() when the request was submitted */
+	ulonglong start_time() const
+		MY_ATTRIBUTE((warn_unused_result))
+	{
+		return(m_start);
+	}
+
 	/** Set the pointer to file node for IO
 	@param[in] node			File node */
 	void set_fil_node(fil_node_t* node)
@@ -449,6 +484,9 @@ class IORequest {
 	/** File node */
 	fil_node_t*		m_fil_node;
 
+	/** Submission time in microseconds, for latency accounting */
+	ulonglong		m_start;
+
 	/** Request type bit flags */
 	uint16_t		m_type;
 };
@@ -1440,6 +1478,19 @@ Frees the asynchronous io system. */
 void
 os_aio_free();
 
+/** Register the memory that page I/O buffers are allocated from, so
+that innodb_use_io_uring can skip mapping the pages on every request.
+@param[in]	mem	start addresses of the memory ranges
+@param[in]	len	lengths of the memory ranges, in bytes
+@param[in]	n	number of memory ranges */
+void
+os_aio_register_buffers(byte* const* mem, const ulint* len, ulint n);
+
+/** Unregister the memory of os_aio_register_buffers(), before any of
+it is freed. */
+void
+os_aio_unregister_buffers();
+
 /**
 NOTE! Use the corresponding macro os_aio(), not directly this function!
 Requests an asynchronous i/o operation.
@@ -82,8 +82,19 @@ class ReadView
   int32_t m_state;
 
 
+  /**
+    Set by trx_sys_t::clone_oldest_view() while it may be copying this view.
+
+    The purge thread sets this flag before it checks m_state. The owner waits
+    for the flag to be cleared after changing m_state from
+    READ_VIEW_STATE_OPEN to READ_VIEW_STATE_REGISTERED, before it starts
+    to overwrite the snapshot.
+  */
+  mutable int32_t m_purge_copying;
+
+
 public:
-  ReadView(): m_state(READ_VIEW_STATE_CLOSED) {}
+  ReadView(): m_state(READ_VIEW_STATE_CLOSED), m_purge_copying(0) {}
 
 
   /**
@@ -143,6 +154,18 @@ class ReadView
   void open(trx_t *trx);
 
 
+  /**
+    Opens a read view that sees exactly what another open view sees.
+
+    Used by the worker transactions of a parallel scan, which must read the
+    snapshot of the statement. View becomes visible to purge thread via
+    trx_sys.m_views.
+
+    @param other    open view of another transaction
+  */
+  void open_copy(const ReadView &other);
+
+
   /**
     Closes the view.
 
@@ -162,8 +185,7 @@ class ReadView
           m_state == READ_VIEW_STATE_REGISTERED ||
           m_state == READ_VIEW_STATE_OPEN);
     if (m_state == READ_VIEW_STATE_OPEN)
-      my_atomic_store32_explicit(&m_state, READ_VIEW_STATE_REGISTERED,
-                                 MY_MEMORY_ORDER_RELAXED);
+      my_atomic_store32(&m_state, READ_VIEW_STATE_REGISTERED);
   }
 
 
@@ -175,6 +197,25 @@ class ReadView
   }
 
 
+  /**
+    Announces that trx_sys::clone_oldest_view() is about to copy the view.
+
+    @return m_state, loaded after the announcement
+  */
+  int32_t purge_copy_start() const
+  {
+    my_atomic_store32(&m_purge_copying, 1);
+    return my_atomic_load32(const_cast<int32*>(&m_state));
+  }
+
+
+  /** Announces that trx_sys::clone_oldest_view() is done with the view. */
+  void purge_copy_end() const
+  {
+    my_atomic_store32_explicit(&m_purge_copying, 0, MY_MEMORY_ORDER_RELEASE);
+  }
+
+
   /**
     Returns true if view is open.
 
@@ -65,6 +65,24 @@ cmp_data_data(
 	ulint		len2)
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Compare two byte strings of equal length, like memcmp(). Short
+strings are compared a machine word or a SIMD register at a time,
+without a library call.
+@param[in] data1 byte string
+@param[in] data2 byte string
+@param[in] len length of both strings in bytes
+@return the comparison result of data1 and data2
+@retval 0 if data1 is equal to data2
+@retval negative if data1 is less than data2
+@retval positive if data1 is greater than data2 */
+UNIV_INLINE
+int
+cmp_bytes(
+	const byte*	data1,
+	const byte*	data2,
+	ulint		len)
+	MY_ATTRIBUTE((warn_unused_result));
+
 /** Compare two data fields.
 @param[in] dfield1 data field; must have type field set
 @param[in] dfield2 data field
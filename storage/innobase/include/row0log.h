@@ -41,6 +41,9 @@ class ut_stage_alter_t;
 extern ulint onlineddl_rowlog_rows;
 extern ulint onlineddl_rowlog_pct_used;
 extern ulint onlineddl_pct_progress;
+/** Number of threads that row_merge_read_clustered_index_parallel()
+has started for scanning key ranges of a clustered index */
+extern ulint onlineddl_parallel_scan_threads;
 
 /******************************************************//**
 Allocate the row log for an index and flag the index
@@ -53,6 +53,11 @@ row_mysql_prebuilt_free_blob_heap(
 /*==============================*/
 	row_prebuilt_t*	prebuilt);	/*!< in: prebuilt struct of a
 					ha_innobase:: table handle */
+/** Free the prefetch cache of a table handle.
+@param[in,out]	prebuilt	prebuilt struct of a ha_innobase:: table
+handle, with no rows in the prefetch cache */
+void
+row_mysql_prebuilt_free_fetch_cache(row_prebuilt_t* prebuilt);
 /*******************************************************************//**
 Stores a >= 5.0.3 format true VARCHAR length to dest, in the MySQL row
 format.
@@ -607,7 +612,14 @@ struct mysql_row_templ_t {
 	ulint	is_virtual;		/*!< if a column is a virtual column */
 };
 
+/* Number of rows in the first batch of fetch_cache after positioning
+the cursor */
 #define MYSQL_FETCH_CACHE_SIZE		8
+/* Maximum number of rows in a batch of fetch_cache */
+#define MYSQL_FETCH_CACHE_MAX_SIZE	1024
+/* Maximum size of fetch_cache in bytes, unless MYSQL_FETCH_CACHE_SIZE
+rows need more */
+#define MYSQL_FETCH_CACHE_MAX_BYTES	(256 * 1024)
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
 
@@ -782,16 +794,24 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
-					/*!< a cache for fetched rows if we
+	byte*		fetch_cache;	/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
-					batch; we reserve mysql_row_len
-					bytes for each such row; these
-					pointers point 4 bytes past the
-					allocated mem buf start, because
-					there is a 4 byte magic number at the
-					start and at the end */
+					batch; a contiguous arena of
+					fetch_cache_alloc rows of
+					mysql_row_len bytes, or NULL; this
+					points 4 bytes past the allocated
+					mem buf start, because there is a
+					4 byte magic number at the start and
+					at the end */
+	ulint		fetch_cache_alloc;/*!< number of rows allocated
+					in fetch_cache */
+	ulint		fetch_cache_size;/*!< number of rows to cache in
+					a batch; doubled, up to
+					MYSQL_FETCH_CACHE_MAX_SIZE and
+					MYSQL_FETCH_CACHE_MAX_BYTES, each
+					time the scan consumes a whole
+					batch */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
@@ -800,6 +820,13 @@ struct row_prebuilt_t {
 					fetched row in fetch_cache */
 	ulint		n_fetch_cached;	/*!< number of not yet fetched rows
 					in fetch_cache */
+	ulint		clust_read_ahead_page;/*!< secondary index page whose
+					records had their clustered index
+					leaf pages read ahead, or FIL_NULL */
+	bool		clust_read_ahead_off;/*!< whether the read-ahead of
+					clustered index leaf pages found
+					them all in the buffer pool in
+					this scan */
 	mem_heap_t*	blob_heap;	/*!< in SELECTS BLOB fields are copied
 					to this heap */
 	mem_heap_t*	old_vers_heap;	/*!< memory heap where a previous
@@ -116,6 +116,12 @@ struct purge_node_t{
 				clustered index record */
 	ibool		done;	/* Debug flag */
 	trx_id_t	trx_id;	/*!< trx id for this purging record */
+	ulint		n_purged;/*!< number of undo log records that
+				this node has processed since startup */
+	ulint		n_tables;/*!< number of tables that were assigned
+				to this node in the current batch */
+	ib_uint64_t	purge_time;/*!< time spent processing undo log
+				records, in microseconds */
 
 #ifdef UNIV_DEBUG
 	/***********************************************************//**
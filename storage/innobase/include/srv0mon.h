@@ -206,6 +206,7 @@ enum monitor_id_t {
 	MONITOR_FLUSH_ADAPTIVE_AVG_PASS,
 	MONITOR_LRU_BATCH_FLUSH_AVG_PASS,
 	MONITOR_FLUSH_AVG_PASS,
+	MONITOR_FLUSH_IO_DEPTH_STALL_TIME,
 
 	MONITOR_LRU_GET_FREE_LOOPS,
 	MONITOR_LRU_GET_FREE_WAITS,
@@ -302,6 +303,7 @@ enum monitor_id_t {
 	MONITOR_TRX_ROLLBACK_SAVEPOINT,
 	MONITOR_TRX_ROLLBACK_ACTIVE,
 	MONITOR_TRX_ACTIVE,
+	MONITOR_TRX_SNAPSHOT_REUSED,
 	MONITOR_RSEG_HISTORY_LEN,
 	MONITOR_NUM_UNDO_SLOT_USED,
 	MONITOR_NUM_UNDO_SLOT_CACHED,
@@ -374,6 +376,7 @@ enum monitor_id_t {
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVED,
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVE_NOT_FOUND,
 	MONITOR_ADAPTIVE_HASH_ROW_UPDATED,
+	MONITOR_OVLD_ADAPTIVE_HASH_LATCH_WAITS,
 #endif /* BTR_CUR_HASH_ADAPT */
 
 	/* Tablespace related counters */
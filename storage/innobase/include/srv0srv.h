@@ -150,6 +150,10 @@ struct srv_stats_t
 	/** Number of threads currently waiting on database locks */
 	simple_counter<ulint, true> n_lock_wait_current_count;
 
+	/** Number of record locks granted under a lock_sys.rec_shards[]
+	mutex; incremented at the index of the shard */
+	ulint_ctr_64_t		n_lock_rec_shard_grants;
+
 	/** Number of rows read. */
 	ulint_ctr_64_t		n_rows_read;
 
@@ -180,6 +184,10 @@ struct srv_stats_t
 	/** Number of times prefix optimization avoided triggering cluster lookup */
 	ulint_ctr_64_t		n_sec_rec_cluster_reads_avoided;
 
+	/** Number of clustered index leaf pages read ahead for
+	secondary index lookups */
+	ulint_ctr_64_t		n_sec_rec_cluster_read_aheads;
+
 	/** Number of times page 0 is read from tablespace */
 	ulint_ctr_64_t		page0_read;
 
@@ -256,6 +264,8 @@ extern my_bool	high_level_read_only;
 /** store to its own file each table created by an user; data
 dictionary tables are in the system tablespace 0 */
 extern my_bool	srv_file_per_table;
+/** Number of threads that open the file-per-table tablespaces at startup */
+extern ulong	srv_tablespace_discovery_threads;
 /** Sleep delay for threads waiting to enter InnoDB. In micro-seconds. */
 extern	ulong	srv_thread_sleep_delay;
 /** Maximum sleep delay (in micro-seconds), value of 0 disables it.*/
@@ -269,13 +279,22 @@ extern ibool	srv_locks_unsafe_for_binlog;
 extern ulong	srv_sort_buf_size;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
+/** Number of threads that scan the clustered index and load the
+secondary indexes in ALTER TABLE...ADD INDEX; 1=no parallel build */
+extern ulong	srv_index_build_threads;
 
 /* If this flag is TRUE, then we will use the native aio of the
 OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+/** innodb_use_io_uring: whether native aio on Linux uses io_uring
+instead of libaio */
+extern my_bool	srv_use_io_uring;
 extern my_bool	srv_numa_interleave;
+/** innodb_buffer_pool_numa_bind: whether to bind each buffer pool
+instance to a NUMA node */
+extern my_bool	srv_buf_pool_numa_bind;
 
 /* Use atomic writes i.e disable doublewrite buffer */
 extern my_bool srv_use_atomic_writes;
@@ -335,6 +354,10 @@ extern my_bool	srv_undo_log_truncate;
 /* Enables or disables this prefix optimization.  Disabled by default. */
 extern my_bool	srv_prefix_index_cluster_optimization;
 
+/** innodb_batched_lookup_size; maximum number of records of a secondary
+index page whose clustered index leaf pages are read ahead together */
+extern ulong	srv_batched_lookup_size;
+
 /** Default size of UNDO tablespace while it is created new. */
 extern const ulint	SRV_UNDO_TABLESPACE_SIZE_IN_PAGES;
 
@@ -390,6 +413,12 @@ extern ulint	srv_buf_pool_base_size;
 extern ulint	srv_buf_pool_curr_size;
 /** Dump this % of each buffer pool during BP dump */
 extern ulong	srv_buf_pool_dump_pct;
+/** Number of threads that load the buffer pool */
+extern ulong	srv_buf_pool_load_threads;
+/** Pending asynchronous reads per buffer pool load thread */
+extern ulong	srv_buf_pool_load_io_depth;
+/** Percentage of the buffer pool load to wait for at startup */
+extern ulong	srv_buf_pool_load_warm_pct;
 #ifdef UNIV_DEBUG
 /** Abort load after this amount of pages */
 extern ulong srv_buf_pool_load_pages_abort;
@@ -430,6 +459,10 @@ capacity. PCT_IO(5) -> returns the number of IO operations that
 is 5% of the max where max is srv_io_capacity.  */
 #define PCT_IO(p) ((ulong) (srv_io_capacity * ((double) (p) / 100.0)))
 
+/** innodb_flush_io_depth: maximum number of page writes that a flush_list
+batch of a buffer pool instance may keep in flight, or 0 for no limit */
+extern ulong	srv_flush_io_depth;
+
 /* The "innodb_stats_method" setting, decides how InnoDB is going
 to treat NULL value when collecting statistics. It is not defined
 as enum type because the configure option takes unsigned integer type. */
@@ -473,6 +506,9 @@ extern my_bool			srv_stats_sample_traditional;
 
 extern ibool	srv_use_doublewrite_buf;
 extern ulong	srv_doublewrite_batch_size;
+/** innodb_doublewrite_segments: number of independently flushed
+segments of the doublewrite buffer, or 0 for one per page cleaner */
+extern ulong	srv_doublewrite_segments;
 extern ulong	srv_checksum_algorithm;
 
 extern double	srv_max_buf_pool_modified_pct;
@@ -562,6 +598,10 @@ extern ulong srv_n_purge_threads;
 /* the number of pages to purge in one batch */
 extern ulong srv_purge_batch_size;
 
+/** innodb_recovery_apply_threads; the number of threads applying
+redo log records to pages during crash recovery */
+extern ulong srv_n_recv_apply_threads;
+
 /* the number of sync wait arrays */
 extern ulong srv_sync_array_size;
 
@@ -601,8 +641,10 @@ extern mysql_pfs_key_t	io_read_thread_key;
 extern mysql_pfs_key_t	io_write_thread_key;
 extern mysql_pfs_key_t	page_cleaner_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
 extern mysql_pfs_key_t	srv_error_monitor_thread_key;
 extern mysql_pfs_key_t	srv_lock_timeout_thread_key;
+extern mysql_pfs_key_t	srv_lock_deadlock_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_monitor_thread_key;
 extern mysql_pfs_key_t	srv_purge_thread_key;
@@ -969,6 +1011,8 @@ struct export_var_t{
 	ulint innodb_buffer_pool_read_ahead_evicted;/*!< srv_read_ahead evicted*/
 	ulint innodb_dblwr_pages_written;	/*!< srv_dblwr_pages_written */
 	ulint innodb_dblwr_writes;		/*!< srv_dblwr_writes */
+	ulint innodb_dblwr_segments;		/*!< buf_dblwr->n_segments */
+	ulint innodb_dblwr_segments_written;	/*!< buf_dblwr_n_segments_written() */
 	ibool innodb_have_atomic_builtins;	/*!< HAVE_ATOMIC_BUILTINS */
 	ulint innodb_log_waits;			/*!< srv_log_waits */
 	ulint innodb_log_write_requests;	/*!< srv_log_write_requests */
@@ -984,6 +1028,7 @@ struct export_var_t{
 	ulint innodb_pages_written;		/*!< buf_pool->stat.n_pages_written */
 	ulint innodb_row_lock_waits;		/*!< srv_n_lock_wait_count */
 	ulint innodb_row_lock_current_waits;	/*!< srv_n_lock_wait_current_count */
+	ulint innodb_row_lock_shard_grants;	/*!< srv_stats.n_lock_rec_shard_grants */
 	int64_t innodb_row_lock_time;		/*!< srv_n_lock_wait_time
 						/ 1000 */
 	ulint innodb_row_lock_time_avg;		/*!< srv_n_lock_wait_time
@@ -1019,11 +1064,16 @@ struct export_var_t{
 	ulint innodb_onlineddl_rowlog_pct_used; /*!< Online alter percentage
 						of used row log buffer */
 	ulint innodb_onlineddl_pct_progress;	/*!< Online alter progress */
+	ulint innodb_onlineddl_parallel_scan_threads;
+						/*!< onlineddl_parallel_scan_threads */
 
 #ifdef UNIV_DEBUG
 	ulint innodb_ahi_drop_lookups;		/*!< number of adaptive hash
 						index lookups when freeing
 						file pages */
+	ulint innodb_purge_split_batches;	/*!< number of purge batches
+						whose tables were dispatched
+						to several purge threads */
 #endif /* UNIV_DEBUG */
 
 	int64_t innodb_page_compression_saved;/*!< Number of bytes saved
@@ -1057,6 +1107,7 @@ struct export_var_t{
 
 	ulint innodb_sec_rec_cluster_reads;	/*!< srv_sec_rec_cluster_reads */
 	ulint innodb_sec_rec_cluster_reads_avoided;/*!< srv_sec_rec_cluster_reads_avoided */
+	ulint innodb_sec_rec_cluster_read_aheads;/*!< srv_sec_rec_cluster_read_aheads */
 
 	ulint innodb_encryption_rotation_pages_read_from_cache;
 	ulint innodb_encryption_rotation_pages_read_from_disk;
@@ -235,6 +235,7 @@ enum latch_level_t {
 	SYNC_TRX,
 	SYNC_RW_TRX_HASH_ELEMENT,
 	SYNC_TRX_SYS,
+	SYNC_LOCK_REC_HASH,
 	SYNC_LOCK_SYS,
 	SYNC_LOCK_WAIT_SYS,
 
@@ -343,6 +344,7 @@ enum latch_id_t {
 	LATCH_ID_TRX_POOL_MANAGER,
 	LATCH_ID_TRX,
 	LATCH_ID_LOCK_SYS,
+	LATCH_ID_LOCK_SYS_REC_HASH,
 	LATCH_ID_LOCK_SYS_WAIT,
 	LATCH_ID_TRX_SYS,
 	LATCH_ID_SRV_SYS,
@@ -370,6 +372,7 @@ enum latch_id_t {
 	LATCH_ID_FTS_CACHE_INIT,
 	LATCH_ID_TRX_I_S_CACHE,
 	LATCH_ID_TRX_PURGE,
+	LATCH_ID_TRX_SYS_SNAPSHOT,
 	LATCH_ID_IBUF_INDEX_TREE,
 	LATCH_ID_INDEX_TREE,
 	LATCH_ID_DICT_TABLE_STATS,
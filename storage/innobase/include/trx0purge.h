@@ -483,6 +483,13 @@ class purge_sys_t
 	undo::Truncate	undo_trunc;	/*!< Track UNDO tablespace marked
 					for truncate. */
 
+	mem_heap_t*	heap;		/*!< Memory heap for the copies of
+					the undo log records of the current
+					purge batch; emptied when the next
+					batch is attached */
+	ulint		prefetch_page_no;/*!< Undo log page that was last
+					submitted for read-ahead, or FIL_NULL */
+
 
   /**
     Constructor.
@@ -507,6 +514,11 @@ class purge_sys_t
 /** The global data structure coordinating a purge */
 extern purge_sys_t	purge_sys;
 
+/** Print the per-thread purge statistics.
+@param[in,out]	file	output stream */
+void
+trx_purge_print_stats(FILE* file);
+
 /** Info required to purge a record */
 struct trx_purge_rec_t {
 	trx_undo_rec_t*	undo_rec;	/*!< Record to purge */
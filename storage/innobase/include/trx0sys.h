@@ -590,10 +590,10 @@ class rw_trx_hash_t
     the transaction may get committed before this method returns.
 
     With do_ref_count == false the caller may dereference returned trx pointer
-    only if lock_sys.mutex was acquired before calling find().
+    only if lock_sys.latch was acquired before calling find().
 
     With do_ref_count == true caller may dereference trx even if it is not
-    holding lock_sys.mutex. Caller is responsible for calling
+    holding lock_sys.latch. Caller is responsible for calling
     trx->release_reference() when it is done playing with trx.
 
     Ideally this method should get caller rw_trx_hash_pins along with trx
@@ -797,6 +797,39 @@ class trx_sys_t
   MY_ALIGNED(CACHE_LINE_SIZE) trx_id_t m_rw_trx_hash_version;
 
 
+  /**
+    Incremented after a transaction is removed from rw_trx_hash.
+
+    Together with m_max_trx_id it identifies the contents of rw_trx_hash:
+    while neither of them changes, no transaction has been registered,
+    serialised or deregistered, and an earlier MVCC snapshot can be reused.
+
+    @sa deregister_rw()
+    @sa snapshot_ids()
+  */
+  MY_ALIGNED(CACHE_LINE_SIZE) int64 m_rw_trx_hash_erase_version;
+
+
+  /**
+    The most recent MVCC snapshot, shared by all snapshot_ids() callers that
+    observe the same m_max_trx_id and m_rw_trx_hash_erase_version.
+  */
+  struct shared_snapshot_t
+  {
+    /** Protects the other members */
+    rw_lock_t latch;
+    /** m_max_trx_id at the time of the snapshot */
+    trx_id_t max_trx_id;
+    /** m_rw_trx_hash_erase_version at the time of the snapshot */
+    int64 erase_version;
+    /** min(trx->no) of the registered transactions */
+    trx_id_t min_trx_no;
+    /** Sorted identifiers of the registered transactions */
+    trx_ids_t ids;
+  };
+  MY_ALIGNED(CACHE_LINE_SIZE) shared_snapshot_t m_snapshot;
+
+
   /**
     TRX_RSEG_HISTORY list length (number of committed transactions to purge)
   */
@@ -946,6 +979,11 @@ class trx_sys_t
   /**
     Takes MVCC snapshot.
 
+    If no transaction has been registered, serialised or deregistered since
+    the shared snapshot m_snapshot was taken, it is copied instead of
+    iterating rw_trx_hash. Otherwise a new snapshot is taken and published
+    in m_snapshot, unless rw_trx_hash changed meanwhile.
+
     To reduce malloc probablility we reserver rw_trx_hash.size() + 32 elements
     in ids.
 
@@ -960,12 +998,14 @@ class trx_sys_t
     identifiers may appear multiple times in ids.
 
     @param[in,out] caller_trx used to get access to rw_trx_hash_pins
-    @param[out]    ids        array to store registered transaction identifiers
+    @param[out]    ids        sorted array to store registered transaction
+                              identifiers
     @param[out]    max_trx_id variable to store m_max_trx_id value
     @param[out]    mix_trx_no variable to store min(trx->no) value
+    @return whether the shared snapshot was reused
   */
 
-  void snapshot_ids(trx_t *caller_trx, trx_ids_t *ids, trx_id_t *max_trx_id,
+  bool snapshot_ids(trx_t *caller_trx, trx_ids_t *ids, trx_id_t *max_trx_id,
                     trx_id_t *min_trx_no)
   {
     ut_ad(!mutex_own(&mutex));
@@ -974,15 +1014,51 @@ class trx_sys_t
     while ((arg.m_id= get_rw_trx_hash_version()) != get_max_trx_id())
       ut_delay(1);
     arg.m_no= arg.m_id;
+    *max_trx_id= arg.m_id;
+
+    const int64 erase_version= get_rw_trx_hash_erase_version();
+
+    rw_lock_s_lock(&m_snapshot.latch);
+    if (m_snapshot.max_trx_id == arg.m_id &&
+        m_snapshot.erase_version == erase_version)
+    {
+      ids->assign(m_snapshot.ids.begin(), m_snapshot.ids.end());
+      *min_trx_no= m_snapshot.min_trx_no;
+      rw_lock_s_unlock(&m_snapshot.latch);
+      return true;
+    }
+    rw_lock_s_unlock(&m_snapshot.latch);
 
     ids->clear();
     ids->reserve(rw_trx_hash.size() + 32);
     rw_trx_hash.iterate(caller_trx,
                         reinterpret_cast<my_hash_walk_action>(copy_one_id),
                         &arg);
+    std::sort(ids->begin(), ids->end());
 
-    *max_trx_id= arg.m_id;
     *min_trx_no= arg.m_no;
+
+    /*
+      Publish the snapshot only if rw_trx_hash did not change while we were
+      iterating it, so that it reflects exactly the state identified by
+      (arg.m_id, erase_version). Do not wait if another thread is publishing.
+    */
+    if (get_max_trx_id() == arg.m_id &&
+        get_rw_trx_hash_erase_version() == erase_version &&
+        rw_lock_x_lock_nowait(&m_snapshot.latch))
+    {
+      if (m_snapshot.max_trx_id < arg.m_id ||
+          (m_snapshot.max_trx_id == arg.m_id &&
+           m_snapshot.erase_version < erase_version))
+      {
+        m_snapshot.ids.assign(ids->begin(), ids->end());
+        m_snapshot.max_trx_id= arg.m_id;
+        m_snapshot.erase_version= erase_version;
+        m_snapshot.min_trx_no= arg.m_no;
+      }
+      rw_lock_x_unlock(&m_snapshot.latch);
+    }
+    return false;
   }
 
 
@@ -1044,6 +1120,8 @@ class trx_sys_t
   void deregister_rw(trx_t *trx)
   {
     rw_trx_hash.erase(trx);
+    my_atomic_add64_explicit(&m_rw_trx_hash_erase_version, 1,
+                             MY_MEMORY_ORDER_RELEASE);
   }
 
 
@@ -1177,6 +1255,14 @@ class trx_sys_t
   }
 
 
+  /** Getter for m_rw_trx_hash_erase_version, must issue ACQUIRE barrier. */
+  int64 get_rw_trx_hash_erase_version()
+  {
+    return my_atomic_load64_explicit(&m_rw_trx_hash_erase_version,
+                                     MY_MEMORY_ORDER_ACQUIRE);
+  }
+
+
   /** Increments m_rw_trx_hash_version, must issue RELEASE memory barrier. */
   void refresh_rw_trx_hash_version()
   {
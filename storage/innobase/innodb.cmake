@@ -65,6 +65,16 @@ IF(UNIX)
     IF(HAVE_LIBAIO_H AND HAVE_LIBAIO)
       ADD_DEFINITIONS(-DLINUX_NATIVE_AIO=1)
       LINK_LIBRARIES(aio)
+
+      # io_uring is an alternative to libaio (innodb_use_io_uring),
+      # which remains the fallback.
+      CHECK_INCLUDE_FILES (liburing.h HAVE_LIBURING_H)
+      CHECK_LIBRARY_EXISTS(uring io_uring_queue_init "" HAVE_LIBURING)
+
+      IF(HAVE_LIBURING_H AND HAVE_LIBURING)
+        ADD_DEFINITIONS(-DLINUX_NATIVE_URING=1)
+        LINK_LIBRARIES(uring)
+      ENDIF()
     ENDIF()
     IF(HAVE_LIBNUMA)
       LINK_LIBRARIES(numa)
@@ -45,8 +45,10 @@ Created 5/7/1996 Heikki Tuuri
 #include "row0sel.h"
 #include "row0mysql.h"
 #include "pars0pars.h"
+#include "sync0sync.h"
 
 #include <set>
+#include <algorithm>
 
 #ifdef WITH_WSREP
 #include <mysql/service_wsrep.h>
@@ -58,6 +60,9 @@ ulong innodb_lock_schedule_algorithm;
 /** The value of innodb_deadlock_detect */
 my_bool	innobase_deadlock_detect;
 
+/** The value of innodb_deadlock_detect_async */
+my_bool	innobase_deadlock_detect_async;
+
 /** Total number of cached record locks */
 static const ulint	REC_LOCK_CACHE = 8;
 
@@ -81,7 +86,7 @@ lock_rec_has_to_wait_in_queue(
 
 /*************************************************************//**
 Grants a lock to a waiting lock request and releases the waiting transaction.
-The caller must hold lock_sys.mutex. */
+The caller must hold lock_sys.latch. */
 static
 void
 lock_grant(
@@ -128,7 +133,70 @@ class DeadlockChecker {
 		const lock_t*	lock,
 		trx_t*		trx);
 
+	/** Look for deadlocks among the transactions that are suspended
+	in lock waits, and resolve each deadlock found by rolling back a
+	victim transaction. The waits-for graph is copied while holding
+	lock_sys.latch, and searched without holding any latch. Each cycle
+	that is found is validated again under lock_sys.latch before a
+	victim is chosen. Used when innodb_deadlock_detect_async is set. */
+	static void check_and_resolve_async();
+
 private:
+	/** A transaction in the snapshot of the waits-for graph */
+	struct wait_node_t {
+		/** transaction suspended in a lock wait */
+		trx_t*		m_trx;
+		/** the lock that m_trx is waiting for */
+		const lock_t*	m_wait_lock;
+		/** index of the first outgoing edge */
+		ulint		m_first_edge;
+		/** number of outgoing edges */
+		ulint		m_n_edges;
+
+		bool operator<(const wait_node_t& other) const
+		{
+			return(m_trx < other.m_trx);
+		}
+	};
+
+	typedef std::vector<wait_node_t, ut_allocator<wait_node_t> >
+		wait_nodes_t;
+	typedef std::vector<const trx_t*, ut_allocator<const trx_t*> >
+		wait_edges_t;
+	typedef std::vector<ulint, ut_allocator<ulint> > wait_cycle_t;
+
+	/** Invoke a functor on each transaction that holds or waits for
+	a lock that a waiting lock has to wait for.
+	@param wait_lock waiting lock
+	@param f functor invoked on the conflicting locks */
+	template <typename F>
+	static void for_each_blocking(const lock_t* wait_lock, F& f);
+
+	/** Copy the waits-for graph of the suspended transactions.
+	@param[out] nodes the waiting transactions, sorted by m_trx
+	@param[out] edges transactions that the nodes are waiting for */
+	static void snapshot(wait_nodes_t& nodes, wait_edges_t& edges);
+
+	/** Search the snapshot of the waits-for graph for cycles.
+	@param nodes waiting transactions
+	@param edges transactions that the nodes are waiting for
+	@param[out] cycles the nodes of each cycle found, each cycle
+	terminated by ULINT_UNDEFINED */
+	static void find_cycles(
+		const wait_nodes_t&	nodes,
+		const wait_edges_t&	edges,
+		wait_cycle_t&		cycles);
+
+	/** Check that a cycle in the snapshot still exists, and if it
+	does, roll back a victim transaction.
+	@param nodes waiting transactions
+	@param cycle the first node of the cycle
+	@param end the end of the cycle */
+	static void resolve(
+		const wait_nodes_t&		nodes,
+		wait_cycle_t::const_iterator	cycle,
+		wait_cycle_t::const_iterator	end);
+
 	/** Do a shallow copy. Default destructor OK.
 	@param trx the start transaction (start node)
 	@param wait_lock lock that a transaction wants
@@ -279,7 +347,7 @@ class DeadlockChecker {
 		ulint		m_heap_no;	/*!< heap number if rec lock */
 	};
 
-	/** Used in deadlock tracking. Protected by lock_sys.mutex. */
+	/** Used in deadlock tracking. Protected by lock_sys.latch. */
 	static ib_uint64_t	s_lock_mark_counter;
 
 	/** Calculation steps thus far. It is the count of the nodes visited. */
@@ -485,11 +553,16 @@ void lock_sys_t::create(ulint n_cells)
 		(ut_zalloc_nokey(srv_max_n_threads * sizeof *waiting_threads));
 	last_slot = waiting_threads;
 
-	mutex_create(LATCH_ID_LOCK_SYS, &mutex);
+	rw_lock_create(lock_sys_latch_key, &latch, SYNC_LOCK_SYS);
+
+	for (ulint i = 0; i < LOCK_SYS_REC_SHARDS; i++) {
+		mutex_create(LATCH_ID_LOCK_SYS_REC_HASH, &rec_shards[i].mutex);
+	}
 
 	mutex_create(LATCH_ID_LOCK_SYS_WAIT, &wait_mutex);
 
 	timeout_event = os_event_create(0);
+	deadlock_event = os_event_create(0);
 
 	rec_hash = hash_create(n_cells);
 	prdt_hash = hash_create(n_cells);
@@ -523,7 +596,7 @@ void lock_sys_t::resize(ulint n_cells)
 {
 	ut_ad(this == &lock_sys);
 
-	mutex_enter(&mutex);
+	lock_mutex_enter();
 
 	hash_table_t* old_hash = rec_hash;
 	rec_hash = hash_create(n_cells);
@@ -568,7 +641,7 @@ void lock_sys_t::resize(ulint n_cells)
 		buf_pool_mutex_exit(buf_pool);
 	}
 
-	mutex_exit(&mutex);
+	lock_mutex_exit();
 }
 
 
@@ -589,8 +662,14 @@ void lock_sys_t::close()
 	hash_table_free(prdt_page_hash);
 
 	os_event_destroy(timeout_event);
+	os_event_destroy(deadlock_event);
+
+	rw_lock_free(&latch);
+
+	for (ulint i = 0; i < LOCK_SYS_REC_SHARDS; i++) {
+		mutex_destroy(&rec_shards[i].mutex);
+	}
 
-	mutex_destroy(&mutex);
 	mutex_destroy(&wait_mutex);
 
 	for (ulint i = srv_max_n_threads; i--; ) {
@@ -603,6 +682,57 @@ void lock_sys_t::close()
 	m_initialised= false;
 }
 
+
+/**
+  Acquire latch in shared mode and the rec_shards[] mutex of a page.
+
+  @param[in] block buffer block of the page
+  @return the rec_shards[] index to pass to rec_shard_exit()
+*/
+ulint lock_sys_t::rec_shard_enter(const buf_block_t* block)
+{
+	ut_ad(this == &lock_sys);
+
+	rw_lock_s_lock(&latch);
+
+	/* block->lock_hash_val can only change in resize(),
+	while holding latch in exclusive mode. */
+	ulint	shard = buf_block_get_lock_hash_val(block)
+		% LOCK_SYS_REC_SHARDS;
+
+	mutex_enter(&rec_shards[shard].mutex);
+
+	return(shard);
+}
+
+
+/**
+  Release the rec_shards[] mutex and latch.
+
+  @param[in] shard return value of rec_shard_enter()
+*/
+void lock_sys_t::rec_shard_exit(ulint shard)
+{
+	ut_ad(this == &lock_sys);
+
+	mutex_exit(&rec_shards[shard].mutex);
+	rw_lock_s_unlock(&latch);
+}
+
+#ifdef UNIV_DEBUG
+/**
+  Test if the thread holds latch in shared mode and a rec_shards[] mutex.
+
+  @param[in] cell rec_hash cell index
+  @return whether the lock queues in the rec_hash cell are protected
+*/
+bool lock_sys_t::rec_shard_own(ulint cell)
+{
+	return(rw_lock_own(&latch, RW_LOCK_S)
+	       && rec_shards[cell % LOCK_SYS_REC_SHARDS].mutex.is_owned());
+}
+#endif /* UNIV_DEBUG */
+
 /*********************************************************************//**
 Gets the size of a lock struct.
 @return size in bytes */
@@ -1386,7 +1516,7 @@ lock_sec_rec_some_has_impl(
 Return approximate number or record locks (bits set in the bitmap) for
 this transaction. Since delete-marked records may be removed, the
 record count will not be precise.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding lock_sys.latch. */
 ulint
 lock_number_of_rows_locked(
 /*=======================*/
@@ -1399,7 +1529,7 @@ lock_number_of_rows_locked(
 
 /*********************************************************************//**
 Return the number of table locks for a transaction.
-The caller must be holding lock_sys.mutex. */
+The caller must be holding lock_sys.latch. */
 ulint
 lock_number_of_tables_locked(
 /*=========================*/
@@ -1518,7 +1648,7 @@ RecLock::lock_alloc(
 	const RecID&	rec_id,
 	ulint		size)
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(rec_id.m_space_id, rec_id.m_page_no));
 
 	lock_t*	lock;
 
@@ -1568,9 +1698,9 @@ RecLock::lock_alloc(
 
 	lock_rec_set_nth_bit(lock, rec_id.m_heap_no);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
 
 	return(lock);
 }
@@ -1733,7 +1863,7 @@ Add the lock to the record lock hash and the transaction's lock list
 void
 RecLock::lock_add(lock_t* lock, bool add_to_hash) const
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(m_rec_id.m_space_id, m_rec_id.m_page_no));
 	ut_ad(trx_mutex_own(lock->trx));
 
 	bool wait_lock = m_mode & LOCK_WAIT;
@@ -1742,7 +1872,9 @@ RecLock::lock_add(lock_t* lock, bool add_to_hash) const
 		ulint	key = m_rec_id.fold();
 		hash_table_t *lock_hash = lock_hash_get(m_mode);
 
-		++lock->index->table->n_rec_locks;
+		/* Record locks on other pages of the table may be
+		created concurrently, see lock_sys_t::rec_shard_enter(). */
+		my_atomic_addlint(&lock->index->table->n_rec_locks, 1);
 
 		if (innodb_lock_schedule_algorithm == INNODB_LOCK_SCHEDULE_ALGORITHM_VATS
 			&& !thd_is_replication_slave_thread(lock->trx->mysql_thd)) {
@@ -1785,7 +1917,7 @@ RecLock::create(
 #endif /* WITH_WSREP */
 ) const
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_queue_own(m_rec_id.m_space_id, m_rec_id.m_page_no));
 	ut_ad(owns_trx_mutex == trx_mutex_own(trx));
 
 	/* Create the explicit lock instance and initialise it. */
@@ -2280,13 +2412,35 @@ lock_rec_lock(
   ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
   DBUG_EXECUTE_IF("innodb_report_deadlock", return DB_DEADLOCK;);
 
-  lock_mutex_enter();
   ut_ad((LOCK_MODE_MASK & mode) != LOCK_S ||
         lock_table_has(trx, index->table, LOCK_IS));
   ut_ad((LOCK_MODE_MASK & mode) != LOCK_X ||
          lock_table_has(trx, index->table, LOCK_IX));
 
-  if (lock_t *lock= lock_rec_get_first_on_page(lock_sys.rec_hash, block))
+  /*
+    Look at the lock queue of the page while holding only a shard of
+    lock_sys, so that requests on different pages do not conflict.
+    If there are no locks on the page, or the only lock is a similar
+    one of this transaction, the request is granted without looking
+    at anything else. Otherwise, we may have to wait and check for
+    deadlocks, and we retry holding lock_sys.latch in exclusive mode.
+  */
+  ulint shard= lock_sys.rec_shard_enter(block);
+  lock_t *lock= lock_rec_get_first_on_page(lock_sys.rec_hash, block);
+
+  if (lock &&
+      (lock_rec_get_next_on_page(lock) ||
+       lock->trx != trx ||
+       lock->type_mode != (mode | LOCK_REC) ||
+       lock_rec_get_n_bits(lock) <= heap_no))
+  {
+    lock_sys.rec_shard_exit(shard);
+    shard= ULINT_UNDEFINED;
+    lock_mutex_enter();
+    lock= lock_rec_get_first_on_page(lock_sys.rec_hash, block);
+  }
+
+  if (lock)
   {
     trx_mutex_enter(trx);
     if (lock_rec_get_next_on_page(lock) ||
@@ -2342,7 +2496,14 @@ lock_rec_lock(
       RecLock(index, block, heap_no, mode).create(trx, false, true);
     err= DB_SUCCESS_LOCKED_REC;
   }
-  lock_mutex_exit();
+  if (shard == ULINT_UNDEFINED)
+    lock_mutex_exit();
+  else
+  {
+    /* Each shard has its own slot, protected by the shard mutex. */
+    srv_stats.n_lock_rec_shard_grants.inc(shard);
+    lock_sys.rec_shard_exit(shard);
+  }
   MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
   return err;
 }
@@ -2411,7 +2572,7 @@ lock_rec_has_to_wait_in_queue(
 
 /*************************************************************//**
 Grants a lock to a waiting lock request and releases the waiting transaction.
-The caller must hold lock_sys.mutex but not lock->trx->mutex. */
+The caller must hold lock_sys.latch but not lock->trx->mutex. */
 static
 void
 lock_grant(
@@ -5292,6 +5453,8 @@ lock_print_info_summary(
 	fprintf(file,
 		"History list length " ULINTPF "\n", trx_sys.history_size());
 
+	trx_purge_print_stats(file);
+
 #ifdef PRINT_NUM_OF_LOCK_STRUCTS
 	fprintf(file,
 		"Total number of lock structs in row lock hash table %lu\n",
@@ -5516,7 +5679,7 @@ lock_table_queue_validate(
 		/* lock->trx->state cannot change from or to NOT_STARTED
 		while we are holding the trx_sys.mutex. It may change
 		from ACTIVE to PREPARED, but it may not change to
-		COMMITTED, because we are holding the lock_sys.mutex. */
+		COMMITTED, because we are holding the lock_sys.latch. */
 		ut_ad(trx_assert_started(lock->trx));
 
 		if (!lock_get_wait(lock)) {
@@ -5604,7 +5767,7 @@ lock_rec_queue_validate(
 
 		ut_ad(lock_mutex_own());
 		/* impl_trx cannot be committed until lock_mutex_exit()
-		because lock_trx_release_locks() acquires lock_sys.mutex */
+		because lock_trx_release_locks() acquires lock_sys.latch */
 
 		if (impl_trx != NULL) {
 			const lock_t*	other_lock
@@ -6949,11 +7112,11 @@ lock_trx_release_locks(
 
 	bool release_lock = UT_LIST_GET_LEN(trx->lock.trx_locks) > 0;
 
-	/* Don't take lock_sys.mutex if trx didn't acquire any lock. */
+	/* Don't take lock_sys.latch if trx didn't acquire any lock. */
 	if (release_lock) {
 
 		/* The transition of trx->state to TRX_STATE_COMMITTED_IN_MEMORY
-		is protected by both the lock_sys.mutex and the trx->mutex. */
+		is protected by both the lock_sys.latch and the trx->mutex. */
 		lock_mutex_enter();
 	}
 
@@ -7718,6 +7881,356 @@ DeadlockChecker::trx_rollback()
 	trx_mutex_exit(trx);
 }
 
+/** Functor that collects the transactions that a waiting lock is
+blocked by. */
+struct lock_blocking_collect_t {
+	/** Constructor
+	@param edges where to append the transactions */
+	lock_blocking_collect_t(std::vector<const trx_t*,
+					ut_allocator<const trx_t*> >& edges)
+		: m_edges(edges) {}
+
+	void operator()(const lock_t* lock)
+	{
+		m_edges.push_back(lock->trx);
+	}
+
+	/** Transactions that the lock is waiting for */
+	std::vector<const trx_t*, ut_allocator<const trx_t*> >&	m_edges;
+};
+
+/** Functor that checks whether a waiting lock is blocked by a lock of
+a given transaction. */
+struct lock_blocking_find_t {
+	/** Constructor
+	@param trx transaction to look for */
+	explicit lock_blocking_find_t(const trx_t* trx)
+		: m_trx(trx), m_found(false) {}
+
+	void operator()(const lock_t* lock)
+	{
+		m_found |= lock->trx == m_trx;
+	}
+
+	/** Transaction to look for */
+	const trx_t*	m_trx;
+	/** Whether a lock of m_trx was found */
+	bool		m_found;
+};
+
+/** Invoke a functor on each transaction that holds or waits for a lock
+that a waiting lock has to wait for.
+@param wait_lock waiting lock
+@param f functor invoked on the conflicting locks */
+template <typename F>
+void
+DeadlockChecker::for_each_blocking(const lock_t* wait_lock, F& f)
+{
+	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_wait(wait_lock));
+
+	if (lock_get_type_low(wait_lock) == LOCK_REC) {
+		hash_table_t*	lock_hash = wait_lock->type_mode
+			& LOCK_PREDICATE
+			? lock_sys.prdt_hash
+			: lock_sys.rec_hash;
+		ulint		heap_no = lock_rec_find_set_bit(wait_lock);
+
+		for (const lock_t* lock = lock_rec_get_first_on_page_addr(
+			     lock_hash,
+			     wait_lock->un_member.rec_lock.space,
+			     wait_lock->un_member.rec_lock.page_no);
+		     lock != NULL;
+		     lock = lock_rec_get_next_on_page_const(lock)) {
+
+			if (lock != wait_lock
+			    && lock_rec_get_nth_bit(lock, heap_no)
+			    && lock_has_to_wait(wait_lock, lock)) {
+				f(lock);
+			}
+		}
+	} else {
+		ut_ad(lock_get_type_low(wait_lock) == LOCK_TABLE);
+
+		for (const lock_t* lock = UT_LIST_GET_FIRST(
+			     wait_lock->un_member.tab_lock.table->locks);
+		     lock != NULL;
+		     lock = UT_LIST_GET_NEXT(un_member.tab_lock.locks, lock)) {
+
+			if (lock != wait_lock
+			    && lock_has_to_wait(wait_lock, lock)) {
+				f(lock);
+			}
+		}
+	}
+}
+
+/** Copy the waits-for graph of the suspended transactions.
+@param[out] nodes the waiting transactions, sorted by m_trx
+@param[out] edges transactions that the nodes are waiting for */
+void
+DeadlockChecker::snapshot(wait_nodes_t& nodes, wait_edges_t& edges)
+{
+	lock_blocking_collect_t	collect(edges);
+
+	lock_wait_mutex_enter();
+	lock_mutex_enter();
+
+	for (const srv_slot_t* slot = lock_sys.waiting_threads;
+	     slot < lock_sys.last_slot;
+	     ++slot) {
+
+		if (!slot->in_use) {
+			continue;
+		}
+
+		trx_t*		trx = thr_get_trx(slot->thr);
+		const lock_t*	wait_lock = trx->lock.wait_lock;
+
+		if (wait_lock == NULL) {
+			continue;
+		}
+
+		wait_node_t	node;
+
+		node.m_trx = trx;
+		node.m_wait_lock = wait_lock;
+		node.m_first_edge = edges.size();
+
+		for_each_blocking(wait_lock, collect);
+
+		node.m_n_edges = edges.size() - node.m_first_edge;
+
+		nodes.push_back(node);
+	}
+
+	lock_mutex_exit();
+	lock_wait_mutex_exit();
+
+	std::sort(nodes.begin(), nodes.end());
+}
+
+/** Search the snapshot of the waits-for graph for cycles.
+@param nodes waiting transactions
+@param edges transactions that the nodes are waiting for
+@param[out] cycles the nodes of each cycle found, each cycle
+terminated by ULINT_UNDEFINED */
+void
+DeadlockChecker::find_cycles(
+	const wait_nodes_t&	nodes,
+	const wait_edges_t&	edges,
+	wait_cycle_t&		cycles)
+{
+	enum { WHITE, GREY, BLACK };
+
+	const ulint	n_nodes = nodes.size();
+	/* Colour of each node in the depth-first search */
+	std::vector<byte, ut_allocator<byte> >	colour(n_nodes, WHITE);
+	/* Nodes on the current path, and the next edge of each */
+	std::vector<std::pair<ulint, ulint>,
+		    ut_allocator<std::pair<ulint, ulint> > >	path;
+
+	for (ulint start = 0; start < n_nodes; ++start) {
+
+		if (colour[start] != WHITE) {
+			continue;
+		}
+
+		colour[start] = GREY;
+		path.push_back(std::make_pair(start, ulint(0)));
+
+		while (!path.empty()) {
+			const ulint	i = path.back().first;
+			const ulint	e = path.back().second++;
+
+			if (e == nodes[i].m_n_edges) {
+				colour[i] = BLACK;
+				path.pop_back();
+				continue;
+			}
+
+			/* Only the transactions that are waiting can
+			be part of a cycle. */
+			wait_node_t	key;
+
+			key.m_trx = const_cast<trx_t*>(
+				edges[nodes[i].m_first_edge + e]);
+
+			wait_nodes_t::const_iterator	it = std::lower_bound(
+				nodes.begin(), nodes.end(), key);
+
+			if (it == nodes.end() || it->m_trx != key.m_trx) {
+				continue;
+			}
+
+			const ulint	j = ulint(it - nodes.begin());
+
+			switch (colour[j]) {
+			case WHITE:
+				colour[j] = GREY;
+				path.push_back(std::make_pair(j, ulint(0)));
+				break;
+			case GREY:
+				/* Found a cycle: the nodes on the path
+				from j to i. */
+				for (ulint k = path.size(); k--; ) {
+					if (path[k].first == j) {
+						for (; k < path.size(); k++) {
+							cycles.push_back(
+								path[k].first);
+						}
+						break;
+					}
+				}
+
+				cycles.push_back(ULINT_UNDEFINED);
+				break;
+			}
+		}
+	}
+}
+
+/** Check that a cycle in the snapshot still exists, and if it does,
+roll back a victim transaction.
+@param nodes waiting transactions
+@param cycle the first node of the cycle
+@param end the end of the cycle */
+void
+DeadlockChecker::resolve(
+	const wait_nodes_t&		nodes,
+	wait_cycle_t::const_iterator	cycle,
+	wait_cycle_t::const_iterator	end)
+{
+	ut_ad(cycle != end);
+
+	lock_mutex_enter();
+
+	/* The transactions may have been granted their locks or rolled
+	back meanwhile. The deadlock is still there if each transaction
+	is still waiting for the same lock, blocked by a lock of the next
+	transaction in the cycle. */
+	for (wait_cycle_t::const_iterator i = cycle; i != end; ++i) {
+		const wait_node_t&	node = nodes[*i];
+		const wait_node_t&	next = nodes[
+			i + 1 == end ? *cycle : *(i + 1)];
+
+		if (node.m_trx->lock.wait_lock != node.m_wait_lock) {
+			lock_mutex_exit();
+			return;
+		}
+
+		lock_blocking_find_t	find(next.m_trx);
+
+		for_each_blocking(node.m_wait_lock, find);
+
+		if (!find.m_found) {
+			lock_mutex_exit();
+			return;
+		}
+	}
+
+	/* Prefer not to roll back a high priority transaction. Among
+	the others, choose the transaction that has modified or locked
+	the fewest rows. */
+	trx_t*	victim = nodes[*cycle].m_trx;
+
+	for (wait_cycle_t::const_iterator i = cycle + 1; i != end; ++i) {
+		trx_t*	trx = nodes[*i].m_trx;
+
+		if (trx_is_high_priority(trx) != trx_is_high_priority(victim)
+		    ? trx_is_high_priority(victim)
+		    : !trx_weight_ge(trx, victim)) {
+			victim = trx;
+		}
+	}
+
+	start_print();
+
+	ulint	n = 0;
+	ulint	victim_n = 0;
+
+	for (wait_cycle_t::const_iterator i = cycle; i != end; ++i) {
+		const wait_node_t&	node = nodes[*i];
+		char			buf[80];
+
+		if (node.m_trx == victim) {
+			victim_n = n + 1;
+		}
+
+		snprintf(buf, sizeof buf, "\n*** (" ULINTPF ") TRANSACTION:\n",
+			 ++n);
+		print(buf);
+		print(node.m_trx, 3000);
+
+		snprintf(buf, sizeof buf, "*** (" ULINTPF ") WAITING FOR"
+			 " THIS LOCK TO BE GRANTED:\n", n);
+		print(buf);
+		print(node.m_wait_lock);
+	}
+
+	char	buf[80];
+
+	snprintf(buf, sizeof buf,
+		 "*** WE ROLL BACK TRANSACTION (" ULINTPF ")\n", victim_n);
+	print(buf);
+
+	trx_mutex_enter(victim);
+
+	victim->lock.was_chosen_as_deadlock_victim = true;
+
+	lock_cancel_waiting_and_release(victim->lock.wait_lock);
+
+	trx_mutex_exit(victim);
+
+	lock_deadlock_found = true;
+
+	MONITOR_INC(MONITOR_DEADLOCK);
+
+	lock_mutex_exit();
+}
+
+/** Look for deadlocks among the transactions that are suspended in lock
+waits, and resolve each deadlock found by rolling back a victim
+transaction. The waits-for graph is copied while holding lock_sys.latch,
+and searched without holding any latch. Each cycle that is found is
+validated again under lock_sys.latch before a victim is chosen. Used when
+innodb_deadlock_detect_async is set. */
+void
+DeadlockChecker::check_and_resolve_async()
+{
+	ut_ad(!lock_mutex_own());
+	ut_ad(!srv_read_only_mode);
+
+	wait_nodes_t	nodes;
+	wait_edges_t	edges;
+	wait_cycle_t	cycles;
+
+	snapshot(nodes, edges);
+
+	if (nodes.size() < 2) {
+		return;
+	}
+
+	find_cycles(nodes, edges, cycles);
+
+	wait_cycle_t::const_iterator	cycle = cycles.begin();
+
+	for (wait_cycle_t::const_iterator i = cycle; i != cycles.end(); ++i) {
+		if (*i == ULINT_UNDEFINED) {
+			resolve(nodes, cycle, i);
+			cycle = i + 1;
+		}
+	}
+}
+
+/** Look for deadlocks among the transactions that are suspended in lock
+waits, and roll back a victim of each deadlock. */
+void
+lock_deadlock_check_async()
+{
+	DeadlockChecker::check_and_resolve_async();
+}
+
 /** Checks if a joining lock request results in a deadlock. If a deadlock is
 found this function will resolve the deadlock by choosing a victim transaction
 and rolling it back. It will attempt to resolve all deadlocks. The returned
@@ -7741,7 +8254,10 @@ DeadlockChecker::check_and_resolve(const lock_t* lock, trx_t* trx)
 	We return current transaction as deadlock victim here. */
 	if (trx->in_innodb & TRX_FORCE_ROLLBACK_ASYNC) {
 		return(trx);
-	} else if (!innobase_deadlock_detect) {
+	} else if (!innobase_deadlock_detect
+		   || innobase_deadlock_detect_async) {
+		/* With innodb_deadlock_detect_async, lock_deadlock_thread
+		will look for deadlocks once we are suspended. */
 		return(NULL);
 	}
 
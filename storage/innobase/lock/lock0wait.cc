@@ -184,7 +184,7 @@ lock_wait_table_reserve_slot(
 check if lock timeout was for priority thread,
 as a side effect trigger lock monitor
 @param[in]    trx    transaction owning the lock
-@param[in]    locked true if trx and lock_sys.mutex is ownd
+@param[in]    locked true if trx and lock_sys.latch is ownd
 @return	false for regular lock timeout */
 static
 bool
@@ -283,6 +283,11 @@ lock_wait_suspend_thread(
 	lock_wait_mutex_exit();
 	trx_mutex_exit(trx);
 
+	if (innobase_deadlock_detect_async && !srv_read_only_mode) {
+		/* Let lock_deadlock_thread look for a deadlock. */
+		os_event_set(lock_sys.deadlock_event);
+	}
+
 	if (thr->lock_state == QUE_THR_LOCK_ROW) {
 		srv_stats.n_lock_wait_count.inc();
 		srv_stats.n_lock_wait_current_count.inc();
@@ -586,3 +591,48 @@ DECLARE_THREAD(lock_wait_timeout_thread)(void*)
 	OS_THREAD_DUMMY_RETURN;
 }
 
+/** A thread which looks for deadlocks among the transactions that are
+suspended in lock waits, when innodb_deadlock_detect_async is set.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(lock_deadlock_thread)(void*)
+{
+	int64_t		sig_count = 0;
+	os_event_t	event = lock_sys.deadlock_event;
+
+	ut_ad(!srv_read_only_mode);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(srv_lock_deadlock_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	do {
+		/* Wake up when a transaction is suspended in a lock wait,
+		or every second in case a deadlock was formed by a lock
+		wait that we had not yet examined. */
+
+		os_event_wait_time_low(event, 1000000, sig_count);
+		sig_count = os_event_reset(event);
+
+		if (srv_shutdown_state >= SRV_SHUTDOWN_CLEANUP) {
+			break;
+		}
+
+		if (innobase_deadlock_detect
+		    && innobase_deadlock_detect_async) {
+			lock_deadlock_check_async();
+		}
+
+	} while (srv_shutdown_state < SRV_SHUTDOWN_CLEANUP);
+
+	lock_sys.deadlock_thread_active = false;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
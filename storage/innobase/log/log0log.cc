@@ -162,6 +162,25 @@ log_buf_pool_get_oldest_modification(void)
 	return(lsn);
 }
 
+/** Wait until the records of all log_reserve_low() areas have been
+copied to the log buffer. No new areas can be reserved meanwhile,
+because the caller holds log_sys->mutex. */
+static
+void
+log_wait_for_pending_copies()
+{
+	ut_ad(log_mutex_own());
+
+	for (ulint i = 0; my_atomic_loadlint(&log_sys->n_pending_copies);
+	     i++) {
+		if (i < srv_n_spin_wait_rounds) {
+			ut_delay(srv_spin_wait_delay);
+		} else {
+			os_thread_yield();
+		}
+	}
+}
+
 /** Extends the log buffer.
 @param[in]	len	requested minimum size in bytes */
 void
@@ -214,6 +233,8 @@ log_buffer_extend(
 		log_mutex_enter_all();
 	}
 
+	log_wait_for_pending_copies();
+
 	move_start = ut_calc_align_down(
 		log_sys->buf_free,
 		OS_FILE_LOG_BLOCK_SIZE);
@@ -401,16 +422,17 @@ log_reserve_and_open(
 	return(log_sys->lsn);
 }
 
-/************************************************************//**
-Writes to the log the string given. It is assumed that the caller holds the
-log mutex. */
-void
-log_write_low(
-/*==========*/
-	const byte*	str,		/*!< in: string */
-	ulint		str_len)	/*!< in: string length */
+/** Advance log_sys->buf_free and log_sys->lsn over a string that is
+to be appended to the log, and initialize the affected log block headers.
+@param[in]	str_len	length of the string, in bytes
+@return the position of the string in log_sys->buf */
+static
+byte*
+log_advance_low(
+	ulint	str_len)
 {
 	log_t*	log	= log_sys;
+	byte*	start	= log->buf + log->buf_free;
 	ulint	len;
 	ulint	data_len;
 	byte*	log_block;
@@ -434,10 +456,7 @@ log_write_low(
 			- LOG_BLOCK_TRL_SIZE;
 	}
 
-	ut_memcpy(log->buf + log->buf_free, str, len);
-
 	str_len -= len;
-	str = str + len;
 
 	log_block = static_cast<byte*>(
 		ut_align_down(
@@ -469,6 +488,81 @@ log_write_low(
 	}
 
 	srv_stats.log_write_requests.inc();
+
+	return(start);
+}
+
+/** Reserve space for a redo log record group in the log buffer and
+advance the log block headers and log_sys->lsn as if the records were
+written by log_write_low(). The caller must hold log_sys->mutex, and
+must copy the records with log_write_reserved() after releasing it.
+@param[in]	len	length of the records, in bytes
+@return start of the reserved area in log_sys->buf */
+byte*
+log_reserve_low(
+	ulint	len)
+{
+	ut_ad(log_mutex_own());
+	ut_ad(len > 0);
+
+	/* This is being incremented while holding log_sys->mutex,
+	so that log_wait_for_pending_copies() will not miss it. */
+	my_atomic_addlint(&log_sys->n_pending_copies, 1);
+
+	return(log_advance_low(len));
+}
+
+/** Copy part of a redo log record group to the area that was reserved
+with log_reserve_low(), skipping the log block headers and trailers.
+@param[in]	ptr	current position in the reserved area
+@param[in]	str	log records
+@param[in]	str_len	length of str, in bytes
+@return the position following the copied records */
+byte*
+log_write_reserved(
+	byte*		ptr,
+	const byte*	str,
+	ulint		str_len)
+{
+	while (str_len > 0) {
+		ulint	offset	= ut_align_offset(ptr, OS_FILE_LOG_BLOCK_SIZE);
+		ulint	len	= OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE
+			- offset;
+
+		ut_ad(offset >= LOG_BLOCK_HDR_SIZE);
+		ut_ad(offset < OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE);
+
+		if (len > str_len) {
+			len = str_len;
+		}
+
+		ut_memcpy(ptr, str, len);
+
+		ptr += len;
+		str += len;
+		str_len -= len;
+
+		if (offset + len
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* This block became full; skip the trailer
+			and the header of the next block. */
+			ptr += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+		}
+	}
+
+	return(ptr);
+}
+
+/************************************************************//**
+Writes to the log the string given. It is assumed that the caller holds the
+log mutex. */
+void
+log_write_low(
+/*==========*/
+	const byte*	str,		/*!< in: string */
+	ulint		str_len)	/*!< in: string length */
+{
+	log_write_reserved(log_advance_low(str_len), str, str_len);
 }
 
 /************************************************************//**
@@ -1214,6 +1308,10 @@ log_write_up_to(
 		}
 	}
 
+	/* Let the concurrent mtr_commit() complete the copying of
+	their records to the area that is about to be written. */
+	log_wait_for_pending_copies();
+
 	start_offset = log_sys->buf_next_to_write;
 	end_offset = log_sys->buf_free;
 
@@ -1893,6 +1991,9 @@ logs_empty_and_mark_files_at_shutdown(void)
 		if (lock_sys.timeout_thread_active) {
 			os_event_set(lock_sys.timeout_event);
 		}
+		if (lock_sys.deadlock_thread_active) {
+			os_event_set(lock_sys.deadlock_event);
+		}
 		if (dict_stats_event) {
 			os_event_set(dict_stats_event);
 		} else {
@@ -1942,6 +2043,8 @@ logs_empty_and_mark_files_at_shutdown(void)
 		thread_name = "dict_stats_thread";
 	} else if (lock_sys.timeout_thread_active) {
 		thread_name = "lock_wait_timeout_thread";
+	} else if (lock_sys.deadlock_thread_active) {
+		thread_name = "lock_deadlock_thread";
 	} else if (srv_buf_dump_thread_active) {
 		thread_name = "buf_dump_thread";
 		goto wait_suspend_loop;
@@ -27,6 +27,7 @@ Created 9/20/1997 Heikki Tuuri
 
 #include "ha_prototypes.h"
 
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <string>
@@ -122,6 +123,7 @@ static lsn_t	recv_max_page_lsn;
 #ifdef UNIV_PFS_THREAD
 mysql_pfs_key_t	trx_rollback_clean_thread_key;
 mysql_pfs_key_t	recv_writer_thread_key;
+mysql_pfs_key_t	recv_apply_thread_key;
 #endif /* UNIV_PFS_THREAD */
 
 /** Is recv_writer_thread active? */
@@ -1905,6 +1907,154 @@ recv_read_in_area(
 	return(n);
 }
 
+/** Pages of one partition of a recv_apply_hashed_log_recs() batch */
+typedef std::vector<recv_addr_t*, ut_allocator<recv_addr_t*> >
+	recv_addr_vector;
+
+/** Order pages by tablespace and page number, so that the read-ahead
+in recv_read_in_area() will be submitted in ascending file order. */
+struct recv_addr_cmp {
+	bool operator()(const recv_addr_t* a, const recv_addr_t* b) const
+	{
+		return a->space == b->space
+			? a->page_no < b->page_no
+			: a->space < b->space;
+	}
+};
+
+/** Apply the hashed log records to the pages of a partition.
+Pages that reside in the buffer pool are recovered by the calling
+thread; the others are read in, and the log records will be applied
+by the I/O handler threads in buf_page_io_complete().
+@param[in,out]	addrs	pages whose log records are to be applied */
+static
+void
+recv_apply_pages(recv_addr_vector& addrs)
+{
+	std::sort(addrs.begin(), addrs.end(), recv_addr_cmp());
+
+	for (recv_addr_vector::const_iterator i = addrs.begin();
+	     i != addrs.end(); ++i) {
+		recv_addr_t*	recv_addr = *i;
+
+		mutex_enter(&recv_sys->mutex);
+		const bool	abort = recv_sys->found_corrupt_log;
+		const bool	skip = recv_addr->state != RECV_NOT_PROCESSED;
+		mutex_exit(&recv_sys->mutex);
+
+		if (abort) {
+			return;
+		}
+
+		if (skip) {
+			/* The page was read in by a preceding
+			recv_read_in_area(), or it has already
+			been recovered. */
+			continue;
+		}
+
+		const page_id_t		page_id(recv_addr->space,
+						recv_addr->page_no);
+		bool			found;
+		const page_size_t&	page_size
+			= fil_space_get_page_size(recv_addr->space, &found);
+
+		ut_ad(found);
+
+		if (buf_page_peek(page_id)) {
+			mtr_t	mtr;
+			mtr.start();
+
+			buf_block_t* block = buf_page_get(
+				page_id, page_size, RW_X_LATCH, &mtr);
+
+			buf_block_dbg_add_level(block, SYNC_NO_ORDER_CHECK);
+
+			recv_recover_page(FALSE, block);
+			mtr.commit();
+		} else {
+			recv_read_in_area(page_id);
+		}
+	}
+}
+
+/** A partition of a parallel recv_apply_hashed_log_recs() batch */
+struct recv_apply_part_t {
+	/** pages whose log records are to be applied */
+	recv_addr_vector*	addrs;
+	/** number of partitions still being processed;
+	protected by recv_sys->mutex */
+	ulint*			n_running;
+	/** event to signal when n_running reaches 0 */
+	os_event_t		done;
+};
+
+/******************************************************************//**
+recv_apply thread tasked with applying the log records to the pages
+of one partition of a recovery batch.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(recv_apply_thread)(
+/*==============================*/
+	void*	arg)	/*!< in: recv_apply_part_t */
+{
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	const recv_apply_part_t* part
+		= static_cast<const recv_apply_part_t*>(arg);
+
+	recv_apply_pages(*part->addrs);
+
+	mutex_enter(&recv_sys->mutex);
+	if (!--*part->n_running) {
+		os_event_set(part->done);
+	}
+	mutex_exit(&recv_sys->mutex);
+
+	my_thread_end();
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit();
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Apply the hashed log records to the pages of all partitions of a
+batch, using one recv_apply_thread per partition.
+@param[in,out]	parts	the partitions of the batch
+@param[in]	n_parts	number of partitions */
+static
+void
+recv_apply_pages_parallel(recv_addr_vector* parts, ulint n_parts)
+{
+	ut_ad(n_parts > 1);
+	ut_ad(!mutex_own(&recv_sys->mutex));
+
+	ulint			n_running = n_parts;
+	os_event_t		done = os_event_create(0);
+	recv_apply_part_t*	args = UT_NEW_ARRAY_NOKEY(recv_apply_part_t,
+							  n_parts);
+
+	for (ulint i = 0; i < n_parts; i++) {
+		args[i].addrs = &parts[i];
+		args[i].n_running = &n_running;
+		args[i].done = done;
+		os_thread_create(recv_apply_thread, &args[i], NULL);
+	}
+
+	os_event_wait(done);
+
+	ut_ad(!n_running);
+	os_event_destroy(done);
+	UT_DELETE_ARRAY(args);
+}
+
 /** Apply the hash table of stored log records to persistent data pages.
 @param[in]	last_batch	whether the change buffer merge will be
 				performed as part of the operation */
@@ -1948,6 +2098,11 @@ recv_apply_hashed_log_recs(bool last_batch)
 	recv_sys->apply_log_recs = TRUE;
 	recv_sys->apply_batch_on = TRUE;
 
+	const ulint	n_parts = recv_sys->n_addrs < RECV_READ_AHEAD_AREA
+		? 1 : srv_n_recv_apply_threads;
+	recv_addr_vector* parts = UT_NEW_ARRAY_NOKEY(recv_addr_vector,
+						     n_parts);
+
 	for (ulint i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
 		for (recv_addr_t* recv_addr = static_cast<recv_addr_t*>(
 			     HASH_GET_FIRST(recv_sys->addr_hash, i));
@@ -1970,39 +2125,30 @@ recv_apply_hashed_log_recs(bool last_batch)
 				continue;
 			}
 
-			const page_id_t		page_id(recv_addr->space,
-							recv_addr->page_no);
-			bool			found;
-			const page_size_t&	page_size
-				= fil_space_get_page_size(recv_addr->space,
-							  &found);
-
-			ut_ad(found);
-
 			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				mutex_exit(&recv_sys->mutex);
-
-				if (buf_page_peek(page_id)) {
-					mtr_t	mtr;
-					mtr.start();
+				/* Keep each read-ahead area within one
+				partition, so that the threads will not
+				compete for the same pages. */
+				parts[ut_fold_ulint_pair(
+					      recv_addr->space,
+					      recv_addr->page_no
+					      / RECV_READ_AHEAD_AREA)
+				      % n_parts].push_back(recv_addr);
+			}
+		}
+	}
 
-					buf_block_t* block = buf_page_get(
-						page_id, page_size,
-						RW_X_LATCH, &mtr);
+	mutex_exit(&recv_sys->mutex);
 
-					buf_block_dbg_add_level(
-						block, SYNC_NO_ORDER_CHECK);
+	if (n_parts == 1) {
+		recv_apply_pages(parts[0]);
+	} else {
+		recv_apply_pages_parallel(parts, n_parts);
+	}
 
-					recv_recover_page(FALSE, block);
-					mtr.commit();
-				} else {
-					recv_read_in_area(page_id);
-				}
+	UT_DELETE_ARRAY(parts);
 
-				mutex_enter(&recv_sys->mutex);
-			}
-		}
-	}
+	mutex_enter(&recv_sys->mutex);
 
 	/* Wait until all the pages have been processed */
 
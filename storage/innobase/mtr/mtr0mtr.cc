@@ -385,7 +385,8 @@ class mtr_t::Command {
 	@param[in,out]	mtr	mini-transaction */
 	explicit Command(mtr_t* mtr)
 		:
-		m_locks_released()
+		m_locks_released(),
+		m_log_ptr()
 	{
 		init(mtr);
 	}
@@ -422,6 +423,16 @@ class mtr_t::Command {
 	@param[in]	len	number of bytes to write */
 	void finish_write(ulint len);
 
+	/** Reserve space for the redo log records in the redo log buffer.
+	The records must be copied by copy_log() after releasing
+	log_sys->mutex.
+	@param[in]	len	number of bytes to write */
+	void reserve_write(ulint len);
+
+	/** Copy the redo log records to the space that was reserved
+	by reserve_write(). */
+	void copy_log();
+
 private:
 	/** Prepare to write the mini-transaction log to the redo log buffer.
 	@return number of bytes to write in finish_write() */
@@ -440,6 +451,9 @@ class mtr_t::Command {
 	/** Start lsn of the possible log entry for this mtr */
 	lsn_t			m_start_lsn;
 
+	/** The space reserved by reserve_write(), or NULL */
+	byte*			m_log_ptr;
+
 	/** End lsn of the possible log entry for this mtr */
 	lsn_t			m_end_lsn;
 };
@@ -469,6 +483,26 @@ struct mtr_write_log_t {
 	}
 };
 
+/** Copy the block contents to space reserved in the REDO log buffer */
+struct mtr_copy_log_t {
+	/** Constructor
+	@param[in]	ptr	start of the space reserved by
+				log_reserve_low() */
+	explicit mtr_copy_log_t(byte* ptr) : m_ptr(ptr) {}
+
+	/** Copy a block to the reserved space.
+	@return whether the copying should continue */
+	bool operator()(const mtr_buf_t::block_t* block)
+	{
+		m_ptr = log_write_reserved(m_ptr, block->begin(),
+					   block->used());
+		return(true);
+	}
+
+	/** The current position in the reserved space */
+	byte*	m_ptr;
+};
+
 /** Append records to the system-wide redo log buffer.
 @param[in]	log	redo log records */
 void
@@ -906,6 +940,38 @@ mtr_t::Command::finish_write(
 	m_end_lsn = log_close();
 }
 
+/** Reserve space for the redo log records in the redo log buffer.
+The records must be copied by copy_log() after releasing log_sys->mutex.
+@param[in]	len	number of bytes to write */
+void
+mtr_t::Command::reserve_write(
+	ulint	len)
+{
+	ut_ad(m_impl->m_log_mode == MTR_LOG_ALL);
+	ut_ad(log_mutex_own());
+	ut_ad(m_impl->m_log.size() == len);
+	ut_ad(len > 0);
+
+	m_start_lsn = log_reserve_and_open(len);
+	m_log_ptr = log_reserve_low(len);
+	m_end_lsn = log_close();
+}
+
+/** Copy the redo log records to the space that was reserved
+by reserve_write(). */
+void
+mtr_t::Command::copy_log()
+{
+	ut_ad(m_log_ptr != NULL);
+	ut_ad(!log_mutex_own());
+
+	mtr_copy_log_t	copy_log(m_log_ptr);
+	m_impl->m_log.for_each_block(copy_log);
+	log_write_reserved_done();
+
+	m_log_ptr = NULL;
+}
+
 /** Release the latches and blocks acquired by this mini-transaction */
 void
 mtr_t::Command::release_all()
@@ -950,7 +1016,16 @@ mtr_t::Command::execute()
 	ut_ad(m_impl->m_log_mode != MTR_LOG_NONE);
 
 	if (const ulint len = prepare_write()) {
+#ifdef UNIV_LOG_LSN_DEBUG
+		/* log_reserve_and_write_fast() appends MLOG_LSN */
 		finish_write(len);
+#else
+		/* Only reserve the space for the log while holding
+		log_sys->mutex. The records will be copied concurrently
+		with other mini-transactions, and log_write_up_to() will
+		wait for the copying to complete. */
+		reserve_write(len);
+#endif /* UNIV_LOG_LSN_DEBUG */
 	}
 
 	if (m_impl->m_made_dirty) {
@@ -970,6 +1045,10 @@ mtr_t::Command::execute()
 		log_flush_order_mutex_exit();
 	}
 
+	if (m_log_ptr) {
+		copy_log();
+	}
+
 	release_latches();
 
 	release_resources();
@@ -64,6 +64,11 @@ Created 10/21/1995 Heikki Tuuri
 #include <libaio.h>
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_NATIVE_URING
+#include <liburing.h>
+#include <algorithm>
+#endif /* LINUX_NATIVE_URING */
+
 #ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
 # include <fcntl.h>
 # include <linux/falloc.h>
@@ -400,8 +405,11 @@ class AIO {
 #ifdef LINUX_NATIVE_AIO
 	/** Dispatch an AIO request to the kernel.
 	@param[in,out]	slot	an already reserved slot
+	@param[in]	submit	false to leave the request queued until
+				os_aio_simulated_wake_handler_threads()
+				(only with innodb_use_io_uring)
 	@return true on success. */
-	bool linux_dispatch(Slot* slot)
+	bool linux_dispatch(Slot* slot, bool submit)
 		MY_ATTRIBUTE((warn_unused_result));
 
 	/** Accessor for an AIO event
@@ -442,6 +450,47 @@ class AIO {
 		MY_ATTRIBUTE((warn_unused_result));
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_NATIVE_URING
+	/** Accessor for the io_uring of a segment
+	@param[in]	segment	Segment for which to get the io_uring
+	@return the io_uring of the segment */
+	io_uring* uring(ulint segment)
+		MY_ATTRIBUTE((warn_unused_result))
+	{
+		ut_ad(segment < get_n_segments());
+
+		return(&m_uring[segment]);
+	}
+
+	/** Queue a submission for the remaining part of a request.
+	The caller must own the mutex.
+	@param[in,out]	slot	an already reserved slot
+	@param[in,out]	ring	the io_uring of the segment of the slot */
+	void uring_prep(Slot* slot, io_uring* ring);
+
+	/** Submit the requests of all the arrays that were queued by
+	linux_dispatch() with submit=false. */
+	static void uring_submit_all();
+
+	/** Wake up the I/O handler threads that wait for completions,
+	so that they notice a shutdown. */
+	static void uring_wake_all();
+
+	/** Register os_aio_fixed_bufs with the io_uring of all the
+	arrays.
+	@return true on success */
+	static bool uring_register_all()
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Unregister os_aio_fixed_bufs from all the arrays. */
+	static void uring_unregister_all();
+
+	/** Checks if the system supports io_uring.
+	@return true if supported, false otherwise. */
+	static bool is_linux_uring_supported()
+		MY_ATTRIBUTE((warn_unused_result));
+#endif /* LINUX_NATIVE_URING */
+
 #ifdef WIN_ASYNC_IO
 	
 	/** Wake up all AIO threads in Windows native aio */
@@ -587,6 +636,22 @@ class AIO {
 		MY_ATTRIBUTE((warn_unused_result));
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_NATIVE_URING
+	/** Create an io_uring for each segment. On failure,
+	innodb_use_io_uring is disabled and libaio is used instead. */
+	void init_linux_uring();
+
+	/** Register os_aio_fixed_bufs with the io_uring of each segment.
+	@return true on success */
+	bool uring_register()
+		MY_ATTRIBUTE((warn_unused_result));
+
+	/** Unregister the fixed buffers from the io_uring of the
+	first n segments.
+	@param[in]	n	number of segments */
+	void uring_unregister(ulint n);
+#endif /* LINUX_NATIVE_URING */
+
 private:
 	typedef std::vector<Slot> Slots;
 
@@ -629,6 +694,17 @@ class AIO {
 	IOEvents		m_events;
 #endif /* LINUX_NATIV_AIO */
 
+#ifdef LINUX_NATIVE_URING
+	/** io_uring instances, one per segment, or NULL if
+	innodb_use_io_uring was not enabled when creating the array.
+	The submission queues are protected by m_mutex; the completion
+	queue of each segment is only accessed by its I/O thread. */
+	io_uring*		m_uring;
+
+	/** Whether os_aio_fixed_bufs are registered with m_uring */
+	bool			m_uring_fixed;
+#endif /* LINUX_NATIVE_URING */
+
 	/** The aio arrays for non-ibuf i/o and ibuf i/o, as well as
 	sync AIO. These are NULL when the module has not yet been
 	initialized. */
@@ -667,6 +743,47 @@ static const ulint	OS_AIO_IO_SETUP_RETRY_SLEEP = 500000UL;
 static const int	OS_AIO_IO_SETUP_RETRY_ATTEMPTS = 5;
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_NATIVE_URING
+/** Memory ranges registered as io_uring fixed buffers by
+os_aio_register_buffers(), sorted by address */
+static std::vector<iovec>	os_aio_fixed_bufs;
+
+/** The kernel limit of the size of a fixed buffer */
+static const ulint	OS_AIO_FIXED_BUF_MAX = 1U << 30;
+
+/** Find the fixed buffer that contains an I/O buffer.
+@param[in]	ptr	start of the I/O buffer
+@param[in]	len	length of the I/O buffer
+@return index of the fixed buffer, or ULINT_UNDEFINED */
+static
+ulint
+os_aio_fixed_buf(const byte* ptr, ulint len)
+{
+	struct cmp {
+		bool operator()(const byte* p, const iovec& iov) const
+		{
+			return(p < static_cast<const byte*>(iov.iov_base));
+		}
+	};
+
+	std::vector<iovec>::const_iterator	it = std::upper_bound(
+		os_aio_fixed_bufs.begin(), os_aio_fixed_bufs.end(),
+		ptr, cmp());
+
+	if (it == os_aio_fixed_bufs.begin()) {
+		return(ULINT_UNDEFINED);
+	}
+
+	--it;
+
+	const byte*	base = static_cast<const byte*>(it->iov_base);
+
+	return(ptr + len <= base + it->iov_len
+	       ? ulint(it - os_aio_fixed_bufs.begin())
+	       : ULINT_UNDEFINED);
+}
+#endif /* LINUX_NATIVE_URING */
+
 /** Array of events used in simulated AIO */
 static os_event_t*	os_aio_segment_wait_events;
 
@@ -1696,6 +1813,18 @@ class LinuxAIOHandler {
 	each wakeup and that is why we use timed wait in io_getevents(). */
 	void collect();
 
+	/** Mark a request as completed.
+	@param[in,out]	slot		the completed request
+	@param[in]	n_bytes		number of bytes read or written
+	@param[in]	ret		0 or negative error code */
+	void completed(Slot* slot, ssize_t n_bytes, int ret);
+
+#ifdef LINUX_NATIVE_URING
+	/** collect() for innodb_use_io_uring. The I/O thread submits any
+	queued requests and then waits for completions. */
+	void collect_uring();
+#endif /* LINUX_NATIVE_URING */
+
 private:
 	/** Slot array */
 	AIO*			m_array;
@@ -1736,6 +1865,31 @@ LinuxAIOHandler::resubmit(Slot* slot)
 	slot->n_bytes = 0;
 	slot->io_already_done = false;
 
+#ifdef LINUX_NATIVE_URING
+	if (srv_use_io_uring) {
+		io_uring*	ring = m_array->uring(m_segment);
+
+		m_array->uring_prep(slot, ring);
+
+		/* On a transient failure, the request remains queued
+		and collect_uring() will submit it. */
+		int	ret = io_uring_submit(ring);
+
+		switch (ret) {
+		case -EAGAIN:
+		case -EBUSY:
+		case -EINTR:
+			return(DB_SUCCESS);
+		}
+
+		if (ret < 0) {
+			errno = -ret;
+		}
+
+		return(ret < 0 ? DB_IO_PARTIAL_FAILED : DB_SUCCESS);
+	}
+#endif /* LINUX_NATIVE_URING */
+
 	struct iocb*	iocb = &slot->control;
 
 	if (slot->type.is_read()) {
@@ -1864,6 +2018,13 @@ LinuxAIOHandler::collect()
 	ut_ad(m_array != NULL);
 	ut_ad(m_segment < m_array->get_n_segments());
 
+#ifdef LINUX_NATIVE_URING
+	if (srv_use_io_uring) {
+		collect_uring();
+		return;
+	}
+#endif /* LINUX_NATIVE_URING */
+
 	/* Which io_context we are going to use. */
 	io_context*	io_ctx = m_array->io_ctx(m_segment);
 
@@ -1912,29 +2073,7 @@ LinuxAIOHandler::collect()
 			/* We have not overstepped to next segment. */
 			ut_a(slot->pos < end_pos);
 
-			/* Deallocate unused blocks from file system.
-			This is newer done to page 0 or to log files.*/
-			if (slot->offset > 0
-			    && !slot->type.is_log()
-			    && slot->type.is_write()
-			    && slot->type.punch_hole()) {
-
-				slot->err = slot->type.punch_hole(
-					slot->file,
-					slot->offset, slot->len);
-			} else {
-				slot->err = DB_SUCCESS;
-			}
-
-			/* Mark this request as completed. The error handling
-			will be done in the calling function. */
-			m_array->acquire();
-
-			slot->ret = events[i].res2;
-			slot->io_already_done = true;
-			slot->n_bytes = events[i].res;
-
-			m_array->release();
+			completed(slot, events[i].res, int(events[i].res2));
 		}
 
 		if (srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS
@@ -1974,6 +2113,121 @@ LinuxAIOHandler::collect()
 	}
 }
 
+/** Mark a request as completed.
+@param[in,out]	slot		the completed request
+@param[in]	n_bytes		number of bytes read or written
+@param[in]	ret		0 or negative error code */
+void
+LinuxAIOHandler::completed(Slot* slot, ssize_t n_bytes, int ret)
+{
+	/* Deallocate unused blocks from file system.
+	This is newer done to page 0 or to log files.*/
+	if (slot->offset > 0
+	    && !slot->type.is_log()
+	    && slot->type.is_write()
+	    && slot->type.punch_hole()) {
+
+		slot->err = slot->type.punch_hole(
+			slot->file,
+			slot->offset, slot->len);
+	} else {
+		slot->err = DB_SUCCESS;
+	}
+
+	/* Mark this request as completed. The error handling
+	will be done in the calling function. */
+	m_array->acquire();
+
+	slot->ret = ret;
+	slot->io_already_done = true;
+	slot->n_bytes = n_bytes;
+
+	m_array->release();
+}
+
+#ifdef LINUX_NATIVE_URING
+/** collect() for innodb_use_io_uring. The I/O thread submits any
+queued requests and then waits for completions. */
+void
+LinuxAIOHandler::collect_uring()
+{
+	io_uring*	ring = m_array->uring(m_segment);
+
+	for (;;) {
+		/* Submit the requests that were queued without waking
+		us up, so that we will not wait for them forever. */
+		m_array->acquire();
+
+		if (io_uring_sq_ready(ring)) {
+			io_uring_submit(ring);
+		}
+
+		m_array->release();
+
+		io_uring_cqe*	cqe;
+		int		ret;
+
+#ifdef IORING_FEAT_EXT_ARG
+		if (ring->features & IORING_FEAT_EXT_ARG) {
+			/* This does not use the submission queue. */
+			__kernel_timespec	timeout;
+
+			timeout.tv_sec = 0;
+			timeout.tv_nsec = OS_AIO_REAP_TIMEOUT;
+
+			ret = io_uring_wait_cqe_timeout(ring, &cqe, &timeout);
+		} else
+#endif /* IORING_FEAT_EXT_ARG */
+		{
+			/* At shutdown, uring_wake_all() submits a no-op
+			request to end the wait. */
+			ret = io_uring_wait_cqe(ring, &cqe);
+		}
+
+		ulint	n = 0;
+
+		for (; ret == 0; ret = io_uring_peek_cqe(ring, &cqe)) {
+			Slot*	slot = static_cast<Slot*>(
+				io_uring_cqe_get_data(cqe));
+			int	res = cqe->res;
+
+			io_uring_cqe_seen(ring, cqe);
+
+			if (slot == NULL) {
+				/* A wakeup from uring_wake_all() */
+				continue;
+			}
+
+			ut_a(slot->is_reserved);
+			ut_a(slot->pos >= m_segment * m_n_slots);
+			ut_a(slot->pos < (m_segment + 1) * m_n_slots);
+
+			completed(slot, res < 0 ? 0 : res, res < 0 ? res : 0);
+			++n;
+		}
+
+		if (srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS
+		    || !buf_page_cleaner_is_active
+		    || n > 0) {
+
+			break;
+		}
+
+		switch (ret) {
+		case -EAGAIN:
+			/* The completion queue was emptied. */
+		case -ETIME:
+		case -EINTR:
+			continue;
+		}
+
+		ib::fatal()
+			<< "Unexpected ret_code[" << ret
+			<< "] from io_uring_wait_cqe()!";
+	}
+}
+#endif /* LINUX_NATIVE_URING */
+
 /** Process a Linux AIO request
 @param[out]	m1		the messages passed with the
 @param[out]	m2		AIO request; note that in case the
@@ -2095,9 +2349,12 @@ os_aio_linux_handler(
 
 /** Dispatch an AIO request to the kernel.
 @param[in,out]	slot		an already reserved slot
+@param[in]	submit		false to leave the request queued until
+				os_aio_simulated_wake_handler_threads()
+				(only with innodb_use_io_uring)
 @return true on success. */
 bool
-AIO::linux_dispatch(Slot* slot)
+AIO::linux_dispatch(Slot* slot, bool submit)
 {
 	ut_a(slot->is_reserved);
 	ut_ad(slot->type.validate());
@@ -2111,6 +2368,44 @@ AIO::linux_dispatch(Slot* slot)
 
 	io_ctx_index = (slot->pos * m_n_segments) / m_slots.size();
 
+#ifdef LINUX_NATIVE_URING
+	if (srv_use_io_uring) {
+		io_uring*	ring = uring(io_ctx_index);
+
+		/* Without IORING_FEAT_EXT_ARG, collect_uring() waits
+		without a timeout and would not notice a queued request. */
+#ifdef IORING_FEAT_EXT_ARG
+		submit |= !(ring->features & IORING_FEAT_EXT_ARG);
+#else
+		submit = true;
+#endif /* IORING_FEAT_EXT_ARG */
+
+		acquire();
+
+		uring_prep(slot, ring);
+
+		int	ret = submit ? io_uring_submit(ring) : 0;
+
+		release();
+
+		switch (ret) {
+		case -EAGAIN:
+		case -EBUSY:
+		case -EINTR:
+			/* The request remains queued, and the I/O
+			handler thread will submit it. */
+			return(true);
+		}
+
+		if (ret < 0) {
+			errno = -ret;
+			return(false);
+		}
+
+		return(true);
+	}
+#endif /* LINUX_NATIVE_URING */
+
 	int	ret = io_submit(m_aio_ctx[io_ctx_index], 1, &iocb);
 
 	/* io_submit() returns number of successfully queued requests
@@ -2328,6 +2623,306 @@ AIO::is_linux_native_aio_supported()
 	return(false);
 }
 
+#ifdef LINUX_NATIVE_URING
+/** Queue a submission for the remaining part of a request.
+The caller must own the mutex.
+@param[in,out]	slot	an already reserved slot
+@param[in,out]	ring	the io_uring of the segment of the slot */
+void
+AIO::uring_prep(Slot* slot, io_uring* ring)
+{
+	ut_ad(is_mutex_owned());
+
+	/* Each segment has as many submission queue entries as slots. */
+	io_uring_sqe*	sqe = io_uring_get_sqe(ring);
+
+	ut_a(sqe != NULL);
+
+	byte*		ptr = slot->ptr + slot->n_bytes;
+	ulint		len = slot->len - slot->n_bytes;
+	os_offset_t	offset = slot->offset + slot->n_bytes;
+	ulint		fixed = m_uring_fixed
+		? os_aio_fixed_buf(ptr, len) : ULINT_UNDEFINED;
+
+	if (fixed == ULINT_UNDEFINED) {
+		if (slot->type.is_read()) {
+			io_uring_prep_read(
+				sqe, slot->file, ptr, unsigned(len), offset);
+		} else {
+			io_uring_prep_write(
+				sqe, slot->file, ptr, unsigned(len), offset);
+		}
+	} else if (slot->type.is_read()) {
+		io_uring_prep_read_fixed(
+			sqe, slot->file, ptr, unsigned(len), offset,
+			int(fixed));
+	} else {
+		io_uring_prep_write_fixed(
+			sqe, slot->file, ptr, unsigned(len), offset,
+			int(fixed));
+	}
+
+	io_uring_sqe_set_data(sqe, slot);
+}
+
+/** Submit the requests of all the arrays that were queued by
+linux_dispatch() with submit=false. */
+void
+AIO::uring_submit_all()
+{
+	AIO*	arrays[] = { s_ibuf, s_log, s_reads, s_writes };
+
+	for (ulint a = 0; a < UT_ARR_SIZE(arrays); ++a) {
+		AIO*	array = arrays[a];
+
+		if (array == NULL || array->m_uring == NULL) {
+			continue;
+		}
+
+		array->acquire();
+
+		for (ulint i = 0; i < array->m_n_segments; ++i) {
+			io_uring*	ring = &array->m_uring[i];
+
+			if (io_uring_sq_ready(ring)) {
+				/* On failure, the I/O handler thread
+				will retry. */
+				io_uring_submit(ring);
+			}
+		}
+
+		array->release();
+	}
+}
+
+/** Wake up the I/O handler threads that wait for completions,
+so that they notice a shutdown. */
+void
+AIO::uring_wake_all()
+{
+	AIO*	arrays[] = { s_ibuf, s_log, s_reads, s_writes };
+
+	for (ulint a = 0; a < UT_ARR_SIZE(arrays); ++a) {
+		AIO*	array = arrays[a];
+
+		if (array == NULL || array->m_uring == NULL) {
+			continue;
+		}
+
+		array->acquire();
+
+		for (ulint i = 0; i < array->m_n_segments; ++i) {
+			io_uring*	ring = &array->m_uring[i];
+			io_uring_sqe*	sqe = io_uring_get_sqe(ring);
+
+			if (sqe != NULL) {
+				io_uring_prep_nop(sqe);
+				io_uring_sqe_set_data(sqe, NULL);
+			}
+
+			io_uring_submit(ring);
+		}
+
+		array->release();
+	}
+}
+
+/** Register os_aio_fixed_bufs with the io_uring of each segment.
+@return true on success */
+bool
+AIO::uring_register()
+{
+	ut_ad(!m_uring_fixed);
+
+	acquire();
+
+	for (ulint i = 0; i < m_n_segments; ++i) {
+		int	ret = io_uring_register_buffers(
+			&m_uring[i], &os_aio_fixed_bufs[0],
+			unsigned(os_aio_fixed_bufs.size()));
+
+		if (ret < 0) {
+			uring_unregister(i);
+			release();
+
+			ib::warn()
+				<< "io_uring_register_buffers() returned"
+				" error[" << -ret << "]. Not using"
+				" fixed buffers. You may want to increase"
+				" the locked memory limit (ulimit -l).";
+
+			return(false);
+		}
+	}
+
+	m_uring_fixed = true;
+
+	release();
+
+	return(true);
+}
+
+/** Unregister the fixed buffers from the io_uring of the
+first segments. The caller must own the mutex.
+@param[in]	n	number of segments */
+void
+AIO::uring_unregister(ulint n)
+{
+	ut_ad(is_mutex_owned());
+
+	m_uring_fixed = false;
+
+	for (ulint i = 0; i < n; ++i) {
+		io_uring*	ring = &m_uring[i];
+
+		/* Requests that were queued by linux_dispatch() with
+		submit=false may refer to the fixed buffers by index.
+		Submit them while the buffers are still registered,
+		or they would fail with EFAULT. No new such requests
+		can be queued, because m_uring_fixed was reset. */
+		while (io_uring_sq_ready(ring)) {
+			int	ret = io_uring_submit(ring);
+
+			if (ret >= 0) {
+				continue;
+			}
+
+			if (ret != -EAGAIN && ret != -EBUSY && ret != -EINTR) {
+				ib::error() << "io_uring_submit() returned"
+					" error[" << -ret << "]";
+				break;
+			}
+
+			/* Let the I/O handler thread reap completions. */
+			release();
+			os_thread_sleep(100);
+			acquire();
+		}
+
+		io_uring_unregister_buffers(ring);
+	}
+}
+
+/** Register os_aio_fixed_bufs with the io_uring of all the
+arrays.
+@return true on success */
+bool
+AIO::uring_register_all()
+{
+	AIO*	arrays[] = { s_ibuf, s_log, s_reads, s_writes };
+
+	for (ulint a = 0; a < UT_ARR_SIZE(arrays); ++a) {
+		AIO*	array = arrays[a];
+
+		if (array == NULL || array->m_uring == NULL) {
+			continue;
+		}
+
+		if (!array->uring_register()) {
+			uring_unregister_all();
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** Unregister os_aio_fixed_bufs from all the arrays. */
+void
+AIO::uring_unregister_all()
+{
+	AIO*	arrays[] = { s_ibuf, s_log, s_reads, s_writes };
+
+	for (ulint a = 0; a < UT_ARR_SIZE(arrays); ++a) {
+		AIO*	array = arrays[a];
+
+		if (array == NULL || array->m_uring == NULL) {
+			continue;
+		}
+
+		array->acquire();
+
+		if (array->m_uring_fixed) {
+			array->uring_unregister(array->m_n_segments);
+		}
+
+		array->release();
+	}
+}
+
+/** Checks if the system supports io_uring.
+@return true if supported, false otherwise. */
+bool
+AIO::is_linux_uring_supported()
+{
+	io_uring	ring;
+	int		err = io_uring_queue_init(1, &ring, 0);
+
+	if (err < 0) {
+		ib::warn()
+			<< "io_uring_queue_init() returned error["
+			<< -err << "]";
+		return(false);
+	}
+
+	if (srv_read_only_mode) {
+		/* Reads were already checked by
+		is_linux_native_aio_supported(). */
+		io_uring_queue_exit(&ring);
+		return(true);
+	}
+
+	/* Check if tmpdir supports io_uring writes. */
+	int	fd = innobase_mysql_tmpfile(NULL);
+
+	if (fd < 0) {
+		io_uring_queue_exit(&ring);
+
+		ib::warn()
+			<< "Unable to create temp file to check"
+			" io_uring support.";
+
+		return(false);
+	}
+
+	byte*	buf = static_cast<byte*>(ut_malloc_nokey(UNIV_PAGE_SIZE * 2));
+	byte*	ptr = static_cast<byte*>(ut_align(buf, UNIV_PAGE_SIZE));
+
+	/* Suppress valgrind warning. */
+	memset(buf, 0x00, UNIV_PAGE_SIZE * 2);
+
+	io_uring_sqe*	sqe = io_uring_get_sqe(&ring);
+
+	io_uring_prep_write(sqe, fd, ptr, unsigned(UNIV_PAGE_SIZE), 0);
+
+	err = io_uring_submit(&ring);
+
+	if (err == 1) {
+		io_uring_cqe*	cqe;
+
+		err = io_uring_wait_cqe(&ring, &cqe);
+
+		if (err == 0) {
+			err = cqe->res;
+			io_uring_cqe_seen(&ring, cqe);
+		}
+	}
+
+	ut_free(buf);
+	close(fd);
+	io_uring_queue_exit(&ring);
+
+	if (err != int(UNIV_PAGE_SIZE)) {
+		ib::warn()
+			<< "io_uring check on tmpdir returned error["
+			<< -err << "]";
+		return(false);
+	}
+
+	return(true);
+}
+#endif /* LINUX_NATIVE_URING */
+
 #endif /* LINUX_NATIVE_AIO */
 
 /** Retrieves the last error number if an error occurs in a file io function.
@@ -5702,6 +6297,10 @@ AIO::AIO(
 	,m_aio_ctx(),
 	m_events(m_slots.size())
 # endif /* LINUX_NATIVE_AIO */
+# ifdef LINUX_NATIVE_URING
+	,m_uring(),
+	m_uring_fixed(false)
+# endif /* LINUX_NATIVE_URING */
 {
 	ut_a(n > 0);
 	ut_a(m_n_segments > 0);
@@ -5796,6 +6395,45 @@ AIO::init_linux_native_aio()
 
 	return(DB_SUCCESS);
 }
+
+#ifdef LINUX_NATIVE_URING
+/** Create an io_uring for each segment. On failure,
+innodb_use_io_uring is disabled and libaio is used instead. */
+void
+AIO::init_linux_uring()
+{
+	ut_a(m_uring == NULL);
+
+	m_uring = static_cast<io_uring*>(
+		ut_zalloc_nokey(m_n_segments * sizeof *m_uring));
+
+	if (m_uring == NULL) {
+		srv_use_io_uring = FALSE;
+		return;
+	}
+
+	for (ulint i = 0; i < m_n_segments; ++i) {
+		int	ret = io_uring_queue_init(
+			unsigned(slots_per_segment()), &m_uring[i], 0);
+
+		if (ret < 0) {
+			ib::warn()
+				<< "io_uring_queue_init() returned error["
+				<< -ret << "]. Using libaio instead"
+				" of io_uring.";
+
+			while (i--) {
+				io_uring_queue_exit(&m_uring[i]);
+			}
+
+			ut_free(m_uring);
+			m_uring = NULL;
+			srv_use_io_uring = FALSE;
+			return;
+		}
+	}
+}
+#endif /* LINUX_NATIVE_URING */
 #endif /* LINUX_NATIVE_AIO */
 
 /** Initialise the array */
@@ -5814,6 +6452,14 @@ AIO::init()
 		}
 
 #endif /* LINUX_NATIVE_AIO */
+#ifdef LINUX_NATIVE_URING
+		/* The io_context are kept as well, so that the
+		validity of m_aio_ctx does not depend on
+		innodb_use_io_uring. */
+		if (srv_use_native_aio && srv_use_io_uring) {
+			init_linux_uring();
+		}
+#endif /* LINUX_NATIVE_URING */
 	}
 
 	return(init_slots());
@@ -5869,6 +6515,16 @@ AIO::~AIO()
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_NATIVE_URING
+	if (m_uring != NULL) {
+		for (ulint i = 0; i < m_n_segments; ++i) {
+			io_uring_queue_exit(&m_uring[i]);
+		}
+
+		ut_free(m_uring);
+	}
+#endif /* LINUX_NATIVE_URING */
+
 	m_slots.clear();
 }
 
@@ -5901,6 +6557,23 @@ AIO::start(
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#ifdef LINUX_NATIVE_URING
+	if (srv_use_native_aio && srv_use_io_uring
+	    && !is_linux_uring_supported()) {
+
+		ib::warn() << "io_uring disabled. Using libaio instead.";
+
+		srv_use_io_uring = FALSE;
+	}
+#else
+	if (srv_use_io_uring) {
+		ib::warn() << "innodb_use_io_uring is not supported"
+			" by this build. Using libaio instead.";
+
+		srv_use_io_uring = FALSE;
+	}
+#endif /* LINUX_NATIVE_URING */
+
 	srv_reset_io_thread_op_info();
 
 	s_reads = create(
@@ -6056,6 +6729,71 @@ os_aio_free()
 		os_aio_segment_wait_events = 0;
 	}
 	os_aio_n_segments = 0;
+
+#ifdef LINUX_NATIVE_URING
+	os_aio_fixed_bufs.clear();
+#endif /* LINUX_NATIVE_URING */
+}
+
+/** Register buffers for asynchronous I/O, so that the kernel does not
+have to map them on each request (only with innodb_use_io_uring).
+Any previously registered buffers are replaced.
+@param[in]	mem	start addresses of the buffers
+@param[in]	len	lengths of the buffers
+@param[in]	n	number of buffers */
+void
+os_aio_register_buffers(byte* const* mem, const ulint* len, ulint n)
+{
+#ifdef LINUX_NATIVE_URING
+	if (!srv_use_native_aio || !srv_use_io_uring) {
+		return;
+	}
+
+	os_aio_unregister_buffers();
+
+	for (ulint i = 0; i < n; ++i) {
+		/* Larger buffers are not accepted by the kernel;
+		requests on them will not use fixed buffers. */
+		if (len[i] <= OS_AIO_FIXED_BUF_MAX) {
+			iovec	iov;
+
+			iov.iov_base = mem[i];
+			iov.iov_len = len[i];
+
+			os_aio_fixed_bufs.push_back(iov);
+		}
+	}
+
+	if (os_aio_fixed_bufs.empty()) {
+		return;
+	}
+
+	struct cmp {
+		bool operator()(const iovec& a, const iovec& b) const
+		{
+			return(a.iov_base < b.iov_base);
+		}
+	};
+
+	std::sort(os_aio_fixed_bufs.begin(), os_aio_fixed_bufs.end(), cmp());
+
+	if (!AIO::uring_register_all()) {
+		os_aio_fixed_bufs.clear();
+	}
+#endif /* LINUX_NATIVE_URING */
+}
+
+/** Unregister the buffers that were registered by
+os_aio_register_buffers(). */
+void
+os_aio_unregister_buffers()
+{
+#ifdef LINUX_NATIVE_URING
+	if (!os_aio_fixed_bufs.empty()) {
+		AIO::uring_unregister_all();
+		os_aio_fixed_bufs.clear();
+	}
+#endif /* LINUX_NATIVE_URING */
 }
 
 /** Wakes up all async i/o threads so that they know to exit themselves in
@@ -6070,6 +6808,12 @@ os_aio_wake_all_threads_at_shutdown()
 	wait on io_getevents with a timeout value of 500ms. At
 	each wake up these threads check the server status.
 	No need to do anything to wake them up. */
+# ifdef LINUX_NATIVE_URING
+	/* With io_uring, the threads may wait without a timeout. */
+	if (srv_use_native_aio && srv_use_io_uring) {
+		AIO::uring_wake_all();
+	}
+# endif /* LINUX_NATIVE_URING */
 #endif /* !WIN_ASYNC_AIO */
 
 	if (srv_use_native_aio) {
@@ -6353,6 +7097,14 @@ void
 os_aio_simulated_wake_handler_threads()
 {
 	if (srv_use_native_aio) {
+#ifdef LINUX_NATIVE_URING
+		/* Submit the requests that were queued with
+		IORequest::DO_NOT_WAKE, in a single system call
+		per segment. */
+		if (srv_use_io_uring) {
+			AIO::uring_submit_all();
+		}
+#endif /* LINUX_NATIVE_URING */
 		/* We do not use simulated aio: do nothing */
 
 		return;
@@ -6662,7 +7414,7 @@ os_aio_func(
 				file, slot->ptr, slot->len,
 				NULL, &slot->control);
 #elif defined(LINUX_NATIVE_AIO)
-			if (!array->linux_dispatch(slot)) {
+			if (!array->linux_dispatch(slot, type.is_wake())) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -6680,7 +7432,7 @@ os_aio_func(
 				file, slot->ptr, slot->len,
 				NULL, &slot->control);
 #elif defined(LINUX_NATIVE_AIO)
-			if (!array->linux_dispatch(slot)) {
+			if (!array->linux_dispatch(slot, type.is_wake())) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -299,6 +299,85 @@ page_cur_rec_field_extends(
 }
 #endif /* PAGE_CUR_LE_OR_EXTENDS */
 
+/** Determine if the first field of a search key can be compared to
+records with cmp_bytes(), directly at the record origin. This holds for
+fixed-length NOT NULL fields that are ordered by memcmp(): integers,
+system columns and binary strings.
+@param[in]	index	index tree
+@param[in]	tuple	key to be searched for
+@return length of the first field, or 0 if the records must be
+compared with cmp_dtuple_rec_with_match() */
+static
+ulint
+page_cur_get_key_prefix_len(
+	const dict_index_t*	index,
+	const dtuple_t*		tuple)
+{
+	if (dtuple_get_n_fields_cmp(tuple) == 0
+	    || (dtuple_get_info_bits(tuple) & REC_INFO_MIN_REC_FLAG)) {
+		return(0);
+	}
+
+	const dict_field_t*	field = dict_index_get_nth_field(index, 0);
+	const dfield_t*		dfield = dtuple_get_nth_field(tuple, 0);
+	const dtype_t*		type = dfield_get_type(dfield);
+
+	if (!field->fixed_len
+	    || !(field->col->prtype & DATA_NOT_NULL)
+	    || dfield_get_len(dfield) != field->fixed_len) {
+		return(0);
+	}
+
+	switch (type->mtype) {
+	case DATA_FIXBINARY:
+	case DATA_BINARY:
+		if (dtype_get_charset_coll(type->prtype)
+		    != DATA_MYSQL_BINARY_CHARSET_COLL) {
+			return(0);
+		}
+		/* fall through */
+	case DATA_INT:
+	case DATA_SYS_CHILD:
+	case DATA_SYS:
+		return(field->fixed_len);
+	}
+
+	return(0);
+}
+
+/** Compare the first field of a search key to a record, without
+computing the offsets of the record.
+@param[in]	key		first field of the search key
+@param[in]	len		page_cur_get_key_prefix_len()
+@param[in]	rec		user record
+@param[in]	comp		whether the page is in ROW_FORMAT=COMPACT
+@param[out]	matched_fields	1 if the first field is equal
+@return the comparison result of key and the first field of rec
+@retval 0 if the first field is equal, or rec is the minimum record */
+static inline
+int
+page_cur_cmp_key_prefix(
+	const byte*	key,
+	ulint		len,
+	const rec_t*	rec,
+	bool		comp,
+	ulint*		matched_fields)
+{
+	ut_ad(len);
+
+	if (rec_get_info_bits(rec, comp) & REC_INFO_MIN_REC_FLAG) {
+		return(0);
+	}
+
+	int	cmp = cmp_bytes(key, rec, len);
+
+	if (!cmp) {
+		*matched_fields = 1;
+	}
+
+	return(cmp);
+}
+
 /****************************************************************//**
 Searches the right position for a page cursor. */
 void
@@ -408,6 +487,13 @@ page_cur_search_with_match(
 	up_matched_fields  = *iup_matched_fields;
 	low_matched_fields = *ilow_matched_fields;
 
+	/* Until the first field is matched, it is compared in place,
+	which avoids rec_get_offsets() for most of the records. */
+	const ulint	key_len = page_cur_get_key_prefix_len(index, tuple);
+	const byte*	key = static_cast<const byte*>(
+		dfield_get_data(dtuple_get_nth_field(tuple, 0)));
+	const bool	comp = page_is_comp(page);
+
 	/* Perform binary search. First the search is done through the page
 	directory, after that as a linear search in the list of records
 	owned by the upper limit directory slot. */
@@ -426,13 +512,18 @@ page_cur_search_with_match(
 		cur_matched_fields = std::min(low_matched_fields,
 					      up_matched_fields);
 
-		offsets = offsets_;
-		offsets = rec_get_offsets(
-			mid_rec, index, offsets, is_leaf,
-			dtuple_get_n_fields_cmp(tuple), &heap);
-
-		cmp = cmp_dtuple_rec_with_match(
-			tuple, mid_rec, offsets, &cur_matched_fields);
+		if (cur_matched_fields || !key_len
+		    || !(cmp = page_cur_cmp_key_prefix(
+				 key, key_len, mid_rec, comp,
+				 &cur_matched_fields))) {
+			offsets = offsets_;
+			offsets = rec_get_offsets(
+				mid_rec, index, offsets, is_leaf,
+				dtuple_get_n_fields_cmp(tuple), &heap);
+
+			cmp = cmp_dtuple_rec_with_match(
+				tuple, mid_rec, offsets, &cur_matched_fields);
+		}
 
 		if (cmp > 0) {
 low_slot_match:
@@ -480,13 +571,18 @@ page_cur_search_with_match(
 		cur_matched_fields = std::min(low_matched_fields,
 					      up_matched_fields);
 
-		offsets = offsets_;
-		offsets = rec_get_offsets(
-			mid_rec, index, offsets, is_leaf,
-			dtuple_get_n_fields_cmp(tuple), &heap);
-
-		cmp = cmp_dtuple_rec_with_match(
-			tuple, mid_rec, offsets, &cur_matched_fields);
+		if (cur_matched_fields || !key_len
+		    || !(cmp = page_cur_cmp_key_prefix(
+				 key, key_len, mid_rec, comp,
+				 &cur_matched_fields))) {
+			offsets = offsets_;
+			offsets = rec_get_offsets(
+				mid_rec, index, offsets, is_leaf,
+				dtuple_get_n_fields_cmp(tuple), &heap);
+
+			cmp = cmp_dtuple_rec_with_match(
+				tuple, mid_rec, offsets, &cur_matched_fields);
+		}
 
 		if (cmp > 0) {
 low_rec_match:
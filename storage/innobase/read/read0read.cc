@@ -26,6 +26,7 @@ Created 2/16/1997 Heikki Tuuri
 
 #include "read0types.h"
 
+#include "srv0mon.h"
 #include "srv0srv.h"
 #include "trx0sys.h"
 #include "trx0purge.h"
@@ -182,8 +183,8 @@ will mark their views as closed but not actually free their views.
 */
 inline void ReadView::snapshot(trx_t *trx)
 {
-  trx_sys.snapshot_ids(trx, &m_ids, &m_low_limit_id, &m_low_limit_no);
-  std::sort(m_ids.begin(), m_ids.end());
+  if (trx_sys.snapshot_ids(trx, &m_ids, &m_low_limit_id, &m_low_limit_no))
+    MONITOR_ATOMIC_INC(MONITOR_TRX_SNAPSHOT_REUSED);
   m_up_limit_id= m_ids.empty() ? m_low_limit_id : m_ids.front();
   ut_ad(m_up_limit_id <= m_low_limit_id);
 }
@@ -253,18 +254,14 @@ void ReadView::open(trx_t *trx)
     /*
       Can't reuse view, take new snapshot.
 
-      Alas this empty critical section is simplest way to make sure concurrent
-      purge thread completed snapshot copy. Of course purge thread may come
-      again and try to copy once again after we release this mutex, but in
-      this case it is guaranteed to see READ_VIEW_STATE_REGISTERED and thus
-      it'll skip this view.
-
-      This critical section can be replaced with new state, which purge thread
-      would set to inform us to wait until it completes snapshot. However it'd
-      complicate m_state even further.
+      Wait until concurrent purge thread completed snapshot copy. unuse()
+      published READ_VIEW_STATE_REGISTERED before we load m_purge_copying,
+      and purge thread sets m_purge_copying before it loads m_state. Thus
+      if purge thread comes again, it is guaranteed to see
+      READ_VIEW_STATE_REGISTERED and it'll skip this view.
     */
-    mutex_enter(&trx_sys.mutex);
-    mutex_exit(&trx_sys.mutex);
+    while (my_atomic_load32(&m_purge_copying))
+      ut_delay(1);
     my_atomic_store32_explicit(&m_state, READ_VIEW_STATE_SNAPSHOT,
                                MY_MEMORY_ORDER_RELAXED);
     break;
@@ -286,6 +283,32 @@ void ReadView::open(trx_t *trx)
 }
 
 
+/**
+  Opens a read view that sees exactly what another open view sees.
+
+  @param other    open view of another transaction
+*/
+void ReadView::open_copy(const ReadView &other)
+{
+  ut_ad(&other != this);
+  ut_ad(m_state == READ_VIEW_STATE_CLOSED);
+  ut_ad(other.m_state == READ_VIEW_STATE_OPEN);
+  ut_ad(!srv_read_only_mode);
+
+  m_state= READ_VIEW_STATE_SNAPSHOT;
+  trx_sys.register_view(this);
+
+  m_low_limit_id= other.m_low_limit_id;
+  m_up_limit_id= other.m_up_limit_id;
+  m_low_limit_no= other.m_low_limit_no;
+  m_ids= other.m_ids;
+  /* Let the copy see the changes of the transaction of the statement. */
+  m_creator_trx_id= other.m_creator_trx_id;
+  my_atomic_store32_explicit(&m_state, READ_VIEW_STATE_OPEN,
+                             MY_MEMORY_ORDER_RELEASE);
+}
+
+
 /**
   Closes the view.
 
@@ -325,13 +348,17 @@ void trx_sys_t::clone_oldest_view()
   for (const ReadView *v= UT_LIST_GET_FIRST(m_views); v;
        v= UT_LIST_GET_NEXT(m_view_list, v))
   {
-    int32_t state;
+    int32_t state= v->purge_copy_start();
 
-    while ((state= v->get_state()) == READ_VIEW_STATE_SNAPSHOT)
+    while (state == READ_VIEW_STATE_SNAPSHOT)
+    {
       ut_delay(1);
+      state= v->get_state();
+    }
 
     if (state == READ_VIEW_STATE_OPEN)
       purge_sys.view.copy(*v);
+    v->purge_copy_end();
   }
   mutex_exit(&mutex);
 }
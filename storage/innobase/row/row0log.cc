@@ -45,6 +45,7 @@ Created 2011-05-26 Marko Makela
 ulint onlineddl_rowlog_rows;
 ulint onlineddl_rowlog_pct_used;
 ulint onlineddl_pct_progress;
+ulint onlineddl_parallel_scan_threads;
 
 /** Table row modification operations during online table rebuild.
 Delete-marked records are not copied to the rebuilt table. */
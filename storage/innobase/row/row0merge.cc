@@ -2857,7 +2857,7 @@ row_merge_read_clustered_index(
 		/* Sync fts cache for other fts indexes to keep all
 		fts indexes consistent in sync_doc_id. */
 		err = fts_sync_table(const_cast<dict_table_t*>(new_table),
-				     false, true, false);
+				     true, false);
 
 		if (err == DB_SUCCESS) {
 			fts_update_next_doc_id(
@@ -2880,6 +2880,719 @@ row_merge_read_clustered_index(
 	DBUG_RETURN(err);
 }
 
+/** Shared state of a parallel clustered index scan in
+row_merge_read_clustered_index_parallel() */
+struct row_merge_scan_t {
+	/** transaction of the ALTER TABLE */
+	trx_t*			trx;
+	/** MySQL table object, for reporting duplicate keys */
+	struct TABLE*		table;
+	/** table whose clustered index is scanned */
+	const dict_table_t*	old_table;
+	/** whether the indexes are being created online */
+	bool			online;
+	/** whether to skip historical system rows */
+	bool			drop_historical;
+	/** indexes to be created */
+	dict_index_t**		index;
+	/** temporary files, one for each of index[] */
+	merge_file_t*		files;
+	/** number of indexes to be created */
+	ulint			n_index;
+	/** nonzero once a duplicate key was reported to table */
+	int32			dup_reported;
+	/** nonzero when some thread failed, so that the others
+	can stop early */
+	int32			aborted;
+	/** number of threads that have not finished */
+	ulint			n_running;
+	/** signalled when a thread finishes */
+	os_event_t		done;
+};
+
+/** A key range of the parallel clustered index scan */
+struct row_merge_scan_thread_t {
+	/** shared scan state */
+	row_merge_scan_t*	scan;
+	/** first key of the range, or NULL for the start of the index */
+	const dtuple_t*		low;
+	/** first key after the range, or NULL for the end of the index */
+	const dtuple_t*		high;
+	/** thread handle */
+	os_thread_id_t		thread_id;
+	/** error code */
+	dberr_t			error;
+	/** position in index[] of the index that failed, or 0 */
+	ulint			error_key;
+	/** number of entries written for each of index[] */
+	ib_uint64_t*		n_rec;
+	/** number of clustered index records read */
+	ib_uint64_t		n_rows;
+	/** number of clustered index leaf pages read */
+	ulint			n_pages;
+};
+
+/** Determine whether row_merge_read_clustered_index_parallel() can be used.
+@param[in]	old_table	table where rows are read from
+@param[in]	new_table	table where indexes are created
+@param[in]	index		indexes to be created
+@param[in]	n_index		number of indexes to be created
+@return whether the clustered index can be scanned by multiple threads */
+static
+bool
+row_merge_scan_is_parallel(
+	const dict_table_t*	old_table,
+	const dict_table_t*	new_table,
+	dict_index_t**		index,
+	ulint			n_index)
+{
+	/* Rebuilding the table must produce the PRIMARY KEY in order,
+	and full-text and spatial indexes are built by their own
+	threads or directly from the scan. */
+	if (srv_index_build_threads <= 1 || old_table != new_table) {
+		return(false);
+	}
+
+	for (ulint i = 0; i < n_index; i++) {
+		if ((index[i]->type & (DICT_FTS | DICT_SPATIAL))
+		    || dict_index_has_virtual(index[i])) {
+			return(false);
+		}
+	}
+
+	/* Do not bother splitting small tables. */
+	return(dict_table_get_first_index(old_table)->stat_n_leaf_pages
+	       >= 4 * srv_index_build_threads);
+}
+
+/** Split the clustered index into key ranges of roughly equal size,
+based on the node pointers of the highest B-tree level that has enough
+of them.
+@param[in,out]	index	clustered index
+@param[in]	n	desired number of ranges
+@param[in,out]	heap	memory heap for the boundaries
+@param[out]	bounds	n - 1 or fewer ascending range boundaries */
+static
+void
+row_merge_scan_bounds(
+	dict_index_t*	index,
+	ulint		n,
+	mem_heap_t*	heap,
+	std::vector<dtuple_t*, ut_allocator<dtuple_t*> >&	bounds)
+{
+	const ulint		n_uniq = dict_index_get_n_unique(index);
+	const page_size_t	page_size(dict_table_page_size(index->table));
+	std::vector<dtuple_t*, ut_allocator<dtuple_t*> >	keys;
+	mem_heap_t*		offsets_heap = NULL;
+	ulint*			offsets = NULL;
+	mtr_t			mtr;
+
+	bounds.clear();
+
+	mtr.start();
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+	ulint		savepoint = mtr_set_savepoint(&mtr);
+	buf_block_t*	block = btr_root_block_get(index, RW_S_LATCH, &mtr);
+	ulint		level = btr_page_get_level(buf_block_get_frame(block));
+
+	while (level > 0) {
+		ulint	child_page_no = FIL_NULL;
+
+		keys.clear();
+
+		for (;;) {
+			const page_t*	page = buf_block_get_frame(block);
+			const bool	comp = page_is_comp(page);
+
+			for (const rec_t* rec = page_rec_get_next_const(
+				     page_get_infimum_rec(page));
+			     !page_rec_is_supremum(rec);
+			     rec = page_rec_get_next_const(rec)) {
+				offsets = rec_get_offsets(
+					rec, index, offsets, false,
+					ULINT_UNDEFINED, &offsets_heap);
+
+				if (child_page_no == FIL_NULL) {
+					child_page_no
+						= btr_node_ptr_get_child_page_no(
+							rec, offsets);
+				}
+
+				if (rec_get_info_bits(rec, comp)
+				    & REC_INFO_MIN_REC_FLAG) {
+					continue;
+				}
+
+				keys.push_back(dict_index_build_data_tuple(
+						       rec, index, false,
+						       n_uniq, heap));
+			}
+
+			ulint	next_page_no = btr_page_get_next(page, &mtr);
+
+			mtr_release_block_at_savepoint(&mtr, savepoint, block);
+
+			if (next_page_no == FIL_NULL) {
+				break;
+			}
+
+			savepoint = mtr_set_savepoint(&mtr);
+			block = btr_block_get(
+				page_id_t(index->space, next_page_no),
+				page_size, RW_S_LATCH, index, &mtr);
+		}
+
+		/* Stop at the level above the leaf pages, or at the
+		first level that allows reasonably even ranges. */
+		if (--level == 0 || keys.size() >= 16 * n) {
+			break;
+		}
+
+		savepoint = mtr_set_savepoint(&mtr);
+		block = btr_block_get(page_id_t(index->space, child_page_no),
+				      page_size, RW_S_LATCH, index, &mtr);
+	}
+
+	mtr.commit();
+
+	if (offsets_heap != NULL) {
+		mem_heap_free(offsets_heap);
+	}
+
+	if (keys.size() < n) {
+		n = keys.size() + 1;
+	}
+
+	for (ulint i = 1; i < n; i++) {
+		bounds.push_back(keys[i * keys.size() / n]);
+	}
+}
+
+/** Write the sorted contents of a merge buffer as a run of its own
+to the temporary file shared by the scan threads.
+@param[in,out]	thr		scan thread
+@param[in]	i		position of the index in index[]
+@param[in,out]	buf		merge buffer
+@param[out]	block		file buffer
+@param[out]	crypt_block	encrypted file buffer, or NULL
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_scan_write(
+	row_merge_scan_thread_t*	thr,
+	ulint				i,
+	row_merge_buf_t*		buf,
+	row_merge_block_t*		block,
+	row_merge_block_t*		crypt_block)
+{
+	row_merge_scan_t*	scan = thr->scan;
+	merge_file_t*		file = &scan->files[i];
+
+	if (dict_index_is_unique(buf->index)) {
+		/* Only count the duplicates here; n_dup=1 prevents
+		row_merge_dup_report() from touching scan->table. */
+		row_merge_dup_t	dup = {buf->index, NULL, NULL, 1};
+
+		row_merge_buf_sort(buf, &dup);
+
+		if (dup.n_dup > 1) {
+			int32	reported = 0;
+
+			if (my_atomic_cas32(&scan->dup_reported,
+					    &reported, 1)) {
+				/* Sort again, so that the first duplicate
+				is reported to the SQL layer by exactly
+				one thread. */
+				row_merge_dup_t	report = {
+					buf->index, scan->table, NULL, 0};
+
+				row_merge_buf_sort(buf, &report);
+			}
+
+			thr->error_key = i;
+			return(DB_DUPLICATE_KEY);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	row_merge_buf_write(buf, file, block);
+
+	/* Each thread writes whole blocks, so every block is a sorted
+	run of its own for row_merge_sort(). */
+	ulint	offset = ulint(my_atomic_addlint(&file->offset, 1));
+
+	if (!row_merge_write(file->fd, offset, block, crypt_block,
+			     scan->old_table->space)) {
+		thr->error_key = i;
+		return(DB_TEMP_FILE_WRITE_FAIL);
+	}
+
+	UNIV_MEM_INVALID(&block[0], srv_sort_buf_size);
+	return(DB_SUCCESS);
+}
+
+/** Build a row for the indexes from a clustered index record
+in a parallel scan thread.
+@param[in]	scan		scan state
+@param[in]	rec		clustered index leaf page record
+@param[in]	offsets		rec_get_offsets(rec)
+@param[in,out]	mtr		mini-transaction holding a latch on rec
+@param[out]	ext		externally stored column prefixes
+@param[in,out]	heap	memory heap for the row
+@return the row, or NULL if the record is to be skipped */
+static
+const dtuple_t*
+row_merge_scan_build_row(
+	const row_merge_scan_t*	scan,
+	const rec_t*		rec,
+	ulint*			offsets,
+	mtr_t*			mtr,
+	row_ext_t**		ext,
+	mem_heap_t**		heap)
+{
+	const dict_table_t*	table = scan->old_table;
+	dict_index_t*		clust_index = dict_table_get_first_index(
+		table);
+	trx_t*			trx = scan->trx;
+
+	if (scan->online) {
+		/* Perform a REPEATABLE READ, like
+		row_merge_read_clustered_index() does. */
+		trx_id_t	rec_trx_id = row_get_rec_trx_id(
+			rec, clust_index, offsets);
+
+		ut_ad(trx->read_view.is_open());
+		ut_ad(rec_trx_id != trx->id);
+
+		if (!trx->read_view.changes_visible(rec_trx_id,
+						    table->name)) {
+			rec_t*	old_vers;
+
+			row_vers_build_for_consistent_read(
+				rec, mtr, clust_index, &offsets,
+				&trx->read_view, heap, *heap, &old_vers,
+				NULL);
+
+			if (!old_vers) {
+				return(NULL);
+			}
+
+			rec = old_vers;
+		}
+	}
+
+	/* Skip delete-marked records, as in
+	row_merge_read_clustered_index(). */
+	if (rec_get_deleted_flag(rec, dict_table_is_comp(table))) {
+		return(NULL);
+	}
+
+	if (scan->drop_historical && table->versioned()
+	    && clust_index->vers_history_row(rec, offsets)) {
+		return(NULL);
+	}
+
+	return(row_build_w_add_vcol(ROW_COPY_POINTERS, clust_index, rec,
+				    offsets, table, NULL, NULL, NULL,
+				    ext, *heap));
+}
+
+/** Scan a key range of the clustered index and write the index entries
+for the indexes to be created to the shared temporary files.
+@param[in,out]	thr	scan thread
+@return DB_SUCCESS or error code */
+static
+dberr_t
+row_merge_scan_range(
+	row_merge_scan_thread_t*	thr)
+{
+	row_merge_scan_t*	scan = thr->scan;
+	trx_t*			trx = scan->trx;
+	const dict_table_t*	table = scan->old_table;
+	dict_index_t*		clust_index = dict_table_get_first_index(
+		table);
+	const ulint		n_index = scan->n_index;
+	dberr_t			err = DB_SUCCESS;
+	mem_heap_t*		row_heap;
+	mem_heap_t*		v_heap = NULL;
+	btr_pcur_t		pcur;
+	mtr_t			mtr;
+	ut_new_pfx_t		block_pfx;
+	ut_new_pfx_t		crypt_pfx;
+	row_merge_block_t*	crypt_block = NULL;
+
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+	row_merge_block_t*	block = alloc.allocate_large(
+		srv_sort_buf_size, &block_pfx);
+
+	if (block == NULL) {
+		return(DB_OUT_OF_MEMORY);
+	}
+
+	if (log_tmp_is_encrypted()) {
+		crypt_block = alloc.allocate_large(
+			srv_sort_buf_size, &crypt_pfx);
+
+		if (crypt_block == NULL) {
+			alloc.deallocate_large(block, &block_pfx,
+					       srv_sort_buf_size);
+			return(DB_OUT_OF_MEMORY);
+		}
+	}
+
+	row_merge_buf_t**	merge_buf = static_cast<row_merge_buf_t**>(
+		ut_malloc_nokey(n_index * sizeof *merge_buf));
+
+	for (ulint i = 0; i < n_index; i++) {
+		merge_buf[i] = row_merge_buf_create(scan->index[i]);
+	}
+
+	row_heap = mem_heap_create(sizeof(mrec_buf_t));
+
+	mtr.start();
+
+	if (thr->low != NULL) {
+		btr_pcur_open(clust_index, thr->low, PAGE_CUR_L,
+			      BTR_SEARCH_LEAF, &pcur, &mtr);
+	} else {
+		btr_pcur_open_at_index_side(
+			true, clust_index, BTR_SEARCH_LEAF, &pcur, true, 0,
+			&mtr);
+	}
+
+	while (btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+
+		mem_heap_empty(row_heap);
+
+		if (rec_is_default_row(rec, clust_index)) {
+			/* Skip the 'default row' pseudo-record. */
+			continue;
+		}
+
+		ulint*	offsets = rec_get_offsets(
+			rec, clust_index, NULL, true, ULINT_UNDEFINED,
+			&row_heap);
+
+		if (thr->high != NULL
+		    && cmp_dtuple_rec(thr->high, rec, offsets) <= 0) {
+			break;
+		}
+
+		thr->n_rows++;
+
+		row_ext_t*	ext = NULL;
+		const dtuple_t*	row = row_merge_scan_build_row(
+			scan, rec, offsets, &mtr, &ext, &row_heap);
+
+		for (ulint i = 0; row != NULL && i < n_index; i++) {
+			row_merge_buf_t*	buf = merge_buf[i];
+			doc_id_t		doc_id = 0;
+			ulint			rows_added = row_merge_buf_add(
+				buf, NULL, table, table, NULL, row, ext,
+				&doc_id, NULL, &err, &v_heap, NULL, trx);
+
+			if (!rows_added) {
+				if (err != DB_SUCCESS) {
+					thr->error_key = i;
+					break;
+				}
+
+				/* The buffer is full. Write it out and
+				retry with an empty buffer. */
+				err = row_merge_scan_write(
+					thr, i, buf, block, crypt_block);
+
+				if (err != DB_SUCCESS) {
+					break;
+				}
+
+				merge_buf[i] = buf = row_merge_buf_empty(buf);
+
+				if (UNIV_UNLIKELY
+				    (!(rows_added = row_merge_buf_add(
+						buf, NULL, table, table, NULL,
+						row, ext, &doc_id, NULL, &err,
+						&v_heap, NULL, trx)))) {
+					/* An empty buffer should have enough
+					room for at least one record. */
+					ut_error;
+				}
+			}
+
+			if (err != DB_SUCCESS) {
+				thr->error_key = i;
+				break;
+			}
+
+			thr->n_rec[i] += rows_added;
+		}
+
+		if (v_heap) {
+			mem_heap_empty(v_heap);
+		}
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+
+		if (!page_rec_is_supremum(page_rec_get_next_const(
+						  btr_pcur_get_rec(&pcur)))) {
+			continue;
+		}
+
+		thr->n_pages++;
+
+		if (UNIV_UNLIKELY(trx_is_interrupted(trx))) {
+			err = DB_INTERRUPTED;
+			break;
+		}
+
+		if (my_atomic_load32_explicit(&scan->aborted,
+					      MY_MEMORY_ORDER_RELAXED)) {
+			/* Another thread failed; it reports the error. */
+			break;
+		}
+
+		if (my_atomic_load32_explicit(&clust_index->lock.waiters,
+					      MY_MEMORY_ORDER_RELAXED)) {
+			/* Let the waiters on the clustered index tree
+			lock proceed, as in
+			row_merge_read_clustered_index(). */
+			btr_pcur_store_position(&pcur, &mtr);
+			mtr.commit();
+			os_thread_yield();
+			mtr.start();
+			btr_pcur_restore_position(
+				BTR_SEARCH_LEAF, &pcur, &mtr);
+		}
+	}
+
+	mtr.commit();
+	btr_pcur_close(&pcur);
+
+	for (ulint i = 0; i < n_index; i++) {
+		if (err == DB_SUCCESS && merge_buf[i]->n_tuples) {
+			err = row_merge_scan_write(
+				thr, i, merge_buf[i], block, crypt_block);
+		}
+
+		row_merge_buf_free(merge_buf[i]);
+	}
+
+	ut_free(merge_buf);
+	mem_heap_free(row_heap);
+
+	if (v_heap) {
+		mem_heap_free(v_heap);
+	}
+
+	alloc.deallocate_large(block, &block_pfx, srv_sort_buf_size);
+
+	if (crypt_block) {
+		alloc.deallocate_large(crypt_block, &crypt_pfx,
+				       srv_sort_buf_size);
+	}
+
+	return(err);
+}
+
+/** Thread that scans one key range of the clustered index.
+@param[in,out]	arg	row_merge_scan_thread_t
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(row_merge_scan_thread)(void* arg)
+{
+	row_merge_scan_thread_t*	thr
+		= static_cast<row_merge_scan_thread_t*>(arg);
+	row_merge_scan_t*		scan = thr->scan;
+
+	thr->error = row_merge_scan_range(thr);
+
+	if (thr->error != DB_SUCCESS) {
+		my_atomic_store32(&scan->aborted, 1);
+	}
+
+	/* The waiting thread polls n_running, so that it will not
+	miss the wakeup, and scan is not accessed after it. */
+	os_event_set(scan->done);
+	my_atomic_addlint(&scan->n_running, -1);
+
+	os_thread_exit(false);
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Read the clustered index of the table with multiple threads, each
+scanning a key range, and create temporary files containing the index
+entries for the secondary indexes to be created.
+@param[in]	trx		transaction
+@param[in,out]	table		MySQL table object, for reporting erroneous
+				records
+@param[in]	old_table	table where rows are read from
+@param[in]	online		true if creating indexes online
+@param[in]	index		indexes to be created
+@param[in,out]	files		temporary files
+@param[in]	n_index		number of indexes to create
+@param[in,out]	tmpfd		temporary file handle
+@param[in,out]	stage		performance schema accounting object, used by
+ALTER TABLE. stage->n_pk_recs_inc() will be called for each record read and
+stage->inc() will be called for each page read.
+@param[in]	pct_cost	percent of task weight out of total alter job
+@param[in]	drop_historical	whether to drop historical system rows
+@return DB_SUCCESS or error */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_merge_read_clustered_index_parallel(
+	trx_t*			trx,
+	struct TABLE*		table,
+	const dict_table_t*	old_table,
+	bool			online,
+	dict_index_t**		index,
+	merge_file_t*		files,
+	ulint			n_index,
+	int*			tmpfd,
+	ut_stage_alter_t*	stage,
+	double			pct_cost,
+	bool			drop_historical)
+{
+	dict_index_t*	clust_index = dict_table_get_first_index(old_table);
+	const char*	path = thd_innodb_tmpdir(trx->mysql_thd);
+	dberr_t		err = DB_SUCCESS;
+
+	DBUG_ENTER("row_merge_read_clustered_index_parallel");
+
+	ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
+	ut_ad(trx->id);
+
+	trx->op_info = "reading clustered index";
+
+	for (ulint i = 0; i < n_index; i++) {
+		if (row_merge_file_create_if_needed(
+			    &files[i], tmpfd, 0, path) < 0) {
+			trx->error_key_num = i;
+			DBUG_RETURN(DB_OUT_OF_MEMORY);
+		}
+	}
+
+	mem_heap_t*	heap = mem_heap_create(1024);
+	std::vector<dtuple_t*, ut_allocator<dtuple_t*> >	bounds;
+
+	row_merge_scan_bounds(clust_index, srv_index_build_threads,
+			      heap, bounds);
+
+	const ulint	n_threads = bounds.size() + 1;
+
+	row_merge_scan_t	scan;
+	scan.trx = trx;
+	scan.table = table;
+	scan.old_table = old_table;
+	scan.online = online;
+	scan.drop_historical = drop_historical;
+	scan.index = index;
+	scan.files = files;
+	scan.n_index = n_index;
+	scan.dup_reported = 0;
+	scan.aborted = 0;
+	scan.n_running = n_threads;
+	scan.done = os_event_create(0);
+
+	row_merge_scan_thread_t*	thr
+		= static_cast<row_merge_scan_thread_t*>(
+			mem_heap_zalloc(heap, n_threads * sizeof *thr));
+
+	for (ulint t = 0; t < n_threads; t++) {
+		thr[t].scan = &scan;
+		thr[t].low = t ? bounds[t - 1] : NULL;
+		thr[t].high = t < bounds.size() ? bounds[t] : NULL;
+		thr[t].error = DB_SUCCESS;
+		thr[t].n_rec = static_cast<ib_uint64_t*>(
+			mem_heap_zalloc(heap, n_index * sizeof *thr[t].n_rec));
+	}
+
+	for (ulint t = 0; t < n_threads; t++) {
+		os_thread_create(row_merge_scan_thread, &thr[t],
+				 &thr[t].thread_id);
+	}
+
+	my_atomic_addlint(&onlineddl_parallel_scan_threads, n_threads);
+
+	for (;;) {
+		int64_t	sig_count = os_event_reset(scan.done);
+
+		if (!my_atomic_loadlint(&scan.n_running)) {
+			break;
+		}
+
+		os_event_wait_time_low(scan.done, 100000, sig_count);
+	}
+
+	for (ulint t = 0; t < n_threads; t++) {
+		os_thread_join(thr[t].thread_id);
+	}
+
+	os_event_destroy(scan.done);
+
+	for (ulint t = 0; t < n_threads; t++) {
+		for (ulint i = 0; i < n_index; i++) {
+			files[i].n_rec += thr[t].n_rec[i];
+		}
+
+		for (ulint p = thr[t].n_pages; p--; ) {
+			stage->inc();
+		}
+
+		for (ib_uint64_t r = thr[t].n_rows; r--; ) {
+			stage->n_pk_recs_inc();
+		}
+
+		if (err == DB_SUCCESS && thr[t].error != DB_SUCCESS) {
+			err = thr[t].error;
+			trx->error_key_num = thr[t].error_key;
+		}
+	}
+
+	mem_heap_free(heap);
+	trx->op_info = "";
+
+	if (err != DB_SUCCESS) {
+		DBUG_RETURN(err);
+	}
+
+	for (ulint i = 0; i < n_index; i++) {
+		if (!files[i].offset) {
+			/* The index is empty. */
+			row_merge_file_destroy(&files[i]);
+		}
+
+		if (online) {
+			/* Note the newest transaction that modified this
+			index when the scan was completed, as in
+			row_merge_read_clustered_index(). */
+			rw_lock_x_lock(dict_index_get_lock(index[i]));
+			ut_a(dict_index_get_online_status(index[i])
+			     == ONLINE_INDEX_CREATION);
+
+			trx_id_t	max_trx_id = row_log_get_max_trx(
+				index[i]);
+
+			if (max_trx_id > index[i]->trx_id) {
+				index[i]->trx_id = max_trx_id;
+			}
+
+			rw_lock_x_unlock(dict_index_get_lock(index[i]));
+		}
+	}
+
+	/* presenting 10.12% as 1012 integer */
+	onlineddl_pct_progress = (ulint) (pct_cost * 100);
+
+	DBUG_RETURN(DB_SUCCESS);
+}
+
 /** Write a record via buffer 2 and read the next record to buffer N.
 @param N number of the buffer (0 or 1)
 @param INDEX record descriptor
@@ -3357,7 +4070,7 @@ row_merge_sort(
 	*/
 #ifndef UNIV_SOLARIS
 	/* Progress report only for "normal" indexes. */
-	if (!(dup->index->type & DICT_FTS)) {
+	if (update_progress && !(dup->index->type & DICT_FTS)) {
 		thd_progress_init(trx->mysql_thd, 1);
 	}
 #endif /* UNIV_SOLARIS */
@@ -3374,7 +4087,8 @@ row_merge_sort(
 		show processlist progress field */
 		/* Progress report only for "normal" indexes. */
 #ifndef UNIV_SOLARIS
-		if (!(dup->index->type & DICT_FTS)) {
+		if (update_progress
+		    && !(dup->index->type & DICT_FTS)) {
 			thd_progress_report(trx->mysql_thd, file->offset - num_runs, file->offset);
 		}
 #endif /* UNIV_SOLARIS */
@@ -3401,9 +4115,10 @@ row_merge_sort(
 
 	ut_free(run_offset);
 
-	/* Progress report only for "normal" indexes. */
+	/* Progress report only for "normal" indexes, and not from
+	row_merge_load_thread(), which does not own trx->mysql_thd. */
 #ifndef UNIV_SOLARIS
-	if (!(dup->index->type & DICT_FTS)) {
+	if (update_progress && !(dup->index->type & DICT_FTS)) {
 		thd_progress_end(trx->mysql_thd);
 	}
 #endif /* UNIV_SOLARIS */
@@ -4567,6 +5282,259 @@ row_merge_write_redo(
 	mtr.commit();
 }
 
+/** Secondary indexes that are sorted and bulk loaded by
+row_merge_load_thread() while row_merge_build_indexes() builds the rest */
+struct row_merge_load_t {
+	/** transaction of the ALTER TABLE */
+	trx_t*			trx;
+	/** table where rows are read from */
+	const dict_table_t*	old_table;
+	/** table where indexes are created */
+	const dict_table_t*	new_table;
+	/** indexes to be created */
+	dict_index_t**		indexes;
+	/** temporary files, one for each of indexes[] */
+	merge_file_t*		files;
+	/** flush observer of the bulk load, or NULL */
+	FlushObserver*		flush_observer;
+	/** progress percent when the threads were started */
+	double			pct_progress;
+	/** positions in indexes[] that are built by the threads */
+	ulint*			owned;
+	/** number of elements in owned[] */
+	ulint			n_owned;
+	/** whether indexes[i] is built by the threads */
+	bool*			is_owned;
+	/** error code for each of indexes[] */
+	dberr_t*		error;
+	/** position of the next owned[] element to build */
+	ulint			next;
+	/** thread handles */
+	os_thread_id_t*		thread_ids;
+	/** number of threads */
+	ulint			n_threads;
+	/** number of threads that have not finished */
+	ulint			n_running;
+	/** signalled when a thread finishes */
+	os_event_t		done;
+	/** memory heap for this object */
+	mem_heap_t*		heap;
+};
+
+/** Thread that sorts and bulk loads secondary indexes of
+row_merge_load_t::owned[] until none are left.
+@param[in,out]	arg	row_merge_load_t
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(row_merge_load_thread)(void* arg)
+{
+	row_merge_load_t*	load = static_cast<row_merge_load_t*>(arg);
+	const size_t		block_size = 3 * srv_sort_buf_size;
+	ut_new_pfx_t		block_pfx;
+	ut_new_pfx_t		crypt_pfx;
+	row_merge_block_t*	crypt_block = NULL;
+	int			tmpfd = -1;
+	bool			oom;
+
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+
+	row_merge_block_t*	block = alloc.allocate_large(
+		block_size, &block_pfx);
+
+	oom = block == NULL;
+
+	if (!oom && log_tmp_is_encrypted()) {
+		crypt_block = alloc.allocate_large(block_size, &crypt_pfx);
+		oom = crypt_block == NULL;
+	}
+
+	for (;;) {
+		ulint	k = my_atomic_addlint(&load->next, 1);
+
+		if (k >= load->n_owned) {
+			break;
+		}
+
+		const ulint	i = load->owned[k];
+		dict_index_t*	sort_idx = load->indexes[i];
+		merge_file_t*	file = &load->files[i];
+		dberr_t		error = DB_OUT_OF_MEMORY;
+
+		if (!oom) {
+			/* The index is not unique, so that no duplicates
+			can be reported. */
+			row_merge_dup_t	dup = {sort_idx, NULL, NULL, 0};
+
+			error = row_merge_sort(
+				load->trx, &dup, file, block, &tmpfd, false,
+				0, 0, crypt_block, load->new_table->space,
+				NULL);
+		}
+
+		if (error == DB_SUCCESS) {
+			BtrBulk	btr_bulk(sort_idx, load->trx->id,
+					 load->flush_observer);
+			btr_bulk.init();
+
+			error = row_merge_insert_index_tuples(
+				sort_idx, load->old_table, file->fd, block,
+				NULL, &btr_bulk, file->n_rec,
+				load->pct_progress, 0, crypt_block,
+				load->new_table->space);
+
+			error = btr_bulk.finish(error);
+		}
+
+		load->error[i] = error;
+	}
+
+	row_merge_file_destroy_low(tmpfd);
+
+	if (block) {
+		alloc.deallocate_large(block, &block_pfx, block_size);
+	}
+
+	if (crypt_block) {
+		alloc.deallocate_large(crypt_block, &crypt_pfx, block_size);
+	}
+
+	/* The waiting thread polls n_running, so that it will not
+	miss the wakeup, and load is not accessed after it. */
+	os_event_set(load->done);
+	my_atomic_addlint(&load->n_running, -1);
+
+	os_thread_exit(false);
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/** Start sorting and bulk loading the non-unique secondary indexes
+in background threads, so that they are built in parallel with each
+other and with the indexes that row_merge_build_indexes() builds itself.
+@param[in]	trx		transaction
+@param[in]	old_table	table where rows are read from
+@param[in]	new_table	table where indexes are created
+@param[in]	indexes		indexes to be created
+@param[in]	files		temporary files, one for each of indexes[]
+@param[in]	n_indexes	number of indexes to be created
+@param[in]	flush_observer	flush observer of the bulk load, or NULL
+@param[in]	pct_progress	total progress percent until now
+@return the threads, or NULL if the indexes are not worth building
+in parallel */
+static
+row_merge_load_t*
+row_merge_load_start(
+	trx_t*			trx,
+	const dict_table_t*	old_table,
+	const dict_table_t*	new_table,
+	dict_index_t**		indexes,
+	merge_file_t*		files,
+	ulint			n_indexes,
+	FlushObserver*		flush_observer,
+	double			pct_progress)
+{
+	ulint	n_sorted = 0;
+	ulint	n_owned = 0;
+
+	if (srv_index_build_threads <= 1) {
+		return(NULL);
+	}
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		if (files[i].fd < 0
+		    || (indexes[i]->type & (DICT_FTS | DICT_SPATIAL))) {
+			continue;
+		}
+
+		n_sorted++;
+
+		if (!dict_index_is_unique(indexes[i])) {
+			/* Duplicates of unique indexes are reported
+			to the SQL layer, which is only safe from the
+			thread that executes the ALTER TABLE. */
+			n_owned++;
+		}
+	}
+
+	if (n_sorted < 2 || n_owned == 0) {
+		return(NULL);
+	}
+
+	mem_heap_t*		heap = mem_heap_create(1024);
+	row_merge_load_t*	load = static_cast<row_merge_load_t*>(
+		mem_heap_zalloc(heap, sizeof *load));
+
+	load->heap = heap;
+	load->trx = trx;
+	load->old_table = old_table;
+	load->new_table = new_table;
+	load->indexes = indexes;
+	load->files = files;
+	load->flush_observer = flush_observer;
+	load->pct_progress = pct_progress;
+	load->owned = static_cast<ulint*>(
+		mem_heap_alloc(heap, n_owned * sizeof *load->owned));
+	load->is_owned = static_cast<bool*>(
+		mem_heap_zalloc(heap, n_indexes * sizeof *load->is_owned));
+	load->error = static_cast<dberr_t*>(
+		mem_heap_alloc(heap, n_indexes * sizeof *load->error));
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		load->error[i] = DB_SUCCESS;
+
+		if (files[i].fd >= 0
+		    && !(indexes[i]->type & (DICT_FTS | DICT_SPATIAL))
+		    && !dict_index_is_unique(indexes[i])) {
+			load->owned[load->n_owned++] = i;
+			load->is_owned[i] = true;
+		}
+	}
+
+	ut_ad(load->n_owned == n_owned);
+
+	load->n_threads = ut_min(ulint(srv_index_build_threads), n_owned);
+	load->n_running = load->n_threads;
+	load->done = os_event_create(0);
+	load->thread_ids = static_cast<os_thread_id_t*>(
+		mem_heap_alloc(heap, load->n_threads
+			       * sizeof *load->thread_ids));
+
+	for (ulint t = 0; t < load->n_threads; t++) {
+		os_thread_create(row_merge_load_thread, load,
+				 &load->thread_ids[t]);
+	}
+
+	return(load);
+}
+
+/** Wait for the threads of row_merge_load_start() to finish.
+@param[in,out]	load	threads */
+static
+void
+row_merge_load_wait(row_merge_load_t* load)
+{
+	if (load->done == NULL) {
+		return;
+	}
+
+	for (;;) {
+		int64_t	sig_count = os_event_reset(load->done);
+
+		if (!my_atomic_loadlint(&load->n_running)) {
+			break;
+		}
+
+		os_event_wait_time_low(load->done, 100000, sig_count);
+	}
+
+	for (ulint t = 0; t < load->n_threads; t++) {
+		os_thread_join(load->thread_ids[t]);
+	}
+
+	os_event_destroy(load->done);
+	load->done = NULL;
+}
+
 /** Build indexes on a table by reading a clustered index, creating a temporary
 file containing index entries, merge sorting these index entries and inserting
 sorted index entries to indexes.
@@ -4631,6 +5599,7 @@ row_merge_build_indexes(
 	fts_psort_t*		merge_info = NULL;
 	int64_t			sig_count = 0;
 	bool			fts_psort_initiated = false;
+	row_merge_load_t*	load = NULL;
 
 	double total_static_cost = 0;
 	double total_dynamic_cost = 0;
@@ -4773,12 +5742,20 @@ row_merge_build_indexes(
 
 	/* Read clustered index of the table and create files for
 	secondary index entries for merge sort */
-	error = row_merge_read_clustered_index(
-		trx, table, old_table, new_table, online, indexes,
-		fts_sort_idx, psort_info, merge_files, key_numbers,
-		n_indexes, add_cols, add_v, col_map, add_autoinc,
-		sequence, block, skip_pk_sort, &tmpfd, stage,
-		pct_cost, crypt_block, eval_table, drop_historical);
+	if (row_merge_scan_is_parallel(old_table, new_table,
+				       indexes, n_indexes)) {
+		error = row_merge_read_clustered_index_parallel(
+			trx, table, old_table, online, indexes,
+			merge_files, n_indexes, &tmpfd, stage,
+			pct_cost, drop_historical);
+	} else {
+		error = row_merge_read_clustered_index(
+			trx, table, old_table, new_table, online, indexes,
+			fts_sort_idx, psort_info, merge_files, key_numbers,
+			n_indexes, add_cols, add_v, col_map, add_autoinc,
+			sequence, block, skip_pk_sort, &tmpfd, stage,
+			pct_cost, crypt_block, eval_table, drop_historical);
+	}
 
 	stage->end_phase_read_pk();
 
@@ -4803,6 +5780,10 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
+	load = row_merge_load_start(trx, old_table, new_table, indexes,
+				    merge_files, n_indexes, flush_observer,
+				    pct_progress);
+
 	for (i = 0; i < n_indexes; i++) {
 		dict_index_t*	sort_idx = indexes[i];
 
@@ -4882,6 +5863,11 @@ row_merge_build_indexes(
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
+		} else if (load != NULL && load->is_owned[i]) {
+			/* The index was sorted and loaded by
+			row_merge_load_thread(). */
+			row_merge_load_wait(load);
+			error = load->error[i];
 		} else if (merge_files[i].fd >= 0) {
 			char	buf[NAME_LEN + 1];
 			row_merge_dup_t	dup = {
@@ -4993,6 +5979,11 @@ row_merge_build_indexes(
 					"InnoDB: Online DDL : Applying"
 					" log to index");
 			}
+			/* Do not flush while pages of the other
+			indexes are still being bulk loaded. */
+			if (load != NULL) {
+				row_merge_load_wait(load);
+			}
 			flush_observer->flush();
 			row_merge_write_redo(indexes[i]);
 
@@ -5019,6 +6010,11 @@ row_merge_build_indexes(
 		error = DB_TOO_MANY_CONCURRENT_TRXS;
 		trx->error_state = error;);
 
+	if (load != NULL) {
+		row_merge_load_wait(load);
+		mem_heap_free(load->heap);
+	}
+
 	if (fts_psort_initiated) {
 		/* Clean up FTS psort related resource */
 		row_fts_psort_info_destroy(psort_info, merge_info);
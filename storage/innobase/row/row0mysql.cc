@@ -158,6 +158,27 @@ row_mysql_prebuilt_free_blob_heap(
 	DBUG_VOID_RETURN;
 }
 
+/** Free the prefetch cache of a table handle.
+@param[in,out]	prebuilt	prebuilt struct of a ha_innobase:: table
+handle, with no rows in the prefetch cache */
+void
+row_mysql_prebuilt_free_fetch_cache(row_prebuilt_t* prebuilt)
+{
+	ut_ad(prebuilt->n_fetch_cached == 0);
+
+	byte*	base = prebuilt->fetch_cache - 4;
+
+	ut_a(mach_read_from_4(base) == ROW_PREBUILT_FETCH_MAGIC_N);
+	ut_a(mach_read_from_4(prebuilt->fetch_cache
+			      + prebuilt->fetch_cache_alloc
+			      * prebuilt->mysql_row_len)
+	     == ROW_PREBUILT_FETCH_MAGIC_N);
+
+	ut_free(base);
+	prebuilt->fetch_cache = NULL;
+	prebuilt->fetch_cache_alloc = 0;
+}
+
 /*******************************************************************//**
 Stores a >= 5.0.3 format true VARCHAR length to dest, in the MySQL row
 format.
@@ -911,6 +932,8 @@ row_create_prebuilt(
 
 	prebuilt->sql_stat_start = TRUE;
 	prebuilt->heap = heap;
+	prebuilt->fetch_cache_size = MYSQL_FETCH_CACHE_SIZE;
+	prebuilt->clust_read_ahead_page = FIL_NULL;
 
 	prebuilt->srch_key_val_len = srch_key_len;
 	if (prebuilt->srch_key_val_len) {
@@ -1008,25 +1031,9 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	if (prebuilt->fetch_cache[0] != NULL) {
-		byte*	base = prebuilt->fetch_cache[0] - 4;
-		byte*	ptr = base;
-
-		for (ulint i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-			ulint	magic1 = mach_read_from_4(ptr);
-			ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
-			ptr += 4;
-
-			byte*	row = ptr;
-			ut_a(row == prebuilt->fetch_cache[i]);
-			ptr += prebuilt->mysql_row_len;
-
-			ulint	magic2 = mach_read_from_4(ptr);
-			ut_a(magic2 == ROW_PREBUILT_FETCH_MAGIC_N);
-			ptr += 4;
-		}
-
-		ut_free(base);
+	if (prebuilt->fetch_cache != NULL) {
+		prebuilt->n_fetch_cached = 0;
+		row_mysql_prebuilt_free_fetch_cache(prebuilt);
 	}
 
 	if (prebuilt->rtr_info) {
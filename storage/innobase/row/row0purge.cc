@@ -1184,8 +1184,13 @@ row_purge_step(
 
 		node->roll_ptr = purge_rec->roll_ptr;
 
+		uintmax_t	start_time = ut_time_us(NULL);
+
 		row_purge(node, purge_rec->undo_rec, thr);
 
+		node->purge_time += ut_time_us(NULL) - start_time;
+		node->n_purged++;
+
 		if (ib_vector_is_empty(node->undo_recs)) {
 			row_purge_end(thr);
 		} else {
@@ -52,6 +52,7 @@ Created 12/19/1997 Heikki Tuuri
 #include "pars0pars.h"
 #include "row0mysql.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
 #include "srv0srv.h"
 #include "ha_prototypes.h"
 #include "srv0mon.h"
@@ -3497,6 +3498,165 @@ row_sel_get_clust_rec_for_mysql(
 	return(err);
 }
 
+/** Read ahead the clustered index leaf page of a row reference.
+@param[in]	clust_index	clustered index
+@param[in]	ref		row reference
+@param[in,out]	prev		child page number of the previous call,
+or FIL_NULL
+@return whether a read was initiated */
+static
+bool
+row_sel_read_ahead_clust_leaf(
+	dict_index_t*		clust_index,
+	const dtuple_t*		ref,
+	ulint*			prev)
+{
+	mtr_t		mtr;
+	mem_heap_t*	heap		= NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets		= offsets_;
+	bool		read		= false;
+	const page_size_t page_size(dict_table_page_size(clust_index->table));
+	rec_offs_init(offsets_);
+
+	mtr.start();
+	/* Descend like a BTR_SEARCH_LEAF search, but stop at level 1 and
+	only initiate the read of the leaf page. */
+	mtr_s_lock(dict_index_get_lock(clust_index), &mtr);
+
+	for (buf_block_t* block = btr_root_block_get(
+		     clust_index, RW_S_LATCH, &mtr);
+	     block != NULL && !page_is_leaf(block->frame); ) {
+		page_cur_t	cur;
+		ulint		up_match = 0;
+		ulint		low_match = 0;
+
+		page_cur_search_with_match(block, clust_index, ref,
+					   PAGE_CUR_LE, &up_match, &low_match,
+					   &cur, NULL);
+
+		const rec_t*	node_ptr = page_cur_get_rec(&cur);
+
+		if (page_rec_is_infimum(node_ptr)) {
+			node_ptr = page_rec_get_next_const(node_ptr);
+		}
+
+		if (!page_rec_is_user_rec(node_ptr)) {
+			break;
+		}
+
+		offsets = rec_get_offsets(node_ptr, clust_index, offsets,
+					  false, ULINT_UNDEFINED, &heap);
+
+		const page_id_t	child(block->page.id.space(),
+				      btr_node_ptr_get_child_page_no(
+					      node_ptr, offsets));
+
+		if (btr_page_get_level(block->frame) > 1) {
+			block = btr_block_get(child, page_size, RW_S_LATCH,
+					      clust_index, &mtr);
+			continue;
+		}
+
+		if (child.page_no() != *prev && !buf_page_peek(child)) {
+			buf_read_page_background(child, page_size, false);
+			read = true;
+		}
+
+		*prev = child.page_no();
+		break;
+	}
+
+	mtr.commit();
+
+	if (UNIV_LIKELY_NULL(heap)) {
+		mem_heap_free(heap);
+	}
+
+	return(read);
+}
+
+/** Ordering of clustered index record references by the PRIMARY KEY,
+for row_sel_read_ahead_clust() */
+struct row_sel_ref_less {
+	/** @return whether a sorts before b */
+	bool operator()(const dtuple_t* a, const dtuple_t* b) const
+	{
+		return(dtuple_coll_cmp(a, b) < 0);
+	}
+};
+
+/** Read ahead the clustered index leaf pages of the records that follow
+a secondary index record on its page, in the order of the PRIMARY KEY.
+The rows are then looked up one at a time in the order of the secondary
+index, and the lookups find the leaf pages in the buffer pool instead
+of waiting for one random read after another.
+@param[in,out]	prebuilt	prebuilt struct in the handle
+@param[in]	sec_index	secondary index
+@param[in]	rec		secondary index record that is about to be
+looked up; its page must be latched
+@param[in]	moves_up	whether the scan is in ascending order */
+static
+void
+row_sel_read_ahead_clust(
+	row_prebuilt_t*		prebuilt,
+	const dict_index_t*	sec_index,
+	const rec_t*		rec,
+	bool			moves_up)
+{
+	dict_index_t*		clust_index
+		= dict_table_get_first_index(sec_index->table);
+	const ulint		n_uniq = dict_index_get_n_unique(clust_index);
+	const ulint		n_max = srv_batched_lookup_size;
+	mem_heap_t*		heap = mem_heap_create(
+		n_max * (sizeof(dtuple_t*) + DTUPLE_EST_ALLOC(n_uniq)));
+	dtuple_t**		refs = static_cast<dtuple_t**>(
+		mem_heap_alloc(heap, n_max * sizeof *refs));
+	ulint*			offsets = NULL;
+	ulint			n = 0;
+
+	prebuilt->clust_read_ahead_page = page_get_page_no(page_align(rec));
+
+	/* The references point to the records of the latched page. */
+	while (n < n_max && page_rec_is_user_rec(rec)) {
+		offsets = rec_get_offsets(rec, sec_index, offsets, true,
+					  ULINT_UNDEFINED, &heap);
+
+		dtuple_t*	ref = dtuple_create(heap, n_uniq);
+		dict_index_copy_types(ref, clust_index, n_uniq);
+		row_build_row_ref_in_tuple(ref, rec, sec_index, offsets,
+					   prebuilt->trx);
+		refs[n++] = ref;
+
+		rec = moves_up
+			? page_rec_get_next_const(rec)
+			: page_rec_get_prev_const(rec);
+	}
+
+	if (n > 1) {
+		std::sort(refs, refs + n, row_sel_ref_less());
+
+		ulint	prev = FIL_NULL;
+		ulint	n_reads = 0;
+
+		for (ulint i = 0; i < n; i++) {
+			n_reads += row_sel_read_ahead_clust_leaf(
+				clust_index, refs[i], &prev);
+		}
+
+		if (n_reads) {
+			os_aio_simulated_wake_handler_threads();
+			srv_stats.n_sec_rec_cluster_read_aheads.add(n_reads);
+		} else {
+			/* The rows are in the buffer pool. Avoid the
+			overhead for the rest of the scan. */
+			prebuilt->clust_read_ahead_off = true;
+		}
+	}
+
+	mem_heap_free(heap);
+}
+
 /********************************************************************//**
 Restores cursor position after it has been stored. We have to take into
 account that the record cursor was positioned on may have been deleted.
@@ -3670,6 +3830,18 @@ row_sel_copy_cached_fields_for_mysql(
 	}
 }
 
+/** Get a row buffer of the prefetch cache.
+@param[in]	prebuilt	prebuilt struct
+@param[in]	i		row number in the cache
+@return row buffer of mysql_row_len bytes */
+UNIV_INLINE
+byte*
+row_sel_fetch_cache_row(const row_prebuilt_t* prebuilt, ulint i)
+{
+	ut_ad(i < prebuilt->fetch_cache_alloc);
+	return(prebuilt->fetch_cache + i * prebuilt->mysql_row_len);
+}
+
 /********************************************************************//**
 Pops a cached row for MySQL from the fetch cache. */
 UNIV_INLINE
@@ -3688,7 +3860,8 @@ row_sel_dequeue_cached_row_for_mysql(
 
 	UNIV_MEM_ASSERT_W(buf, prebuilt->mysql_row_len);
 
-	cached_rec = prebuilt->fetch_cache[prebuilt->fetch_cache_first];
+	cached_rec = row_sel_fetch_cache_row(prebuilt,
+					     prebuilt->fetch_cache_first);
 
 	if (UNIV_UNLIKELY(prebuilt->keep_other_fields_on_keyread)) {
 		row_sel_copy_cached_fields_for_mysql(buf, cached_rec, prebuilt);
@@ -3728,36 +3901,50 @@ row_sel_dequeue_cached_row_for_mysql(
 }
 
 /********************************************************************//**
-Initialise the prefetch cache. */
+Initialise the prefetch cache for fetch_cache_size rows. */
 UNIV_INLINE
 void
 row_sel_prefetch_cache_init(
 /*========================*/
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
-	ulint	i;
-	ulint	sz;
-	byte*	ptr;
+	ut_ad(prebuilt->n_fetch_cached == 0);
 
-	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
-	ptr = static_cast<byte*>(ut_malloc_nokey(sz));
+	if (prebuilt->fetch_cache != NULL) {
+		row_mysql_prebuilt_free_fetch_cache(prebuilt);
+	}
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	/* Reserve space for the magic numbers. A user has reported
+	memory corruption in these buffers in Linux. Put magic numbers
+	there to help to track a possible bug. */
+	byte*	ptr = static_cast<byte*>(ut_malloc_nokey(
+		prebuilt->fetch_cache_size * prebuilt->mysql_row_len + 8));
 
-		/* A user has reported memory corruption in these
-		buffers in Linux. Put magic numbers there to help
-		to track a possible bug. */
+	mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
+	ptr += 4;
 
-		mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
-		ptr += 4;
+	prebuilt->fetch_cache = ptr;
+	prebuilt->fetch_cache_alloc = prebuilt->fetch_cache_size;
 
-		prebuilt->fetch_cache[i] = ptr;
-		ptr += prebuilt->mysql_row_len;
+	mach_write_to_4(ptr + prebuilt->fetch_cache_alloc
+			* prebuilt->mysql_row_len, ROW_PREBUILT_FETCH_MAGIC_N);
+}
 
-		mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
-		ptr += 4;
-	}
+/** Grow the batch size of the prefetch cache after the scan consumed
+a whole batch.
+@param[in,out]	prebuilt	prebuilt struct */
+UNIV_INLINE
+void
+row_sel_prefetch_cache_grow(row_prebuilt_t* prebuilt)
+{
+	ulint	max_size = MYSQL_FETCH_CACHE_MAX_BYTES
+		/ std::max<ulint>(prebuilt->mysql_row_len, 1);
+
+	max_size = std::min<ulint>(max_size, MYSQL_FETCH_CACHE_MAX_SIZE);
+	max_size = std::max<ulint>(max_size, MYSQL_FETCH_CACHE_SIZE);
+
+	prebuilt->fetch_cache_size = std::min(
+		2 * prebuilt->fetch_cache_size, max_size);
 }
 
 /********************************************************************//**
@@ -3770,9 +3957,9 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
+	if (prebuilt->fetch_cache_alloc < prebuilt->fetch_cache_size) {
 		/* Allocate memory for the fetch cache */
 		ut_ad(prebuilt->n_fetch_cached == 0);
 
@@ -3780,10 +3967,13 @@ row_sel_fetch_last_buf(
 	}
 
 	ut_ad(prebuilt->fetch_cache_first == 0);
-	UNIV_MEM_INVALID(prebuilt->fetch_cache[prebuilt->n_fetch_cached],
-			 prebuilt->mysql_row_len);
 
-	return(prebuilt->fetch_cache[prebuilt->n_fetch_cached]);
+	byte*	buf = row_sel_fetch_cache_row(prebuilt,
+					      prebuilt->n_fetch_cached);
+
+	UNIV_MEM_INVALID(buf, prebuilt->mysql_row_len);
+
+	return(buf);
 }
 
 /********************************************************************//**
@@ -4142,6 +4332,9 @@ row_search_mvcc(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_size = MYSQL_FETCH_CACHE_SIZE;
+		prebuilt->clust_read_ahead_page = FIL_NULL;
+		prebuilt->clust_read_ahead_off = false;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -4166,6 +4359,7 @@ row_search_mvcc(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_size = MYSQL_FETCH_CACHE_SIZE;
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_dequeue_cached_row_for_mysql(buf, prebuilt);
@@ -4177,7 +4371,8 @@ row_search_mvcc(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_size) {
 
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -4187,6 +4382,12 @@ row_search_mvcc(
 			goto func_exit;
 		}
 
+		if (prebuilt->n_rows_fetched > MYSQL_FETCH_CACHE_THRESHOLD) {
+			/* The previous batch was consumed: the scan is
+			long, so fetch a bigger batch this time. */
+			row_sel_prefetch_cache_grow(prebuilt);
+		}
+
 		prebuilt->n_rows_fetched++;
 
 		if (prebuilt->n_rows_fetched > 1000000000) {
@@ -5209,6 +5410,18 @@ row_search_mvcc(
 		}
 	}
 
+	if (use_clustered_index
+	    && srv_batched_lookup_size > 1
+	    && !unique_search
+	    && !prebuilt->clust_read_ahead_off
+	    && prebuilt->n_rows_fetched >= MYSQL_FETCH_CACHE_THRESHOLD
+	    && !dict_index_is_spatial(index)
+	    && !srv_read_only_mode
+	    && page_get_page_no(page_align(rec))
+	    != prebuilt->clust_read_ahead_page) {
+		row_sel_read_ahead_clust(prebuilt, index, rec, moves_up);
+	}
+
 	if (use_clustered_index) {
 requires_clust_rec:
 		ut_ad(index != clust_index);
@@ -5342,7 +5555,7 @@ row_search_mvcc(
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -5395,7 +5608,7 @@ row_search_mvcc(
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_size) {
 			goto next_rec;
 		}
 
@@ -25,6 +25,7 @@ Database monitor counter interfaces
 Created 12/9/2009 Jimmy Yang
 *******************************************************/
 
+#include "btr0sea.h"
 #include "buf0buf.h"
 #include "dict0mem.h"
 #include "ibuf0ibuf.h"
@@ -437,6 +438,12 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_FLUSH_AVG_PASS},
 
+	{"buffer_flush_io_depth_stall_time", "buffer",
+	 "Time (us) flush_list batches waited for page writes to complete"
+	 " (innodb_flush_io_depth).",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_IO_DEPTH_STALL_TIME},
+
 	{"buffer_LRU_get_free_loops", "buffer",
 	 "Total loops in LRU get free.",
 	 MONITOR_NONE,
@@ -812,6 +819,12 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_TRX_ACTIVE},
 
+	{"trx_snapshots_reused", "transaction",
+	 "Number of read views that reused a shared snapshot"
+	 " of the active transactions",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_TRX_SNAPSHOT_REUSED},
+
 	{"trx_rseg_history_len", "transaction",
 	 "Length of the TRX_RSEG_HISTORY list",
 	 static_cast<monitor_type_t>(
@@ -1100,6 +1113,12 @@ static monitor_info_t	innodb_counter_info[] =
 	 "Number of Adaptive Hash Index rows updated",
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_ROW_UPDATED},
+
+	{"adaptive_hash_latch_waits", "adaptive_hash_index",
+	 "Number of times a thread waited for an Adaptive Hash Index"
+	 " partition latch",
+	 MONITOR_EXISTING,
+	 MONITOR_DEFAULT_START, MONITOR_OVLD_ADAPTIVE_HASH_LATCH_WAITS},
 #endif /* BTR_CUR_HASH_ADAPT */
 
 	/* ========== Counters for tablespace ========== */
@@ -2027,6 +2046,10 @@ srv_mon_process_existing_counter(
 	case MONITOR_OVLD_ADAPTIVE_HASH_SEARCH:
 		value = btr_cur_n_sea;
 		break;
+
+	case MONITOR_OVLD_ADAPTIVE_HASH_LATCH_WAITS:
+		value = btr_search_latch_waits();
+		break;
 #endif /* BTR_CUR_HASH_ADAPT */
 
 	case MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE:
@@ -49,6 +49,7 @@ Created 10/8/1995 Heikki Tuuri
 #include "ha_prototypes.h"
 
 #include "btr0sea.h"
+#include "buf0dblwr.h"
 #include "buf0flu.h"
 #include "buf0lru.h"
 #include "dict0boot.h"
@@ -146,6 +147,8 @@ my_bool	srv_read_only_mode;
 /** store to its own file each table created by an user; data
 dictionary tables are in the system tablespace 0 */
 my_bool	srv_file_per_table;
+/** Number of threads that open the file-per-table tablespaces at startup */
+ulong	srv_tablespace_discovery_threads;
 /** Set if InnoDB operates in read-only mode or innodb-force-recovery
 is greater than SRV_FORCE_NO_TRX_UNDO. */
 my_bool	high_level_read_only;
@@ -157,13 +160,22 @@ ibool	srv_locks_unsafe_for_binlog;
 ulong	srv_sort_buf_size;
 /** Maximum modification log file size for online index creation */
 unsigned long long	srv_online_max_size;
+/** Number of threads that scan the clustered index and load the
+secondary indexes in ALTER TABLE...ADD INDEX; 1=no parallel build */
+ulong	srv_index_build_threads;
 
 /* If this flag is TRUE, then we will use the native aio of the
 OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 my_bool	srv_use_native_aio;
+/** innodb_use_io_uring: whether native aio on Linux uses io_uring
+instead of libaio */
+my_bool	srv_use_io_uring;
 my_bool	srv_numa_interleave;
+/** innodb_buffer_pool_numa_bind: whether to bind each buffer pool
+instance to a NUMA node */
+my_bool	srv_buf_pool_numa_bind;
 /** copy of innodb_use_atomic_writes; @see innobase_init() */
 my_bool	srv_use_atomic_writes;
 /** innodb_compression_algorithm; used with page compression */
@@ -246,6 +258,12 @@ ulint	srv_buf_pool_base_size;
 ulint	srv_buf_pool_curr_size;
 /** Dump this % of each buffer pool during BP dump */
 ulong	srv_buf_pool_dump_pct;
+/** Number of threads that load the buffer pool */
+ulong	srv_buf_pool_load_threads;
+/** Pending asynchronous reads per buffer pool load thread */
+ulong	srv_buf_pool_load_io_depth;
+/** Percentage of the buffer pool load to wait for at startup */
+ulong	srv_buf_pool_load_warm_pct;
 /** Abort load after this amount of pages */
 #ifdef UNIV_DEBUG
 ulong srv_buf_pool_load_pages_abort = LONG_MAX;
@@ -285,6 +303,8 @@ ulint	srv_max_n_open_files;
 ulong	srv_io_capacity;
 /** innodb_io_capacity_max */
 ulong	srv_max_io_capacity;
+/** innodb_flush_io_depth */
+ulong	srv_flush_io_depth;
 
 /** innodb_page_cleaners; the number of page cleaner threads */
 ulong	srv_n_page_cleaners;
@@ -313,6 +333,10 @@ ulong	srv_n_purge_threads;
 /** innodb_purge_batch_size, in pages */
 ulong	srv_purge_batch_size;
 
+/** innodb_recovery_apply_threads; the number of threads applying
+redo log records to pages during crash recovery */
+ulong	srv_n_recv_apply_threads;
+
 /** innodb_stats_method decides how InnoDB treats
 NULL value when collecting statistics. By default, it is set to
 SRV_STATS_NULLS_EQUAL(0), ie. all NULL value are treated equal */
@@ -350,6 +374,10 @@ ibool	srv_innodb_status;
 prefix index queries to skip cluster index lookup when possible */
 my_bool	srv_prefix_index_cluster_optimization;
 
+/** innodb_batched_lookup_size; maximum number of records of a secondary
+index page whose clustered index leaf pages are read ahead together */
+ulong	srv_batched_lookup_size;
+
 /** innodb_stats_transient_sample_pages;
 When estimating number of different key values in an index, sample
 this many index pages, there are 2 ways to calculate statistics:
@@ -383,6 +411,9 @@ number of pages to use in LRU and flush_list batch flushing.
 The rest of the doublewrite buffer is used for single-page flushing. */
 ulong	srv_doublewrite_batch_size = 120;
 
+/** innodb_doublewrite_segments */
+ulong	srv_doublewrite_segments;
+
 /** innodb_replication_delay */
 ulong	srv_replication_delay;
 
@@ -1320,9 +1351,15 @@ srv_printf_innodb_monitor(
 		table->heap will be pointing to the same object
 		for the full lifetime of the server. Even during
 		btr_search_disable() the heap will stay valid. */
+		const btr_search_part_stat_t& stat
+			= btr_search_sys->part_stats[i];
 		fprintf(file, "Hash table size " ULINTPF
-			", node heap has " ULINTPF " buffer(s)\n",
-			table->n_cells, heap->base.count - !heap->free_block);
+			", node heap has " ULINTPF " buffer(s)"
+			", hits " ULINTPF ", misses " ULINTPF
+			", latch waits " ULINTPF "\n",
+			table->n_cells, heap->base.count - !heap->free_block,
+			stat.n_hash_succ, stat.n_hash_fail,
+			stat.n_latch_waits);
 	}
 
 	fprintf(file,
@@ -1556,6 +1593,12 @@ srv_export_innodb_status(void)
 
 	export_vars.innodb_dblwr_writes = srv_stats.dblwr_writes;
 
+	export_vars.innodb_dblwr_segments = buf_dblwr
+		? buf_dblwr->n_segments : 0;
+
+	export_vars.innodb_dblwr_segments_written = buf_dblwr
+		? buf_dblwr_n_segments_written() : 0;
+
 	export_vars.innodb_pages_created = stat.n_pages_created;
 
 	export_vars.innodb_pages_read = stat.n_pages_read;
@@ -1568,6 +1611,9 @@ srv_export_innodb_status(void)
 	export_vars.innodb_row_lock_current_waits =
 		srv_stats.n_lock_wait_current_count;
 
+	export_vars.innodb_row_lock_shard_grants =
+		srv_stats.n_lock_rec_shard_grants;
+
 	export_vars.innodb_row_lock_time = srv_stats.n_lock_wait_time / 1000;
 
 	if (srv_stats.n_lock_wait_count > 0) {
@@ -1630,11 +1676,15 @@ srv_export_innodb_status(void)
 	export_vars.innodb_onlineddl_rowlog_rows = onlineddl_rowlog_rows;
 	export_vars.innodb_onlineddl_rowlog_pct_used = onlineddl_rowlog_pct_used;
 	export_vars.innodb_onlineddl_pct_progress = onlineddl_pct_progress;
+	export_vars.innodb_onlineddl_parallel_scan_threads =
+		my_atomic_loadlint(&onlineddl_parallel_scan_threads);
 
 	export_vars.innodb_sec_rec_cluster_reads =
 		srv_stats.n_sec_rec_cluster_reads;
 	export_vars.innodb_sec_rec_cluster_reads_avoided =
 		srv_stats.n_sec_rec_cluster_reads_avoided;
+	export_vars.innodb_sec_rec_cluster_read_aheads =
+		srv_stats.n_sec_rec_cluster_read_aheads;
 
 	if (!srv_read_only_mode) {
 	export_vars.innodb_encryption_rotation_pages_read_from_cache =
@@ -1717,7 +1767,7 @@ DECLARE_THREAD(srv_monitor_thread)(void*)
 		if (srv_print_innodb_monitor) {
 			/* Reset mutex_skipped counter everytime
 			srv_print_innodb_monitor changes. This is to
-			ensure we will not be blocked by lock_sys.mutex
+			ensure we will not be blocked by lock_sys.latch
 			for short duration information printing,
 			such as requested by sync_array_print_long_waits() */
 			if (!last_srv_print_monitor) {
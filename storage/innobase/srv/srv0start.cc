@@ -177,6 +177,59 @@ enum srv_start_state_t {
 /** Track server thrd starting phases */
 static ulint	srv_start_state;
 
+/** A phase of innobase_start_or_create_for_mysql() */
+struct srv_start_phase_t {
+	/** name of the phase */
+	const char*	name;
+	/** duration of the phase, in milliseconds */
+	ulint		ms;
+};
+
+/** The completed startup phases */
+static srv_start_phase_t	srv_start_phases[8];
+/** Number of completed startup phases */
+static ulint			srv_start_n_phases;
+/** ut_time_ms() at the start of the current startup phase */
+static ulint			srv_start_phase_time;
+
+/** Note the end of a startup phase.
+@param[in]	name	name of the phase */
+static
+void
+srv_start_phase_end(const char* name)
+{
+	ulint	now = ut_time_ms();
+
+	ut_ad(srv_start_n_phases < UT_ARR_SIZE(srv_start_phases));
+
+	srv_start_phase_t&	phase = srv_start_phases[srv_start_n_phases++];
+
+	phase.name = name;
+	phase.ms = now - srv_start_phase_time;
+	srv_start_phase_time = now;
+}
+
+/** Report the durations of the startup phases. */
+static
+void
+srv_start_phases_print()
+{
+	ulint	total = 0;
+
+	for (ulint i = 0; i < srv_start_n_phases; i++) {
+		total += srv_start_phases[i].ms;
+	}
+
+	ib::info	info;
+
+	info << "Startup took " << total << " ms:";
+
+	for (ulint i = 0; i < srv_start_n_phases; i++) {
+		info << (i ? ", " : " ") << srv_start_phases[i].name
+		     << " " << srv_start_phases[i].ms << " ms";
+	}
+}
+
 /** At a shutdown this value climbs from SRV_SHUTDOWN_NONE to
 SRV_SHUTDOWN_CLEANUP and then to SRV_SHUTDOWN_LAST_PHASE, and so on */
 enum srv_shutdown_t	srv_shutdown_state = SRV_SHUTDOWN_NONE;
@@ -217,6 +270,7 @@ mysql_pfs_key_t	io_read_thread_key;
 mysql_pfs_key_t	io_write_thread_key;
 mysql_pfs_key_t	srv_error_monitor_thread_key;
 mysql_pfs_key_t	srv_lock_timeout_thread_key;
+mysql_pfs_key_t	srv_lock_deadlock_thread_key;
 mysql_pfs_key_t	srv_master_thread_key;
 mysql_pfs_key_t	srv_monitor_thread_key;
 mysql_pfs_key_t	srv_purge_thread_key;
@@ -1263,6 +1317,7 @@ srv_shutdown_all_bg_threads()
 		if (srv_start_state_is_set(SRV_START_STATE_LOCK_SYS)) {
 			/* a. Let the lock timeout thread exit */
 			os_event_set(lock_sys.timeout_event);
+			os_event_set(lock_sys.deadlock_event);
 		}
 
 		if (!srv_read_only_mode) {
@@ -1502,6 +1557,8 @@ innobase_start_or_create_for_mysql()
 
 	/* Reset the start state. */
 	srv_start_state = SRV_START_STATE_NONE;
+	srv_start_n_phases = 0;
+	srv_start_phase_time = ut_time_ms();
 
 	if (srv_read_only_mode) {
 		ib::info() << "Started in read only mode";
@@ -1641,6 +1698,7 @@ innobase_start_or_create_for_mysql()
 	srv_max_n_threads = 1   /* io_ibuf_thread */
 			    + 1 /* io_log_thread */
 			    + 1 /* lock_wait_timeout_thread */
+			    + 1 /* lock_deadlock_thread */
 			    + 1 /* srv_error_monitor_thread */
 			    + 1 /* srv_monitor_thread */
 			    + 1 /* srv_master_thread */
@@ -1657,6 +1715,7 @@ innobase_start_or_create_for_mysql()
 			    + srv_n_write_io_threads
 			    + srv_n_purge_threads
 			    + srv_n_page_cleaners
+			    + srv_n_recv_apply_threads
 			    /* FTS Parallel Sort */
 			    + fts_sort_pll_degree * FTS_NUM_AUX_INDEX
 			      * max_connections;
@@ -1677,6 +1736,12 @@ innobase_start_or_create_for_mysql()
 			srv_buf_pool_instances = 8;
 #endif /* defined(_WIN32) && !defined(_WIN64) */
 		}
+	} else if (DBUG_EVALUATE_IF("innodb_small_buffer_pool_instances",
+				    srv_buf_pool_instances
+				    != srv_buf_pool_instances_default,
+				    false)) {
+		/* Keep the requested number of instances, so that
+		tests can use several of them with a small buffer pool. */
 	} else {
 		/* If buffer pool is less than 1 GiB, assume fewer
 		threads. Also use only one buffer pool instance. */
@@ -1918,6 +1983,8 @@ innobase_start_or_create_for_mysql()
 		recv_sys_debug_free();
 	}
 
+	srv_start_phase_end("initialization");
+
 	/* Open or create the data files. */
 	ulint	sum_of_new_sizes;
 
@@ -2135,6 +2202,8 @@ innobase_start_or_create_for_mysql()
 		return(srv_init_abort(err));
 	}
 
+	srv_start_phase_end("data files");
+
 	/* Initialize objects used by dict stats gathering thread, which
 	can also be used by recovery if it tries to drop some table */
 	if (!srv_read_only_mode) {
@@ -2222,6 +2291,8 @@ innobase_start_or_create_for_mysql()
 			return(srv_init_abort(err));
 		}
 
+		srv_start_phase_end("redo log scan");
+
 		switch (srv_operation) {
 		case SRV_OPERATION_NORMAL:
 		case SRV_OPERATION_RESTORE_EXPORT:
@@ -2241,6 +2312,8 @@ innobase_start_or_create_for_mysql()
 			ut_ad(!"wrong mariabackup mode");
 		}
 
+		srv_start_phase_end("data dictionary");
+
 		if (srv_force_recovery < SRV_FORCE_NO_LOG_REDO) {
 			/* Apply the hashed log records to the
 			respective file pages, for the last batch of
@@ -2257,6 +2330,8 @@ innobase_start_or_create_for_mysql()
 			if (recv_needed_recovery) {
 				trx_sys_print_mysql_binlog_offset();
 			}
+
+			srv_start_phase_end("redo log apply");
 		}
 
 		if (!srv_read_only_mode) {
@@ -2513,6 +2588,8 @@ innobase_start_or_create_for_mysql()
 				&& srv_force_recovery == 0;
 
 			dict_check_tablespaces_and_store_max_id(validate);
+
+			srv_start_phase_end("tablespace discovery");
 		}
 
 		/* Fix-up truncate of table if server crashed while truncate
@@ -2567,6 +2644,11 @@ innobase_start_or_create_for_mysql()
 		thread_started[2 + SRV_MAX_N_IO_THREADS] = true;
 		lock_sys.timeout_thread_active = true;
 
+		/* Create the thread which looks for deadlocks
+		when innodb_deadlock_detect_async is set */
+		lock_sys.deadlock_thread_active = true;
+		os_thread_create(lock_deadlock_thread, NULL, NULL);
+
 		/* Create the thread which warns of long semaphore waits */
 		srv_error_monitor_active = true;
 		thread_handles[3 + SRV_MAX_N_IO_THREADS] = os_thread_create(
@@ -2740,6 +2822,20 @@ innobase_start_or_create_for_mysql()
 	srv_buf_resize_thread_active = true;
 	os_thread_create(buf_resize_thread, NULL, NULL);
 
+	if (!srv_read_only_mode
+#ifdef WITH_WSREP
+	    && !wsrep_recovery
+#endif /* WITH_WSREP */
+	    ) {
+		buf_load_wait_warm();
+	}
+
+	srv_start_phase_end("background tasks");
+
+	if (srv_print_verbose_log) {
+		srv_start_phases_print();
+	}
+
 	return(DB_SUCCESS);
 }
 
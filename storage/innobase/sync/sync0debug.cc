@@ -482,6 +482,7 @@ LatchDebug::LatchDebug()
 	LEVEL_MAP_INSERT(SYNC_TRX);
 	LEVEL_MAP_INSERT(SYNC_RW_TRX_HASH_ELEMENT);
 	LEVEL_MAP_INSERT(SYNC_TRX_SYS);
+	LEVEL_MAP_INSERT(SYNC_LOCK_REC_HASH);
 	LEVEL_MAP_INSERT(SYNC_LOCK_SYS);
 	LEVEL_MAP_INSERT(SYNC_LOCK_WAIT_SYS);
 	LEVEL_MAP_INSERT(SYNC_INDEX_ONLINE_LOG);
@@ -760,6 +761,7 @@ LatchDebug::check_order(
 	case SYNC_DOUBLEWRITE:
 	case SYNC_SEARCH_SYS:
 	case SYNC_THREADS:
+	case SYNC_LOCK_REC_HASH:
 	case SYNC_LOCK_SYS:
 	case SYNC_LOCK_WAIT_SYS:
 	case SYNC_RW_TRX_HASH_ELEMENT:
@@ -811,7 +813,7 @@ LatchDebug::check_order(
 
 	case SYNC_TRX:
 
-		/* Either the thread must own the lock_sys.mutex, or
+		/* Either the thread must own the lock_sys.latch, or
 		it is allowed to own only ONE trx_t::mutex. */
 
 		if (less(latches, level) != NULL) {
@@ -1409,7 +1411,8 @@ sync_latch_meta_init()
 
 	LATCH_ADD_MUTEX(TRX, SYNC_TRX, trx_mutex_key);
 
-	LATCH_ADD_MUTEX(LOCK_SYS, SYNC_LOCK_SYS, lock_mutex_key);
+	LATCH_ADD_MUTEX(LOCK_SYS_REC_HASH, SYNC_LOCK_REC_HASH,
+			lock_rec_hash_mutex_key);
 
 	LATCH_ADD_MUTEX(LOCK_SYS_WAIT, SYNC_LOCK_WAIT_SYS,
 			lock_wait_mutex_key);
@@ -1477,6 +1480,8 @@ sync_latch_meta_init()
 
 	LATCH_ADD_RWLOCK(CHECKPOINT, SYNC_NO_ORDER_CHECK, checkpoint_lock_key);
 
+	LATCH_ADD_RWLOCK(LOCK_SYS, SYNC_LOCK_SYS, lock_sys_latch_key);
+
 	LATCH_ADD_RWLOCK(FIL_SPACE, SYNC_FSP, fil_space_latch_key);
 
 	LATCH_ADD_RWLOCK(FTS_CACHE, SYNC_FTS_CACHE, fts_cache_rw_lock_key);
@@ -1489,6 +1494,9 @@ sync_latch_meta_init()
 
 	LATCH_ADD_RWLOCK(TRX_PURGE, SYNC_PURGE_LATCH, trx_purge_latch_key);
 
+	LATCH_ADD_RWLOCK(TRX_SYS_SNAPSHOT, SYNC_NO_ORDER_CHECK,
+			 trx_sys_snapshot_latch_key);
+
 	LATCH_ADD_RWLOCK(IBUF_INDEX_TREE, SYNC_IBUF_INDEX_TREE,
 			 index_tree_rw_lock_key);
 
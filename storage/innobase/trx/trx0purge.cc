@@ -27,6 +27,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "ha_prototypes.h"
 
 #include "trx0purge.h"
+#include "buf0rea.h"
 #include "fsp0fsp.h"
 #include "fut0fut.h"
 #include "mach0data.h"
@@ -178,6 +179,8 @@ void purge_sys_t::create()
   rw_lock_create(trx_purge_latch_key, &latch, SYNC_PURGE_LATCH);
   mutex_create(LATCH_ID_PURGE_SYS_PQ, &pq_mutex);
   undo_trunc.create();
+  heap= mem_heap_create(srv_page_size);
+  prefetch_page_no= FIL_NULL;
   m_initialised = true;
 }
 
@@ -201,6 +204,8 @@ void purge_sys_t::close()
 	ut_d(latch.magic_n = RW_LOCK_MAGIC_N);
 	mutex_free(&pq_mutex);
 	os_event_destroy(event);
+	mem_heap_free(heap);
+	heap = NULL;
 }
 
 /*================ UNDO LOG HISTORY LIST =============================*/
@@ -1238,6 +1243,7 @@ trx_purge_get_next_rec(
 	ulint		offset;
 	ulint		page_no;
 	ulint		space;
+	ulint		prefetch_page_no = FIL_NULL;
 	mtr_t		mtr;
 
 	ut_ad(purge_sys.next_stored);
@@ -1303,12 +1309,27 @@ trx_purge_get_next_rec(
 			/* We advance to a new page of the undo log: */
 			(*n_pages_handled)++;
 		}
+
+		/* Read ahead the page that follows the one that we are
+		about to parse, so that it will hopefully be in the buffer
+		pool by the time we get there. */
+		prefetch_page_no = flst_get_next_addr(
+			page + TRX_UNDO_PAGE_HDR + TRX_UNDO_PAGE_NODE,
+			&mtr).page;
 	}
 
 	rec_copy = trx_undo_rec_copy(rec, heap);
 
 	mtr_commit(&mtr);
 
+	if (prefetch_page_no != FIL_NULL
+	    && prefetch_page_no != purge_sys.prefetch_page_no) {
+		purge_sys.prefetch_page_no = prefetch_page_no;
+		buf_read_page_background(page_id_t(space, prefetch_page_no),
+					 univ_page_size, false);
+		os_aio_simulated_wake_handler_threads();
+	}
+
 	return(rec_copy);
 }
 
@@ -1357,7 +1378,74 @@ trx_purge_fetch_next_rec(
 	return(trx_purge_get_next_rec(n_pages_handled, heap));
 }
 
+/** Determine the table that an undo log record refers to.
+@param[in]	undo_rec	undo log record, or &trx_purge_dummy_rec
+@return table identifier, or 0 for the dummy record */
+static
+table_id_t
+trx_purge_get_table_id(trx_undo_rec_t* undo_rec)
+{
+	if (undo_rec == &trx_purge_dummy_rec) {
+		return(0);
+	}
+
+	ulint		type;
+	ulint		cmpl_info;
+	bool		updated_extern;
+	undo_no_t	undo_no;
+	table_id_t	table_id;
+
+	trx_undo_rec_get_pars(undo_rec, &type, &cmpl_info, &updated_extern,
+			      &undo_no, &table_id);
+
+	return(table_id);
+}
+
+/** Find the purge node that has been assigned the fewest undo log records
+in the current batch.
+@param n_purge_threads	number of purge threads
+@return purge node */
+static
+purge_node_t*
+trx_purge_least_loaded_node(ulint n_purge_threads)
+{
+	purge_node_t*	best = NULL;
+	ulint		best_size = ULINT_UNDEFINED;
+	ulint		i = 0;
+
+	for (que_thr_t* thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
+	     thr != NULL && i < n_purge_threads;
+	     thr = UT_LIST_GET_NEXT(thrs, thr), ++i) {
+
+		purge_node_t*	node = static_cast<purge_node_t*>(thr->child);
+		ulint		size = node->undo_recs
+			? ib_vector_size(node->undo_recs) : 0;
+
+		if (size < best_size) {
+			best = node;
+			best_size = size;
+
+			if (!size) {
+				break;
+			}
+		}
+	}
+
+	return(best);
+}
+
+/** Map from table identifier to the purge node that handles the
+undo log records of the table in the current batch */
+typedef std::map<
+	table_id_t, purge_node_t*, std::less<table_id_t>,
+	ut_allocator<std::pair<const table_id_t, purge_node_t*> > >
+	purge_table_map_t;
+
 /** Run a purge batch.
+All undo log records of a table are assigned to the same purge thread,
+so that the threads do not contend for the same index pages and
+dictionary objects. Each table goes to the thread that has been
+assigned the fewest records so far.
 @param n_purge_threads	number of purge threads
 @return number of undo log pages handled in the batch */
 static
@@ -1367,12 +1455,14 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 	que_thr_t*	thr;
 	ulint		i = 0;
 	ulint		n_pages_handled = 0;
-	ulint		n_thrs = UT_LIST_GET_LEN(purge_sys.query->thrs);
 
 	ut_a(n_purge_threads > 0);
 
 	purge_sys.head = purge_sys.tail;
 
+	/* The records of the previous batch have all been processed. */
+	mem_heap_empty(purge_sys.heap);
+
 	/* Debug code to validate some pre-requisites and reset done flag. */
 	for (thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
 	     thr != NULL && i < n_purge_threads;
@@ -1383,11 +1473,13 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 		/* Get the purge node. */
 		node = (purge_node_t*) thr->child;
 
+		ut_a(!thr->is_active);
 		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
 		ut_a(node->undo_recs == NULL);
 		ut_a(node->done);
 
 		node->done = FALSE;
+		node->n_tables = 0;
 	}
 
 	/* There should never be fewer nodes than threads, the inverse
@@ -1396,27 +1488,16 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 
 	/* Fetch and parse the UNDO records. The UNDO records are added
 	to a per purge node vector. */
-	thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
-	ut_a(n_thrs > 0 && thr != NULL);
-
 	ut_ad(purge_sys.head <= purge_sys.tail);
 
-	i = 0;
-
-	const ulint batch_size = srv_purge_batch_size;
+	const ulint		batch_size = srv_purge_batch_size;
+	purge_table_map_t	table_node;
+	table_id_t		last_table_id = 0;
+	purge_node_t*		last_node = NULL;
 
 	for (;;) {
 		purge_node_t*		node;
-		trx_purge_rec_t*	purge_rec;
-
-		ut_a(!thr->is_active);
-
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
-
-		purge_rec = static_cast<trx_purge_rec_t*>(
-			mem_heap_zalloc(node->heap, sizeof(*purge_rec)));
+		trx_purge_rec_t		purge_rec;
 
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
@@ -1426,44 +1507,120 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 		}
 
 		/* Fetch the next record, and advance the purge_sys.tail. */
-		purge_rec->undo_rec = trx_purge_fetch_next_rec(
-			&purge_rec->roll_ptr, &n_pages_handled, node->heap);
-
-		if (purge_rec->undo_rec != NULL) {
-
-			if (node->undo_recs == NULL) {
-				node->undo_recs = ib_vector_create(
-					ib_heap_allocator_create(node->heap),
-					sizeof(trx_purge_rec_t),
-					batch_size);
-			} else {
-				ut_a(!ib_vector_is_empty(node->undo_recs));
-			}
+		purge_rec.undo_rec = trx_purge_fetch_next_rec(
+			&purge_rec.roll_ptr, &n_pages_handled,
+			purge_sys.heap);
 
-			ib_vector_push(node->undo_recs, purge_rec);
+		if (purge_rec.undo_rec == NULL) {
+			break;
+		}
 
-			if (n_pages_handled >= batch_size) {
+		const table_id_t table_id = trx_purge_get_table_id(
+			purge_rec.undo_rec);
 
-				break;
+		if (last_node != NULL && table_id == last_table_id) {
+			/* Consecutive records of the same table are
+			the common case. */
+			node = last_node;
+		} else {
+			node = NULL;
+
+			if (table_id != 0) {
+				purge_table_map_t::const_iterator it
+					= table_node.find(table_id);
+
+				if (it != table_node.end()) {
+					node = it->second;
+				}
 			}
+
+			if (node == NULL) {
+				node = trx_purge_least_loaded_node(
+					n_purge_threads);
+
+				if (table_id != 0) {
+					table_node[table_id] = node;
+					node->n_tables++;
+				}
+			}
+
+			last_table_id = table_id;
+			last_node = node;
+		}
+
+		if (node->undo_recs == NULL) {
+			node->undo_recs = ib_vector_create(
+				ib_heap_allocator_create(node->heap),
+				sizeof(trx_purge_rec_t),
+				batch_size);
 		} else {
-			break;
+			ut_a(!ib_vector_is_empty(node->undo_recs));
 		}
 
-		thr = UT_LIST_GET_NEXT(thrs, thr);
+		ib_vector_push(node->undo_recs, &purge_rec);
 
-		if (!(++i % n_purge_threads)) {
-			thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
+		if (n_pages_handled >= batch_size) {
+			break;
 		}
-
-		ut_a(thr != NULL);
 	}
 
 	ut_ad(purge_sys.head <= purge_sys.tail);
 
+#ifdef UNIV_DEBUG
+	ulint	n_nodes_with_tables = 0;
+	i = 0;
+
+	for (thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
+	     thr != NULL && i < n_purge_threads;
+	     thr = UT_LIST_GET_NEXT(thrs, thr), ++i) {
+		n_nodes_with_tables += static_cast<purge_node_t*>(
+			thr->child)->n_tables > 0;
+	}
+
+	if (n_nodes_with_tables > 1) {
+		export_vars.innodb_purge_split_batches++;
+	}
+#endif /* UNIV_DEBUG */
+
 	return(n_pages_handled);
 }
 
+/** Print the per-thread purge statistics.
+@param[in,out]	file	output stream */
+void
+trx_purge_print_stats(FILE* file)
+{
+	if (!purge_sys.is_initialised()) {
+		return;
+	}
+
+	ulint	i = 0;
+
+	for (const que_thr_t* thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
+	     thr != NULL;
+	     thr = UT_LIST_GET_NEXT(thrs, thr), ++i) {
+
+		const purge_node_t*	node
+			= static_cast<const purge_node_t*>(thr->child);
+
+		if (!node->n_purged) {
+			continue;
+		}
+
+		fprintf(file,
+			"Purge thread " ULINTPF ": " ULINTPF " undo records"
+			" in %.2f s, %.2f records/s, " ULINTPF
+			" tables in last batch\n",
+			i, node->n_purged,
+			double(node->purge_time) / 1000000.0,
+			node->purge_time
+			? double(node->n_purged) * 1000000.0
+			/ double(node->purge_time)
+			: 0.0,
+			node->n_tables);
+	}
+}
+
 /*******************************************************************//**
 Calculate the DML delay required.
 @return delay in microseconds or ULINT_MAX */
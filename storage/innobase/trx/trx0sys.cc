@@ -43,6 +43,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "log0recv.h"
 #include "os0file.h"
 #include "fsp0sysspace.h"
+#include "sync0sync.h"
 
 #include <mysql/service_wsrep.h>
 
@@ -217,6 +218,13 @@ trx_sys_t::create()
 	UT_LIST_INIT(mysql_trx_list, &trx_t::mysql_trx_list);
 	UT_LIST_INIT(m_views, &ReadView::m_view_list);
 	my_atomic_store32(&rseg_history_len, 0);
+	my_atomic_store64(&m_rw_trx_hash_erase_version, 0);
+
+	rw_lock_create(trx_sys_snapshot_latch_key, &m_snapshot.latch,
+		       SYNC_NO_ORDER_CHECK);
+	m_snapshot.max_trx_id = 0;
+	m_snapshot.erase_version = -1;
+	m_snapshot.min_trx_no = 0;
 
 	rw_trx_hash.init();
 }
@@ -344,6 +352,8 @@ trx_sys_t::close()
 
 	ut_a(UT_LIST_GET_LEN(mysql_trx_list) == 0);
 	ut_ad(UT_LIST_GET_LEN(m_views) == 0);
+	trx_ids_t().swap(m_snapshot.ids);
+	rw_lock_free(&m_snapshot.latch);
 	mutex_free(&mutex);
 	m_initialised = false;
 }
@@ -0,0 +1,157 @@
+/* Copyright (c) 2018, MariaDB Corporation.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software Foundation,
+  51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA */
+
+/*
+  Correctness test of cmp_bytes(), the word-wide comparison of binary
+  key fields in InnoDB, against memcmp() and against the byte loop
+  followed by memcmp() that cmp_data() used before.
+
+  With the --bench argument, the comparison functions are also timed.
+  ctest does not pass it, because the timings depend on the machine.
+*/
+
+#include "univ.i"
+#include "rem0cmp.h"
+#include <my_sys.h>
+#include <tap.h>
+
+/** Maximum key length to test */
+static const ulint MAX_LEN = 300;
+/** Number of comparisons to time */
+static const ulint N_ROUNDS = 2000000;
+
+/** The comparison of the common prefix in cmp_data() before cmp_bytes()
+@return the comparison result of data1 and data2 */
+static int cmp_bytes_old(const byte *data1, const byte *data2, ulint len)
+{
+  int cmp;
+#if defined __i386__ || defined __x86_64__ || defined _M_IX86 || defined _M_X64
+  for (ulint i= 4 + (len & 3); i > 0; i--)
+  {
+    cmp= int(*data1++) - int(*data2++);
+    if (cmp)
+      return cmp;
+    if (!--len)
+      return 0;
+  }
+#endif
+  return memcmp(data1, data2, len);
+}
+
+static int cmp_memcmp(const byte *data1, const byte *data2, ulint len)
+{
+  return memcmp(data1, data2, len);
+}
+
+/** Time a comparison function.
+@return nanoseconds per comparison */
+static double bench(int (*cmp)(const byte*, const byte*, ulint),
+                    const byte *a, const byte *b, ulint len)
+{
+  volatile int sink= 0;
+  ulonglong start= my_interval_timer();
+
+  for (ulint i= 0; i < N_ROUNDS; i++)
+    sink+= cmp(a + (i & 1), b + (i & 1), len);
+
+  return double(my_interval_timer() - start) / N_ROUNDS;
+}
+
+static int sign(int cmp)
+{
+  return (cmp > 0) - (cmp < 0);
+}
+
+/** Compare all lengths, difference positions and alignments with memcmp().
+@return number of mismatches */
+static ulint test_cmp_bytes(const byte *a, byte *b)
+{
+  ulint errors= 0;
+
+  for (ulint offset= 0; offset < 8; offset++)
+  {
+    for (ulint len= 0; len + offset <= MAX_LEN; len++)
+    {
+      const byte *x= a + offset;
+      byte *y= b + offset;
+
+      memcpy(y, x, len);
+      errors+= cmp_bytes(x, y, len) != 0;
+
+      for (ulint pos= 0; pos < len; pos++)
+      {
+        const byte save= y[pos];
+
+        for (int delta= -1; delta <= 1; delta+= 2)
+        {
+          y[pos]= byte(save + delta);
+          errors+= sign(cmp_bytes(x, y, len)) != sign(memcmp(x, y, len));
+          errors+= sign(cmp_bytes(y, x, len)) != sign(memcmp(y, x, len));
+        }
+
+        y[pos]= save;
+      }
+    }
+  }
+
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  const bool do_bench= argc > 1 && !strcmp(argv[1], "--bench");
+
+  MY_INIT(argv[0]);
+  plan(2);
+
+  byte *a= static_cast<byte*>(malloc(MAX_LEN + 8));
+  byte *b= static_cast<byte*>(malloc(MAX_LEN + 8));
+
+  for (ulint i= 0; i < MAX_LEN + 8; i++)
+    a[i]= byte(i * 131 + 17);
+
+  ok(test_cmp_bytes(a, b) == 0, "cmp_bytes() orders like memcmp()");
+
+  static const ulint lens[]= {4, 8, 16, 20, 32, 64, 255};
+  ulint errors= 0;
+
+  for (ulint i= 0; i < array_elements(lens); i++)
+  {
+    const ulint len= lens[i];
+
+    memcpy(b, a, MAX_LEN + 8);
+    b[len - 1]^= 1;
+    b[len]^= 1;
+
+    errors+= sign(cmp_bytes(a, b, len)) != sign(cmp_bytes_old(a, b, len));
+
+    if (do_bench)
+    {
+      double t_old= bench(cmp_bytes_old, a, b, len);
+      double t_new= bench(cmp_bytes, a, b, len);
+      double t_memcmp= bench(cmp_memcmp, a, b, len);
+
+      diag("len %3lu: old %6.2f ns, cmp_bytes %6.2f ns, memcmp %6.2f ns",
+           ulong(len), t_old, t_new, t_memcmp);
+    }
+  }
+
+  ok(errors == 0, "cmp_bytes() agrees with the old comparison");
+
+  free(a);
+  free(b);
+  my_end(0);
+  return exit_status();
+}